@@ -39,6 +39,28 @@ QT += sql
 
 QMAKE_CXXFLAGS += -std=c++17 -static -static-libgcc
 
+  # Allows the compiler to if-convert and vectorise the floating point kernels. The library does not use errno or FP exceptions.
+
+QMAKE_CXXFLAGS += -fno-math-errno -fno-trapping-math
+
+  # The coroutine interface (include/async.h) needs C++20. Enabled with qmake CONFIG+=wcl_coroutines.
+
+wcl_coroutines {
+  QMAKE_CXXFLAGS += -std=c++20
+}
+
+  # Compiles in the span tracing (include/trace.h). Enabled with qmake CONFIG+=wcl_tracing.
+
+wcl_tracing {
+  DEFINES += WCL_TRACING
+}
+
+  # Counts the operator new calls of each thread (include/allocationCounter.h). Enabled with qmake CONFIG+=wcl_allocationCount.
+
+wcl_allocationCount {
+  DEFINES += WCL_COUNT_ALLOCATIONS
+}
+
 win32:CONFIG(release, debug|release) {
   DESTDIR = "../Library/win32/release"
   OBJECTS_DIR = "../Library/win32/release/object/WCL"
@@ -70,23 +92,72 @@ INCLUDEPATH += \
 SOURCES += \
     source/WeatherLink.cpp \
     source/database.cpp \
+    source/databaseSQLite.cpp \
     source/GeneralFunctions.cpp \
     source/settings.cpp \
     source/common.cpp \
-    source/error.cpp
+    source/error.cpp \
+    source/importCatalog.cpp \
+    source/meteorology.cpp \
+    source/replay.cpp \
+    source/rollingStatistics.cpp \
+    source/streamMerge.cpp \
+    source/timeSeriesStore.cpp \
+    source/timestamp.cpp \
+    source/weatherLinkTail.cpp \
+    source/windRose.cpp \
+    source/exporter.cpp \
+    source/arrowExporter.cpp \
+    source/validation.cpp \
+    source/gapIndex.cpp \
+    source/archiveDump.cpp \
+    source/shardedWriter.cpp \
+    source/async.cpp \
+    source/trace.cpp \
+    source/boundedImport.cpp \
+    source/stationCache.cpp \
+    source/priorityWriter.cpp \
+    source/allocationCounter.cpp
 
 HEADERS += \
     WCL \
     include/Ccitt.h \
     include/database.h \
+    include/databaseSQLite.h \
     include/GeneralFunctions.h \
     include/settings.h \
     include/WeatherLink.h \
     include/WeatherLinkIP.h \
     include/common.h \
-    include/error.h
+    include/error.h \
+    include/importCatalog.h \
+    include/meteorology.h \
+    include/replay.h \
+    include/rollingStatistics.h \
+    include/streamMerge.h \
+    include/timeSeriesStore.h \
+    include/timestamp.h \
+    include/weatherLinkTail.h \
+    include/weatherStore.h \
+    include/windRose.h \
+    include/exporter.h \
+    include/arrowExporter.h \
+    include/validation.h \
+    include/gapIndex.h \
+    include/archiveDump.h \
+    include/wireFormat.h \
+    include/unitTransform.h \
+    include/observation.h \
+    include/shardedWriter.h \
+    include/async.h \
+    include/trace.h \
+    include/boundedImport.h \
+    include/stationCache.h \
+    include/priorityWriter.h \
+    include/allocationCounter.h
 
 LIBS += -L../GCL -lGCL
 LIBS += -L../PCL -lPCL
+LIBS += -lsqlite3
 
 
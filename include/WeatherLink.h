@@ -30,6 +30,7 @@
 // CLASS HIERARCHY:     CWeatherLinkDatabaseFile
 //
 // HISTORY:             2011-07-24/GGB - Development of classes for openAIRS
+//                      2026-10-19/GGB - Added reloadHeader() and readArchiveRecords() for tailing the current file.
 //
 //*********************************************************************************************************************************
 
@@ -40,6 +41,7 @@
 
   // Standard C++ library header files
 
+#include <cstddef>
 #include <cstdint>
 #include <fstream>
 #include <string>
@@ -191,6 +193,10 @@ namespace WCL
     SWeatherDataRecord const &getArchiveRecord() const;
     int const &getDay() const { return dayIndex;}
 
+    SHeaderBlock const &getHeaderBlock() const { return headerBlock; }
+    bool reloadHeader();
+    std::size_t readArchiveRecords(int, int, SWeatherDataRecord *, std::size_t);
+
   };
 
 
@@ -110,6 +110,13 @@ namespace WCL
     std::uint16_t CRC;
   };
 
+  struct SDMPAFTRequest
+  {
+    std::uint16_t dateStamp;      ///< day + month * 32 + (year - 2000) * 512
+    std::uint16_t timeStamp;      ///< hour * 100 + minute
+    std::uint16_t CRC;            ///< Sent MSB first.
+  } __attribute__((packed));
+
   struct SDMPAFTResponse
   {
     std::uint16_t pages;
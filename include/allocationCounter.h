@@ -0,0 +1,56 @@
+﻿//*********************************************************************************************************************************
+//
+// PROJECT:							Weather Class Library (WCL)
+// FILE:								allocationCounter
+// SUBSYSTEM:						Heap allocation counting
+// LANGUAGE:						C++
+// TARGET OS:						WINDOWS/UNIX/LINUX/MAC
+// LIBRARY DEPENDANCE:	None.
+// NAMESPACE:						WCL
+// AUTHOR:							Gavin Blakeman.
+// LICENSE:             GPLv2
+//
+//                      Copyright 2026 Gavin Blakeman.
+//                      This file is part of the Weather Class Library (WCL).
+//
+//                      WCL is free software: you can redistribute it and/or modify it under the terms of the GNU General
+//                      Public License as published by the Free Software Foundation, either version 2 of the License, or (at your
+//                      option) any later version.
+//
+//                      WCL is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the
+//                      implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//                      for more details.
+//
+//                      You should have received a copy of the GNU General Public License along with WCL.  If not, see
+//                      <http://www.gnu.org/licenses/>.
+//
+// OVERVIEW:						Counts the heap allocations made by each thread, so that the allocations made per record by the insert paths
+//                      can be measured. When WCL_COUNT_ALLOCATIONS is defined (qmake CONFIG+=wcl_allocationCount) the library
+//                      replaces the global operator new and counts each call in a thread local counter. Otherwise nothing is
+//                      replaced and the count is always zero.
+//                      Only allocations made through operator new are counted. Memory that is allocated directly with malloc(),
+//                      for example by the Qt containers and by SQLite, is not counted.
+//
+// CLASSES INCLUDED:    None.
+//
+// CLASS HIERARCHY:     None.
+//
+// HISTORY:             2026-10-19 GGB - File Created
+//
+//*********************************************************************************************************************************
+
+#ifndef WCL_ALLOCATIONCOUNTER_H
+#define WCL_ALLOCATIONCOUNTER_H
+
+  // Standard C++ Library header files.
+
+#include <cstdint>
+
+namespace WCL
+{
+  std::uint64_t allocationCount() noexcept;
+  bool allocationCounting() noexcept;
+
+} // namespace WCL
+
+#endif // WCL_ALLOCATIONCOUNTER_H
@@ -0,0 +1,121 @@
+﻿//*********************************************************************************************************************************
+//
+// PROJECT:							Weather Class Library (WCL)
+// FILE:								archiveDump
+// SUBSYSTEM:						Decoding of the console archive memory dump
+// LANGUAGE:						C++
+// TARGET OS:						WINDOWS/UNIX/LINUX/MAC
+// LIBRARY DEPENDANCE:	None.
+// NAMESPACE:						WCL
+// AUTHOR:							Gavin Blakeman.
+// LICENSE:             GPLv2
+//
+//                      Copyright 2026 Gavin Blakeman.
+//                      This file is part of the Weather Class Library (WCL).
+//
+//                      WCL is free software: you can redistribute it and/or modify it under the terms of the GNU General
+//                      Public License as published by the Free Software Foundation, either version 2 of the License, or (at your
+//                      option) any later version.
+//
+//                      WCL is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the
+//                      implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//                      for more details.
+//
+//                      You should have received a copy of the GNU General Public License along with WCL.  If not, see
+//                      <http://www.gnu.org/licenses/>.
+//
+// OVERVIEW:						Decodes a full archive memory download (the DMP command) from a Vantage console. The console sends the
+//                      512 pages of its archive memory, each of 267 bytes: a sequence number, 5 archive records, 4 unused bytes
+//                      and a CRC (MSB first), so the CRC over the whole page is zero.
+//                      The bytes are appended as they are received from the link into a buffer that holds the whole dump, and
+//                      each completed page is handed to a pool of worker threads that check the CRC and decode the records and
+//                      their timestamps. The decoding is therefore finished shortly after the last page arrives and the time
+//                      taken for a recovery is that of the link.
+//                      The archive memory is circular, so the page order is not the time order. finish() reassembles the
+//                      records by timestamp, drops the unused records and the records that are not after a watermark (the last
+//                      record in the database), and returns the records in time order ready to be inserted.
+//
+// CLASSES INCLUDED:    CArchiveDump
+//
+// CLASS HIERARCHY:     CArchiveDump
+//
+// HISTORY:             2026-10-19 GGB - File Created
+//
+//*********************************************************************************************************************************
+
+#ifndef WCL_ARCHIVEDUMP_H
+#define WCL_ARCHIVEDUMP_H
+
+  // Standard C++ Library header files.
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+  // WCL header files
+
+#include "include/timestamp.h"
+#include "include/weatherStore.h"
+#include "include/WeatherLinkIP.h"
+
+namespace WCL
+{
+  class CArchiveDump
+  {
+  public:
+    static std::size_t const PAGE_SIZE = 267;             ///< Bytes of a page on the link.
+    static std::size_t const PAGE_COUNT = 512;            ///< Pages of the archive memory.
+    static std::size_t const RECORDS_PER_PAGE = 5;
+
+    enum EPageStatus : std::uint8_t
+    {
+      PS_PENDING,
+      PS_VALID,
+      PS_CRC_ERROR
+    };
+
+  private:
+    std::size_t pageCount_;
+    std::vector<std::uint8_t> buffer_;                    ///< Allocated once, so the workers can read while bytes are appended.
+    std::size_t bytes_ = 0;
+    std::vector<SArchiveRecord> records_;
+    std::vector<TTimestamp> timestamps_;
+    std::vector<EPageStatus> status_;
+    std::size_t threads_;
+    std::vector<std::thread> workers_;
+    std::mutex mutex_;
+    std::condition_variable pageCondition_;
+    std::condition_variable doneCondition_;
+    std::size_t pages_ = 0;                               ///< Complete pages received.
+    std::size_t nextPage_ = 0;                            ///< Next page to decode.
+    std::size_t decodedPages_ = 0;
+    bool stop_ = false;
+
+    CArchiveDump(CArchiveDump const &) = delete;
+    CArchiveDump &operator=(CArchiveDump const &) = delete;
+
+    void decodePages(std::size_t, std::size_t);
+    void worker();
+
+  public:
+    CArchiveDump(std::size_t = 0, std::size_t = PAGE_COUNT);
+    ~CArchiveDump();
+
+    std::size_t append(std::uint8_t const *, std::size_t);
+    std::size_t finish(TTimestamp, std::vector<SArchiveRecord> &);
+    std::size_t finish(CWeatherStore &, unsigned long siteID, unsigned long instrumentID, std::vector<SArchiveRecord> &);
+    void reset();
+
+    std::size_t pages() const { return pages_; }
+    std::size_t pageCount() const { return pageCount_; }
+    std::vector<std::size_t> badPages();
+
+    static bool validPage(std::uint8_t const *);
+  };
+
+} // namespace WCL
+
+#endif // WCL_ARCHIVEDUMP_H
@@ -0,0 +1,117 @@
+﻿//*********************************************************************************************************************************
+//
+// PROJECT:							Weather Class Library (WCL)
+// FILE:								arrowExporter
+// SUBSYSTEM:						Arrow IPC export of archive records
+// LANGUAGE:						C++
+// TARGET OS:						WINDOWS/UNIX/LINUX/MAC
+// LIBRARY DEPENDANCE:	boost::filesystem
+// NAMESPACE:						WCL
+// AUTHOR:							Gavin Blakeman.
+// LICENSE:             GPLv2
+//
+//                      Copyright 2026 Gavin Blakeman.
+//                      This file is part of the Weather Class Library (WCL).
+//
+//                      WCL is free software: you can redistribute it and/or modify it under the terms of the GNU General
+//                      Public License as published by the Free Software Foundation, either version 2 of the License, or (at your
+//                      option) any later version.
+//
+//                      WCL is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the
+//                      implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//                      for more details.
+//
+//                      You should have received a copy of the GNU General Public License along with WCL.  If not, see
+//                      <http://www.gnu.org/licenses/>.
+//
+// OVERVIEW:						Writes archive records to an Arrow IPC file (Feather V2) that can be loaded by pandas, Polars or any
+//                      other Arrow reader without conversion.
+//                      Each field of the time series record is a column of a fixed width type (float64 for the SI values,
+//                      uint16/uint8 for the direction, solar and UV values) and the time is a timestamp[s] column in local
+//                      station time. The SI unit of each column is stored in the field metadata under the key "unit".
+//                      Values that are marked as missing (NaN or a CRecordValidator missing marker) are written as nulls using
+//                      the validity bitmaps from CRecordValidator::missing(). A column without nulls has no validity buffer.
+//                      The records are transposed into column buffers and written as a record batch when the batch is full, so
+//                      the memory used is bounded by the batch size whatever the length of the export. The body buffers are
+//                      aligned to 64 bytes in the file so that a reader can memory map the file and use the columns in place.
+//                      The flatbuffer metadata is written by a small builder in the translation unit so that there is no
+//                      dependency on the Arrow or flatbuffers libraries.
+//
+// CLASSES INCLUDED:    CArrowExporter
+//
+// CLASS HIERARCHY:     CRecordSink
+//                        - CArrowExporter
+//
+// HISTORY:             2026-10-19 GGB - File Created
+//
+//*********************************************************************************************************************************
+
+#ifndef WCL_ARROWEXPORTER_H
+#define WCL_ARROWEXPORTER_H
+
+  // Standard C++ Library header files.
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+  // Miscellanous library header files.
+
+#include <boost/filesystem.hpp>
+
+  // WCL header files
+
+#include "include/exporter.h"
+#include "include/validation.h"
+
+namespace WCL
+{
+  class CArrowExporter : public CRecordSink
+  {
+  public:
+    static std::size_t const COLUMN_COUNT = VF_COUNT + 1;
+
+  private:
+    struct SBlock
+    {
+      std::uint64_t offset;
+      std::uint32_t metadataLength;
+      std::uint64_t bodyLength;
+    };
+
+    std::FILE *file_;
+    std::uint64_t offset_ = 0;
+    std::size_t batchSize_;
+    std::size_t batchRows_ = 0;
+    std::uint64_t rows_ = 0;
+    std::vector<std::uint8_t> columns_[COLUMN_COUNT];
+    std::vector<std::uint64_t> validity_[COLUMN_COUNT];       ///< Validity bitmaps of the batch.
+    std::size_t nulls_[COLUMN_COUNT];
+    SValidity chunkValidity_;
+    std::vector<SBlock> blocks_;
+    bool closed_ = false;
+
+    CArrowExporter(CArrowExporter const &) = delete;
+    CArrowExporter &operator=(CArrowExporter const &) = delete;
+
+    void writeBytes(void const *, std::size_t);
+    void writeMessage(std::vector<std::uint8_t> const &, std::size_t);
+    void writeBatch();
+
+  public:
+    CArrowExporter(boost::filesystem::path const &, std::size_t = 65536);
+    virtual ~CArrowExporter();
+
+    using CRecordSink::write;
+    virtual void write(STimeSeriesRecord const &) override;
+    virtual void write(STimeSeriesRecord const *, std::size_t) override;
+    void close();
+
+    std::uint64_t rows() const { return rows_; }
+    std::size_t batches() const { return blocks_.size(); }
+  };
+
+} // namespace WCL
+
+#endif // WCL_ARROWEXPORTER_H
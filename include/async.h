@@ -0,0 +1,489 @@
+﻿//*********************************************************************************************************************************
+//
+// PROJECT:							Weather Class Library (WCL)
+// FILE:								async
+// SUBSYSTEM:						Coroutine interface for file and database operations
+// LANGUAGE:						C++
+// TARGET OS:						WINDOWS/UNIX/LINUX/MAC
+// LIBRARY DEPENDANCE:	None.
+// NAMESPACE:						WCL
+// AUTHOR:							Gavin Blakeman.
+// LICENSE:             GPLv2
+//
+//                      Copyright 2026 Gavin Blakeman.
+//                      This file is part of the Weather Class Library (WCL).
+//
+//                      WCL is free software: you can redistribute it and/or modify it under the terms of the GNU General
+//                      Public License as published by the Free Software Foundation, either version 2 of the License, or (at your
+//                      option) any later version.
+//
+//                      WCL is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the
+//                      implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//                      for more details.
+//
+//                      You should have received a copy of the GNU General Public License along with WCL.  If not, see
+//                      <http://www.gnu.org/licenses/>.
+//
+// OVERVIEW:						Awaitable variants of the blocking file and store operations, so that many stations can be driven from a
+//                      few threads with straight line code.
+//                      CExecutor is a small thread pool. CStrand runs the work posted to it one at a time, in order, on the
+//                      threads of an executor; each file or store is used through its own strand so it is never used by two
+//                      threads at the same time. CAsyncCall runs a blocking call on a strand and resumes the awaiting coroutine on
+//                      a thread of the executor of the strand when the call returns.
+//                      CTask is a lazy coroutine type. A task is started by co_await, by syncWait() or by whenAll().
+//                      CAsyncWeatherLinkFile and CAsyncStore wrap a .wlk file and a store. A Qt database (CDatabase) can only be
+//                      used by the thread that opened it, so it must be given a one thread executor. Batched writes on a
+//                      worker pool are obtained by wrapping a CShardedWriter.
+//                      The interface needs C++20 coroutines. The library is built as C++17 unless qmake is run with
+//                      CONFIG+=wcl_coroutines, and this file is empty when coroutines are not available.
+//
+// CLASSES INCLUDED:    CExecutor
+//                      CStrand
+//                      CAsyncCall
+//                      CTask
+//                      CAsyncWeatherLinkFile
+//                      CAsyncStore
+//
+// CLASS HIERARCHY:     CExecutor
+//                      CStrand
+//                      CAsyncCall
+//                      CTask
+//                      CAsyncWeatherLinkFile
+//                      CAsyncStore
+//
+// HISTORY:             2026-10-19 GGB - File Created
+//
+//*********************************************************************************************************************************
+
+#ifndef WCL_ASYNC_H
+#define WCL_ASYNC_H
+
+#ifdef __cpp_impl_coroutine
+
+  // Standard C++ Library header files.
+
+#include <atomic>
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+  // Miscellanous library header files.
+
+#include <ACL>
+
+  // WCL header files
+
+#include "include/WeatherLink.h"
+#include "include/WeatherLinkIP.h"
+#include "include/weatherStore.h"
+
+namespace WCL
+{
+  class CExecutor
+  {
+  private:
+    std::mutex mutex_;
+    std::condition_variable pending_;
+    std::deque<std::function<void()>> queue_;
+    std::vector<std::thread> threads_;
+    bool stop_ = false;
+
+    CExecutor(CExecutor const &) = delete;
+    CExecutor &operator=(CExecutor const &) = delete;
+
+    void worker();
+
+  public:
+    struct SSchedule
+    {
+      CExecutor &executor;
+
+      bool await_ready() const noexcept { return false; }
+      void await_suspend(std::coroutine_handle<> handle) { executor.post([handle] { handle.resume(); }); }
+      void await_resume() const noexcept {}
+    };
+
+    CExecutor(std::size_t = 0);
+    ~CExecutor();
+
+    void post(std::function<void()>);
+    std::size_t threadCount() const { return threads_.size(); }
+
+      /// @brief      Returns an awaitable that resumes the awaiting coroutine on a thread of the executor.
+
+    SSchedule schedule() { return SSchedule{ *this }; }
+  };
+
+  class CStrand
+  {
+  private:
+      /// @brief      The state of the strand is shared with the running loop. The last work run by the loop may resume the
+      ///             coroutine that owns the strand, which can then destroy the strand before the loop has finished.
+
+    struct SState
+    {
+      CExecutor &executor;
+      std::mutex mutex;
+      std::deque<std::function<void()>> queue;
+      bool running = false;
+
+      explicit SState(CExecutor &e) : executor(e) {}
+    };
+
+    std::shared_ptr<SState> state_;
+
+    CStrand(CStrand const &) = delete;
+    CStrand &operator=(CStrand const &) = delete;
+
+    static void run(std::shared_ptr<SState> const &);
+
+  public:
+    explicit CStrand(CExecutor &executor) : state_(std::make_shared<SState>(executor)) {}
+
+    CExecutor &executor() { return state_->executor; }
+    void post(std::function<void()>);
+  };
+
+  /// @brief      Awaitable that runs a blocking call on a strand. The awaiting coroutine is resumed on a thread of the executor of
+  ///             the strand, with the value returned by the call, or the exception thrown by the call is rethrown.
+
+  template<typename R>
+  class CAsyncCall
+  {
+  private:
+    typedef std::conditional_t<std::is_void_v<R>, std::monostate, R> value_t;
+
+    CStrand &strand_;
+    std::function<R()> function_;
+    std::variant<std::monostate, value_t, std::exception_ptr> result_;
+
+  public:
+    CAsyncCall(CStrand &strand, std::function<R()> function) : strand_(strand), function_(std::move(function)) {}
+
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> handle)
+    {
+      strand_.post([this, handle]
+      {
+        try
+        {
+          if constexpr (std::is_void_v<R>)
+          {
+            function_();
+            result_.template emplace<1>();
+          }
+          else
+          {
+            result_.template emplace<1>(function_());
+          };
+        }
+        catch(...)
+        {
+          result_.template emplace<2>(std::current_exception());
+        };
+        strand_.executor().post([handle] { handle.resume(); });
+      });
+    }
+    R await_resume()
+    {
+      if (result_.index() == 2)
+      {
+        std::rethrow_exception(std::get<2>(result_));
+      };
+      if constexpr (!std::is_void_v<R>)
+      {
+        return std::move(std::get<1>(result_));
+      };
+    }
+  };
+
+  /// @brief      Lazy coroutine returning a T. The coroutine starts when the task is awaited and the awaiting coroutine is
+  ///             resumed when it completes.
+
+  template<typename T = void>
+  class CTask
+  {
+  private:
+    typedef std::conditional_t<std::is_void_v<T>, std::monostate, T> value_t;
+
+    struct SFinal
+    {
+      bool await_ready() const noexcept { return false; }
+      template<typename P>
+      std::coroutine_handle<> await_suspend(std::coroutine_handle<P> handle) noexcept { return handle.promise().continuation; }
+      void await_resume() const noexcept {}
+    };
+
+    struct SPromiseBase
+    {
+      std::variant<std::monostate, value_t, std::exception_ptr> result;
+      std::coroutine_handle<> continuation = std::noop_coroutine();
+
+      std::suspend_always initial_suspend() const noexcept { return {}; }
+      SFinal final_suspend() const noexcept { return {}; }
+      void unhandled_exception() noexcept { result.template emplace<2>(std::current_exception()); }
+    };
+
+    struct SValuePromise : public SPromiseBase
+    {
+      template<typename U>
+      void return_value(U &&value) { this->result.template emplace<1>(std::forward<U>(value)); }
+    };
+
+    struct SVoidPromise : public SPromiseBase
+    {
+      void return_void() { this->result.template emplace<1>(); }
+    };
+
+  public:
+    struct promise_type : public std::conditional_t<std::is_void_v<T>, SVoidPromise, SValuePromise>
+    {
+      CTask get_return_object() { return CTask(std::coroutine_handle<promise_type>::from_promise(*this)); }
+    };
+
+  private:
+    std::coroutine_handle<promise_type> handle_;
+
+    explicit CTask(std::coroutine_handle<promise_type> handle) : handle_(handle) {}
+
+    CTask(CTask const &) = delete;
+    CTask &operator=(CTask const &) = delete;
+
+    struct SAwaiter
+    {
+      std::coroutine_handle<promise_type> handle;
+
+      bool await_ready() const noexcept { return !handle || handle.done(); }
+      std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept
+      {
+        handle.promise().continuation = awaiting;
+        return handle;
+      }
+    };
+
+  public:
+    struct SResult : public SAwaiter
+    {
+      T await_resume() { return result(this->handle); }
+    };
+
+    struct SReady : public SAwaiter
+    {
+      void await_resume() const noexcept {}
+    };
+
+    CTask(CTask &&other) noexcept : handle_(std::exchange(other.handle_, nullptr)) {}
+    CTask &operator=(CTask &&other) noexcept
+    {
+      if (this != &other)
+      {
+        if (handle_)
+        {
+          handle_.destroy();
+        };
+        handle_ = std::exchange(other.handle_, nullptr);
+      };
+      return *this;
+    }
+    ~CTask()
+    {
+      if (handle_)
+      {
+        handle_.destroy();
+      };
+    }
+
+    SResult operator co_await() noexcept { return SResult{ { handle_ } }; }
+
+      /// @brief      Returns an awaitable that runs the task to completion without taking its result.
+
+    SReady ready() noexcept { return SReady{ { handle_ } }; }
+
+    bool done() const noexcept { return !handle_ || handle_.done(); }
+
+      /// @brief      Returns the value of a completed task, or rethrows the exception that ended it.
+
+    T result() { return result(handle_); }
+
+  private:
+    static T result(std::coroutine_handle<promise_type> handle)
+    {
+      auto &value = handle.promise().result;
+
+      if (value.index() == 2)
+      {
+        std::rethrow_exception(std::get<2>(value));
+      };
+      if constexpr (!std::is_void_v<T>)
+      {
+        return std::move(std::get<1>(value));
+      };
+    }
+  };
+
+  /// @brief      Coroutine that starts immediately and destroys itself when it completes. Used to start tasks from ordinary code.
+
+  struct SDetachedTask
+  {
+    struct promise_type
+    {
+      SDetachedTask get_return_object() const noexcept { return {}; }
+      std::suspend_never initial_suspend() const noexcept { return {}; }
+      std::suspend_never final_suspend() const noexcept { return {}; }
+      void return_void() const noexcept {}
+      void unhandled_exception() const noexcept { std::terminate(); }
+    };
+  };
+
+  struct SSyncState
+  {
+    std::mutex mutex;
+    std::condition_variable completed;
+    bool done = false;
+  };
+
+  /// @brief      Runs a task until it completes and signals the waiting thread.
+
+  template<typename T>
+  SDetachedTask syncWaitRun(CTask<T> &task, SSyncState &state)
+  {
+    co_await task.ready();
+
+    std::lock_guard<std::mutex> lock(state.mutex);
+
+    state.done = true;
+    state.completed.notify_one();
+  }
+
+  /// @brief      Starts a task and blocks the calling thread until it completes.
+  /// @param[in]  task: The task.
+  /// @returns    The value of the task.
+  /// @throws     The exception that ended the task.
+
+  template<typename T>
+  T syncWait(CTask<T> task)
+  {
+    SSyncState state;
+
+    syncWaitRun(task, state);
+
+    std::unique_lock<std::mutex> lock(state.mutex);
+
+    state.completed.wait(lock, [&] { return state.done; });
+
+    return task.result();
+  }
+
+  struct SWhenAllState
+  {
+    std::atomic<std::size_t> remaining;
+    std::coroutine_handle<> continuation;
+  };
+
+  template<typename T>
+  SDetachedTask whenAllRun(CTask<T> &task, SWhenAllState &state)
+  {
+    co_await task.ready();
+
+    if (state.remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+      state.continuation.resume();
+    };
+  }
+
+  template<typename T>
+  struct SWhenAll
+  {
+    std::vector<CTask<T>> &tasks;
+    SWhenAllState state;
+
+    bool await_ready() const noexcept { return tasks.empty(); }
+    bool await_suspend(std::coroutine_handle<> handle)
+    {
+      state.continuation = handle;
+      state.remaining.store(tasks.size() + 1, std::memory_order_relaxed);
+
+      for (CTask<T> &task : tasks)
+      {
+        whenAllRun(task, state);
+      };
+
+      return state.remaining.fetch_sub(1, std::memory_order_acq_rel) != 1;
+    }
+    void await_resume() const noexcept {}
+  };
+
+  /// @brief      Starts the tasks together and completes when they have all completed. The value or the error of each task is
+  ///             returned by its result().
+  /// @param[in]  tasks: The tasks. Must remain valid until the returned task completes.
+
+  template<typename T>
+  CTask<void> whenAll(std::vector<CTask<T>> &tasks)
+  {
+    co_await SWhenAll<T>{ tasks, {} };
+  }
+
+  class CAsyncWeatherLinkFile
+  {
+  private:
+    CWeatherLinkDatabaseFile file_;
+    CStrand strand_;
+
+  public:
+    CAsyncWeatherLinkFile(boost::filesystem::path const &, CExecutor &);
+
+    CAsyncCall<bool> openFile();
+    CAsyncCall<bool> closeFile();
+    CAsyncCall<bool> firstDayRecord();
+    CAsyncCall<bool> nextDayRecord();
+    CAsyncCall<bool> reloadHeader();
+    CAsyncCall<std::size_t> readArchiveRecords(int, int, SWeatherDataRecord *, std::size_t);
+
+      /// @brief      Returns the file. Only to be used between awaits on this object.
+
+    CWeatherLinkDatabaseFile &file() { return file_; }
+  };
+
+  class CAsyncStore
+  {
+  private:
+    CWeatherStore &store_;
+    CStrand strand_;
+
+  public:
+    CAsyncStore(CWeatherStore &, CExecutor &);
+
+    CAsyncCall<bool> insertRecord(unsigned long siteID, unsigned long instrumentID, SArchiveRecord const &);
+    CAsyncCall<bool> insertRecord(unsigned long siteID, unsigned long instrumentID, SWeatherDataRecord const &, ACL::TJD const &);
+    CAsyncCall<std::size_t> insertRecords(unsigned long siteID, unsigned long instrumentID, std::vector<SArchiveRecord>);
+    CAsyncCall<std::size_t> insertRecords(unsigned long siteID, unsigned long instrumentID, std::vector<SWeatherDataRecord>,
+                                          ACL::TJD const &);
+    CAsyncCall<bool> lastWeatherRecord(unsigned long siteID, unsigned long instrumentID, std::uint16_t &, std::uint16_t &);
+    CAsyncCall<bool> recordExists(unsigned long siteID, unsigned long instrumentID, ACL::TJD, std::uint16_t);
+
+      /// @brief      Runs a function on the store, on the strand of the store. Used for the operations that are not part of
+      ///             CWeatherStore, for example CDatabase::connectToDatabase().
+
+    template<typename F>
+    auto call(F function) -> CAsyncCall<std::invoke_result_t<F, CWeatherStore &>>
+    {
+      return { strand_, [this, function]() mutable { return function(store_); } };
+    }
+  };
+
+} // namespace WCL
+
+#endif // __cpp_impl_coroutine
+
+#endif // WCL_ASYNC_H
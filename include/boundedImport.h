@@ -0,0 +1,152 @@
+﻿//*********************************************************************************************************************************
+//
+// PROJECT:							Weather Class Library (WCL)
+// FILE:								boundedImport
+// SUBSYSTEM:						Import of .wlk files within a fixed memory budget
+// LANGUAGE:						C++
+// TARGET OS:						WINDOWS/UNIX/LINUX/MAC
+// LIBRARY DEPENDANCE:	None.
+// NAMESPACE:						WCL
+// AUTHOR:							Gavin Blakeman.
+// LICENSE:             GPLv2
+//
+//                      Copyright 2026 Gavin Blakeman.
+//                      This file is part of the Weather Class Library (WCL).
+//
+//                      WCL is free software: you can redistribute it and/or modify it under the terms of the GNU General
+//                      Public License as published by the Free Software Foundation, either version 2 of the License, or (at your
+//                      option) any later version.
+//
+//                      WCL is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the
+//                      implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//                      for more details.
+//
+//                      You should have received a copy of the GNU General Public License along with WCL.  If not, see
+//                      <http://www.gnu.org/licenses/>.
+//
+// OVERVIEW:						Imports a large set of .wlk files with a fixed memory budget. The budget is divided into blocks of archive
+//                      records that are allocated once and recycled. Reader threads read the files directly into free blocks
+//                      and pass the full blocks to the writer, which writes each block to the store as one batch and returns it
+//                      to the free list. A reader stops when there is no free block, so a store that is slower than the readers
+//                      does not cause records to be buffered beyond the budget, while the blocks already read keep the store
+//                      busy.
+//                      All the files of a station are read by the same reader, in file (date) order, so the records of a station
+//                      reach the store in time order.
+//                      The statistics count the times each side waited for the other, which shows whether the import is limited
+//                      by reading or by the store.
+//
+// CLASSES INCLUDED:    SBoundedImportStatistics
+//                      CBoundedImport
+//
+// CLASS HIERARCHY:     CBoundedImport
+//
+// HISTORY:             2026-10-19 GGB - File Created
+//
+//*********************************************************************************************************************************
+
+#ifndef WCL_BOUNDEDIMPORT_H
+#define WCL_BOUNDEDIMPORT_H
+
+  // Standard C++ Library header files.
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+  // Miscellanous library header files.
+
+#include <ACL>
+#include <boost/filesystem.hpp>
+
+  // WCL header files
+
+#include "include/WeatherLink.h"
+#include "include/weatherStore.h"
+
+namespace WCL
+{
+  struct SBoundedImportStatistics
+  {
+    std::size_t files = 0;                ///< Files read.
+    std::size_t filesFailed = 0;          ///< Files that could not be read.
+    std::uint64_t records = 0;            ///< Records read.
+    std::uint64_t inserted = 0;           ///< Records the store reported as inserted.
+    std::uint64_t blocks = 0;             ///< Blocks written.
+    std::uint64_t readerWaits = 0;        ///< Times a reader waited for a free block (the store is the limit).
+    std::uint64_t writerWaits = 0;        ///< Times the writer waited for a full block (reading is the limit).
+    std::size_t blockCount = 0;           ///< Blocks in the pool.
+    std::size_t blockBytes = 0;           ///< Size of a block.
+  };
+
+  class CBoundedImport
+  {
+  private:
+    struct SDay
+    {
+      ACL::TJD JD;
+      std::size_t end;                    ///< One past the last record of the day in the block.
+    };
+
+    struct SBlock
+    {
+      unsigned long siteID = 0;
+      unsigned long instrumentID = 0;
+      std::unique_ptr<SWeatherDataRecord[]> records;
+      std::size_t count = 0;
+      std::vector<SDay> days;
+    };
+
+    struct SFile
+    {
+      boost::filesystem::path path;
+      unsigned long siteID;
+      unsigned long instrumentID;
+    };
+
+    CWeatherStore &store_;
+    std::size_t blockRecords_;
+    std::size_t blockCount_;
+    std::size_t readerCount_;
+    std::vector<SFile> files_;
+
+    std::vector<std::unique_ptr<SBlock>> blocks_;
+    std::mutex mutex_;
+    std::condition_variable freeAvailable_;
+    std::condition_variable fullAvailable_;
+    std::vector<SBlock *> free_;
+    std::deque<SBlock *> full_;
+    std::size_t readersRunning_ = 0;
+    bool stop_ = false;
+    std::exception_ptr error_;
+    SBoundedImportStatistics statistics_;
+
+    CBoundedImport(CBoundedImport const &) = delete;
+    CBoundedImport &operator=(CBoundedImport const &) = delete;
+
+    SBlock *freeBlock(unsigned long siteID, unsigned long instrumentID);
+    void fullBlock(SBlock *);
+    void readFile(SFile const &, SBlock *&);
+    void reader(std::vector<SFile const *>);
+    std::uint64_t writeBlock(SBlock &);
+
+  public:
+    CBoundedImport(CWeatherStore &, std::size_t, std::size_t = 1, std::size_t = 1024);
+
+    void addFile(boost::filesystem::path const &, unsigned long siteID, unsigned long instrumentID);
+    std::size_t addDirectory(boost::filesystem::path const &, unsigned long siteID, unsigned long instrumentID);
+
+    SBoundedImportStatistics run();
+
+    std::size_t blockCount() const { return blockCount_; }
+    std::size_t blockRecords() const { return blockRecords_; }
+  };
+
+} // namespace WCL
+
+#endif // WCL_BOUNDEDIMPORT_H
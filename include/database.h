@@ -39,6 +39,11 @@
 
   // Standard C++ Library header files.
 
+#include <array>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <utility>
 
   // Miscellanous library header files.
 
@@ -51,6 +56,9 @@
 
 #include "include/WeatherLink.h"
 #include "include/WeatherLinkIP.h"
+#include "include/observation.h"
+#include "include/validation.h"
+#include "include/weatherStore.h"
 
 namespace WCL
 {
@@ -61,32 +69,61 @@ namespace WCL
 
   const int ROLE_FILTERID  = Qt::UserRole + 0;
 
-  class CDatabase
+  struct SQueryStatistics
+  {
+    std::uint64_t prepared = 0;           ///< Query objects created and prepared.
+    std::uint64_t reused = 0;             ///< Executions that reused a prepared query object.
+    std::uint64_t records = 0;            ///< Calls to insertRecord().
+    std::uint64_t allocations = 0;        ///< operator new calls made by insertRecord(). Needs WCL_COUNT_ALLOCATIONS.
+  };
+
+  class CDatabase : public CWeatherStore
   {
   private:
+    enum EQuery
+    {
+      QUERY_ARCHIVE_INSERT,
+      QUERY_ARCHIVE_EXISTS,
+      QUERY_COUNT
+    };
+
+    std::array<std::unique_ptr<QSqlQuery>, QUERY_COUNT> queries_;
+    SQueryStatistics queryStatistics_;
+    std::map<std::pair<unsigned long, unsigned long>, CRecordValidator> validators_;
+
     virtual void ODBC();
     virtual void OracleXE();
     virtual void MySQL();
     virtual void SQLite();
 
+    bool insertArchive(unsigned long siteID, unsigned long instrumentID, ACL::TJD const &, STimeSeriesRecord const &);
+    QSqlQuery *preparedQuery(EQuery);
+    void releaseQueries();
+    CRecordValidator &validator(unsigned long siteID, unsigned long instrumentID);
+
   protected:
     QString szConnectionName;
     QSqlDatabase database_;
 
   public:
-    CDatabase() : database_() {}
+    CDatabase(QString const &connectionName = QString("WEATHER")) : szConnectionName(connectionName), database_() {}
 
     virtual void connectToDatabase();
     virtual void disconnectFromDatabase();
 
     bool dailyRecordExists(std::uint32_t siteID, std::uint32_t instrumentID, ACL::TJD const &);
     bool insertDailySummary(unsigned long siteID, unsigned long instrumentID, SDailySummary1 const &, SDailySummary2 const &, const ACL::TJD &JD);
-    bool insertRecord(unsigned long siteID, unsigned long instrumentID, SArchiveRecord &);
-    bool insertRecord(unsigned long siteID, unsigned long instrumentID, SWeatherDataRecord const &, ACL::TJD const &);
-    bool lastWeatherRecord(unsigned long siteID, unsigned long instrumentID, uint16_t &, uint16_t &);
-    bool recordExists(unsigned long siteID, unsigned long instrumentID, ACL::TJD , uint16_t);
+    virtual bool insertRecord(unsigned long siteID, unsigned long instrumentID, SArchiveRecord &) override;
+    virtual bool insertRecord(unsigned long siteID, unsigned long instrumentID, SWeatherDataRecord const &, ACL::TJD const &) override;
+    virtual bool lastWeatherRecord(unsigned long siteID, unsigned long instrumentID, uint16_t &, uint16_t &) override;
+    virtual bool recordExists(unsigned long siteID, unsigned long instrumentID, ACL::TJD , uint16_t) override;
+    virtual void beginBatch() override;
+    virtual void endBatch() override;
+    virtual void abortBatch() noexcept override;
     bool openDatabase();
     void closeDatabase();
+
+    SQueryStatistics const &queryStatistics() const { return queryStatistics_; }
   };
 
   CDatabase extern database;
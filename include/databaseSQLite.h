@@ -0,0 +1,179 @@
+﻿//*********************************************************************************************************************************
+//
+// PROJECT:							Weather Class Library (WCL)
+// FILE:								databaseSQLite
+// SUBSYSTEM:						Native SQLite database class
+// LANGUAGE:						C++
+// TARGET OS:						WINDOWS/UNIX/LINUX/MAC
+// LIBRARY DEPENDANCE:	sqlite3, ACL
+// NAMESPACE:						WCL
+// AUTHOR:							Gavin Blakeman.
+// LICENSE:             GPLv2
+//
+//                      Copyright 2026 Gavin Blakeman.
+//                      This file is part of the Weather Class Library (WCL).
+//
+//                      WCL is free software: you can redistribute it and/or modify it under the terms of the GNU General
+//                      Public License as published by the Free Software Foundation, either version 2 of the License, or (at your
+//                      option) any later version.
+//
+//                      WCL is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the
+//                      implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//                      for more details.
+//
+//                      You should have received a copy of the GNU General Public License along with WCL.  If not, see
+//                      <http://www.gnu.org/licenses/>.
+//
+// OVERVIEW:						Implements a database class that talks to sqlite3 directly rather than through the QtSql driver. The
+//                      database is opened in WAL mode with a configurable synchronous level. All statements are prepared once
+//                      and cached, and values are bound as raw values. A bulk-load mode writes the archive rows to an unindexed
+//                      load table in large transactions. When the bulk load is ended the rows are merged into the archive in key
+//                      order, through the archive key index, so the cost depends on the rows loaded and not on the archive size.
+//                      Archive records are validated (CRecordValidator) before they are inserted, and invalid values are stored
+//                      as NULL.
+//                      A CStationCache can be attached with stationCache(). The last record and daily summary queries of the
+//                      cached stations are then answered from the cache, and the cache is saved after a commit when its save
+//                      interval has passed and when the database is closed.
+//
+// CLASSES INCLUDED:    CDatabaseSQLite
+//
+// CLASS HIERARCHY:     CWeatherStore
+//                        - CDatabaseSQLite
+//
+// HISTORY:             2026-10-19 GGB - File Created
+//
+//*********************************************************************************************************************************
+
+#ifndef WCL_DATABASESQLITE_H
+#define WCL_DATABASESQLITE_H
+
+  // Standard C++ Library header files.
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+  // Miscellanous library header files.
+
+#include <ACL>
+#include <sqlite3.h>
+
+  // WCL header files
+
+#include "include/WeatherLink.h"
+#include "include/WeatherLinkIP.h"
+#include "include/timeSeriesStore.h"
+#include "include/validation.h"
+#include "include/weatherStore.h"
+
+namespace WCL
+{
+  class CGapIndex;
+  class CStationCache;
+  struct SStoreWatermark;
+
+  class CDatabaseSQLite : public CWeatherStore
+  {
+  public:
+    enum ESynchronous
+    {
+      SYNC_OFF = 0,
+      SYNC_NORMAL = 1,
+      SYNC_FULL = 2,
+      SYNC_EXTRA = 3
+    };
+
+  private:
+    enum EStatement
+    {
+      STMT_BEGIN,
+      STMT_COMMIT,
+      STMT_ARCHIVE_INSERT,
+      STMT_ARCHIVE_EXISTS,
+      STMT_ARCHIVE_LAST,
+      STMT_DAYSUMMARY_INSERT,
+      STMT_DAYSUMMARY_EXISTS,
+      STMT_ARCHIVE_RANGE,
+      STMT_ARCHIVE_KEYS,
+      STMT_DAYSUMMARY_DAYS,
+      STMT_WATERMARK,
+      STMT_ARCHIVE_LOAD,
+      STMT_COUNT
+    };
+
+    sqlite3 *database_ = nullptr;
+    std::array<sqlite3_stmt *, STMT_COUNT> statements_;
+    ESynchronous synchronous_ = SYNC_NORMAL;
+    bool bulkLoad_ = false;
+    bool inTransaction_ = false;
+    std::size_t transactionRows_ = 0;
+    std::size_t bulkTransactionSize_ = 50000;
+    std::map<std::pair<unsigned long, unsigned long>, CRecordValidator> validators_;
+    std::map<std::pair<unsigned long, unsigned long>, CGapIndex *> gapIndexes_;
+    std::vector<std::pair<CGapIndex *, std::uint32_t>> pendingMarks_;   ///< Gap index marks of the open transaction.
+    CStationCache *stationCache_ = nullptr;
+
+    CDatabaseSQLite(CDatabaseSQLite const &) = delete;
+    CDatabaseSQLite &operator=(CDatabaseSQLite const &) = delete;
+
+    void createSchema();
+    void execute(char const *);
+    sqlite3_stmt *statement(EStatement);
+    bool step(sqlite3_stmt *);
+    void finaliseStatements();
+    void rowInserted();
+    void mergeLoad();
+    void rollbackTransaction() noexcept;
+
+    bool insertArchive(unsigned long siteID, unsigned long instrumentID, STimeSeriesRecord const &);
+    CRecordValidator &validator(unsigned long siteID, unsigned long instrumentID);
+
+  public:
+    CDatabaseSQLite();
+    virtual ~CDatabaseSQLite();
+
+    void connectToDatabase();
+    void openDatabase(std::string const &, ESynchronous = SYNC_NORMAL);
+    void closeDatabase();
+    bool isOpen() const { return database_ != nullptr; }
+
+    void synchronous(ESynchronous);
+    ESynchronous synchronous() const { return synchronous_; }
+
+    void beginTransaction();
+    void commitTransaction();
+
+    void beginBulkLoad(std::size_t = 50000);
+    void endBulkLoad();
+    bool bulkLoad() const { return bulkLoad_; }
+
+    bool dailyRecordExists(std::uint32_t siteID, std::uint32_t instrumentID, ACL::TJD const &);
+    bool insertDailySummary(unsigned long siteID, unsigned long instrumentID, SDailySummary1 const &, SDailySummary2 const &, ACL::TJD const &);
+    virtual bool insertRecord(unsigned long siteID, unsigned long instrumentID, SArchiveRecord &) override;
+    virtual bool insertRecord(unsigned long siteID, unsigned long instrumentID, SWeatherDataRecord const &, ACL::TJD const &) override;
+    virtual bool lastWeatherRecord(unsigned long siteID, unsigned long instrumentID, std::uint16_t &, std::uint16_t &) override;
+    virtual bool recordExists(unsigned long siteID, unsigned long instrumentID, ACL::TJD, std::uint16_t) override;
+    virtual void beginBatch() override;
+    virtual void endBatch() override;
+    virtual void abortBatch() noexcept override;
+
+    std::size_t readRange(unsigned long siteID, unsigned long instrumentID, std::uint32_t, std::uint32_t,
+                          std::function<bool(STimeSeriesRecord const &)>);
+    std::size_t readKeys(unsigned long siteID, unsigned long instrumentID, std::uint32_t, std::uint32_t,
+                         std::function<void(std::uint32_t, std::uint16_t)>);
+    std::size_t readSummaryDays(unsigned long siteID, unsigned long instrumentID, std::function<void(std::uint32_t)>);
+    SStoreWatermark watermark();
+
+    void gapIndex(unsigned long siteID, unsigned long instrumentID, CGapIndex *);
+    void stationCache(CStationCache *stationCache) { stationCache_ = stationCache; }
+    CStationCache *stationCache() const { return stationCache_; }
+  };
+
+} // namespace WCL
+
+#endif // WCL_DATABASESQLITE_H
@@ -0,0 +1,178 @@
+﻿//*********************************************************************************************************************************
+//
+// PROJECT:							Weather Class Library (WCL)
+// FILE:								exporter
+// SUBSYSTEM:						CSV and JSON lines export of archive records
+// LANGUAGE:						C++
+// TARGET OS:						WINDOWS/UNIX/LINUX/MAC
+// LIBRARY DEPENDANCE:	boost::filesystem
+// NAMESPACE:						WCL
+// AUTHOR:							Gavin Blakeman.
+// LICENSE:             GPLv2
+//
+//                      Copyright 2026 Gavin Blakeman.
+//                      This file is part of the Weather Class Library (WCL).
+//
+//                      WCL is free software: you can redistribute it and/or modify it under the terms of the GNU General
+//                      Public License as published by the Free Software Foundation, either version 2 of the License, or (at your
+//                      option) any later version.
+//
+//                      WCL is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the
+//                      implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//                      for more details.
+//
+//                      You should have received a copy of the GNU General Public License along with WCL.  If not, see
+//                      <http://www.gnu.org/licenses/>.
+//
+// OVERVIEW:						Streams archive records to CSV or JSON lines. The records are formatted with std::to_chars directly into
+//                      a large buffer that is reused for the whole export, and the buffer is written with a single fwrite when
+//                      it fills, so there are no allocations or stream formatting per row.
+//                      The records can come from a .wlk file, from a range of the SQLite database or from the time series store.
+//                      The columns and the units of the temperature, pressure, speed and rain columns can be selected. The unit
+//                      conversions from SI are applied as a scale and offset per column.
+//                      Missing values (NaN or a CRecordValidator missing marker) are written as an empty field in CSV and as null
+//                      in JSON. Records read from a .wlk file are validated before they are written.
+//                      CRecordSink is the base of the exporters, and reads the records from the sources.
+//
+// CLASSES INCLUDED:    CRecordSink
+//                      CRecordExporter
+//
+// CLASS HIERARCHY:     CRecordSink
+//                        - CRecordExporter
+//
+// HISTORY:             2026-10-19 GGB - File Created
+//
+//*********************************************************************************************************************************
+
+#ifndef WCL_EXPORTER_H
+#define WCL_EXPORTER_H
+
+  // Standard C++ Library header files.
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+  // Miscellanous library header files.
+
+#include <boost/filesystem.hpp>
+
+  // WCL header files
+
+#include "include/databaseSQLite.h"
+#include "include/timeSeriesStore.h"
+#include "include/unitTransform.h"
+#include "include/validation.h"
+
+namespace WCL
+{
+  class CRecordSink
+  {
+  private:
+    CRecordValidator validator_;
+
+  public:
+    virtual ~CRecordSink() {}
+
+    virtual void write(STimeSeriesRecord const &) = 0;
+    virtual void write(STimeSeriesRecord const *, std::size_t);
+
+    std::size_t exportFile(boost::filesystem::path const &);
+    std::size_t exportRange(CDatabaseSQLite &, unsigned long siteID, unsigned long instrumentID, std::uint32_t, std::uint32_t);
+    std::size_t exportRange(CTimeSeriesStore &, unsigned long siteID, unsigned long instrumentID, std::uint32_t, std::uint32_t);
+  };
+
+  class CRecordExporter : public CRecordSink
+  {
+  public:
+    enum EFormat
+    {
+      FORMAT_CSV,
+      FORMAT_JSON_LINES
+    };
+
+    enum EColumn
+    {
+      COL_TIMESTAMP,            ///< ISO 8601 local station time (YYYY-MM-DDTHH:MM)
+      COL_MJD,
+      COL_TIME,                 ///< HHMM
+      COL_OUTSIDE_TEMP,
+      COL_HI_OUTSIDE_TEMP,
+      COL_LOW_OUTSIDE_TEMP,
+      COL_INSIDE_TEMP,
+      COL_BAROMETER,
+      COL_OUTSIDE_HUMIDITY,
+      COL_INSIDE_HUMIDITY,
+      COL_RAIN,
+      COL_HI_RAIN_RATE,
+      COL_WIND_SPEED,
+      COL_HI_WIND_SPEED,
+      COL_WIND_DIRECTION,
+      COL_SOLAR_RAD,
+      COL_HI_SOLAR_RAD,
+      COL_UV,
+      COL_HI_UV,
+      COL_COUNT
+    };
+
+    enum ETemperatureUnit { TEMP_K, TEMP_C, TEMP_F };
+    enum EPressureUnit { PRESSURE_PA, PRESSURE_HPA, PRESSURE_INHG };
+    enum ESpeedUnit { SPEED_MPS, SPEED_KMH, SPEED_MPH, SPEED_KNOTS };
+    enum ERainUnit { RAIN_MM, RAIN_IN };
+
+    struct SUnits
+    {
+      ETemperatureUnit temperature = TEMP_K;
+      EPressureUnit pressure = PRESSURE_PA;
+      ESpeedUnit speed = SPEED_MPS;
+      ERainUnit rain = RAIN_MM;
+    };
+
+  private:
+    struct SColumnFormat
+    {
+      SAffine transform = {1, 0};
+      int precision = 0;
+    };
+
+    std::FILE *file_;
+    bool ownsFile_;
+    EFormat format_;
+    std::vector<EColumn> columns_;
+    SUnits units_;
+    std::array<SColumnFormat, COL_COUNT> columnFormat_;
+    std::vector<char> buffer_;
+    std::size_t used_ = 0;
+    std::uint64_t rows_ = 0;
+    bool headerWritten_ = false;
+
+    CRecordExporter(CRecordExporter const &) = delete;
+    CRecordExporter &operator=(CRecordExporter const &) = delete;
+
+    void setFormats();
+    void writeHeader();
+    char *formatValue(char *, char *, EColumn, STimeSeriesRecord const &) const;
+
+  public:
+    CRecordExporter(boost::filesystem::path const &, EFormat, std::size_t = 1 << 20);
+    CRecordExporter(std::FILE *, EFormat, std::size_t = 1 << 20);
+    virtual ~CRecordExporter();
+
+    void columns(std::vector<EColumn> const &);
+    std::vector<EColumn> const &columns() const { return columns_; }
+    void units(SUnits const &);
+    SUnits const &units() const { return units_; }
+
+    using CRecordSink::write;
+    virtual void write(STimeSeriesRecord const &) override;
+    void flush();
+    std::uint64_t rows() const { return rows_; }
+
+    static char const *columnName(EColumn);
+  };
+
+} // namespace WCL
+
+#endif // WCL_EXPORTER_H
@@ -0,0 +1,142 @@
+﻿//*********************************************************************************************************************************
+//
+// PROJECT:							Weather Class Library (WCL)
+// FILE:								gapIndex
+// SUBSYSTEM:						Gap detection and backfill planning
+// LANGUAGE:						C++
+// TARGET OS:						WINDOWS/UNIX/LINUX/MAC
+// LIBRARY DEPENDANCE:	None.
+// NAMESPACE:						WCL
+// AUTHOR:							Gavin Blakeman.
+// LICENSE:             GPLv2
+//
+//                      Copyright 2026 Gavin Blakeman.
+//                      This file is part of the Weather Class Library (WCL).
+//
+//                      WCL is free software: you can redistribute it and/or modify it under the terms of the GNU General
+//                      Public License as published by the Free Software Foundation, either version 2 of the License, or (at your
+//                      option) any later version.
+//
+//                      WCL is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the
+//                      implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//                      for more details.
+//
+//                      You should have received a copy of the GNU General Public License along with WCL.  If not, see
+//                      <http://www.gnu.org/licenses/>.
+//
+// OVERVIEW:						Keeps an occupancy bitmap of the archive intervals of one series so that the missing intervals can be
+//                      listed without querying the archive table.
+//                      Each day is a fixed number of 64 bit words (5 words for a 5 minute interval) holding one bit per
+//                      interval, and the days are stored contiguously so a year of a series is about 15kB. The index is
+//                      loaded with one scan of the archive key index (CDatabaseSQLite::readKeys) or from a CTimeSeriesStore,
+//                      and can be kept current by attaching it to a CDatabaseSQLite with gapIndex(), which marks each inserted
+//                      record.
+//                      gaps() scans the words in the range, skipping complete words, so that years of data are scanned in a few
+//                      milliseconds. plan() turns the gaps into the fewest requests that will fill them: a single DMPAFT for the
+//                      gaps that are still in the console archive memory (the console returns every record after the
+//                      timestamp), and one request per .wlk file (one file per month) for the older gaps.
+//
+// CLASSES INCLUDED:    SGap
+//                      SBackfillOptions
+//                      SBackfillRequest
+//                      CGapIndex
+//
+// CLASS HIERARCHY:     CGapIndex
+//
+// HISTORY:             2026-10-19 GGB - File Created
+//
+//*********************************************************************************************************************************
+
+#ifndef WCL_GAPINDEX_H
+#define WCL_GAPINDEX_H
+
+  // Standard C++ Library header files.
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+  // WCL header files
+
+#include "include/timestamp.h"
+#include "include/WeatherLinkIP.h"
+
+namespace WCL
+{
+  class CDatabaseSQLite;
+  class CTimeSeriesStore;
+
+  struct SGap
+  {
+    TTimestamp first;             ///< First missing interval.
+    TTimestamp last;              ///< Last missing interval.
+    std::size_t slots;            ///< Number of missing intervals.
+  };
+
+  enum EBackfillSource
+  {
+    BS_DMPAFT,                    ///< Download from the console archive memory.
+    BS_WLK,                       ///< Read from a WeatherLink .wlk file.
+    BS_UNAVAILABLE                ///< No source holds the data.
+  };
+
+  struct SBackfillOptions
+  {
+    TTimestamp consoleNewest;                 ///< Newest record in the console archive memory. Invalid if there is no console.
+    std::size_t consoleCapacity = 2560;       ///< Records held by the console archive memory.
+    bool wlkFiles = true;                     ///< true if .wlk files are available.
+  };
+
+  struct SBackfillRequest
+  {
+    EBackfillSource source;
+    TTimestamp first;             ///< First missing interval filled by the request.
+    TTimestamp last;              ///< Last missing interval filled by the request.
+    std::size_t slots;            ///< Number of missing intervals filled by the request.
+    SDMPAFTRequest dmpaft;        ///< BS_DMPAFT: The request to send after the DMPAFT command.
+    int year;                     ///< BS_WLK: The year of the file.
+    int month;                    ///< BS_WLK: The month of the file.
+    std::uint32_t days;           ///< BS_WLK: Bit (day - 1) is set for each day to read.
+  };
+
+  class CGapIndex
+  {
+  private:
+    int interval_;
+    int slotsPerDay_;
+    std::size_t wordsPerDay_;
+    std::int32_t firstDay_ = 0;             ///< Days since 1970-01-01 of the first stored day.
+    std::int32_t dayCount_ = 0;
+    std::vector<std::uint64_t> words_;
+    std::size_t count_ = 0;
+
+    void extend(std::int32_t);
+
+  public:
+    explicit CGapIndex(int = 5);
+
+    int interval() const { return interval_; }
+    std::size_t count() const { return count_; }
+    std::size_t wordsPerDay() const { return wordsPerDay_; }
+    std::int32_t firstDay() const { return firstDay_; }
+    std::int32_t dayCount() const { return dayCount_; }
+    std::vector<std::uint64_t> const &words() const { return words_; }
+
+    void clear();
+    void assign(std::int32_t, std::int32_t, std::uint64_t const *);
+    bool mark(TTimestamp);
+    bool mark(std::uint32_t);
+    bool occupied(TTimestamp) const;
+
+    std::size_t load(CDatabaseSQLite &, unsigned long siteID, unsigned long instrumentID, TTimestamp, TTimestamp);
+    std::size_t load(CTimeSeriesStore &, unsigned long siteID, unsigned long instrumentID, TTimestamp, TTimestamp);
+
+    std::size_t gaps(TTimestamp, TTimestamp, std::vector<SGap> &) const;
+    std::size_t plan(std::vector<SGap> const &, SBackfillOptions const &, std::vector<SBackfillRequest> &) const;
+
+    static SDMPAFTRequest DMPAFTRequest(TTimestamp);
+  };
+
+} // namespace WCL
+
+#endif // WCL_GAPINDEX_H
@@ -0,0 +1,115 @@
+﻿//*********************************************************************************************************************************
+//
+// PROJECT:							Weather Class Library (WCL)
+// FILE:								importCatalog
+// SUBSYSTEM:						Incremental import of .wlk files
+// LANGUAGE:						C++
+// TARGET OS:						WINDOWS/UNIX/LINUX/MAC
+// LIBRARY DEPENDANCE:	boost::filesystem
+// NAMESPACE:						WCL
+// AUTHOR:							Gavin Blakeman.
+// LICENSE:             GPLv2
+//
+//                      Copyright 2026 Gavin Blakeman.
+//                      This file is part of the Weather Class Library (WCL).
+//
+//                      WCL is free software: you can redistribute it and/or modify it under the terms of the GNU General
+//                      Public License as published by the Free Software Foundation, either version 2 of the License, or (at your
+//                      option) any later version.
+//
+//                      WCL is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the
+//                      implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//                      for more details.
+//
+//                      You should have received a copy of the GNU General Public License along with WCL.  If not, see
+//                      <http://www.gnu.org/licenses/>.
+//
+// OVERVIEW:						A catalog of the .wlk files that have been imported. For each file the size, modification time and a hash
+//                      of the header block are stored, together with a hash of the records of each day (the range given by the
+//                      day index). When a directory is imported again, files whose size, time and header are unchanged are
+//                      skipped without reading any further, and in changed files only the days whose hash has changed are
+//                      written to the store.
+//                      The catalog is a text file with one line per .wlk file. It is written to a temporary file and renamed,
+//                      so an interrupted save leaves the previous catalog intact. The hashes are 64 bit FNV-1a.
+//
+// CLASSES INCLUDED:    CImportCatalog
+//
+// CLASS HIERARCHY:     CImportCatalog
+//
+// HISTORY:             2026-10-19 GGB - File Created
+//
+//*********************************************************************************************************************************
+
+#ifndef WCL_IMPORTCATALOG_H
+#define WCL_IMPORTCATALOG_H
+
+  // Standard C++ Library header files.
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <map>
+#include <string>
+#include <vector>
+
+  // Miscellanous library header files.
+
+#include <boost/filesystem.hpp>
+
+  // WCL header files
+
+#include "include/weatherStore.h"
+
+namespace WCL
+{
+  struct SCatalogEntry
+  {
+    std::uintmax_t size = 0;
+    std::time_t writeTime = 0;
+    std::uint64_t headerHash = 0;
+    std::array<std::uint64_t, 32> dayHash{};   ///< Index 0 not used. Zero for days without records.
+  };
+
+  struct SImportStatistics
+  {
+    std::size_t filesScanned = 0;
+    std::size_t filesSkipped = 0;
+    std::size_t daysImported = 0;
+    std::size_t daysSkipped = 0;
+    std::size_t records = 0;
+  };
+
+  class CImportCatalog
+  {
+  private:
+    boost::filesystem::path catalogFile_;
+    std::map<std::string, SCatalogEntry> entries_;
+    bool modified_ = false;
+
+    static std::string key(boost::filesystem::path const &);
+    static bool readFile(boost::filesystem::path const &, std::vector<char> &);
+
+  public:
+    CImportCatalog(boost::filesystem::path const &);
+
+    bool load();
+    bool save();
+    bool modified() const { return modified_; }
+
+    bool unchanged(boost::filesystem::path const &) const;
+    bool scan(boost::filesystem::path const &, std::vector<char> &, SCatalogEntry &, std::vector<int> &) const;
+    void update(boost::filesystem::path const &, SCatalogEntry const &);
+    void remove(boost::filesystem::path const &);
+
+    std::size_t importFile(boost::filesystem::path const &, CWeatherStore &, unsigned long siteID, unsigned long instrumentID,
+                           SImportStatistics &);
+    SImportStatistics importDirectory(boost::filesystem::path const &, CWeatherStore &, unsigned long siteID,
+                                      unsigned long instrumentID);
+
+    static std::uint64_t hash(void const *, std::size_t);
+  };
+
+} // namespace WCL
+
+#endif // WCL_IMPORTCATALOG_H
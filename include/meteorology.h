@@ -0,0 +1,110 @@
+﻿//*********************************************************************************************************************************
+//
+// PROJECT:							Weather Class Library (WCL)
+// FILE:								meteorology
+// SUBSYSTEM:						Derived meteorological quantities
+// LANGUAGE:						C++
+// TARGET OS:						WINDOWS/UNIX/LINUX/MAC
+// LIBRARY DEPENDANCE:	None.
+// NAMESPACE:						WCL::meteorology
+// AUTHOR:							Gavin Blakeman.
+// LICENSE:             GPLv2
+//
+//                      Copyright 2026 Gavin Blakeman.
+//                      This file is part of the Weather Class Library (WCL).
+//
+//                      WCL is free software: you can redistribute it and/or modify it under the terms of the GNU General
+//                      Public License as published by the Free Software Foundation, either version 2 of the License, or (at your
+//                      option) any later version.
+//
+//                      WCL is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the
+//                      implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//                      for more details.
+//
+//                      You should have received a copy of the GNU General Public License along with WCL.  If not, see
+//                      <http://www.gnu.org/licenses/>.
+//
+// OVERVIEW:						Batch kernels for the derived quantities carried in the daily summaries (dew point, wind chill, heat
+//                      index, THW, THSW and wet bulb). The kernels work on whole columns of floats. The logarithm, exponential
+//                      and arctangent are replaced by branch-free polynomial approximations so that the loops can be vectorised
+//                      by the compiler.
+//                      All temperatures are in degrees C, humidity in %, wind speed in m/s and solar radiation in W/m^2.
+//                      columns() extracts the inputs from .wlk records, console archive records or time series records. A value
+//                      that is missing (the Davis sentinel, or outside the observation limits) becomes NaN. The kernels return NaN
+//                      where an input is NaN and summarise() ignores NaN values.
+//
+//                      Reference formulae:
+//                        Dew point   - Magnus formula with the Alduchov & Eskridge (1996) coefficients.
+//                        Heat index  - NWS (Rothfusz regression with the NWS adjustments).
+//                        Wind chill  - NWS (2001). Equal to the temperature above 10C or below 3mph.
+//                        THW         - Heat index less 1.072F per mph of wind speed (Davis).
+//                        THSW        - Steadman (1994) apparent temperature including solar radiation.
+//                        Wet bulb    - Stull (2011).
+//                      The approximations agree with the reference formulae to better than 0.01C over the range of the station
+//                      sensors. This is checked by the test program in test/meteorology.
+//
+// CLASSES INCLUDED:    None.
+//
+// CLASS HIERARCHY:     None.
+//
+// HISTORY:             2026-10-19 GGB - File Created
+//
+//*********************************************************************************************************************************
+
+#ifndef WCL_METEOROLOGY_H
+#define WCL_METEOROLOGY_H
+
+  // Standard C++ Library header files.
+
+#include <cstddef>
+#include <vector>
+
+  // WCL header files
+
+#include "include/observation.h"
+#include "include/WeatherLink.h"
+
+namespace WCL
+{
+  namespace meteorology
+  {
+    /// @brief The input columns for the kernels.
+
+    struct SColumns
+    {
+      std::vector<float> temperature;     ///< Outside temperature (C)
+      std::vector<float> humidity;        ///< Outside humidity (%)
+      std::vector<float> windSpeed;       ///< Average wind speed (m/s)
+      std::vector<float> solarRadiation;  ///< Solar radiation (W/m^2)
+
+      std::size_t size() const { return temperature.size(); }
+      void resize(std::size_t);
+    };
+
+    /// @brief The high, low and average of a column.
+
+    struct SSummary
+    {
+      float high;
+      float low;
+      float average;
+    };
+
+    void columns(SWeatherDataRecord const *, std::size_t, SColumns &);
+    void columns(SArchiveRecord const *, std::size_t, SColumns &);
+    void columns(STimeSeriesRecord const *, std::size_t, SColumns &);
+
+    void dewPoint(float const *temperature, float const *humidity, float *out, std::size_t);
+    void heatIndex(float const *temperature, float const *humidity, float *out, std::size_t);
+    void windChill(float const *temperature, float const *windSpeed, float *out, std::size_t);
+    void THW(float const *temperature, float const *humidity, float const *windSpeed, float *out, std::size_t);
+    void THSW(float const *temperature, float const *humidity, float const *windSpeed, float const *solarRadiation, float *out,
+              std::size_t);
+    void wetBulb(float const *temperature, float const *humidity, float *out, std::size_t);
+
+    SSummary summarise(float const *, std::size_t);
+
+  } // namespace meteorology
+} // namespace WCL
+
+#endif // WCL_METEOROLOGY_H
@@ -0,0 +1,259 @@
+﻿//*********************************************************************************************************************************
+//
+// PROJECT:							Weather Class Library (WCL)
+// FILE:								observation
+// SUBSYSTEM:						Canonical observation record and field descriptors
+// LANGUAGE:						C++
+// TARGET OS:						WINDOWS/UNIX/LINUX/MAC
+// LIBRARY DEPENDANCE:	None.
+// NAMESPACE:						WCL
+// AUTHOR:							Gavin Blakeman.
+// LICENSE:             GPLv2
+//
+//                      Copyright 2026 Gavin Blakeman.
+//                      This file is part of the Weather Class Library (WCL).
+//
+//                      WCL is free software: you can redistribute it and/or modify it under the terms of the GNU General
+//                      Public License as published by the Free Software Foundation, either version 2 of the License, or (at your
+//                      option) any later version.
+//
+//                      WCL is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the
+//                      implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//                      for more details.
+//
+//                      You should have received a copy of the GNU General Public License along with WCL.  If not, see
+//                      <http://www.gnu.org/licenses/>.
+//
+// OVERVIEW:						The canonical observation record (STimeSeriesRecord) and a constexpr table that describes each of its
+//                      values: the column name, the storage type, the SI unit, the source field in the console archive record
+//                      and in the .wlk record, the missing marker and the default validation limits. The table is in the
+//                      EValidatedField order.
+//                      The decoders of the .wlk files and of the console download, the SQLite binding, the validator and the
+//                      exporters are all driven from the table, so adding a value to the record is one entry here (and the
+//                      member of the record). decodeObservation() unrolls the table at compile time: each value is one load
+//                      from the wire bytes and one multiply and add with constants.
+//                      The rain values have no wire field as the size of a rain click depends on the collector, so the
+//                      decoders set them from the collector type.
+//
+// CLASSES INCLUDED:    STimeSeriesRecord
+//                      SObservationField
+//
+// CLASS HIERARCHY:     None.
+//
+// HISTORY:             2026-10-19 GGB - File Created
+//
+//*********************************************************************************************************************************
+
+#ifndef WCL_OBSERVATION_H
+#define WCL_OBSERVATION_H
+
+  // Standard C++ Library header files.
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+  // WCL header files
+
+#include "include/unitTransform.h"
+#include "include/validation.h"
+#include "include/wireFormat.h"
+
+namespace WCL
+{
+  /// @brief The canonical observation record. Values are in SI units and are the values stored in the database columns and the
+  ///        segment files.
+
+  struct STimeSeriesRecord
+  {
+    std::uint32_t key;              ///< MJD * 10000 + HHMM
+    std::uint16_t windDirection;
+    std::uint16_t solarRad;
+    std::uint16_t hiSolarRad;
+    std::uint8_t UV;
+    std::uint8_t hiUV;
+    std::uint32_t reserved;
+    double outsideTemp;
+    double hiOutsideTemp;
+    double lowOutsideTemp;
+    double insideTemp;
+    double barometer;
+    double outsideHumidity;
+    double insideHumidity;
+    double rain;
+    double hiRainRate;
+    double windSpeed;
+    double hiWindSpeed;
+
+    static std::uint32_t makeKey(std::uint32_t MJD, std::uint16_t time) { return MJD * 10000 + time; }
+    std::uint32_t MJD() const { return key / 10000; }
+    std::uint16_t time() const { return static_cast<std::uint16_t>(key % 10000); }
+  };
+
+  static_assert(sizeof(STimeSeriesRecord) == 104, "STimeSeriesRecord must not contain hidden padding.");
+
+  enum EObservationType
+  {
+    OT_DOUBLE,
+    OT_UINT16,
+    OT_UINT8
+  };
+
+  constexpr std::size_t NO_WIRE_FIELD = ~static_cast<std::size_t>(0);
+
+  struct SObservationField
+  {
+    char const *name;               ///< Name of the column in TBL_ARCHIVE and in the exports.
+    std::size_t offset;             ///< Offset of the value in STimeSeriesRecord.
+    EObservationType type;
+    EUnit unit;                     ///< Unit of the stored value. U_NONE for the integer values, which are stored raw.
+    char const *unitName;           ///< Unit written to the export metadata.
+    std::size_t archiveField;       ///< Source field in SArchiveRecord.
+    std::size_t wlkField;           ///< Source field in SWeatherDataRecord.
+    std::uint16_t marker;           ///< Missing value marker of an integer value.
+    SFieldLimits limits;            ///< Default limits in SI units (raw units for the integer values).
+  };
+
+  inline constexpr SObservationField observationFields[] =
+  {
+    { "outsideTemp",      offsetof(STimeSeriesRecord, outsideTemp),     OT_DOUBLE, U_KELVIN,              "K",
+      ARF_TEMPERATURE_OUTSIDE,      WDF_OUTSIDE_TEMP,     0,                                   { 183.15, 333.15, 5 } },
+    { "hiOutsideTemp",    offsetof(STimeSeriesRecord, hiOutsideTemp),   OT_DOUBLE, U_KELVIN,              "K",
+      ARF_TEMPERATURE_HIGH_OUTSIDE, WDF_HI_OUTSIDE_TEMP,  0,                                   { 183.15, 333.15, 0 } },
+    { "lowOutsideTemp",   offsetof(STimeSeriesRecord, lowOutsideTemp),  OT_DOUBLE, U_KELVIN,              "K",
+      ARF_TEMPERATURE_LOW_OUTSIDE,  WDF_LOW_OUTSIDE_TEMP, 0,                                   { 183.15, 333.15, 0 } },
+    { "insideTemp",       offsetof(STimeSeriesRecord, insideTemp),      OT_DOUBLE, U_KELVIN,              "K",
+      ARF_TEMPERATURE_INSIDE,       WDF_INSIDE_TEMP,      0,                                   { 233.15, 343.15, 0 } },
+    { "barometer",        offsetof(STimeSeriesRecord, barometer),       OT_DOUBLE, U_PASCAL,              "Pa",
+      ARF_BAROMETER,                WDF_BAROMETER,        0,                                   { 87000, 108500, 200 } },
+    { "outsideHumidity",  offsetof(STimeSeriesRecord, outsideHumidity), OT_DOUBLE, U_PERCENT,             "%",
+      ARF_HUMIDITY_OUTSIDE,         WDF_OUTSIDE_HUM,      0,                                   { 0, 100, 20 } },
+    { "insideHumidity",   offsetof(STimeSeriesRecord, insideHumidity),  OT_DOUBLE, U_PERCENT,             "%",
+      ARF_HUMIDITY_INSIDE,          WDF_INSIDE_HUM,       0,                                   { 0, 100, 0 } },
+    { "rain",             offsetof(STimeSeriesRecord, rain),            OT_DOUBLE, U_MILLIMETRE,          "mm",
+      NO_WIRE_FIELD,                NO_WIRE_FIELD,        0,                                   { 0, 200, 0 } },
+    { "hiRainRate",       offsetof(STimeSeriesRecord, hiRainRate),      OT_DOUBLE, U_MILLIMETRE_PER_HOUR, "mm/h",
+      NO_WIRE_FIELD,                NO_WIRE_FIELD,        0,                                   { 0, 2000, 0 } },
+    { "windSpeed",        offsetof(STimeSeriesRecord, windSpeed),       OT_DOUBLE, U_METRE_PER_SECOND,    "m/s",
+      ARF_WIND_SPEED_AVERAGE,       WDF_WIND_SPEED,       0,                                   { 0, 75, 0 } },
+    { "hiWindSpeed",      offsetof(STimeSeriesRecord, hiWindSpeed),     OT_DOUBLE, U_METRE_PER_SECOND,    "m/s",
+      ARF_WIND_SPEED_HIGH,          WDF_HI_WIND_SPEED,    0,                                   { 0, 100, 0 } },
+    { "windDirection",    offsetof(STimeSeriesRecord, windDirection),   OT_UINT16, U_NONE,                "",
+      ARF_PREVAILING_WIND,          WDF_WIND_DIRECTION,   CRecordValidator::MISSING_DIRECTION, { 0, 15, 0 } },
+    { "solarRad",         offsetof(STimeSeriesRecord, solarRad),        OT_UINT16, U_NONE,                "W/m2",
+      ARF_SOLAR_RADIATION,          WDF_SOLAR_RAD,        CRecordValidator::MISSING_SOLAR,     { 0, 1800, 0 } },
+    { "hiSolarRad",       offsetof(STimeSeriesRecord, hiSolarRad),      OT_UINT16, U_NONE,                "W/m2",
+      ARF_SOLAR_RADIATION_HIGH,     WDF_HI_SOLAR_RAD,     CRecordValidator::MISSING_SOLAR,     { 0, 1800, 0 } },
+    { "UV",               offsetof(STimeSeriesRecord, UV),              OT_UINT8,  U_NONE,                "",
+      ARF_AVERAGE_UVINDEX,          WDF_UV,               CRecordValidator::MISSING_UV,        { 0, 200, 0 } },
+    { "hiUV",             offsetof(STimeSeriesRecord, hiUV),            OT_UINT8,  U_NONE,                "",
+      ARF_UVINDEX_HIGH,             WDF_HI_UV,            CRecordValidator::MISSING_UV,        { 0, 200, 0 } },
+  };
+
+  static_assert(sizeof(observationFields) / sizeof(observationFields[0]) == VF_COUNT, "Observation field missing.");
+
+  /// @brief Returns the width in bytes of a value of the record.
+
+  constexpr std::size_t observationWidth(EObservationType type)
+  {
+    return (type == OT_DOUBLE) ? sizeof(double) : ((type == OT_UINT16) ? sizeof(std::uint16_t) : sizeof(std::uint8_t));
+  }
+
+  /// @brief Returns the source field of an observation in a wire structure.
+
+  template<typename T>
+  constexpr std::size_t observationWireField(std::size_t index);
+
+  template<>
+  constexpr std::size_t observationWireField<SArchiveRecord>(std::size_t index)
+  {
+    return observationFields[index].archiveField;
+  }
+
+  template<>
+  constexpr std::size_t observationWireField<SWeatherDataRecord>(std::size_t index)
+  {
+    return observationFields[index].wlkField;
+  }
+
+  /// @brief Loads a value from a record.
+
+  template<typename V>
+  inline V observationLoad(STimeSeriesRecord const &record, std::size_t offset)
+  {
+    V returnValue;
+
+    std::memcpy(&returnValue, reinterpret_cast<char const *>(&record) + offset, sizeof(V));
+
+    return returnValue;
+  }
+
+  /// @brief Stores a value in a record.
+
+  template<typename V>
+  inline void observationStore(STimeSeriesRecord &record, std::size_t offset, V value)
+  {
+    std::memcpy(reinterpret_cast<char *>(&record) + offset, &value, sizeof(V));
+  }
+
+  /// @brief Calls a function with std::integral_constant<std::size_t, INDEX> for each observation field, in table order.
+
+  template<typename F, std::size_t... INDEX>
+  inline void forEachObservationField(F &&function, std::index_sequence<INDEX...>)
+  {
+    (function(std::integral_constant<std::size_t, INDEX>()), ...);
+  }
+
+  template<typename F>
+  inline void forEachObservationField(F &&function)
+  {
+    forEachObservationField(std::forward<F>(function), std::make_index_sequence<VF_COUNT>());
+  }
+
+  /// @brief Decodes an observation value from the bytes of a wire structure. The real values are converted to the unit of the
+  ///        field, the integer values are copied raw (as unsigned, so that a signed 0xFF is the missing marker 255).
+
+  template<typename T, std::size_t INDEX>
+  inline void decodeObservationField(std::uint8_t const *bytes, STimeSeriesRecord &record)
+  {
+    constexpr SObservationField field = observationFields[INDEX];
+    constexpr std::size_t WIRE = observationWireField<T>(INDEX);
+
+    if constexpr (WIRE != NO_WIRE_FIELD)
+    {
+      constexpr SWireField wire = TWireLayout<T>::fields[WIRE];
+
+      if constexpr (field.type == OT_DOUBLE)
+      {
+        observationStore(record, field.offset, wireConvert<T, WIRE, field.unit>(bytes));
+      }
+      else if constexpr (field.type == OT_UINT16)
+      {
+        observationStore(record, field.offset, static_cast<std::uint16_t>(wireLoad<wire.width, false>(bytes + wire.offset)));
+      }
+      else
+      {
+        observationStore(record, field.offset, static_cast<std::uint8_t>(wireLoad<wire.width, false>(bytes + wire.offset)));
+      };
+    };
+  }
+
+  /// @brief Decodes all the observation values that have a source field in a wire structure.
+
+  template<typename T, std::size_t... INDEX>
+  inline void decodeObservation(std::uint8_t const *bytes, STimeSeriesRecord &record, std::index_sequence<INDEX...>)
+  {
+    (decodeObservationField<T, INDEX>(bytes, record), ...);
+  }
+
+  template<typename T>
+  inline void decodeObservation(std::uint8_t const *bytes, STimeSeriesRecord &record)
+  {
+    decodeObservation<T>(bytes, record, std::make_index_sequence<VF_COUNT>());
+  }
+
+} // namespace WCL
+
+#endif // WCL_OBSERVATION_H
@@ -0,0 +1,193 @@
+﻿//*********************************************************************************************************************************
+//
+// PROJECT:							Weather Class Library (WCL)
+// FILE:								priorityWriter
+// SUBSYSTEM:						Priority scheduling of live and backfill writes to one store
+// LANGUAGE:						C++
+// TARGET OS:						WINDOWS/UNIX/LINUX/MAC
+// LIBRARY DEPENDANCE:	None.
+// NAMESPACE:						WCL
+// AUTHOR:							Gavin Blakeman.
+// LICENSE:             GPLv2
+//
+//                      Copyright 2026 Gavin Blakeman.
+//                      This file is part of the Weather Class Library (WCL).
+//
+//                      WCL is free software: you can redistribute it and/or modify it under the terms of the GNU General
+//                      Public License as published by the Free Software Foundation, either version 2 of the License, or (at your
+//                      option) any later version.
+//
+//                      WCL is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the
+//                      implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//                      for more details.
+//
+//                      You should have received a copy of the GNU General Public License along with WCL.  If not, see
+//                      <http://www.gnu.org/licenses/>.
+//
+// OVERVIEW:						Shares one store (one database connection) between the live ingest (LOOP and archive polling) and the
+//                      backfill (file imports and DMP recovery). Each priority class has its own queue and is used through its
+//                      own CWeatherStore (store()), so the existing importers and pollers are unchanged.
+//                      One writer thread owns the store, which is created by a factory on the writer thread. The writer always
+//                      takes the live queue first. The backfill queue is only written when the live queue is empty, so the
+//                      backfill uses the capacity that is left over.
+//                      The live work waits at most for the backfill batch that is being written. The backfill batch size is
+//                      adapted after each batch so that a batch takes about the slice time, whatever the speed of the store.
+//                      Each class can also be limited to a rate (records per second) and a queue length at which its producers
+//                      block.
+//                      Queries (lastWeatherRecord(), recordExists()) are queued behind the records of their class and run on
+//                      the writer thread. A live query does not wait for the queued backfill records.
+//                      An error raised by the store is held and rethrown to the next caller. The records of the failed batch
+//                      are not retried.
+//
+// CLASSES INCLUDED:    SPriorityLimits
+//                      SPriorityStatistics
+//                      CPriorityWriter
+//
+// CLASS HIERARCHY:     CPriorityWriter
+//                      CWeatherStore
+//                        - CPriorityWriter::CClassStore
+//
+// HISTORY:             2026-10-19 GGB - File Created
+//
+//*********************************************************************************************************************************
+
+#ifndef WCL_PRIORITYWRITER_H
+#define WCL_PRIORITYWRITER_H
+
+  // Standard C++ Library header files.
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <variant>
+#include <vector>
+
+  // Miscellanous library header files.
+
+#include <ACL>
+
+  // WCL header files
+
+#include "include/weatherStore.h"
+
+namespace WCL
+{
+  enum EPriorityClass
+  {
+    PC_LIVE,                              ///< LOOP and archive polling of the stations.
+    PC_BACKFILL,                          ///< File imports and DMP recovery.
+    PC_COUNT
+  };
+
+  struct SPriorityLimits
+  {
+    std::size_t batchSize = 1000;         ///< Largest number of records written as one batch.
+    std::size_t queueLimit = 4000;        ///< Queued records at which a producer blocks.
+    std::chrono::milliseconds flushInterval = std::chrono::milliseconds(0);   ///< Longest time a record waits for a full batch.
+    double rate = 0;                      ///< Records per second. (0 = unlimited)
+  };
+
+  struct SPriorityStatistics
+  {
+    std::uint64_t queued = 0;             ///< Records queued.
+    std::uint64_t written = 0;            ///< Records passed to the store.
+    std::uint64_t inserted = 0;           ///< Records the store reported as inserted.
+    std::uint64_t batches = 0;
+    std::size_t maxQueue = 0;             ///< Largest queue length seen.
+    std::chrono::microseconds maxWait = std::chrono::microseconds(0);   ///< Longest time from queueing to the start of the write.
+  };
+
+  class CPriorityWriter
+  {
+  public:
+    typedef std::function<std::unique_ptr<CWeatherStore>()> factory_t;
+
+    class CClassStore : public CWeatherStore
+    {
+    private:
+      CPriorityWriter &writer_;
+      EPriorityClass priority_;
+
+    public:
+      CClassStore(CPriorityWriter &writer, EPriorityClass priority) : writer_(writer), priority_(priority) {}
+
+      virtual bool insertRecord(unsigned long siteID, unsigned long instrumentID, SArchiveRecord &) override;
+      virtual bool insertRecord(unsigned long siteID, unsigned long instrumentID, SWeatherDataRecord const &,
+                                ACL::TJD const &) override;
+      virtual bool lastWeatherRecord(unsigned long siteID, unsigned long instrumentID, std::uint16_t &, std::uint16_t &) override;
+      virtual bool recordExists(unsigned long siteID, unsigned long instrumentID, ACL::TJD, std::uint16_t) override;
+      virtual void endBatch() override;
+    };
+
+  private:
+    struct SWlkRecord
+    {
+      SWeatherDataRecord record;
+      ACL::TJD JD;
+    };
+    typedef std::packaged_task<bool(CWeatherStore &)> query_t;
+
+    struct SItem
+    {
+      unsigned long siteID;
+      unsigned long instrumentID;
+      std::variant<SArchiveRecord, SWlkRecord, query_t> value;
+      std::chrono::steady_clock::time_point queued;
+    };
+
+    struct SClass
+    {
+      SPriorityLimits limits;
+      std::deque<SItem> queue;
+      std::size_t batchSize;                          ///< Size of the next batch. Adapted to the slice time for the backfill.
+      std::chrono::steady_clock::time_point readyAt;  ///< The rate limit allows the next batch from this time.
+      bool flushRequested = false;
+      SPriorityStatistics statistics;
+    };
+
+    factory_t factory_;
+    std::chrono::microseconds slice_;
+    std::mutex mutex_;
+    std::condition_variable pending_;     ///< Signalled when there is work for the writer thread.
+    std::condition_variable space_;       ///< Signalled when a batch has been taken or written.
+    std::array<SClass, PC_COUNT> classes_;
+    std::array<std::unique_ptr<CClassStore>, PC_COUNT> stores_;
+    bool writing_ = false;
+    bool stop_ = false;
+    std::unique_ptr<CWeatherStore> store_;
+    std::exception_ptr error_;
+    std::thread thread_;
+
+    CPriorityWriter(CPriorityWriter const &) = delete;
+    CPriorityWriter &operator=(CPriorityWriter const &) = delete;
+
+    void enqueue(EPriorityClass, SItem &&);
+    bool query(EPriorityClass, std::function<bool(CWeatherStore &)>);
+    void requestFlush(EPriorityClass);
+    int select(std::chrono::steady_clock::time_point, std::chrono::steady_clock::time_point &);
+    std::chrono::microseconds writeBatch(SClass &, std::vector<SItem> &, bool);
+    void writer();
+
+  public:
+    CPriorityWriter(factory_t, SPriorityLimits const & = SPriorityLimits(), SPriorityLimits const & = SPriorityLimits(),
+                    std::chrono::milliseconds = std::chrono::milliseconds(50));
+    virtual ~CPriorityWriter();
+
+    CWeatherStore &store(EPriorityClass priority) { return *stores_[priority]; }
+
+    void flush();
+    std::array<SPriorityStatistics, PC_COUNT> statistics();
+  };
+
+} // namespace WCL
+
+#endif // WCL_PRIORITYWRITER_H
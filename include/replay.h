@@ -0,0 +1,143 @@
+﻿//*********************************************************************************************************************************
+//
+// PROJECT:							Weather Class Library (WCL)
+// FILE:								replay
+// SUBSYSTEM:						Historical replay driver
+// LANGUAGE:						C++
+// TARGET OS:						WINDOWS/UNIX/LINUX/MAC
+// LIBRARY DEPENDANCE:	Boost
+// NAMESPACE:						WCL
+// AUTHOR:							Gavin Blakeman.
+// LICENSE:             GPLv2
+//
+//                      Copyright 2026 Gavin Blakeman.
+//                      This file is part of the Weather Class Library (WCL).
+//
+//                      WCL is free software: you can redistribute it and/or modify it under the terms of the GNU General
+//                      Public License as published by the Free Software Foundation, either version 2 of the License, or (at your
+//                      option) any later version.
+//
+//                      WCL is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the
+//                      implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//                      for more details.
+//
+//                      You should have received a copy of the GNU General Public License along with WCL.  If not, see
+//                      <http://www.gnu.org/licenses/>.
+//
+// OVERVIEW:						Replays the archive records in .wlk files through a callback in timestamp order. The replay can run at
+//                      real time, at a speed-up factor or as fast as possible. Each station is replayed on its own thread and the
+//                      throughput and lag (time behind the schedule) are measured for each station.
+//                      The .wlk files do not hold the year and month, so the files must be named YYYY-MM.wlk as written by the
+//                      WeatherLink software.
+//
+// CLASSES INCLUDED:    CReplayDriver
+//
+// CLASS HIERARCHY:     CReplayDriver
+//
+// HISTORY:             2026-10-19 GGB - File Created
+//
+//*********************************************************************************************************************************
+
+#ifndef WCL_REPLAY_H
+#define WCL_REPLAY_H
+
+  // Standard C++ Library header files.
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+  // Miscellanous library header files.
+
+#include <boost/filesystem.hpp>
+
+  // WCL header files
+
+#include "include/WeatherLink.h"
+
+namespace WCL
+{
+  struct SReplayRecord
+  {
+    unsigned long siteID;
+    unsigned long instrumentID;
+    int year;
+    int month;
+    int day;
+    std::int64_t minute;                  ///< Minutes since 1970-01-01 00:00.
+    SWeatherDataRecord const *record;
+  };
+
+  struct SReplayStatistics
+  {
+    unsigned long siteID = 0;
+    unsigned long instrumentID = 0;
+    std::uint64_t records = 0;
+    std::uint64_t filesRead = 0;
+    std::uint64_t filesFailed = 0;
+    double elapsed = 0;                   ///< Seconds since the replay started.
+    double recordsPerSecond = 0;
+    double meanLag = 0;                   ///< Mean time behind schedule (seconds).
+    double maxLag = 0;                    ///< Maximum time behind schedule (seconds).
+    bool complete = false;
+    bool failed = false;                  ///< The replay of the station was stopped by an exception.
+  };
+
+  class CReplayDriver
+  {
+  public:
+    typedef std::function<void(SReplayRecord const &)> callback_t;
+
+  private:
+    struct SStation
+    {
+      unsigned long siteID;
+      unsigned long instrumentID;
+      std::vector<boost::filesystem::path> files;
+      std::thread thread;
+      mutable std::mutex statisticsMutex;
+      SReplayStatistics statistics;
+      double totalLag = 0;
+    };
+
+    callback_t callback_;
+    double speedFactor_ = 0;
+    std::atomic<bool> stop_;
+    bool running_ = false;
+    std::chrono::steady_clock::time_point startTime_;
+    std::int64_t startMinute_ = 0;
+    std::vector<std::unique_ptr<SStation>> stations_;
+
+    CReplayDriver(CReplayDriver const &) = delete;
+    CReplayDriver &operator=(CReplayDriver const &) = delete;
+
+    void replayStation(SStation &);
+    std::int64_t firstMinute() const;
+
+  public:
+    CReplayDriver(callback_t);
+    virtual ~CReplayDriver();
+
+    void addStation(unsigned long siteID, unsigned long instrumentID, boost::filesystem::path const &);
+    void addStation(unsigned long siteID, unsigned long instrumentID, std::vector<boost::filesystem::path> const &);
+
+    void speedFactor(double);
+    double speedFactor() const { return speedFactor_; }
+
+    void start();
+    void stop();
+    void wait();
+
+    std::vector<SReplayStatistics> statistics() const;
+
+    static bool fileDate(boost::filesystem::path const &, int &, int &);
+  };
+
+} // namespace WCL
+
+#endif // WCL_REPLAY_H
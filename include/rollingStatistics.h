@@ -0,0 +1,134 @@
+﻿//*********************************************************************************************************************************
+//
+// PROJECT:							Weather Class Library (WCL)
+// FILE:								rollingStatistics
+// SUBSYSTEM:						Streaming (sliding window) statistics
+// LANGUAGE:						C++
+// TARGET OS:						WINDOWS/UNIX/LINUX/MAC
+// LIBRARY DEPENDANCE:	None.
+// NAMESPACE:						WCL
+// AUTHOR:							Gavin Blakeman.
+// LICENSE:             GPLv2
+//
+//                      Copyright 2026 Gavin Blakeman.
+//                      This file is part of the Weather Class Library (WCL).
+//
+//                      WCL is free software: you can redistribute it and/or modify it under the terms of the GNU General
+//                      Public License as published by the Free Software Foundation, either version 2 of the License, or (at your
+//                      option) any later version.
+//
+//                      WCL is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the
+//                      implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//                      for more details.
+//
+//                      You should have received a copy of the GNU General Public License along with WCL.  If not, see
+//                      <http://www.gnu.org/licenses/>.
+//
+// OVERVIEW:						Sliding window statistics over a live feed. Each field can have any number of time windows (eg 10 minute
+//                      wind speed, 1 hour rain, 3 hour pressure tendency). The samples of a field are held once, in a buffer
+//                      sized for the longest window. Each window keeps a monotonic deque for the minimum and maximum, and
+//                      compensated (Neumaier) running sums for the mean and variance, so that adding a sample and querying a
+//                      window are both amortised O(1).
+//                      The sums are taken about the first sample of the field to avoid cancellation in the variance for fields
+//                      with a large offset such as pressure.
+//
+// CLASSES INCLUDED:    CRollingStatistics
+//
+// CLASS HIERARCHY:     CRollingStatistics
+//
+// HISTORY:             2026-10-19 GGB - File Created
+//
+//*********************************************************************************************************************************
+
+#ifndef WCL_ROLLINGSTATISTICS_H
+#define WCL_ROLLINGSTATISTICS_H
+
+  // Standard C++ Library header files.
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
+
+namespace WCL
+{
+  class CRollingStatistics
+  {
+  public:
+    typedef std::size_t fieldID_t;
+    typedef std::size_t windowID_t;
+    typedef std::int64_t time_t;
+
+  private:
+    struct SSample
+    {
+      time_t time;
+      double value;
+      std::uint64_t sequence;
+    };
+
+    class CCompensatedSum
+    {
+    private:
+      double sum_ = 0;
+      double compensation_ = 0;
+
+    public:
+      void add(double);
+      void reset() { sum_ = compensation_ = 0; }
+      double value() const { return sum_ + compensation_; }
+    };
+
+    struct SWindow
+    {
+      fieldID_t field;
+      time_t length;
+      std::uint64_t startSequence = 0;    ///< Sequence number of the oldest sample in the window.
+      std::size_t count = 0;
+      CCompensatedSum sum;
+      CCompensatedSum sumSquares;
+      std::deque<SSample> minimum;        ///< Increasing values. Front is the minimum.
+      std::deque<SSample> maximum;        ///< Decreasing values. Front is the maximum.
+    };
+
+    struct SField
+    {
+      std::string name;
+      std::deque<SSample> samples;
+      std::uint64_t nextSequence = 0;
+      double offset = 0;
+      bool hasOffset = false;
+      std::vector<windowID_t> windows;
+    };
+
+    std::vector<SField> fields_;
+    std::vector<SWindow> windows_;
+
+    void expire(SWindow &, SField const &, time_t);
+    SSample const *oldest(SWindow const &) const;
+
+  public:
+    fieldID_t addField(std::string const &);
+    windowID_t addWindow(fieldID_t, time_t);
+    fieldID_t field(std::string const &) const;
+
+    void add(fieldID_t, time_t, double);
+    void advance(time_t);
+    void reset();
+
+    std::size_t count(windowID_t) const;
+    double sum(windowID_t) const;
+    double mean(windowID_t) const;
+    double variance(windowID_t) const;
+    double standardDeviation(windowID_t) const;
+    double minimum(windowID_t) const;
+    double maximum(windowID_t) const;
+    double first(windowID_t) const;
+    double last(windowID_t) const;
+    double change(windowID_t) const;
+  };
+
+} // namespace WCL
+
+#endif // WCL_ROLLINGSTATISTICS_H
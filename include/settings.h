@@ -77,6 +77,7 @@ namespace WCL
 
     QString const WEATHER_SQLITE_DRIVERNAME                 ("Weather Database/SQLite/DriverName");
     QString const WEATHER_SQLITE_DATABASENAME               ("Weather Database/SQLite/DatabaseName");
+    QString const WEATHER_SQLITE_SYNCHRONOUS                ("Weather Database/SQLite/Synchronous");
 
     QSettings extern settings;
 
@@ -0,0 +1,156 @@
+﻿//*********************************************************************************************************************************
+//
+// PROJECT:							Weather Class Library (WCL)
+// FILE:								shardedWriter
+// SUBSYSTEM:						Concurrent archive writers sharded by station
+// LANGUAGE:						C++
+// TARGET OS:						WINDOWS/UNIX/LINUX/MAC
+// LIBRARY DEPENDANCE:	None.
+// NAMESPACE:						WCL
+// AUTHOR:							Gavin Blakeman.
+// LICENSE:             GPLv2
+//
+//                      Copyright 2026 Gavin Blakeman.
+//                      This file is part of the Weather Class Library (WCL).
+//
+//                      WCL is free software: you can redistribute it and/or modify it under the terms of the GNU General
+//                      Public License as published by the Free Software Foundation, either version 2 of the License, or (at your
+//                      option) any later version.
+//
+//                      WCL is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the
+//                      implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//                      for more details.
+//
+//                      You should have received a copy of the GNU General Public License along with WCL.  If not, see
+//                      <http://www.gnu.org/licenses/>.
+//
+// OVERVIEW:						Writes archive records to several stores in parallel. Each (site, instrument) pair is hashed to one of N
+//                      shards. Each shard has its own writer thread, its own store (and so its own database connection) and its
+//                      own queue. The stores are created by a factory on the writer thread, as a Qt database connection can only
+//                      be used on the thread that created it.
+//                      The queue of a shard is written in order by one thread, so the records of a station are written in the
+//                      order they were inserted. The queue is written as a batch (one transaction) when it reaches the batch
+//                      size or when the oldest queued record is older than the flush interval. A producer blocks when the queue
+//                      of its shard reaches the queue limit, so the memory used is bounded when the store cannot keep up.
+//                      Queries (lastWeatherRecord(), recordExists()) are queued behind the records of the shard and run on the
+//                      writer thread, so they see all the records inserted before them.
+//                      An error raised by a store is held by the shard and rethrown to the next caller that uses the shard. The
+//                      records of the failed batch are not retried.
+//
+// CLASSES INCLUDED:    CShardedWriter
+//
+// CLASS HIERARCHY:     CWeatherStore
+//                        - CShardedWriter
+//
+// HISTORY:             2026-10-19 GGB - File Created
+//
+//*********************************************************************************************************************************
+
+#ifndef WCL_SHARDEDWRITER_H
+#define WCL_SHARDEDWRITER_H
+
+  // Standard C++ Library header files.
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <variant>
+#include <vector>
+
+  // Miscellanous library header files.
+
+#include <ACL>
+
+  // WCL header files
+
+#include "include/weatherStore.h"
+
+namespace WCL
+{
+  struct SShardStatistics
+  {
+    std::uint64_t queued = 0;             ///< Records queued.
+    std::uint64_t written = 0;            ///< Records passed to the store.
+    std::uint64_t inserted = 0;           ///< Records the store reported as inserted.
+    std::uint64_t batches = 0;
+    std::size_t maxQueue = 0;             ///< Largest queue length seen.
+  };
+
+  class CShardedWriter : public CWeatherStore
+  {
+  public:
+    typedef std::function<std::unique_ptr<CWeatherStore>(std::size_t)> factory_t;
+
+  private:
+    struct SWlkRecord
+    {
+      SWeatherDataRecord record;
+      ACL::TJD JD;
+    };
+    typedef std::packaged_task<bool(CWeatherStore &)> query_t;
+
+    struct SItem
+    {
+      unsigned long siteID;
+      unsigned long instrumentID;
+      std::variant<SArchiveRecord, SWlkRecord, query_t> value;
+    };
+
+    struct SShard
+    {
+      std::thread thread;
+      std::mutex mutex;
+      std::condition_variable pending;      ///< Signalled when there is work for the writer thread.
+      std::condition_variable space;        ///< Signalled when a batch has been written.
+      std::vector<SItem> queue;
+      std::chrono::steady_clock::time_point oldest;   ///< Time the first record of the queue was queued.
+      bool flushRequested = false;
+      bool writing = false;
+      bool stop = false;
+      std::unique_ptr<CWeatherStore> store;
+      std::exception_ptr error;
+      SShardStatistics statistics;
+    };
+
+    factory_t factory_;
+    std::size_t batchSize_;
+    std::size_t queueLimit_;
+    std::chrono::milliseconds flushInterval_;
+    std::vector<std::unique_ptr<SShard>> shards_;
+
+    CShardedWriter(CShardedWriter const &) = delete;
+    CShardedWriter &operator=(CShardedWriter const &) = delete;
+
+    void enqueue(SShard &, SItem &&);
+    bool query(unsigned long siteID, unsigned long instrumentID, std::function<bool(CWeatherStore &)>);
+    void writeBatch(SShard &, std::vector<SItem> &, bool);
+    void writer(SShard &, std::size_t);
+
+  public:
+    CShardedWriter(std::size_t, factory_t, std::size_t = 1000, std::chrono::milliseconds = std::chrono::milliseconds(1000),
+                   std::size_t = 0);
+    virtual ~CShardedWriter();
+
+    virtual bool insertRecord(unsigned long siteID, unsigned long instrumentID, SArchiveRecord &) override;
+    virtual bool insertRecord(unsigned long siteID, unsigned long instrumentID, SWeatherDataRecord const &, ACL::TJD const &) override;
+    virtual bool lastWeatherRecord(unsigned long siteID, unsigned long instrumentID, std::uint16_t &, std::uint16_t &) override;
+    virtual bool recordExists(unsigned long siteID, unsigned long instrumentID, ACL::TJD, std::uint16_t) override;
+
+    void flush();
+
+    std::size_t shardCount() const { return shards_.size(); }
+    std::size_t shard(unsigned long siteID, unsigned long instrumentID) const;
+    std::vector<SShardStatistics> statistics();
+  };
+
+} // namespace WCL
+
+#endif // WCL_SHARDEDWRITER_H
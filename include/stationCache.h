@@ -0,0 +1,140 @@
+﻿//*********************************************************************************************************************************
+//
+// PROJECT:							Weather Class Library (WCL)
+// FILE:								stationCache
+// SUBSYSTEM:						Warm start cache of the station state held by the database
+// LANGUAGE:						C++
+// TARGET OS:						WINDOWS/UNIX/LINUX/MAC
+// LIBRARY DEPENDANCE:	boost::filesystem, boost::interprocess
+// NAMESPACE:						WCL
+// AUTHOR:							Gavin Blakeman.
+// LICENSE:             GPLv2
+//
+//                      Copyright 2026 Gavin Blakeman.
+//                      This file is part of the Weather Class Library (WCL).
+//
+//                      WCL is free software: you can redistribute it and/or modify it under the terms of the GNU General
+//                      Public License as published by the Free Software Foundation, either version 2 of the License, or (at your
+//                      option) any later version.
+//
+//                      WCL is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the
+//                      implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//                      for more details.
+//
+//                      You should have received a copy of the GNU General Public License along with WCL.  If not, see
+//                      <http://www.gnu.org/licenses/>.
+//
+// OVERVIEW:						Holds the state of each station that the ingest daemon otherwise queries from the database when it starts:
+//                      the last archive record (lastWeatherRecord()), the days that have a daily summary (dailyRecordExists())
+//                      and the gap index of the archive records.
+//                      The cache is attached to a CDatabaseSQLite with stationCache(). The database then answers the queries
+//                      for the cached stations from the cache and updates the cache as records are inserted. A station is added
+//                      with build(), which reads its state from the database.
+//                      The cache is written to a versioned binary snapshot, periodically after a commit and when the database
+//                      is closed. The snapshot is written to a temporary file and renamed, so a crash leaves the previous
+//                      snapshot. At startup the snapshot is mapped and copied into the cache. It records the largest rowid of
+//                      the archive and daily summary tables when it was written (the watermark). Both are read from the end of
+//                      the table b-tree, so the check is cheap. A snapshot whose watermark does not match the database (records
+//                      were written after the snapshot) is discarded and the stations are rebuilt from the database.
+//                      The snapshot is in the native byte order and is not portable between machines.
+//                      The cache is only correct if the database connection it is attached to is the only writer of the cached
+//                      stations.
+//
+// CLASSES INCLUDED:    SStoreWatermark
+//                      SStationState
+//                      CStationCache
+//
+// CLASS HIERARCHY:     CStationCache
+//
+// HISTORY:             2026-10-19 GGB - File Created
+//
+//*********************************************************************************************************************************
+
+#ifndef WCL_STATIONCACHE_H
+#define WCL_STATIONCACHE_H
+
+  // Standard C++ Library header files.
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <utility>
+#include <vector>
+
+  // Miscellaneous library header files.
+
+#include <boost/filesystem.hpp>
+
+  // WCL header files
+
+#include "include/gapIndex.h"
+#include "include/timestamp.h"
+
+namespace WCL
+{
+  class CDatabaseSQLite;
+
+  struct SStoreWatermark
+  {
+    std::int64_t archiveRows = 0;           ///< Largest rowid of TBL_ARCHIVE.
+    std::int64_t summaryRows = 0;           ///< Largest rowid of TBL_DAYSUMMARY.
+
+    bool operator==(SStoreWatermark const &rhs) const
+    {
+      return (archiveRows == rhs.archiveRows) && (summaryRows == rhs.summaryRows);
+    }
+    bool operator!=(SStoreWatermark const &rhs) const { return !(*this == rhs); }
+  };
+
+  struct SStationState
+  {
+    bool hasLast = false;                   ///< false if the station has no archive records.
+    std::uint16_t lastMJD = 0;
+    std::uint16_t lastTime = 0;             ///< HHMM
+    std::vector<std::uint32_t> summaryDays; ///< MJD of the days with a daily summary, in order.
+    CGapIndex gaps;
+
+    explicit SStationState(int interval) : gaps(interval) {}
+
+    bool summaryExists(std::uint32_t) const;
+  };
+
+  class CStationCache
+  {
+  public:
+    static std::uint32_t const VERSION = 1;
+
+  private:
+    boost::filesystem::path snapshotFile_;
+    std::chrono::seconds saveInterval_;
+    std::chrono::steady_clock::time_point lastSave_;
+    int interval_;
+    std::map<std::pair<unsigned long, unsigned long>, SStationState> stations_;
+    bool modified_ = false;
+
+    CStationCache(CStationCache const &) = delete;
+    CStationCache &operator=(CStationCache const &) = delete;
+
+  public:
+    CStationCache(boost::filesystem::path const &, std::chrono::seconds = std::chrono::seconds(300), int = 5);
+
+    boost::filesystem::path const &snapshotFile() const { return snapshotFile_; }
+    std::size_t size() const { return stations_.size(); }
+    bool modified() const { return modified_; }
+
+    void clear();
+    SStationState const *find(unsigned long siteID, unsigned long instrumentID) const;
+    void build(CDatabaseSQLite &, unsigned long siteID, unsigned long instrumentID, TTimestamp, TTimestamp);
+
+    void archiveInserted(unsigned long siteID, unsigned long instrumentID, std::uint32_t);
+    void summaryInserted(unsigned long siteID, unsigned long instrumentID, std::uint32_t);
+
+    bool load(CDatabaseSQLite &);
+    bool save(CDatabaseSQLite &);
+    bool saveIfDue(CDatabaseSQLite &);
+  };
+
+} // namespace WCL
+
+#endif // WCL_STATIONCACHE_H
@@ -0,0 +1,173 @@
+﻿//*********************************************************************************************************************************
+//
+// PROJECT:							Weather Class Library (WCL)
+// FILE:								streamMerge
+// SUBSYSTEM:						Merging of the .wlk and console archive streams
+// LANGUAGE:						C++
+// TARGET OS:						WINDOWS/UNIX/LINUX/MAC
+// LIBRARY DEPENDANCE:	boost::filesystem
+// NAMESPACE:						WCL
+// AUTHOR:							Gavin Blakeman.
+// LICENSE:             GPLv2
+//
+//                      Copyright 2026 Gavin Blakeman.
+//                      This file is part of the Weather Class Library (WCL).
+//
+//                      WCL is free software: you can redistribute it and/or modify it under the terms of the GNU General
+//                      Public License as published by the Free Software Foundation, either version 2 of the License, or (at your
+//                      option) any later version.
+//
+//                      WCL is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the
+//                      implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//                      for more details.
+//
+//                      You should have received a copy of the GNU General Public License along with WCL.  If not, see
+//                      <http://www.gnu.org/licenses/>.
+//
+// OVERVIEW:						The same observations arrive from the .wlk files and from the console archive downloads. The sources are
+//                      merged on a common timestamp (minutes since 1970-01-01 00:00) with a heap holding the head of each source.
+//                      When more than one source has a record for the same minute, the record of the source with the highest
+//                      precedence is kept (the first source added if the precedence is equal) and the others are dropped. The
+//                      output is strictly increasing in time, so the store sees each row once and in key order.
+//                      Each source must deliver its records in time order. Records that are not after the last record emitted
+//                      are discarded.
+//
+// CLASSES INCLUDED:    CMergeSource
+//                      CWlkFileSource
+//                      CArchiveRecordSource
+//                      CStreamMerge
+//
+// CLASS HIERARCHY:     CMergeSource
+//                        - CWlkFileSource
+//                        - CArchiveRecordSource
+//                      CStreamMerge
+//
+// HISTORY:             2026-10-19 GGB - File Created
+//
+//*********************************************************************************************************************************
+
+#ifndef WCL_STREAMMERGE_H
+#define WCL_STREAMMERGE_H
+
+  // Standard C++ Library header files.
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+  // Miscellanous library header files.
+
+#include <boost/filesystem.hpp>
+
+  // WCL header files
+
+#include "include/WeatherLink.h"
+#include "include/WeatherLinkIP.h"
+#include "include/weatherStore.h"
+
+namespace WCL
+{
+  struct SMergedRecord
+  {
+    std::int64_t minute;                  ///< Minutes since 1970-01-01 00:00.
+    int year;
+    int month;
+    int day;
+    std::size_t source;                   ///< Index of the source the record was taken from.
+    bool console;                         ///< true - archiveRecord is valid. false - weatherRecord is valid.
+    SWeatherDataRecord weatherRecord;
+    SArchiveRecord archiveRecord;
+  };
+
+  /// @brief Interface for a source of records in time order.
+
+  class CMergeSource
+  {
+  public:
+    virtual ~CMergeSource() {}
+
+    virtual bool next(SMergedRecord &) = 0;
+  };
+
+  /// @brief Reads the archive records from a set of .wlk files. The records of each day are sorted by time.
+
+  class CWlkFileSource : public CMergeSource
+  {
+  private:
+    std::vector<boost::filesystem::path> files_;
+    std::size_t fileIndex_ = 0;
+    std::unique_ptr<CWeatherLinkDatabaseFile> file_;
+    int year_ = 0;
+    int month_ = 0;
+    int day_ = 0;
+    std::vector<SWeatherDataRecord> dayRecords_;
+    std::size_t recordIndex_ = 0;
+
+    bool nextDay();
+
+  public:
+    CWlkFileSource(std::vector<boost::filesystem::path> const &);
+    CWlkFileSource(boost::filesystem::path const &);
+
+    virtual bool next(SMergedRecord &) override;
+  };
+
+  /// @brief Delivers console archive records (from DMP/DMPAFT downloads). The records are sorted by time on construction and
+  ///        records with an invalid date or time are dropped.
+
+  class CArchiveRecordSource : public CMergeSource
+  {
+  private:
+    std::vector<SArchiveRecord> records_;
+    std::size_t recordIndex_ = 0;
+
+  public:
+    CArchiveRecordSource(std::vector<SArchiveRecord> const &);
+    CArchiveRecordSource(SArchiveRecord const *, std::size_t);
+
+    virtual bool next(SMergedRecord &) override;
+
+    static bool timestamp(SArchiveRecord const &, std::int64_t &);
+  };
+
+  class CStreamMerge
+  {
+  public:
+    typedef std::function<void(SMergedRecord const &)> callback_t;
+
+  private:
+    struct SSource
+    {
+      std::unique_ptr<CMergeSource> source;
+      int precedence;
+      SMergedRecord head;
+      bool valid;
+    };
+
+    std::vector<SSource> sources_;
+    std::vector<std::size_t> heap_;       ///< Indexes of the sources with a valid head, as a heap ordered by time.
+    bool started_ = false;
+    bool haveLast_ = false;
+    std::int64_t lastMinute_ = 0;
+    std::size_t duplicates_ = 0;
+    std::size_t discarded_ = 0;
+
+    bool before(std::size_t, std::size_t) const;
+    void advance(std::size_t);
+
+  public:
+    std::size_t addSource(std::unique_ptr<CMergeSource>, int precedence = 0);
+
+    bool next(SMergedRecord &);
+    std::size_t run(callback_t);
+    std::size_t run(CWeatherStore &, unsigned long siteID, unsigned long instrumentID);
+
+    std::size_t duplicates() const { return duplicates_; }
+    std::size_t discarded() const { return discarded_; }
+  };
+
+} // namespace WCL
+
+#endif // WCL_STREAMMERGE_H
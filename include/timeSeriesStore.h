@@ -0,0 +1,170 @@
+﻿//*********************************************************************************************************************************
+//
+// PROJECT:							Weather Class Library (WCL)
+// FILE:								timeSeriesStore
+// SUBSYSTEM:						Embedded append-only storage engine
+// LANGUAGE:						C++
+// TARGET OS:						WINDOWS/UNIX/LINUX/MAC
+// LIBRARY DEPENDANCE:	Boost, ACL
+// NAMESPACE:						WCL
+// AUTHOR:							Gavin Blakeman.
+// LICENSE:             GPLv2
+//
+//                      Copyright 2026 Gavin Blakeman.
+//                      This file is part of the Weather Class Library (WCL).
+//
+//                      WCL is free software: you can redistribute it and/or modify it under the terms of the GNU General
+//                      Public License as published by the Free Software Foundation, either version 2 of the License, or (at your
+//                      option) any later version.
+//
+//                      WCL is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the
+//                      implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//                      for more details.
+//
+//                      You should have received a copy of the GNU General Public License along with WCL.  If not, see
+//                      <http://www.gnu.org/licenses/>.
+//
+// OVERVIEW:						Implements a storage backend that does not need a database server. The observations for each
+//                      (site, instrument) pair are stored in a directory of append-only segment files. Each record is a fixed
+//                      size and is keyed by MJD * 10000 + HHMM.
+//                      The segment being written is held in memory as well as being appended to the file. When it is full it is
+//                      sealed and read through a memory mapping with a sparse index of every STRIDE'th key. A background thread
+//                      compacts sealed segments that are small or out of order into larger sorted segments.
+//                      Records are stored in host byte order. Each record is validated before it is appended, and invalid values
+//                      are stored as NaN or the CRecordValidator missing markers.
+//
+// CLASSES INCLUDED:    CTimeSeriesStore
+//
+// CLASS HIERARCHY:     CWeatherStore
+//                        - CTimeSeriesStore
+//
+// HISTORY:             2026-10-19 GGB - File Created
+//
+//*********************************************************************************************************************************
+
+#ifndef WCL_TIMESERIESSTORE_H
+#define WCL_TIMESERIESSTORE_H
+
+  // Standard C++ Library header files.
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+  // Miscellanous library header files.
+
+#include <ACL>
+#include <boost/filesystem.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+  // WCL header files
+
+#include "include/observation.h"
+#include "include/validation.h"
+#include "include/weatherStore.h"
+
+namespace WCL
+{
+  class CTimeSeriesStore : public CWeatherStore
+  {
+  public:
+    typedef std::pair<unsigned long, unsigned long> seriesKey_t;
+
+  private:
+    static std::size_t const STRIDE = 128;
+
+    struct SSegment
+    {
+      boost::filesystem::path fileName;
+      std::size_t recordCount = 0;
+      std::uint32_t minKey = 0xFFFFFFFF;
+      std::uint32_t maxKey = 0;
+      bool sorted = true;
+      bool obsolete = false;
+      std::vector<std::uint32_t> sparseIndex;                   ///< Every STRIDE'th key (sorted segments only).
+      std::unique_ptr<boost::interprocess::file_mapping> mapping;
+      std::unique_ptr<boost::interprocess::mapped_region> region;
+
+      ~SSegment();
+      STimeSeriesRecord const *records() const;
+      void append(STimeSeriesRecord const &);
+      bool find(std::uint32_t) const;
+      void range(std::uint32_t, std::uint32_t, std::vector<STimeSeriesRecord> &) const;
+    };
+    typedef std::shared_ptr<SSegment> segmentPtr_t;
+
+    struct SSeries
+    {
+      std::mutex seriesMutex;
+      boost::filesystem::path directory;
+      std::vector<segmentPtr_t> sealed;
+      std::vector<STimeSeriesRecord> activeRecords;
+      std::vector<std::uint32_t> activeKeys;                    ///< Sorted keys of the active segment.
+      std::ofstream activeFile;
+      std::uint32_t activeNumber = 0;
+      std::uint32_t nextNumber = 1;
+      std::uint32_t lastKey = 0;
+      bool hasLast = false;
+      bool compacting = false;
+      CRecordValidator validator;
+    };
+
+    boost::filesystem::path rootDirectory_;
+    std::size_t maxSegmentRecords_;
+    std::mutex storeMutex_;
+    std::map<seriesKey_t, std::unique_ptr<SSeries>> series_;
+
+    std::thread compactionThread_;
+    std::mutex compactionMutex_;
+    std::condition_variable compactionCondition_;
+    std::atomic<bool> stopCompaction_;
+    bool compactionRequested_ = false;
+    std::chrono::seconds compactionInterval_;
+
+    CTimeSeriesStore(CTimeSeriesStore const &) = delete;
+    CTimeSeriesStore &operator=(CTimeSeriesStore const &) = delete;
+
+    SSeries &series(unsigned long, unsigned long);
+    void loadSeries(SSeries &);
+    segmentPtr_t loadSegment(boost::filesystem::path const &);
+    segmentPtr_t writeSegment(SSeries &, std::vector<STimeSeriesRecord> const &);
+    void openActive(SSeries &);
+    void sealActive(SSeries &);
+    bool existsLocked(SSeries &, std::uint32_t) const;
+    bool append(unsigned long, unsigned long, STimeSeriesRecord const &);
+    void compactSeries(SSeries &);
+    void compactionLoop();
+
+  public:
+    CTimeSeriesStore(boost::filesystem::path const &, std::size_t = 8192, std::chrono::seconds = std::chrono::seconds(60));
+    virtual ~CTimeSeriesStore();
+
+    virtual bool insertRecord(unsigned long siteID, unsigned long instrumentID, SArchiveRecord &) override;
+    virtual bool insertRecord(unsigned long siteID, unsigned long instrumentID, SWeatherDataRecord const &, ACL::TJD const &) override;
+    virtual bool lastWeatherRecord(unsigned long siteID, unsigned long instrumentID, std::uint16_t &, std::uint16_t &) override;
+    virtual bool recordExists(unsigned long siteID, unsigned long instrumentID, ACL::TJD, std::uint16_t) override;
+
+    bool insertRecord(unsigned long siteID, unsigned long instrumentID, STimeSeriesRecord const &);
+    std::size_t readRange(unsigned long siteID, unsigned long instrumentID, std::uint32_t, std::uint32_t,
+                          std::vector<STimeSeriesRecord> &);
+
+    void flush();
+    void compact();
+
+    static bool convert(SArchiveRecord const &, STimeSeriesRecord &);
+    static void convert(SWeatherDataRecord const &, std::uint32_t, STimeSeriesRecord &);
+  };
+
+} // namespace WCL
+
+#endif // WCL_TIMESERIESSTORE_H
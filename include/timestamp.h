@@ -0,0 +1,161 @@
+﻿//*********************************************************************************************************************************
+//
+// PROJECT:							Weather Class Library (WCL)
+// FILE:								timestamp
+// SUBSYSTEM:						Integer timestamps
+// LANGUAGE:						C++
+// TARGET OS:						WINDOWS/UNIX/LINUX/MAC
+// LIBRARY DEPENDANCE:	None.
+// NAMESPACE:						WCL
+// AUTHOR:							Gavin Blakeman.
+// LICENSE:             GPLv2
+//
+//                      Copyright 2026 Gavin Blakeman.
+//                      This file is part of the Weather Class Library (WCL).
+//
+//                      WCL is free software: you can redistribute it and/or modify it under the terms of the GNU General
+//                      Public License as published by the Free Software Foundation, either version 2 of the License, or (at your
+//                      option) any later version.
+//
+//                      WCL is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the
+//                      implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//                      for more details.
+//
+//                      You should have received a copy of the GNU General Public License along with WCL.  If not, see
+//                      <http://www.gnu.org/licenses/>.
+//
+// OVERVIEW:						A timestamp held as a 32 bit count of minutes since 1970-01-01 00:00. The archive records have a
+//                      resolution of one minute, and 32 bits cover +-4000 years, so the timestamp can be sorted, compared and
+//                      differenced as an integer. The calendar conversions use the proleptic Gregorian calendar (H. Hinnant's
+//                      days_from_civil and civil_from_days algorithms) and are constexpr.
+//                      The (MJD, TIME) pair used by the database tables can be formed with MJD() and HHMM().
+//                      The batch decoders convert a block of console archive records (SDate and HHMM time) or the records of a
+//                      day of a .wlk file (day index and packed time) to timestamps without an ACL::TJD per record.
+//
+// CLASSES INCLUDED:    TTimestamp
+//
+// CLASS HIERARCHY:     TTimestamp
+//
+// HISTORY:             2026-10-19 GGB - File Created
+//
+//*********************************************************************************************************************************
+
+#ifndef WCL_TIMESTAMP_H
+#define WCL_TIMESTAMP_H
+
+  // Standard C++ Library header files.
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+  // WCL header files
+
+#include "include/WeatherLink.h"
+#include "include/WeatherLinkIP.h"
+
+namespace WCL
+{
+  class TTimestamp
+  {
+  public:
+    typedef std::int32_t value_type;
+
+    static constexpr value_type INVALID = std::numeric_limits<value_type>::min();
+    static constexpr std::int32_t MJD_EPOCH = 40587;          ///< MJD of 1970-01-01.
+    static constexpr std::int32_t MINUTES_PER_DAY = 1440;
+
+  private:
+    value_type minutes_;
+
+  public:
+    constexpr TTimestamp() : minutes_(INVALID) {}
+    constexpr explicit TTimestamp(value_type minutes) : minutes_(minutes) {}
+    constexpr TTimestamp(int year, int month, int day, int hour = 0, int minute = 0)
+      : minutes_(daysFromCivil(year, month, day) * MINUTES_PER_DAY + hour * 60 + minute) {}
+
+    /// @brief Returns the timestamp for an MJD and a time in HHMM format.
+
+    static constexpr TTimestamp fromMJD(std::int32_t MJD, std::uint16_t HHMM)
+    {
+      return TTimestamp((MJD - MJD_EPOCH) * MINUTES_PER_DAY + HHMMToMinutes(HHMM));
+    }
+
+    /// @brief Returns the number of days since 1970-01-01.
+
+    static constexpr std::int32_t daysFromCivil(int year, int month, int day)
+    {
+      year -= (month <= 2) ? 1 : 0;
+
+      std::int32_t era = (year >= 0 ? year : year - 399) / 400;
+      std::uint32_t yoe = static_cast<std::uint32_t>(year - era * 400);
+      std::uint32_t doy = static_cast<std::uint32_t>((153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1);
+      std::uint32_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+
+      return era * 146097 + static_cast<std::int32_t>(doe) - 719468;
+    }
+
+    /// @brief Returns the date for a number of days since 1970-01-01.
+
+    static constexpr void civilFromDays(std::int32_t days, int &year, int &month, int &day)
+    {
+      days += 719468;
+
+      std::int32_t era = (days >= 0 ? days : days - 146096) / 146097;
+      std::uint32_t doe = static_cast<std::uint32_t>(days - era * 146097);
+      std::uint32_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+      std::uint32_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+      std::uint32_t mp = (5 * doy + 2) / 153;
+
+      day = static_cast<int>(doy - (153 * mp + 2) / 5 + 1);
+      month = static_cast<int>(mp < 10 ? mp + 3 : mp - 9);
+      year = static_cast<int>(yoe) + era * 400 + (month <= 2 ? 1 : 0);
+    }
+
+    /// @brief Converts a time in HHMM format to minutes since midnight.
+
+    static constexpr int HHMMToMinutes(std::uint16_t HHMM) { return (HHMM / 100) * 60 + HHMM % 100; }
+
+    /// @brief Converts a .wlk packed time (minutes since midnight) to HHMM format.
+
+    static constexpr std::uint16_t packedTimeToHHMM(int packedTime)
+    {
+      return static_cast<std::uint16_t>((packedTime / 60) * 100 + packedTime % 60);
+    }
+
+    constexpr bool valid() const { return minutes_ != INVALID; }
+    constexpr value_type minutes() const { return minutes_; }
+    constexpr std::int32_t days() const
+    {
+      return (minutes_ >= 0) ? minutes_ / MINUTES_PER_DAY : (minutes_ - (MINUTES_PER_DAY - 1)) / MINUTES_PER_DAY;
+    }
+    constexpr int minuteOfDay() const { return static_cast<int>(minutes_ - days() * MINUTES_PER_DAY); }
+    constexpr std::int32_t MJD() const { return days() + MJD_EPOCH; }
+    constexpr std::uint16_t HHMM() const { return static_cast<std::uint16_t>((minuteOfDay() / 60) * 100 + minuteOfDay() % 60); }
+    constexpr void date(int &year, int &month, int &day) const { civilFromDays(days(), year, month, day); }
+
+    constexpr TTimestamp operator+(value_type minutes) const { return TTimestamp(minutes_ + minutes); }
+    constexpr TTimestamp operator-(value_type minutes) const { return TTimestamp(minutes_ - minutes); }
+    constexpr value_type operator-(TTimestamp const &rhs) const { return minutes_ - rhs.minutes_; }
+
+    constexpr bool operator==(TTimestamp const &rhs) const { return minutes_ == rhs.minutes_; }
+    constexpr bool operator!=(TTimestamp const &rhs) const { return minutes_ != rhs.minutes_; }
+    constexpr bool operator<(TTimestamp const &rhs) const { return minutes_ < rhs.minutes_; }
+    constexpr bool operator<=(TTimestamp const &rhs) const { return minutes_ <= rhs.minutes_; }
+    constexpr bool operator>(TTimestamp const &rhs) const { return minutes_ > rhs.minutes_; }
+    constexpr bool operator>=(TTimestamp const &rhs) const { return minutes_ >= rhs.minutes_; }
+
+    static TTimestamp decode(SArchiveRecord const &);
+    static std::size_t decode(SArchiveRecord const *, std::size_t, TTimestamp *);
+    static void decode(int year, int month, int day, SWeatherDataRecord const *, std::size_t, TTimestamp *);
+  };
+
+  static_assert(sizeof(TTimestamp) == sizeof(std::int32_t), "TTimestamp must be 32 bits.");
+  static_assert(TTimestamp(1970, 1, 1).minutes() == 0, "Epoch must be 1970-01-01 00:00.");
+  static_assert(TTimestamp(2000, 1, 1).MJD() == 51544, "MJD of 2000-01-01 must be 51544.");
+  static_assert(TTimestamp(2024, 2, 29, 23, 59).HHMM() == 2359, "HHMM conversion error.");
+  static_assert(TTimestamp(1969, 12, 31, 23, 0).days() == -1, "Days must round towards negative infinity.");
+
+} // namespace WCL
+
+#endif // WCL_TIMESTAMP_H
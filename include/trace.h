@@ -0,0 +1,106 @@
+﻿//*********************************************************************************************************************************
+//
+// PROJECT:							Weather Class Library (WCL)
+// FILE:								trace
+// SUBSYSTEM:						Span tracing in Chrome trace format
+// LANGUAGE:						C++
+// TARGET OS:						WINDOWS/UNIX/LINUX/MAC
+// LIBRARY DEPENDANCE:	None.
+// NAMESPACE:						WCL
+// AUTHOR:							Gavin Blakeman.
+// LICENSE:             GPLv2
+//
+//                      Copyright 2026 Gavin Blakeman.
+//                      This file is part of the Weather Class Library (WCL).
+//
+//                      WCL is free software: you can redistribute it and/or modify it under the terms of the GNU General
+//                      Public License as published by the Free Software Foundation, either version 2 of the License, or (at your
+//                      option) any later version.
+//
+//                      WCL is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the
+//                      implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//                      for more details.
+//
+//                      You should have received a copy of the GNU General Public License along with WCL.  If not, see
+//                      <http://www.gnu.org/licenses/>.
+//
+// OVERVIEW:						Records timed spans (start and end time of a scope) so that the overlap of downloading, decoding, converting
+//                      and inserting can be seen on a timeline. The spans are written with the WCL_TRACE_SPAN() macro, which
+//                      creates a CTraceSpan that records the span when the scope exits.
+//                      Each thread records into its own ring buffer, so recording takes no lock. When a buffer is full the oldest
+//                      spans are overwritten. dump() writes the spans of all the threads as Chrome trace JSON, which can be loaded
+//                      into chrome://tracing or Perfetto. dump() may be called while the threads are still recording.
+//                      The buffer of a thread that has exited is released once its spans have been dumped or cleared.
+//                      Tracing is compiled in when WCL_TRACING is defined (qmake CONFIG+=wcl_tracing). Otherwise the macros
+//                      expand to nothing and cost nothing.
+//
+// CLASSES INCLUDED:    CTrace
+//                      CTraceSpan
+//
+// CLASS HIERARCHY:     CTrace
+//                      CTraceSpan
+//
+// HISTORY:             2026-10-19 GGB - File Created
+//
+//*********************************************************************************************************************************
+
+#ifndef WCL_TRACE_H
+#define WCL_TRACE_H
+
+  // Standard C++ Library header files.
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+  // Miscellanous library header files.
+
+#include <boost/filesystem.hpp>
+
+namespace WCL
+{
+  class CTrace
+  {
+  public:
+    static std::size_t const EVENTS_PER_THREAD = 32768;   ///< Size of the ring buffer of each thread. Must be a power of 2.
+
+    static std::int64_t now() noexcept;
+    static void record(char const *, char const *, std::int64_t, std::int64_t) noexcept;
+    static void threadName(std::string const &);
+
+    static std::size_t dump(std::FILE *);
+    static std::size_t dump(boost::filesystem::path const &);
+    static void clear();
+  };
+
+  class CTraceSpan
+  {
+  private:
+    char const *category_;
+    char const *name_;
+    std::int64_t start_;
+
+    CTraceSpan(CTraceSpan const &) = delete;
+    CTraceSpan &operator=(CTraceSpan const &) = delete;
+
+  public:
+      /// @brief      Starts a span. The category and name must be string literals.
+
+    CTraceSpan(char const *category, char const *name) noexcept : category_(category), name_(name), start_(CTrace::now()) {}
+    ~CTraceSpan() { CTrace::record(category_, name_, start_, CTrace::now()); }
+  };
+
+} // namespace WCL
+
+#ifdef WCL_TRACING
+#define WCL_TRACE_CONCAT_(a, b) a##b
+#define WCL_TRACE_CONCAT(a, b) WCL_TRACE_CONCAT_(a, b)
+#define WCL_TRACE_SPAN(category, name) WCL::CTraceSpan WCL_TRACE_CONCAT(traceSpan_, __LINE__)((category), (name))
+#define WCL_TRACE_THREAD(name) WCL::CTrace::threadName(name)
+#else
+#define WCL_TRACE_SPAN(category, name)
+#define WCL_TRACE_THREAD(name)
+#endif
+
+#endif // WCL_TRACE_H
@@ -0,0 +1,258 @@
+﻿//*********************************************************************************************************************************
+//
+// PROJECT:							Weather Class Library (WCL)
+// FILE:								unitTransform
+// SUBSYSTEM:						Compile time unit conversions
+// LANGUAGE:						C++
+// TARGET OS:						WINDOWS/UNIX/LINUX/MAC
+// LIBRARY DEPENDANCE:	None.
+// NAMESPACE:						WCL
+// AUTHOR:							Gavin Blakeman.
+// LICENSE:             GPLv2
+//
+//                      Copyright 2026 Gavin Blakeman.
+//                      This file is part of the Weather Class Library (WCL).
+//
+//                      WCL is free software: you can redistribute it and/or modify it under the terms of the GNU General
+//                      Public License as published by the Free Software Foundation, either version 2 of the License, or (at your
+//                      option) any later version.
+//
+//                      WCL is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the
+//                      implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//                      for more details.
+//
+//                      You should have received a copy of the GNU General Public License along with WCL.  If not, see
+//                      <http://www.gnu.org/licenses/>.
+//
+// OVERVIEW:						Unit conversions as affine transforms (a * x + b) that are composed at compile time.
+//                      Every unit is described by its transform to the SI unit of its dimension, so the conversion between any
+//                      two units of a dimension is the transform to SI followed by the inverse of the other. The raw scale of a
+//                      field in the wire tables (wireFormat.h) is folded into the same transform, so converting a raw value from
+//                      a file or the console to any unit is one multiply and one add with constants, without the run time
+//                      dispatch on the unit of a PCL::convert() call.
+//                      The transforms use the same definitions of the units as PCL (1 inHg = 3386.389 Pa, 1 mph = 0.44704 m/s,
+//                      1 in = 25.4 mm, T(K) = (T(F) + 459.67) * 5/9). The scale and the conversion are folded into a single
+//                      multiply, so a result can differ from the PCL result (scale, then convert) in the last bits: by not
+//                      more than 1e-12 of the value.
+//
+// CLASSES INCLUDED:    SAffine
+//
+// CLASS HIERARCHY:     None.
+//
+// HISTORY:             2026-10-19 GGB - File Created
+//
+//*********************************************************************************************************************************
+
+#ifndef WCL_UNITTRANSFORM_H
+#define WCL_UNITTRANSFORM_H
+
+  // Standard C++ Library header files.
+
+#include <cstddef>
+#include <cstdint>
+
+  // WCL header files
+
+#include "include/wireFormat.h"
+
+namespace WCL
+{
+  enum EUnit
+  {
+    U_NONE,                         ///< Dimensionless or a unit that is not converted.
+    U_KELVIN,
+    U_CELSIUS,
+    U_FAHRENHEIT,
+    U_PASCAL,
+    U_HECTOPASCAL,
+    U_INHG,
+    U_METRE_PER_SECOND,
+    U_KILOMETRE_PER_HOUR,
+    U_MILE_PER_HOUR,
+    U_KNOT,
+    U_MILLIMETRE,
+    U_INCH,
+    U_MILLIMETRE_PER_HOUR,
+    U_INCH_PER_HOUR,
+    U_PERCENT
+  };
+
+  enum EDimension
+  {
+    D_NONE,
+    D_TEMPERATURE,
+    D_PRESSURE,
+    D_SPEED,
+    D_LENGTH,
+    D_RATE,
+    D_FRACTION
+  };
+
+  struct SAffine
+  {
+    double a;
+    double b;
+
+    constexpr double operator()(double x) const { return a * x + b; }
+
+    /// @brief Returns the transform that applies this transform and then another.
+
+    constexpr SAffine then(SAffine const &next) const { return SAffine{next.a * a, next.a * b + next.b}; }
+
+    /// @brief Returns the inverse transform.
+
+    constexpr SAffine inverse() const { return SAffine{1 / a, -b / a}; }
+  };
+
+  /// @brief Returns the dimension of a unit.
+
+  constexpr EDimension dimension(EUnit unit)
+  {
+    switch (unit)
+    {
+      case U_KELVIN:
+      case U_CELSIUS:
+      case U_FAHRENHEIT:
+        return D_TEMPERATURE;
+      case U_PASCAL:
+      case U_HECTOPASCAL:
+      case U_INHG:
+        return D_PRESSURE;
+      case U_METRE_PER_SECOND:
+      case U_KILOMETRE_PER_HOUR:
+      case U_MILE_PER_HOUR:
+      case U_KNOT:
+        return D_SPEED;
+      case U_MILLIMETRE:
+      case U_INCH:
+        return D_LENGTH;
+      case U_MILLIMETRE_PER_HOUR:
+      case U_INCH_PER_HOUR:
+        return D_RATE;
+      case U_PERCENT:
+        return D_FRACTION;
+      default:
+        return D_NONE;
+    };
+  }
+
+  /// @brief Returns the transform from a unit to the unit used for the dimension in the library. (K, Pa, m/s, mm, mm/h, %)
+
+  constexpr SAffine toSI(EUnit unit)
+  {
+    switch (unit)
+    {
+      case U_CELSIUS:
+        return SAffine{1, 273.15};
+      case U_FAHRENHEIT:
+        return SAffine{5.0 / 9.0, 459.67 * 5.0 / 9.0};
+      case U_HECTOPASCAL:
+        return SAffine{100, 0};
+      case U_INHG:
+        return SAffine{3386.389, 0};
+      case U_KILOMETRE_PER_HOUR:
+        return SAffine{1 / 3.6, 0};
+      case U_MILE_PER_HOUR:
+        return SAffine{0.44704, 0};
+      case U_KNOT:
+        return SAffine{1852.0 / 3600.0, 0};
+      case U_INCH:
+      case U_INCH_PER_HOUR:
+        return SAffine{25.4, 0};
+      default:
+        return SAffine{1, 0};
+    };
+  }
+
+  /// @brief Returns the transform between two units of the same dimension.
+
+  constexpr SAffine unitTransform(EUnit from, EUnit to)
+  {
+    return (from == to) ? SAffine{1, 0} : toSI(from).then(toSI(to).inverse());
+  }
+
+  /// @brief Returns the unit of a unit name used in the wire tables.
+
+  constexpr EUnit unitFromName(char const *name)
+  {
+    struct SName
+    {
+      char const *name;
+      EUnit unit;
+    };
+    constexpr SName names[] =
+    {
+      {"K", U_KELVIN}, {"C", U_CELSIUS}, {"F", U_FAHRENHEIT}, {"Pa", U_PASCAL}, {"hPa", U_HECTOPASCAL}, {"inHg", U_INHG},
+      {"m/s", U_METRE_PER_SECOND}, {"km/h", U_KILOMETRE_PER_HOUR}, {"mph", U_MILE_PER_HOUR}, {"kn", U_KNOT},
+      {"mm", U_MILLIMETRE}, {"in", U_INCH}, {"mm/h", U_MILLIMETRE_PER_HOUR}, {"in/h", U_INCH_PER_HOUR}, {"%", U_PERCENT}
+    };
+
+    for (SName const &entry : names)
+    {
+      std::size_t character = 0;
+
+      while ((name[character] != 0) && (name[character] == entry.name[character]))
+      {
+        character++;
+      };
+      if (name[character] == entry.name[character])
+      {
+        return entry.unit;
+      };
+    };
+
+    return U_NONE;
+  }
+
+  /// @brief Returns the transform from the raw value of a field of a wire structure to a unit.
+
+  template<typename T, std::size_t FIELD, EUnit TO>
+  constexpr SAffine wireTransform()
+  {
+    constexpr SWireField field = TWireLayout<T>::fields[FIELD];
+    constexpr EUnit from = unitFromName(field.unit);
+
+    static_assert(dimension(from) == dimension(TO), "The units of a transform must have the same dimension.");
+
+    return SAffine{field.scale, 0}.then(unitTransform(from, TO));
+  }
+
+  /// @brief Decodes a field of a wire structure and converts it to a unit.
+
+  template<typename T, std::size_t FIELD, EUnit TO>
+  constexpr double wireConvert(std::uint8_t const *record, std::size_t element = 0)
+  {
+    constexpr SAffine transform = wireTransform<T, FIELD, TO>();
+
+    return transform(static_cast<double>(wireValue<T, FIELD>(record, element)));
+  }
+
+  /// @brief Decodes a field of an array of wire structures into a column and converts it to a unit.
+
+  template<typename T, std::size_t FIELD, EUnit TO>
+  void wireColumnConvert(std::uint8_t const *records, std::size_t count, double *column, std::size_t element = 0)
+  {
+    for (std::size_t index = 0; index < count; index++)
+    {
+      column[index] = wireConvert<T, FIELD, TO>(records + index * TWireLayout<T>::SIZE, element);
+    };
+  }
+
+  /// @brief Converts a column of values between units.
+
+  inline void convertColumn(SAffine const &transform, double const *input, std::size_t count, double *output)
+  {
+    for (std::size_t index = 0; index < count; index++)
+    {
+      output[index] = transform(input[index]);
+    };
+  }
+
+  static_assert(unitTransform(U_FAHRENHEIT, U_CELSIUS)(212) > 99.999999 && unitTransform(U_FAHRENHEIT, U_CELSIUS)(212) < 100.000001,
+                "Temperature transform error.");
+  static_assert(unitTransform(U_KNOT, U_KILOMETRE_PER_HOUR)(1) > 1.851999 && unitTransform(U_KNOT, U_KILOMETRE_PER_HOUR)(1) < 1.852001,
+                "Speed transform error.");
+
+} // namespace WCL
+
+#endif // WCL_UNITTRANSFORM_H
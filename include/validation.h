@@ -0,0 +1,136 @@
+﻿//*********************************************************************************************************************************
+//
+// PROJECT:							Weather Class Library (WCL)
+// FILE:								validation
+// SUBSYSTEM:						Data quality validation of archive records
+// LANGUAGE:						C++
+// TARGET OS:						WINDOWS/UNIX/LINUX/MAC
+// LIBRARY DEPENDANCE:	None.
+// NAMESPACE:						WCL
+// AUTHOR:							Gavin Blakeman.
+// LICENSE:             GPLv2
+//
+//                      Copyright 2026 Gavin Blakeman.
+//                      This file is part of the Weather Class Library (WCL).
+//
+//                      WCL is free software: you can redistribute it and/or modify it under the terms of the GNU General
+//                      Public License as published by the Free Software Foundation, either version 2 of the License, or (at your
+//                      option) any later version.
+//
+//                      WCL is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the
+//                      implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//                      for more details.
+//
+//                      You should have received a copy of the GNU General Public License along with WCL.  If not, see
+//                      <http://www.gnu.org/licenses/>.
+//
+// OVERVIEW:						Validates blocks of time series records and produces a validity bitmap per field.
+//                      The Davis sentinels for a missing sensor (32767/-32768 for temperatures, 255 for humidity, wind and
+//                      direction, 0x7FFF for solar radiation) convert to values that are far outside the physical range of the
+//                      field, so the sentinels and the range limits are checked by the same compare. The compare is written so
+//                      that NaN also fails it.
+//                      The range test is a branch free loop over each field that produces a 64 bit word per 64 records, so the
+//                      compiler vectorises it. The spike (rate of change) test is then run on the valid values of the fields that
+//                      have a step limit, comparing each value against the last accepted value of the series. The validator
+//                      keeps the last accepted values so that blocks of the same series can be validated in sequence.
+//                      The bitmaps have the same layout as an Arrow validity buffer (bit n of the little endian words is row n).
+//                      apply() writes the result back into the records: invalid real values become NaN and invalid integer
+//                      values become the MISSING_ markers. The writers store both as NULL.
+//
+// CLASSES INCLUDED:    SFieldLimits
+//                      SValidity
+//                      CRecordValidator
+//
+// CLASS HIERARCHY:     CRecordValidator
+//
+// HISTORY:             2026-10-19 GGB - File Created
+//
+//*********************************************************************************************************************************
+
+#ifndef WCL_VALIDATION_H
+#define WCL_VALIDATION_H
+
+  // Standard C++ Library header files.
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace WCL
+{
+  struct STimeSeriesRecord;
+
+  enum EValidatedField
+  {
+    VF_OUTSIDE_TEMP,
+    VF_HI_OUTSIDE_TEMP,
+    VF_LOW_OUTSIDE_TEMP,
+    VF_INSIDE_TEMP,
+    VF_BAROMETER,
+    VF_OUTSIDE_HUMIDITY,
+    VF_INSIDE_HUMIDITY,
+    VF_RAIN,
+    VF_HI_RAIN_RATE,
+    VF_WIND_SPEED,
+    VF_HI_WIND_SPEED,
+    VF_WIND_DIRECTION,
+    VF_SOLAR_RAD,
+    VF_HI_SOLAR_RAD,
+    VF_UV,
+    VF_HI_UV,
+    VF_COUNT
+  };
+
+  struct SFieldLimits
+  {
+    double minimum;
+    double maximum;
+    double step;                ///< Largest change between records 5 minutes apart. Zero disables the spike test.
+  };
+
+  struct SValidity
+  {
+    std::size_t count = 0;
+    std::array<std::vector<std::uint64_t>, VF_COUNT> words;
+    std::array<std::size_t, VF_COUNT> nulls{};
+
+    void resize(std::size_t);
+    bool valid(EValidatedField field, std::size_t row) const { return ((words[field][row / 64] >> (row % 64)) & 1) != 0; }
+  };
+
+  class CRecordValidator
+  {
+  public:
+    static std::uint16_t const MISSING_DIRECTION = 0xFF;
+    static std::uint16_t const MISSING_SOLAR = 0x7FFF;
+    static std::uint8_t const MISSING_UV = 0xFF;
+    static std::int32_t const SPIKE_WINDOW = 60;        ///< Records further apart (minutes) are not spike tested.
+
+  private:
+    std::array<SFieldLimits, VF_COUNT> limits_;
+    std::array<double, VF_COUNT> lastValue_;
+    std::int32_t lastTime_[VF_COUNT];
+    SValidity validity_;
+
+    void spikeTest(STimeSeriesRecord const *, std::size_t, std::size_t, SValidity &);
+
+  public:
+    CRecordValidator();
+
+    SFieldLimits const &limits(EValidatedField field) const { return limits_[field]; }
+    void limits(EValidatedField, SFieldLimits const &);
+    void reset();
+
+    std::size_t validate(STimeSeriesRecord const *, std::size_t, SValidity &);
+    std::size_t validate(STimeSeriesRecord *, std::size_t);
+    bool validate(STimeSeriesRecord &);
+
+    static std::size_t missing(STimeSeriesRecord const *, std::size_t, SValidity &);
+    static bool missing(STimeSeriesRecord const &, EValidatedField);
+    static void apply(STimeSeriesRecord *, std::size_t, SValidity const &);
+  };
+
+} // namespace WCL
+
+#endif // WCL_VALIDATION_H
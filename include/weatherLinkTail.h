@@ -0,0 +1,128 @@
+﻿//*********************************************************************************************************************************
+//
+// PROJECT:							Weather Class Library (WCL)
+// FILE:								weatherLinkTail
+// SUBSYSTEM:						Incremental reading of the current .wlk file
+// LANGUAGE:						C++
+// TARGET OS:						WINDOWS/UNIX/LINUX/MAC
+// LIBRARY DEPENDANCE:	boost::filesystem
+// NAMESPACE:						WCL
+// AUTHOR:							Gavin Blakeman.
+// LICENSE:             GPLv2
+//
+//                      Copyright 2026 Gavin Blakeman.
+//                      This file is part of the Weather Class Library (WCL).
+//
+//                      WCL is free software: you can redistribute it and/or modify it under the terms of the GNU General
+//                      Public License as published by the Free Software Foundation, either version 2 of the License, or (at your
+//                      option) any later version.
+//
+//                      WCL is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the
+//                      implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//                      for more details.
+//
+//                      You should have received a copy of the GNU General Public License along with WCL.  If not, see
+//                      <http://www.gnu.org/licenses/>.
+//
+// OVERVIEW:						Follows the .wlk file that the WeatherLink software is appending to. When the file changes, only the header
+//                      block is re-read. The day index entries are compared with the previous header and only the records
+//                      after the last (day, archive index) that was delivered are decoded.
+//                      On Linux the thread blocks on inotify events for the directory of the file, so the process is idle until
+//                      the file is written. On other platforms the file size and modification time are polled.
+//                      When the file for the following month appears, the remainder of the current file is read and the tail
+//                      moves to the new file.
+//
+// CLASSES INCLUDED:    CWeatherLinkTail
+//
+// CLASS HIERARCHY:     CWeatherLinkTail
+//
+// HISTORY:             2026-10-19 GGB - File Created
+//
+//*********************************************************************************************************************************
+
+#ifndef WCL_WEATHERLINKTAIL_H
+#define WCL_WEATHERLINKTAIL_H
+
+  // Standard C++ Library header files.
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <ctime>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+  // Miscellanous library header files.
+
+#include <ACL>
+#include <boost/filesystem.hpp>
+
+  // WCL header files
+
+#include "include/WeatherLink.h"
+#include "include/weatherStore.h"
+
+namespace WCL
+{
+  class CWeatherLinkTail
+  {
+  public:
+    typedef std::function<void(ACL::TJD const &, SWeatherDataRecord const &)> callback_t;
+
+  private:
+    boost::filesystem::path fileName_;
+    callback_t callback_;
+    std::unique_ptr<CWeatherLinkDatabaseFile> file_;
+    int year_ = 0;
+    int month_ = 0;
+    SHeaderBlock previousHeader_;
+    bool havePreviousHeader_ = false;
+    int day_ = 0;                               ///< Day of the last record delivered.
+    int archiveIndex_ = -1;                     ///< Archive index of the last record delivered.
+    std::vector<SWeatherDataRecord> buffer_;
+    std::atomic<std::uint64_t> records_;
+    std::chrono::milliseconds settle_;
+    std::chrono::milliseconds pollInterval_;
+    std::thread thread_;
+    std::atomic<bool> stop_;
+    std::mutex stopMutex_;
+    std::condition_variable stopCondition_;
+    int inotifyFD_ = -1;
+    int stopFD_ = -1;
+    std::uintmax_t lastSize_ = 0;
+    std::time_t lastWriteTime_ = 0;
+
+    CWeatherLinkTail(CWeatherLinkTail const &) = delete;
+    CWeatherLinkTail &operator=(CWeatherLinkTail const &) = delete;
+
+    bool openFile();
+    boost::filesystem::path nextFile() const;
+    std::size_t readDay(int, int);
+    void tail();
+    bool waitForChange();
+
+  public:
+    CWeatherLinkTail(boost::filesystem::path const &, callback_t);
+    CWeatherLinkTail(boost::filesystem::path const &, CWeatherStore &, unsigned long siteID, unsigned long instrumentID);
+    virtual ~CWeatherLinkTail();
+
+    void position(int day, int archiveIndex);
+    void settleTime(std::chrono::milliseconds settle) { settle_ = settle; }
+    void pollInterval(std::chrono::milliseconds interval) { pollInterval_ = interval; }
+
+    boost::filesystem::path const &fileName() const { return fileName_; }
+    std::uint64_t records() const { return records_; }
+
+    std::size_t update();
+
+    void start();
+    void stop();
+  };
+
+} // namespace WCL
+
+#endif // WCL_WEATHERLINKTAIL_H
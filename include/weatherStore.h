@@ -0,0 +1,81 @@
+﻿//*********************************************************************************************************************************
+//
+// PROJECT:							Weather Class Library (WCL)
+// FILE:								weatherStore
+// SUBSYSTEM:						Storage backend interface
+// LANGUAGE:						C++
+// TARGET OS:						WINDOWS/UNIX/LINUX/MAC
+// LIBRARY DEPENDANCE:	ACL
+// NAMESPACE:						WCL
+// AUTHOR:							Gavin Blakeman.
+// LICENSE:             GPLv2
+//
+//                      Copyright 2026 Gavin Blakeman.
+//                      This file is part of the Weather Class Library (WCL).
+//
+//                      WCL is free software: you can redistribute it and/or modify it under the terms of the GNU General
+//                      Public License as published by the Free Software Foundation, either version 2 of the License, or (at your
+//                      option) any later version.
+//
+//                      WCL is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the
+//                      implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//                      for more details.
+//
+//                      You should have received a copy of the GNU General Public License along with WCL.  If not, see
+//                      <http://www.gnu.org/licenses/>.
+//
+// OVERVIEW:						Defines the interface that all the archive storage backends implement. This allows the callers to store
+//                      archive records without knowing if the backend is an SQL database or an embedded store.
+//                      beginBatch() and endBatch() bracket a group of inserts that the backend may write as one transaction.
+//                      abortBatch() is called instead of endBatch() when an insert of the batch fails, and discards the inserts
+//                      of the batch if the backend can.
+//
+// CLASSES INCLUDED:    CWeatherStore
+//
+// CLASS HIERARCHY:     CWeatherStore
+//                        - CDatabase
+//                        - CDatabaseSQLite
+//                        - CPriorityWriter::CClassStore
+//                        - CShardedWriter
+//                        - CTimeSeriesStore
+//
+// HISTORY:             2026-10-19 GGB - File Created
+//
+//*********************************************************************************************************************************
+
+#ifndef WCL_WEATHERSTORE_H
+#define WCL_WEATHERSTORE_H
+
+  // Standard C++ Library header files.
+
+#include <cstdint>
+
+  // Miscellanous library header files.
+
+#include <ACL>
+
+  // WCL header files
+
+#include "include/WeatherLink.h"
+#include "include/WeatherLinkIP.h"
+
+namespace WCL
+{
+  class CWeatherStore
+  {
+  public:
+    virtual ~CWeatherStore() {}
+
+    virtual bool insertRecord(unsigned long siteID, unsigned long instrumentID, SArchiveRecord &) = 0;
+    virtual bool insertRecord(unsigned long siteID, unsigned long instrumentID, SWeatherDataRecord const &, ACL::TJD const &) = 0;
+    virtual bool lastWeatherRecord(unsigned long siteID, unsigned long instrumentID, std::uint16_t &, std::uint16_t &) = 0;
+    virtual bool recordExists(unsigned long siteID, unsigned long instrumentID, ACL::TJD, std::uint16_t) = 0;
+
+    virtual void beginBatch() {}
+    virtual void endBatch() {}
+    virtual void abortBatch() noexcept {}
+  };
+
+} // namespace WCL
+
+#endif // WCL_WEATHERSTORE_H
@@ -0,0 +1,148 @@
+﻿//*********************************************************************************************************************************
+//
+// PROJECT:							Weather Class Library (WCL)
+// FILE:								windRose
+// SUBSYSTEM:						Wind direction/speed histograms
+// LANGUAGE:						C++
+// TARGET OS:						WINDOWS/UNIX/LINUX/MAC
+// LIBRARY DEPENDANCE:	None.
+// NAMESPACE:						WCL
+// AUTHOR:							Gavin Blakeman.
+// LICENSE:             GPLv2
+//
+//                      Copyright 2026 Gavin Blakeman.
+//                      This file is part of the Weather Class Library (WCL).
+//
+//                      WCL is free software: you can redistribute it and/or modify it under the terms of the GNU General
+//                      Public License as published by the Free Software Foundation, either version 2 of the License, or (at your
+//                      option) any later version.
+//
+//                      WCL is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the
+//                      implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//                      for more details.
+//
+//                      You should have received a copy of the GNU General Public License along with WCL.  If not, see
+//                      <http://www.gnu.org/licenses/>.
+//
+// OVERVIEW:						Wind rose aggregation. The Davis direction codes (0 = N, 1 = NNE ... 15 = NNW, 255 = no direction) and
+//                      raw wind speeds (mph) are mapped to sector and speed bins through 256 entry lookup tables, so the inner
+//                      loop is a pair of loads and an increment with no branches.
+//                      Histograms with the same layout can be merged. This allows a range to be split over threads and allows
+//                      the cache to hold a histogram per day, so that a rose over a long range only merges the daily histograms.
+//
+// CLASSES INCLUDED:    CWindRoseLayout
+//                      CWindHistogram
+//                      CWindRoseCache
+//
+// CLASS HIERARCHY:     CWindRoseLayout
+//                      CWindHistogram
+//                      CWindRoseCache
+//
+// HISTORY:             2026-10-19 GGB - File Created
+//
+//*********************************************************************************************************************************
+
+#ifndef WCL_WINDROSE_H
+#define WCL_WINDROSE_H
+
+  // Standard C++ Library header files.
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+  // WCL header files
+
+#include "include/WeatherLink.h"
+#include "include/WeatherLinkIP.h"
+
+namespace WCL
+{
+  /// @brief Defines the sectors and speed bins of a wind rose and holds the lookup tables.
+
+  class CWindRoseLayout
+  {
+  private:
+    std::size_t sectors_;
+    double rotation_;
+    std::vector<double> speedEdges_;
+    std::array<std::uint8_t, 256> sectorTable_;
+    std::array<std::uint8_t, 256> speedTable_;
+
+  public:
+    CWindRoseLayout(std::size_t sectors, std::vector<double> const &speedEdges, double rotation = 0);
+
+    std::size_t sectors() const { return sectors_; }
+    std::size_t rows() const { return sectors_ + 1; }
+    std::size_t speedBins() const { return speedEdges_.size() + 1; }
+    std::size_t calmRow() const { return sectors_; }
+    double rotation() const { return rotation_; }
+    std::vector<double> const &speedEdges() const { return speedEdges_; }
+
+    std::uint8_t sector(std::uint8_t code) const { return sectorTable_[code]; }
+    std::uint8_t speedBin(std::uint8_t mph) const { return speedTable_[mph]; }
+  };
+
+  typedef std::shared_ptr<CWindRoseLayout const> windRoseLayoutPtr_t;
+
+  /// @brief A direction x speed histogram.
+
+  class CWindHistogram
+  {
+  private:
+    windRoseLayoutPtr_t layout_;
+    std::vector<std::uint32_t> counts_;
+
+  public:
+    CWindHistogram(windRoseLayoutPtr_t);
+
+    windRoseLayoutPtr_t const &layout() const { return layout_; }
+
+    void accumulate(std::uint8_t const *direction, std::uint8_t const *speed, std::size_t count);
+    void accumulate(SWeatherDataRecord const *, std::size_t count, bool high = false);
+    void accumulate(SArchiveRecord const *, std::size_t count);
+    void accumulateParallel(std::uint8_t const *direction, std::uint8_t const *speed, std::size_t count, std::size_t threads);
+    void merge(CWindHistogram const &);
+    void clear();
+
+    std::uint32_t count(std::size_t row, std::size_t speedBin) const { return counts_[row * layout_->speedBins() + speedBin]; }
+    std::uint64_t total() const;
+    std::uint64_t sectorTotal(std::size_t row) const;
+    double frequency(std::size_t row, std::size_t speedBin) const;
+  };
+
+  /// @brief Caches the daily histograms of each station so that roses over long ranges only merge the daily histograms.
+
+  class CWindRoseCache
+  {
+  public:
+    typedef std::function<void(unsigned long siteID, unsigned long instrumentID, std::uint32_t MJD, CWindHistogram &)> loader_t;
+
+  private:
+    typedef std::pair<unsigned long, unsigned long> seriesKey_t;
+
+    windRoseLayoutPtr_t layout_;
+    loader_t loader_;
+    mutable std::mutex cacheMutex_;
+    std::map<seriesKey_t, std::map<std::uint32_t, CWindHistogram>> cache_;
+
+  public:
+    CWindRoseCache(windRoseLayoutPtr_t, loader_t);
+
+    CWindHistogram day(unsigned long siteID, unsigned long instrumentID, std::uint32_t MJD);
+    CWindHistogram range(unsigned long siteID, unsigned long instrumentID, std::uint32_t firstMJD, std::uint32_t lastMJD);
+
+    void store(unsigned long siteID, unsigned long instrumentID, std::uint32_t MJD, CWindHistogram const &);
+    void invalidate(unsigned long siteID, unsigned long instrumentID, std::uint32_t MJD);
+    void clear();
+  };
+
+} // namespace WCL
+
+#endif // WCL_WINDROSE_H
@@ -0,0 +1,610 @@
+﻿//*********************************************************************************************************************************
+//
+// PROJECT:							Weather Class Library (WCL)
+// FILE:								wireFormat
+// SUBSYSTEM:						Portable decoding of the Davis file and console structures
+// LANGUAGE:						C++
+// TARGET OS:						WINDOWS/UNIX/LINUX/MAC
+// LIBRARY DEPENDANCE:	None.
+// NAMESPACE:						WCL
+// AUTHOR:							Gavin Blakeman.
+// LICENSE:             GPLv2
+//
+//                      Copyright 2026 Gavin Blakeman.
+//                      This file is part of the Weather Class Library (WCL).
+//
+//                      WCL is free software: you can redistribute it and/or modify it under the terms of the GNU General
+//                      Public License as published by the Free Software Foundation, either version 2 of the License, or (at your
+//                      option) any later version.
+//
+//                      WCL is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the
+//                      implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//                      for more details.
+//
+//                      You should have received a copy of the GNU General Public License along with WCL.  If not, see
+//                      <http://www.gnu.org/licenses/>.
+//
+// OVERVIEW:						Describes the packed structures of the .wlk files and of the console protocol with constexpr field tables
+//                      (offset, width, signedness, scale and unit of each field), and generates the decoders from the tables at
+//                      compile time.
+//                      The structures in WeatherLink.h and WeatherLinkIP.h mirror the bytes of the files and the link, and the
+//                      code reads their fields in place. That depends on the compiler packing the structures without padding, on
+//                      the host being little endian, and (for SDate) on the compiler allocating bitfields from the least
+//                      significant bit. The tables are checked against the structures below, so a compiler that lays out a
+//                      structure differently fails to compile rather than reading the wrong bytes.
+//                      The decoders read the raw bytes with fixed size little endian loads assembled from single bytes, which
+//                      the compiler turns into one (unaligned safe) load on the targets that allow it. The offset and width of
+//                      a field are template arguments, so a column decoder is a simple strided loop that the compiler can
+//                      vectorise. The values returned are of the same type as the structure field, so a decoded value is
+//                      identical to the value read in place.
+//                      The scale converts the raw value to the unit given (the units used by the library when converting the
+//                      value; the rain clicks depend on the collector type).
+//
+// CLASSES INCLUDED:    SWireField
+//                      SWireBits
+//                      TWireLayout
+//
+// CLASS HIERARCHY:     None.
+//
+// HISTORY:             2026-10-19 GGB - File Created
+//
+//*********************************************************************************************************************************
+
+#ifndef WCL_WIREFORMAT_H
+#define WCL_WIREFORMAT_H
+
+  // Standard C++ Library header files.
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+  // WCL header files
+
+#include "include/WeatherLink.h"
+#include "include/WeatherLinkIP.h"
+
+namespace WCL
+{
+  struct SWireField
+  {
+    char const *name;
+    std::uint16_t offset;           ///< Byte offset of the (first element of the) field.
+    std::uint8_t width;             ///< Bytes (1, 2 or 4).
+    bool isSigned;
+    double scale;                   ///< Multiplier from the raw value to the unit.
+    char const *unit;
+    std::uint8_t count = 1;         ///< Elements of an array field.
+    std::uint8_t stride = 0;        ///< Bytes between the elements of an array field. (0 = width)
+    bool msbFirst = false;          ///< The field is big endian.
+  };
+
+  struct SWireBits
+  {
+    char const *name;
+    std::uint8_t shift;
+    std::uint8_t bits;
+  };
+
+  enum EArchiveRecordField : std::size_t
+  {
+    ARF_DATE,
+    ARF_TIME,
+    ARF_TEMPERATURE_OUTSIDE,
+    ARF_TEMPERATURE_HIGH_OUTSIDE,
+    ARF_TEMPERATURE_LOW_OUTSIDE,
+    ARF_RAINFALL,
+    ARF_RAIN_RATE_HIGH,
+    ARF_BAROMETER,
+    ARF_SOLAR_RADIATION,
+    ARF_NUMBER_WIND_SAMPLES,
+    ARF_TEMPERATURE_INSIDE,
+    ARF_HUMIDITY_INSIDE,
+    ARF_HUMIDITY_OUTSIDE,
+    ARF_WIND_SPEED_AVERAGE,
+    ARF_WIND_SPEED_HIGH,
+    ARF_WIND_SPEED_HIGH_DIRECTION,
+    ARF_PREVAILING_WIND,
+    ARF_AVERAGE_UVINDEX,
+    ARF_ET,
+    ARF_SOLAR_RADIATION_HIGH,
+    ARF_UVINDEX_HIGH,
+    ARF_FORECAST_RULE,
+    ARF_LEAF_TEMPERATURE,
+    ARF_LEAF_WETNESS,
+    ARF_SOIL_TEMPERATURES,
+    ARF_RECORD_TYPE,
+    ARF_UNUSED
+  };
+
+  enum EWeatherDataRecordField : std::size_t
+  {
+    WDF_DATA_TYPE,
+    WDF_ARCHIVE_INTERVAL,
+    WDF_ICON_FLAGS,
+    WDF_MORE_FLAGS,
+    WDF_PACKED_TIME,
+    WDF_OUTSIDE_TEMP,
+    WDF_HI_OUTSIDE_TEMP,
+    WDF_LOW_OUTSIDE_TEMP,
+    WDF_INSIDE_TEMP,
+    WDF_BAROMETER,
+    WDF_OUTSIDE_HUM,
+    WDF_INSIDE_HUM,
+    WDF_RAIN,
+    WDF_HI_RAIN_RATE,
+    WDF_WIND_SPEED,
+    WDF_HI_WIND_SPEED,
+    WDF_WIND_DIRECTION,
+    WDF_HI_WIND_DIRECTION,
+    WDF_NUM_WIND_SAMPLES,
+    WDF_SOLAR_RAD,
+    WDF_HI_SOLAR_RAD,
+    WDF_UV,
+    WDF_HI_UV,
+    WDF_LEAF_TEMP,
+    WDF_EXTRA_RAD,
+    WDF_NEW_SENSORS,
+    WDF_FORECAST,
+    WDF_ET,
+    WDF_SOIL_TEMP,
+    WDF_SOIL_MOISTURE,
+    WDF_LEAF_WETNESS,
+    WDF_EXTRA_TEMP,
+    WDF_EXTRA_HUM
+  };
+
+  enum EDateBits : std::size_t
+  {
+    DB_DAY,
+    DB_MONTH,
+    DB_YEAR
+  };
+
+  template<typename T>
+  struct TWireLayout;
+
+  template<>
+  struct TWireLayout<DayIndex>
+  {
+    static constexpr std::size_t SIZE = 6;
+    static constexpr SWireField fields[] =
+    {
+      {"recordsInDay",  0, 2, true,  1.0,   ""},
+      {"startPos",      2, 4, true,  1.0,   "byte"}
+    };
+  };
+
+  template<>
+  struct TWireLayout<SHeaderBlock>
+  {
+    static constexpr std::size_t SIZE = 212;
+    static constexpr SWireField fields[] =
+    {
+      {"idCode",                  0, 1, false, 1.0,   "", 16},
+      {"totalRecords",           16, 4, true,  1.0,   ""},
+      {"dayIndex.recordsInDay",  20, 2, true,  1.0,   "", 32, 6},
+      {"dayIndex.startPos",      22, 4, true,  1.0,   "", 32, 6}
+    };
+  };
+
+  template<>
+  struct TWireLayout<SDailySummary1>
+  {
+    static constexpr std::size_t SIZE = 88;
+    static constexpr SWireField fields[] =
+    {
+      {"dataType",           0, 1, true,  1.0,   ""},
+      {"reserved",           1, 1, true,  1.0,   ""},
+      {"dataSpan",           2, 2, true,  1.0,   "min"},
+      {"hiOutTemp",          4, 2, true,  0.1,   "F"},
+      {"lowOutTemp",         6, 2, true,  0.1,   "F"},
+      {"hiInTemp",           8, 2, true,  0.1,   "F"},
+      {"lowInTemp",         10, 2, true,  0.1,   "F"},
+      {"avgOutTemp",        12, 2, true,  0.1,   "F"},
+      {"avgInTemp",         14, 2, true,  0.1,   "F"},
+      {"hiChill",           16, 2, true,  0.1,   "F"},
+      {"lowChill",          18, 2, true,  0.1,   "F"},
+      {"hiDew",             20, 2, true,  0.1,   "F"},
+      {"lowDew",            22, 2, true,  0.1,   "F"},
+      {"avgChill",          24, 2, true,  0.1,   "F"},
+      {"avgDew",            26, 2, true,  0.1,   "F"},
+      {"hiOutHum",          28, 2, true,  0.1,   "%"},
+      {"lowOutHum",         30, 2, true,  0.1,   "%"},
+      {"hiInHum",           32, 2, true,  0.1,   "%"},
+      {"lowInHum",          34, 2, true,  0.1,   "%"},
+      {"avgOutHum",         36, 2, true,  0.1,   "%"},
+      {"hiBar",             38, 2, true,  0.001, "inHg"},
+      {"lowBar",            40, 2, true,  0.001, "inHg"},
+      {"avgBar",            42, 2, true,  0.001, "inHg"},
+      {"hiSpeed",           44, 2, true,  0.1,   "mph"},
+      {"avgSpeed",          46, 2, true,  0.1,   "mph"},
+      {"dailyWindRunTotal", 48, 2, true,  0.1,   "mile"},
+      {"hi10MinSpeed",      50, 2, true,  0.1,   "mph"},
+      {"dirHiSpeed",        52, 1, true,  1.0,   ""},
+      {"hi10MinDir",        53, 1, true,  1.0,   ""},
+      {"dailyRainTotal",    54, 2, true,  0.001, "in"},
+      {"hiRainRate",        56, 2, true,  0.001, "in/h"},
+      {"dailyUVDose",       58, 2, true,  0.1,   "MED"},
+      {"hiUV",              60, 1, true,  0.1,   "index"},
+      {"timeValues",        61, 1, true,  1.0,   "", 27}
+    };
+  };
+
+  template<>
+  struct TWireLayout<SDailySummary2>
+  {
+    static constexpr std::size_t SIZE = 88;
+    static constexpr SWireField fields[] =
+    {
+      {"dataType",            0, 1, true,  1.0,   ""},
+      {"reserved",            1, 1, true,  1.0,   ""},
+      {"todaysWeather",       2, 2, false, 1.0,   ""},
+      {"numWindPackets",      4, 2, true,  1.0,   ""},
+      {"hiSolar",             6, 2, true,  1.0,   "W/m2"},
+      {"dailySolarEnergy",    8, 2, true,  0.1,   "Ly"},
+      {"minSunlight",        10, 2, true,  1.0,   "min"},
+      {"dailyETTotal",       12, 2, true,  0.001, "in"},
+      {"hiHeat",             14, 2, true,  0.1,   "F"},
+      {"lowHeat",            16, 2, true,  0.1,   "F"},
+      {"avgHeat",            18, 2, true,  0.1,   "F"},
+      {"hiTHSW",             20, 2, true,  0.1,   "F"},
+      {"lowTHSW",            22, 2, true,  0.1,   "F"},
+      {"hiTHW",              24, 2, true,  0.1,   "F"},
+      {"lowTHW",             26, 2, true,  0.1,   "F"},
+      {"integratedHeatDD65", 28, 2, true,  0.1,   "F.day"},
+      {"hiWetBulb",          30, 2, true,  0.1,   "F"},
+      {"lowWetBulb",         32, 2, true,  0.1,   "F"},
+      {"avgWetBuld",         34, 2, true,  0.1,   "F"},
+      {"dirBins",            36, 1, true,  1.0,   "", 24},
+      {"timeValues",         60, 1, true,  1.0,   "", 15},
+      {"integratedCoolDD65", 75, 2, true,  0.1,   "F.day"},
+      {"reserved2",          77, 1, true,  1.0,   "", 11}
+    };
+  };
+
+  template<>
+  struct TWireLayout<SWeatherDataRecord>
+  {
+    static constexpr std::size_t SIZE = 88;
+    static constexpr SWireField fields[] =
+    {
+      {"dataType",         0, 1, true,  1.0,   ""},
+      {"archiveInterval",  1, 1, true,  1.0,   "min"},
+      {"iconFlags",        2, 1, true,  1.0,   ""},
+      {"moreFlags",        3, 1, true,  1.0,   ""},
+      {"packedTime",       4, 2, true,  1.0,   "min"},
+      {"outsideTemp",      6, 2, true,  0.1,   "F"},
+      {"hiOutsideTemp",    8, 2, true,  0.1,   "F"},
+      {"lowOutsideTemp",  10, 2, true,  0.1,   "F"},
+      {"insideTemp",      12, 2, true,  0.1,   "F"},
+      {"barometer",       14, 2, true,  0.001, "inHg"},
+      {"outsideHum",      16, 2, true,  0.1,   "%"},
+      {"insideHum",       18, 2, true,  0.1,   "%"},
+      {"rain",            20, 2, false, 1.0,   "click"},
+      {"hiRainRate",      22, 2, true,  1.0,   "click/h"},
+      {"windSpeed",       24, 2, true,  1.0,   "mph"},
+      {"hiWindSpeed",     26, 2, true,  1.0,   "mph"},
+      {"windDirection",   28, 1, true,  1.0,   ""},
+      {"hiWindDirection", 29, 1, true,  1.0,   ""},
+      {"numWindSamples",  30, 2, true,  1.0,   ""},
+      {"solarRad",        32, 2, true,  1.0,   "W/m2"},
+      {"hiSolarRad",      34, 2, true,  1.0,   "W/m2"},
+      {"UV",              36, 1, true,  0.1,   "index"},
+      {"hiUV",            37, 1, true,  0.1,   "index"},
+      {"leafTemp",        38, 1, true,  1.0,   "", 4},
+      {"extraRad",        42, 2, true,  1.0,   ""},
+      {"newSensors",      44, 2, true,  1.0,   "", 6},
+      {"forecast",        56, 1, true,  1.0,   ""},
+      {"ET",              57, 1, true,  0.001, "in"},
+      {"soilTemp",        58, 1, true,  1.0,   "", 6},
+      {"soilMoisture",    64, 1, true,  1.0,   "", 6},
+      {"leafWetness",     70, 1, true,  1.0,   "", 4},
+      {"extraTemp",       74, 1, true,  1.0,   "", 7},
+      {"extraHum",        81, 1, true,  1.0,   "", 7}
+    };
+  };
+
+  template<>
+  struct TWireLayout<SDate>
+  {
+    static constexpr std::size_t SIZE = 2;
+    static constexpr SWireField fields[] =
+    {
+      {"date",  0, 2, false, 1.0,   ""}
+    };
+    static constexpr SWireBits bits[] =
+    {
+      {"day",   0, 5},
+      {"month", 5, 4},
+      {"year",  9, 7}               ///< Years since 2000.
+    };
+  };
+
+  template<>
+  struct TWireLayout<SArchiveRecord>
+  {
+    static constexpr std::size_t SIZE = 52;
+    static constexpr SWireField fields[] =
+    {
+      {"date",                    0, 2, false, 1.0,   ""},
+      {"time",                    2, 2, false, 1.0,   ""},
+      {"temperatureOutside",      4, 2, true,  0.1,   "F"},
+      {"temperatureHighOutside",  6, 2, true,  0.1,   "F"},
+      {"temperatureLowOutside",   8, 2, true,  0.1,   "F"},
+      {"rainfall",               10, 2, false, 1.0,   "click"},
+      {"rainRateHigh",           12, 2, false, 1.0,   "click/h"},
+      {"barometer",              14, 2, false, 0.001, "inHg"},
+      {"solarRadiation",         16, 2, false, 1.0,   "W/m2"},
+      {"numberWindSamples",      18, 2, false, 1.0,   ""},
+      {"temperatureInside",      20, 2, true,  0.1,   "F"},
+      {"humidityInside",         22, 1, false, 1.0,   "%"},
+      {"humidityOutside",        23, 1, false, 1.0,   "%"},
+      {"windSpeedAverage",       24, 1, false, 1.0,   "mph"},
+      {"windSpeedHigh",          25, 1, false, 1.0,   "mph"},
+      {"windSpeedHighDirection", 26, 1, false, 1.0,   ""},
+      {"prevailingWind",         27, 1, false, 1.0,   ""},
+      {"averageUVIndex",         28, 1, false, 0.1,   "index"},
+      {"ET",                     29, 1, false, 0.001, "in"},
+      {"solarRadiationHigh",     30, 2, false, 1.0,   "W/m2"},
+      {"UVIndexHigh",            32, 1, false, 0.1,   "index"},
+      {"forecastRule",           33, 1, true,  1.0,   ""},
+      {"leafTemperature",        34, 2, false, 1.0,   ""},
+      {"leafWetness",            36, 2, false, 1.0,   ""},
+      {"soilTemperatures",       38, 4, false, 1.0,   ""},
+      {"recordType",             42, 1, false, 1.0,   ""},
+      {"unused",                 43, 1, false, 1.0,   "", 9}
+    };
+  };
+
+  template<>
+  struct TWireLayout<SDMPAFTRequest>
+  {
+    static constexpr std::size_t SIZE = 6;
+    static constexpr SWireField fields[] =
+    {
+      {"dateStamp",  0, 2, false, 1.0,   ""},
+      {"timeStamp",  2, 2, false, 1.0,   ""},
+      {"CRC",        4, 2, false, 1.0,   "", 1, 0, true}
+    };
+  };
+
+  template<>
+  struct TWireLayout<SDMPAFTResponse>
+  {
+    static constexpr std::size_t SIZE = 6;
+    static constexpr SWireField fields[] =
+    {
+      {"pages",        0, 2, false, 1.0,   ""},
+      {"firstRecord",  2, 2, false, 1.0,   ""},
+      {"CRC",          4, 2, false, 1.0,   "", 1, 0, true}
+    };
+  };
+
+  /// @brief Type of the value of a field of a given width and signedness.
+
+  template<std::size_t WIDTH, bool SIGNED>
+  using wire_type = typename std::conditional<WIDTH == 1, typename std::conditional<SIGNED, std::int8_t, std::uint8_t>::type,
+                    typename std::conditional<WIDTH == 2, typename std::conditional<SIGNED, std::int16_t, std::uint16_t>::type,
+                    typename std::conditional<SIGNED, std::int32_t, std::uint32_t>::type>::type>::type;
+
+  /// @brief Returns the number of fields of a structure.
+
+  template<typename T>
+  constexpr std::size_t wireFieldCount()
+  {
+    return sizeof(TWireLayout<T>::fields) / sizeof(SWireField);
+  }
+
+  /// @brief Returns the index of a field of a structure from its name, or the number of fields if there is no field of that name.
+
+  template<typename T>
+  constexpr std::size_t wireField(char const *name)
+  {
+    std::size_t index = 0;
+
+    for (; index < wireFieldCount<T>(); index++)
+    {
+      char const *fieldName = TWireLayout<T>::fields[index].name;
+      std::size_t character = 0;
+
+      while ((name[character] != 0) && (name[character] == fieldName[character]))
+      {
+        character++;
+      };
+      if (name[character] == fieldName[character])
+      {
+        break;
+      };
+    };
+
+    return index;
+  }
+
+  /// @brief Returns the offset of a field of a structure.
+
+  template<typename T>
+  constexpr std::size_t wireOffset(std::size_t field)
+  {
+    return TWireLayout<T>::fields[field].offset;
+  }
+
+  /// @brief Checks that the fields of a table cover each byte of the structure exactly once.
+
+  template<typename T>
+  constexpr bool wireLayoutValid()
+  {
+    bool covered[TWireLayout<T>::SIZE] = {};
+
+    for (std::size_t index = 0; index < wireFieldCount<T>(); index++)
+    {
+      SWireField const &field = TWireLayout<T>::fields[index];
+
+      if ((field.width != 1) && (field.width != 2) && (field.width != 4))
+      {
+        return false;
+      };
+
+      for (std::size_t element = 0; element < field.count; element++)
+      {
+        std::size_t offset = field.offset + element * (field.stride != 0 ? field.stride : field.width);
+
+        for (std::size_t byte = offset; byte < offset + field.width; byte++)
+        {
+          if ((byte >= TWireLayout<T>::SIZE) || covered[byte])
+          {
+            return false;
+          };
+          covered[byte] = true;
+        };
+      };
+    };
+
+    for (std::size_t byte = 0; byte < TWireLayout<T>::SIZE; byte++)
+    {
+      if (!covered[byte])
+      {
+        return false;
+      };
+    };
+
+    return (sizeof(T) == TWireLayout<T>::SIZE);
+  }
+
+  /// @brief Loads an integer from bytes in a fixed byte order, whatever the alignment of the bytes and the byte order of the host.
+
+  template<std::size_t WIDTH, bool SIGNED, bool MSB_FIRST = false>
+  constexpr wire_type<WIDTH, SIGNED> wireLoad(std::uint8_t const *bytes)
+  {
+    std::uint32_t value = 0;
+
+    for (std::size_t index = 0; index < WIDTH; index++)
+    {
+      value |= static_cast<std::uint32_t>(bytes[MSB_FIRST ? WIDTH - 1 - index : index]) << (8 * index);
+    };
+
+    return static_cast<wire_type<WIDTH, SIGNED>>(static_cast<wire_type<WIDTH, false>>(value));
+  }
+
+  /// @brief Decodes the raw value of a field (or an element of an array field) from the bytes of a structure.
+
+  template<typename T, std::size_t FIELD>
+  constexpr auto wireValue(std::uint8_t const *record, std::size_t element = 0)
+  {
+    static_assert(FIELD < wireFieldCount<T>(), "Unknown field.");
+
+    constexpr SWireField field = TWireLayout<T>::fields[FIELD];
+
+    return wireLoad<field.width, field.isSigned, field.msbFirst>(record + field.offset +
+                                                                  element * (field.stride != 0 ? field.stride : field.width));
+  }
+
+  /// @brief Decodes the value of a field from the bytes of a structure and applies the scale of the field.
+
+  template<typename T, std::size_t FIELD>
+  constexpr double wireScaled(std::uint8_t const *record, std::size_t element = 0)
+  {
+    return static_cast<double>(wireValue<T, FIELD>(record, element)) * TWireLayout<T>::fields[FIELD].scale;
+  }
+
+  /// @brief Decodes a field of an array of structures into a column.
+
+  template<typename T, std::size_t FIELD, typename U>
+  void wireColumn(std::uint8_t const *records, std::size_t count, U *column, std::size_t element = 0)
+  {
+    for (std::size_t index = 0; index < count; index++)
+    {
+      column[index] = static_cast<U>(wireValue<T, FIELD>(records + index * TWireLayout<T>::SIZE, element));
+    };
+  }
+
+  /// @brief Decodes a field of an array of structures into a column and applies the scale of the field.
+
+  template<typename T, std::size_t FIELD>
+  void wireColumnScaled(std::uint8_t const *records, std::size_t count, double *column, std::size_t element = 0)
+  {
+    for (std::size_t index = 0; index < count; index++)
+    {
+      column[index] = wireScaled<T, FIELD>(records + index * TWireLayout<T>::SIZE, element);
+    };
+  }
+
+  /// @brief Extracts a bit field from a raw value.
+
+  template<typename T, std::size_t BITS>
+  constexpr unsigned int wireBits(std::uint32_t value)
+  {
+    constexpr SWireBits field = TWireLayout<T>::bits[BITS];
+
+    return (value >> field.shift) & ((1u << field.bits) - 1);
+  }
+
+  /// @brief Decodes a packed date. (Day + month * 32 + (year - 2000) * 512)
+
+  constexpr void wireDate(std::uint16_t value, int &year, int &month, int &day)
+  {
+    day = static_cast<int>(wireBits<SDate, DB_DAY>(value));
+    month = static_cast<int>(wireBits<SDate, DB_MONTH>(value));
+    year = static_cast<int>(wireBits<SDate, DB_YEAR>(value)) + 2000;
+  }
+
+  static_assert(sizeof(DayIndex) == 6, "DayIndex must be 6 bytes.");
+  static_assert(sizeof(SHeaderBlock) == 212, "SHeaderBlock must be 212 bytes.");
+  static_assert(sizeof(SDailySummary1) == 88, "SDailySummary1 must be 88 bytes.");
+  static_assert(sizeof(SDailySummary2) == 88, "SDailySummary2 must be 88 bytes.");
+  static_assert(sizeof(SWeatherDataRecord) == 88, "SWeatherDataRecord must be 88 bytes.");
+  static_assert(sizeof(SDate) == 2, "SDate must be 2 bytes.");
+  static_assert(sizeof(SArchiveRecord) == 52, "SArchiveRecord must be 52 bytes.");
+  static_assert(sizeof(SDMPAFTRequest) == 6, "SDMPAFTRequest must be 6 bytes.");
+  static_assert(sizeof(SDMPAFTResponse) == 6, "SDMPAFTResponse must be 6 bytes.");
+
+  static_assert(wireLayoutValid<DayIndex>(), "DayIndex table error.");
+  static_assert(wireLayoutValid<SHeaderBlock>(), "SHeaderBlock table error.");
+  static_assert(wireLayoutValid<SDailySummary1>(), "SDailySummary1 table error.");
+  static_assert(wireLayoutValid<SDailySummary2>(), "SDailySummary2 table error.");
+  static_assert(wireLayoutValid<SWeatherDataRecord>(), "SWeatherDataRecord table error.");
+  static_assert(wireLayoutValid<SDate>(), "SDate table error.");
+  static_assert(wireLayoutValid<SArchiveRecord>(), "SArchiveRecord table error.");
+  static_assert(wireLayoutValid<SDMPAFTRequest>(), "SDMPAFTRequest table error.");
+  static_assert(wireLayoutValid<SDMPAFTResponse>(), "SDMPAFTResponse table error.");
+
+    // The fields that are read in place must be where the tables put them.
+
+  static_assert(offsetof(SArchiveRecord, time) == wireOffset<SArchiveRecord>(ARF_TIME), "Layout error.");
+  static_assert(offsetof(SArchiveRecord, temperatureOutside) == wireOffset<SArchiveRecord>(ARF_TEMPERATURE_OUTSIDE), "Layout error.");
+  static_assert(offsetof(SArchiveRecord, temperatureHighOutside) == wireOffset<SArchiveRecord>(ARF_TEMPERATURE_HIGH_OUTSIDE), "Layout error.");
+  static_assert(offsetof(SArchiveRecord, temperatureLowOutside) == wireOffset<SArchiveRecord>(ARF_TEMPERATURE_LOW_OUTSIDE), "Layout error.");
+  static_assert(offsetof(SArchiveRecord, rainfall) == wireOffset<SArchiveRecord>(ARF_RAINFALL), "Layout error.");
+  static_assert(offsetof(SArchiveRecord, rainRateHigh) == wireOffset<SArchiveRecord>(ARF_RAIN_RATE_HIGH), "Layout error.");
+  static_assert(offsetof(SArchiveRecord, barometer) == wireOffset<SArchiveRecord>(ARF_BAROMETER), "Layout error.");
+  static_assert(offsetof(SArchiveRecord, solarRadiation) == wireOffset<SArchiveRecord>(ARF_SOLAR_RADIATION), "Layout error.");
+  static_assert(offsetof(SArchiveRecord, temperatureInside) == wireOffset<SArchiveRecord>(ARF_TEMPERATURE_INSIDE), "Layout error.");
+  static_assert(offsetof(SArchiveRecord, humidityInside) == wireOffset<SArchiveRecord>(ARF_HUMIDITY_INSIDE), "Layout error.");
+  static_assert(offsetof(SArchiveRecord, humidityOutside) == wireOffset<SArchiveRecord>(ARF_HUMIDITY_OUTSIDE), "Layout error.");
+  static_assert(offsetof(SArchiveRecord, windSpeedAverage) == wireOffset<SArchiveRecord>(ARF_WIND_SPEED_AVERAGE), "Layout error.");
+  static_assert(offsetof(SArchiveRecord, windSpeedHigh) == wireOffset<SArchiveRecord>(ARF_WIND_SPEED_HIGH), "Layout error.");
+  static_assert(offsetof(SArchiveRecord, prevailingWind) == wireOffset<SArchiveRecord>(ARF_PREVAILING_WIND), "Layout error.");
+  static_assert(offsetof(SArchiveRecord, averageUVIndex) == wireOffset<SArchiveRecord>(ARF_AVERAGE_UVINDEX), "Layout error.");
+  static_assert(offsetof(SArchiveRecord, solarRadiationHigh) == wireOffset<SArchiveRecord>(ARF_SOLAR_RADIATION_HIGH), "Layout error.");
+  static_assert(offsetof(SArchiveRecord, UVIndexHigh) == wireOffset<SArchiveRecord>(ARF_UVINDEX_HIGH), "Layout error.");
+  static_assert(offsetof(SWeatherDataRecord, packedTime) == wireOffset<SWeatherDataRecord>(WDF_PACKED_TIME), "Layout error.");
+  static_assert(offsetof(SWeatherDataRecord, outsideTemp) == wireOffset<SWeatherDataRecord>(WDF_OUTSIDE_TEMP), "Layout error.");
+  static_assert(offsetof(SWeatherDataRecord, hiOutsideTemp) == wireOffset<SWeatherDataRecord>(WDF_HI_OUTSIDE_TEMP), "Layout error.");
+  static_assert(offsetof(SWeatherDataRecord, lowOutsideTemp) == wireOffset<SWeatherDataRecord>(WDF_LOW_OUTSIDE_TEMP), "Layout error.");
+  static_assert(offsetof(SWeatherDataRecord, insideTemp) == wireOffset<SWeatherDataRecord>(WDF_INSIDE_TEMP), "Layout error.");
+  static_assert(offsetof(SWeatherDataRecord, barometer) == wireOffset<SWeatherDataRecord>(WDF_BAROMETER), "Layout error.");
+  static_assert(offsetof(SWeatherDataRecord, outsideHum) == wireOffset<SWeatherDataRecord>(WDF_OUTSIDE_HUM), "Layout error.");
+  static_assert(offsetof(SWeatherDataRecord, insideHum) == wireOffset<SWeatherDataRecord>(WDF_INSIDE_HUM), "Layout error.");
+  static_assert(offsetof(SWeatherDataRecord, rain) == wireOffset<SWeatherDataRecord>(WDF_RAIN), "Layout error.");
+  static_assert(offsetof(SWeatherDataRecord, hiRainRate) == wireOffset<SWeatherDataRecord>(WDF_HI_RAIN_RATE), "Layout error.");
+  static_assert(offsetof(SWeatherDataRecord, windSpeed) == wireOffset<SWeatherDataRecord>(WDF_WIND_SPEED), "Layout error.");
+  static_assert(offsetof(SWeatherDataRecord, hiWindSpeed) == wireOffset<SWeatherDataRecord>(WDF_HI_WIND_SPEED), "Layout error.");
+  static_assert(offsetof(SWeatherDataRecord, windDirection) == wireOffset<SWeatherDataRecord>(WDF_WIND_DIRECTION), "Layout error.");
+  static_assert(offsetof(SWeatherDataRecord, solarRad) == wireOffset<SWeatherDataRecord>(WDF_SOLAR_RAD), "Layout error.");
+  static_assert(offsetof(SWeatherDataRecord, hiSolarRad) == wireOffset<SWeatherDataRecord>(WDF_HI_SOLAR_RAD), "Layout error.");
+  static_assert(offsetof(SWeatherDataRecord, UV) == wireOffset<SWeatherDataRecord>(WDF_UV), "Layout error.");
+  static_assert(offsetof(SWeatherDataRecord, hiUV) == wireOffset<SWeatherDataRecord>(WDF_HI_UV), "Layout error.");
+
+} // namespace WCL
+
+#endif // WCL_WIREFORMAT_H
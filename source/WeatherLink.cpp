@@ -35,6 +35,15 @@
 
 #include "include/WeatherLink.h"
 
+  // Standard C++ library header files
+
+#include <algorithm>
+#include <iterator>
+
+  // WCL header files
+
+#include "include/trace.h"
+
 namespace WCL
 {
   char idCode[] = {'W', 'D', 'A', 'T', '5', '.', '3', 0, 0, 0, 0, 0, 0, 0, 5, 3};
@@ -204,6 +213,8 @@ namespace WCL
 
   bool CWeatherLinkDatabaseFile::nextDayRecord()
   {
+    WCL_TRACE_SPAN("file", "CWeatherLinkDatabaseFile::nextDayRecord");
+
     bool bDataValid = false;
 
     if (dayIndex >= 31)
@@ -267,6 +278,8 @@ namespace WCL
 
   bool CWeatherLinkDatabaseFile::openFile()
   {
+    WCL_TRACE_SPAN("file", "CWeatherLinkDatabaseFile::openFile");
+
     size_t nIndex;
     bool bEquiv = true;
 
@@ -309,4 +322,73 @@ namespace WCL
     };
   }
 
+  /// @brief      Reads a block of consecutive archive records of a day.
+  /// @param[in]  day: The day (1 - 31).
+  /// @param[in]  firstIndex: The index of the first archive record of the day to read. (0 = first archive record)
+  /// @param[out] records: The buffer to receive the records.
+  /// @param[in]  count: The maximum number of records to read.
+  /// @returns    The number of valid records read. Reading stops at the first record that is not an archive record, or at the
+  ///             end of the file.
+  /// @throws     None.
+  /// @note       The stream state is cleared after the read, so that data appended to the file can be read later.
+  /// @version    2026-10-19/GGB - Function created.
+
+  std::size_t CWeatherLinkDatabaseFile::readArchiveRecords(int day, int firstIndex, SWeatherDataRecord *records, std::size_t count)
+  {
+    WCL_TRACE_SPAN("file", "CWeatherLinkDatabaseFile::readArchiveRecords");
+
+    std::size_t returnValue = 0;
+
+    if (bFileOpen && (day >= 1) && (day <= 31) && (firstIndex >= 0))
+    {
+      wlf.clear();
+      wlf.seekg(sizeof(SHeaderBlock) + (sizeof(SDailySummary1) * (headerBlock.dayIndex[day].startPos + 2))
+        + (sizeof(SWeatherDataRecord) * firstIndex));
+      wlf.read(reinterpret_cast<char *>(records), static_cast<std::streamsize>(sizeof(SWeatherDataRecord) * count));
+
+      std::size_t recordsRead = static_cast<std::size_t>(wlf.gcount()) / sizeof(SWeatherDataRecord);
+
+      while ( (returnValue < recordsRead) && (records[returnValue].dataType == 1) )
+      {
+        returnValue++;
+      };
+      wlf.clear();
+    };
+
+    return returnValue;
+  }
+
+  /// @brief      Re-reads the header block of an open file. Used to pick up the day index of a file that is still being written.
+  /// @returns    true - The header was read and is valid.
+  /// @returns    false - The file is not open or the header could not be read.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  bool CWeatherLinkDatabaseFile::reloadHeader()
+  {
+    SHeaderBlock header;
+
+    if (!bFileOpen)
+    {
+      return false;
+    }
+    else
+    {
+      wlf.clear();
+      wlf.seekg(0);
+      wlf.read(reinterpret_cast<char *>(&header), sizeof(header));
+
+      if ( (wlf.gcount() != sizeof(header)) || !std::equal(std::begin(idCode), std::end(idCode), header.idCode) )
+      {
+        wlf.clear();
+        return false;
+      }
+      else
+      {
+        headerBlock = header;
+        return true;
+      };
+    };
+  }
+
 }	// namespace VWL
@@ -0,0 +1,205 @@
+﻿//*********************************************************************************************************************************
+//
+// PROJECT:							Weather Class Library (WCL)
+// FILE:								allocationCounter
+// SUBSYSTEM:						Heap allocation counting
+// LANGUAGE:						C++
+// TARGET OS:						WINDOWS/UNIX/LINUX/MAC
+// LIBRARY DEPENDANCE:	None.
+// NAMESPACE:						WCL
+// AUTHOR:							Gavin Blakeman.
+// LICENSE:             GPLv2
+//
+//                      Copyright 2026 Gavin Blakeman.
+//                      This file is part of the Weather Class Library (WCL).
+//
+//                      WCL is free software: you can redistribute it and/or modify it under the terms of the GNU General
+//                      Public License as published by the Free Software Foundation, either version 2 of the License, or (at your
+//                      option) any later version.
+//
+//                      WCL is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the
+//                      implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//                      for more details.
+//
+//                      You should have received a copy of the GNU General Public License along with WCL.  If not, see
+//                      <http://www.gnu.org/licenses/>.
+//
+// OVERVIEW:						Counts the heap allocations made by each thread, so that the allocations made per record by the insert paths
+//                      can be measured. When WCL_COUNT_ALLOCATIONS is defined (qmake CONFIG+=wcl_allocationCount) the library
+//                      replaces the global operator new and counts each call in a thread local counter. Otherwise nothing is
+//                      replaced and the count is always zero.
+//                      Only allocations made through operator new are counted. Memory that is allocated directly with malloc(),
+//                      for example by the Qt containers and by SQLite, is not counted.
+//
+// CLASSES INCLUDED:    None.
+//
+// CLASS HIERARCHY:     None.
+//
+// HISTORY:             2026-10-19 GGB - File Created
+//
+//*********************************************************************************************************************************
+
+#include "include/allocationCounter.h"
+
+  // Standard C++ library header files.
+
+#include <cstdlib>
+#include <new>
+
+#ifdef WCL_COUNT_ALLOCATIONS
+
+  /// The count is a plain thread local integer, so counting takes no lock and has no constructor to run before the first
+  /// allocation of a thread.
+
+static thread_local std::uint64_t threadAllocations = 0;
+
+/// @brief      Replacement for the global operator new. Counts the allocation and allocates with malloc(). The array and nothrow
+///             forms are replaced as well and call this function. The aligned forms are left to the standard library.
+/// @param[in]  size: The number of bytes to allocate.
+/// @returns    Pointer to the allocated memory.
+/// @throws     std::bad_alloc
+/// @version    2026-10-19/GGB - Function created.
+
+void *operator new(std::size_t size)
+{
+  threadAllocations++;
+
+  if (size == 0)
+  {
+    size = 1;
+  };
+
+  void *returnValue;
+
+  while ((returnValue = std::malloc(size)) == nullptr)
+  {
+    std::new_handler handler = std::get_new_handler();
+
+    if (handler == nullptr)
+    {
+      throw std::bad_alloc();
+    };
+    handler();
+  };
+
+  return returnValue;
+}
+
+/// @brief      Replacement for the global operator new[].
+/// @param[in]  size: The number of bytes to allocate.
+/// @returns    Pointer to the allocated memory.
+/// @throws     std::bad_alloc
+/// @version    2026-10-19/GGB - Function created.
+
+void *operator new[](std::size_t size)
+{
+  return ::operator new(size);
+}
+
+/// @brief      Replacement for the nothrow global operator new.
+/// @param[in]  size: The number of bytes to allocate.
+/// @returns    Pointer to the allocated memory, or nullptr if the memory cannot be allocated.
+/// @throws     None.
+/// @version    2026-10-19/GGB - Function created.
+
+void *operator new(std::size_t size, std::nothrow_t const &) noexcept
+{
+  try
+  {
+    return ::operator new(size);
+  }
+  catch(...)
+  {
+    return nullptr;
+  };
+}
+
+/// @brief      Replacement for the nothrow global operator new[].
+/// @param[in]  size: The number of bytes to allocate.
+/// @returns    Pointer to the allocated memory, or nullptr if the memory cannot be allocated.
+/// @throws     None.
+/// @version    2026-10-19/GGB - Function created.
+
+void *operator new[](std::size_t size, std::nothrow_t const &) noexcept
+{
+  return ::operator new(size, std::nothrow);
+}
+
+/// @brief      Replacement for the global operator delete, matching the replaced operator new.
+/// @param[in]  pointer: The memory to release.
+/// @throws     None.
+/// @version    2026-10-19/GGB - Function created.
+
+void operator delete(void *pointer) noexcept
+{
+  std::free(pointer);
+}
+
+/// @brief      Replacement for the sized global operator delete, matching the replaced operator new.
+/// @param[in]  pointer: The memory to release.
+/// @throws     None.
+/// @version    2026-10-19/GGB - Function created.
+
+void operator delete(void *pointer, std::size_t) noexcept
+{
+  std::free(pointer);
+}
+
+/// @brief      Replacements for the other forms of the global operator delete, matching the replaced forms of operator new.
+/// @param[in]  pointer: The memory to release.
+/// @throws     None.
+/// @version    2026-10-19/GGB - Function created.
+
+void operator delete[](void *pointer) noexcept
+{
+  std::free(pointer);
+}
+
+void operator delete[](void *pointer, std::size_t) noexcept
+{
+  std::free(pointer);
+}
+
+void operator delete(void *pointer, std::nothrow_t const &) noexcept
+{
+  std::free(pointer);
+}
+
+void operator delete[](void *pointer, std::nothrow_t const &) noexcept
+{
+  std::free(pointer);
+}
+
+#endif // WCL_COUNT_ALLOCATIONS
+
+namespace WCL
+{
+  /// @brief      Returns the number of allocations made through operator new by the calling thread. The difference of two
+  ///             calls is the number of allocations made between them.
+  /// @returns    The number of allocations, or zero when the library is built without WCL_COUNT_ALLOCATIONS.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  std::uint64_t allocationCount() noexcept
+  {
+#ifdef WCL_COUNT_ALLOCATIONS
+    return threadAllocations;
+#else
+    return 0;
+#endif
+  }
+
+  /// @brief      Returns true if the library is built with the allocation counting (WCL_COUNT_ALLOCATIONS).
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  bool allocationCounting() noexcept
+  {
+#ifdef WCL_COUNT_ALLOCATIONS
+    return true;
+#else
+    return false;
+#endif
+  }
+
+} // namespace WCL
@@ -0,0 +1,326 @@
+﻿//*********************************************************************************************************************************
+//
+// PROJECT:							Weather Class Library (WCL)
+// FILE:								archiveDump
+// SUBSYSTEM:						Decoding of the console archive memory dump
+// LANGUAGE:						C++
+// TARGET OS:						WINDOWS/UNIX/LINUX/MAC
+// LIBRARY DEPENDANCE:	None.
+// NAMESPACE:						WCL
+// AUTHOR:							Gavin Blakeman.
+// LICENSE:             GPLv2
+//
+//                      Copyright 2026 Gavin Blakeman.
+//                      This file is part of the Weather Class Library (WCL).
+//
+//                      WCL is free software: you can redistribute it and/or modify it under the terms of the GNU General
+//                      Public License as published by the Free Software Foundation, either version 2 of the License, or (at your
+//                      option) any later version.
+//
+//                      WCL is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the
+//                      implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//                      for more details.
+//
+//                      You should have received a copy of the GNU General Public License along with WCL.  If not, see
+//                      <http://www.gnu.org/licenses/>.
+//
+// OVERVIEW:						Decodes a full archive memory download (the DMP command) from a Vantage console. The console sends the
+//                      512 pages of its archive memory, each of 267 bytes: a sequence number, 5 archive records, 4 unused bytes
+//                      and a CRC (MSB first), so the CRC over the whole page is zero.
+//                      The bytes are appended as they are received from the link into a buffer that holds the whole dump, and
+//                      each completed page is handed to a pool of worker threads that check the CRC and decode the records and
+//                      their timestamps. The decoding is therefore finished shortly after the last page arrives and the time
+//                      taken for a recovery is that of the link.
+//                      The archive memory is circular, so the page order is not the time order. finish() reassembles the
+//                      records by timestamp, drops the unused records and the records that are not after a watermark (the last
+//                      record in the database), and returns the records in time order ready to be inserted.
+//
+// CLASSES INCLUDED:    CArchiveDump
+//
+// CLASS HIERARCHY:     CArchiveDump
+//
+// HISTORY:             2026-10-19 GGB - File Created
+//
+//*********************************************************************************************************************************
+
+#include "include/archiveDump.h"
+
+  // Standard C++ library header files.
+
+#include <algorithm>
+#include <cstring>
+
+  // WCL header files
+
+#include "include/GeneralFunctions.h"
+#include "include/trace.h"
+
+namespace WCL
+{
+  static_assert(sizeof(SArchiveRecord) == 52, "SArchiveRecord must be 52 bytes.");
+  static_assert(1 + CArchiveDump::RECORDS_PER_PAGE * sizeof(SArchiveRecord) + 4 + 2 == CArchiveDump::PAGE_SIZE,
+                "DMP page size error.");
+
+  /// @brief      Constructor. Starts the worker threads.
+  /// @param[in]  threads: The number of worker threads. (0 = hardware concurrency)
+  /// @param[in]  pageCount: The number of pages in the dump.
+  /// @throws     std::bad_alloc
+  /// @version    2026-10-19/GGB - Function created.
+
+  CArchiveDump::CArchiveDump(std::size_t threads, std::size_t pageCount) : pageCount_(pageCount),
+    buffer_(pageCount * PAGE_SIZE), records_(pageCount * RECORDS_PER_PAGE), timestamps_(pageCount * RECORDS_PER_PAGE),
+    status_(pageCount, PS_PENDING)
+  {
+    if (threads == 0)
+    {
+      threads = std::max(1u, std::thread::hardware_concurrency());
+    };
+    threads_ = threads;
+
+    for (std::size_t thread = 0; thread < threads_; thread++)
+    {
+      workers_.emplace_back(&CArchiveDump::worker, this);
+    };
+  }
+
+  /// @brief      Destructor. Stops the worker threads.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  CArchiveDump::~CArchiveDump()
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+
+      stop_ = true;
+    };
+    pageCondition_.notify_all();
+
+    for (auto &worker : workers_)
+    {
+      worker.join();
+    };
+  }
+
+  /// @brief      Appends bytes received from the link. Each page that is completed is passed to the workers to decode.
+  /// @param[in]  data: The bytes received.
+  /// @param[in]  count: The number of bytes.
+  /// @returns    The number of bytes used. Bytes after the last page are not used.
+  /// @note       Pages that fail the CRC check are kept and reported by badPages(). If the link acknowledges each page, use
+  ///             validPage() to decide between ACK and NAK and only append the pages that are acknowledged.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  std::size_t CArchiveDump::append(std::uint8_t const *data, std::size_t count)
+  {
+    std::size_t returnValue = std::min(count, buffer_.size() - bytes_);
+    std::size_t pages;
+
+    std::memcpy(buffer_.data() + bytes_, data, returnValue);
+    bytes_ += returnValue;
+    pages = bytes_ / PAGE_SIZE;
+
+    if (pages != pages_)
+    {
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        pages_ = pages;
+      };
+      pageCondition_.notify_all();
+    };
+
+    return returnValue;
+  }
+
+  /// @brief      Returns the pages that failed the CRC check. Waits for the received pages to be decoded.
+  /// @returns    The indexes of the pages.
+  /// @throws     std::bad_alloc
+  /// @version    2026-10-19/GGB - Function created.
+
+  std::vector<std::size_t> CArchiveDump::badPages()
+  {
+    std::vector<std::size_t> returnValue;
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    doneCondition_.wait(lock, [this] { return decodedPages_ == pages_; });
+
+    for (std::size_t page = 0; page < pages_; page++)
+    {
+      if (status_[page] == PS_CRC_ERROR)
+      {
+        returnValue.push_back(page);
+      };
+    };
+
+    return returnValue;
+  }
+
+  /// @brief      Checks the CRC and decodes the records of a range of pages. Called by the workers without the lock held.
+  /// @param[in]  first: The first page.
+  /// @param[in]  last: One past the last page.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  void CArchiveDump::decodePages(std::size_t first, std::size_t last)
+  {
+    WCL_TRACE_SPAN("decode", "CArchiveDump::decodePages");
+
+    for (std::size_t page = first; page < last; page++)
+    {
+      std::uint8_t const *bytes = buffer_.data() + page * PAGE_SIZE;
+      std::size_t record = page * RECORDS_PER_PAGE;
+
+      if (validPage(bytes))
+      {
+        std::memcpy(&records_[record], bytes + 1, RECORDS_PER_PAGE * sizeof(SArchiveRecord));
+        TTimestamp::decode(&records_[record], RECORDS_PER_PAGE, &timestamps_[record]);
+        status_[page] = PS_VALID;
+      }
+      else
+      {
+        std::fill_n(&timestamps_[record], RECORDS_PER_PAGE, TTimestamp());
+        status_[page] = PS_CRC_ERROR;
+      };
+    };
+  }
+
+  /// @brief      Waits for the received pages to be decoded and returns the records after a watermark in time order.
+  /// @param[in]  watermark: Only the records after this time are returned. An invalid timestamp returns all the records.
+  /// @param[out] records: The records are appended in time order.
+  /// @returns    The number of records appended.
+  /// @note       Unused records and the records of the pages that failed the CRC check are dropped. When records have the same
+  ///             timestamp (the clock was set back) the record that is first in memory is kept.
+  /// @throws     std::bad_alloc
+  /// @version    2026-10-19/GGB - Function created.
+
+  std::size_t CArchiveDump::finish(TTimestamp watermark, std::vector<SArchiveRecord> &records)
+  {
+    WCL_TRACE_SPAN("decode", "CArchiveDump::finish");
+
+    std::vector<std::uint32_t> order;
+    std::size_t recordCount;
+
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+
+      doneCondition_.wait(lock, [this] { return decodedPages_ == pages_; });
+      recordCount = pages_ * RECORDS_PER_PAGE;
+    };
+
+    order.reserve(recordCount);
+    for (std::uint32_t index = 0; index < recordCount; index++)
+    {
+      if (timestamps_[index].valid() && (!watermark.valid() || (timestamps_[index] > watermark)))
+      {
+        order.push_back(index);
+      };
+    };
+
+    std::stable_sort(order.begin(), order.end(),
+                     [this](std::uint32_t lhs, std::uint32_t rhs) { return timestamps_[lhs] < timestamps_[rhs]; });
+    order.erase(std::unique(order.begin(), order.end(),
+                            [this](std::uint32_t lhs, std::uint32_t rhs) { return timestamps_[lhs] == timestamps_[rhs]; }),
+                order.end());
+
+    records.reserve(records.size() + order.size());
+    for (auto index : order)
+    {
+      records.push_back(records_[index]);
+    };
+
+    return order.size();
+  }
+
+  /// @brief      Waits for the received pages to be decoded and returns the records that are newer than the last record of a
+  ///             series in a store.
+  /// @param[in]  store: The store that the records will be written to.
+  /// @param[in]  siteID: The site ID.
+  /// @param[in]  instrumentID: The instrument ID.
+  /// @param[out] records: The records are appended in time order.
+  /// @returns    The number of records appended.
+  /// @throws     std::bad_alloc
+  /// @version    2026-10-19/GGB - Function created.
+
+  std::size_t CArchiveDump::finish(CWeatherStore &store, unsigned long siteID, unsigned long instrumentID,
+                                   std::vector<SArchiveRecord> &records)
+  {
+    std::uint16_t MJD, time;
+    TTimestamp watermark;
+
+    if (store.lastWeatherRecord(siteID, instrumentID, MJD, time))
+    {
+      watermark = TTimestamp::fromMJD(MJD, time);
+    };
+
+    return finish(watermark, records);
+  }
+
+  /// @brief      Clears the buffer so that another dump can be received.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  void CArchiveDump::reset()
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    doneCondition_.wait(lock, [this] { return decodedPages_ == pages_; });
+
+    bytes_ = 0;
+    pages_ = 0;
+    nextPage_ = 0;
+    decodedPages_ = 0;
+    std::fill(status_.begin(), status_.end(), PS_PENDING);
+  }
+
+  /// @brief      Checks the CRC of a page.
+  /// @param[in]  page: The PAGE_SIZE bytes of the page as received.
+  /// @returns    true if the CRC is correct.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  bool CArchiveDump::validPage(std::uint8_t const *page)
+  {
+    return calculateCRC(const_cast<std::uint8_t *>(page), 0, PAGE_SIZE) == 0;
+  }
+
+  /// @brief      Worker thread. Takes the received pages that have not been decoded and decodes them.
+  /// @details    A worker takes a share of the waiting pages so that a large append is spread over the workers, while a single
+  ///             page received from the link is decoded as soon as it arrives.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  void CArchiveDump::worker()
+  {
+    WCL_TRACE_THREAD("dump decoder");
+
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    while (true)
+    {
+      pageCondition_.wait(lock, [this] { return stop_ || (nextPage_ < pages_); });
+
+      if (nextPage_ < pages_)
+      {
+        std::size_t first = nextPage_;
+        std::size_t last = std::min(pages_, first + std::max<std::size_t>(1, (pages_ - first) / threads_));
+
+        nextPage_ = last;
+        lock.unlock();
+        decodePages(first, last);
+        lock.lock();
+
+        decodedPages_ += last - first;
+        if (decodedPages_ == pages_)
+        {
+          doneCondition_.notify_all();
+        };
+      }
+      else
+      {
+        break;
+      };
+    };
+  }
+
+} // namespace WCL
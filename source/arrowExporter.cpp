@@ -0,0 +1,650 @@
+﻿//*********************************************************************************************************************************
+//
+// PROJECT:							Weather Class Library (WCL)
+// FILE:								arrowExporter
+// SUBSYSTEM:						Arrow IPC export of archive records
+// LANGUAGE:						C++
+// TARGET OS:						WINDOWS/UNIX/LINUX/MAC
+// LIBRARY DEPENDANCE:	boost::filesystem
+// NAMESPACE:						WCL
+// AUTHOR:							Gavin Blakeman.
+// LICENSE:             GPLv2
+//
+//                      Copyright 2026 Gavin Blakeman.
+//                      This file is part of the Weather Class Library (WCL).
+//
+//                      WCL is free software: you can redistribute it and/or modify it under the terms of the GNU General
+//                      Public License as published by the Free Software Foundation, either version 2 of the License, or (at your
+//                      option) any later version.
+//
+//                      WCL is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the
+//                      implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//                      for more details.
+//
+//                      You should have received a copy of the GNU General Public License along with WCL.  If not, see
+//                      <http://www.gnu.org/licenses/>.
+//
+// OVERVIEW:						Implements the Arrow IPC file exporter.
+//                      The file layout is: magic, schema message, record batch messages, end of stream marker, footer, footer
+//                      length and magic. Each message is a continuation marker (0xFFFFFFFF), the metadata length, the Message
+//                      flatbuffer and the body. The flatbuffer tables follow Schema.fbs, Message.fbs and File.fbs of the Arrow
+//                      format (metadata version V5).
+//
+// CLASSES INCLUDED:    CFlatBufferBuilder
+//                      CArrowExporter
+//
+// CLASS HIERARCHY:     CFlatBufferBuilder
+//                      CRecordSink
+//                        - CArrowExporter
+//
+// HISTORY:             2026-10-19 GGB - File Created
+//
+//*********************************************************************************************************************************
+
+#include "include/arrowExporter.h"
+
+  // Standard C++ library header files.
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <initializer_list>
+
+  // Miscellaneous library header files.
+
+#include <GCL>
+
+  // WCL header files
+
+#include "include/error.h"
+#include "include/observation.h"
+#include "include/timestamp.h"
+
+namespace WCL
+{
+  static char const ARROW_MAGIC[8] = { 'A', 'R', 'R', 'O', 'W', '1', 0, 0 };
+
+  static std::uint16_t const METADATA_V5 = 4;
+  static std::uint8_t const HEADER_SCHEMA = 1;
+  static std::uint8_t const HEADER_RECORDBATCH = 3;
+  static std::uint8_t const TYPE_INT = 2;
+  static std::uint8_t const TYPE_FLOATINGPOINT = 3;
+  static std::uint8_t const TYPE_TIMESTAMP = 10;
+  static std::uint16_t const PRECISION_DOUBLE = 2;
+  static std::uint16_t const TIMEUNIT_SECOND = 0;
+
+  static std::size_t const BODY_ALIGNMENT = 64;
+
+  enum EArrowType
+  {
+    AT_TIMESTAMP,
+    AT_FLOAT64,
+    AT_UINT16,
+    AT_UINT8
+  };
+
+  struct SArrowColumn
+  {
+    char const *name;
+    char const *unit;
+    EArrowType type;
+    std::size_t width;
+    std::size_t offset;       ///< Offset of the value in STimeSeriesRecord.
+  };
+
+  /// @brief Builds the column descriptors. The timestamp column is followed by a column for each observation field.
+
+  static constexpr std::array<SArrowColumn, CArrowExporter::COLUMN_COUNT> makeArrowColumns()
+  {
+    std::array<SArrowColumn, CArrowExporter::COLUMN_COUNT> returnValue{};
+
+    returnValue[0] = { "timestamp", "", AT_TIMESTAMP, 8, 0 };
+    for (std::size_t field = 0; field < VF_COUNT; field++)
+    {
+      SObservationField const &descriptor = observationFields[field];
+      EArrowType type = (descriptor.type == OT_DOUBLE) ? AT_FLOAT64 : ((descriptor.type == OT_UINT16) ? AT_UINT16 : AT_UINT8);
+
+      returnValue[field + 1] = { descriptor.name, descriptor.unitName, type, observationWidth(descriptor.type), descriptor.offset };
+    };
+
+    return returnValue;
+  }
+
+  static constexpr std::array<SArrowColumn, CArrowExporter::COLUMN_COUNT> arrowColumns = makeArrowColumns();
+
+  //********************************************************************************************************************************
+  //
+  // CFlatBufferBuilder
+  //
+  //********************************************************************************************************************************
+
+  /// @brief  Builds a flatbuffer front to back. Each object is written before the objects that it refers to, and the offset
+  ///         fields are linked to their targets once the targets have been written. (uoffset_t values always point forward.)
+  ///         The buffer must be placed at an 8 byte aligned position in the file.
+
+  class CFlatBufferBuilder
+  {
+  public:
+    struct SField
+    {
+      std::uint16_t id;
+      std::uint8_t size;        ///< 1, 2, 4 or 8 for a scalar. 0 for an offset to another object.
+      std::uint64_t value;
+    };
+
+  private:
+    std::vector<std::uint8_t> buffer_;
+
+    void pad(std::size_t alignment)
+    {
+      buffer_.resize((buffer_.size() + alignment - 1) / alignment * alignment, 0);
+    }
+
+    void put(std::uint64_t value, std::size_t size)
+    {
+      buffer_.resize(buffer_.size() + size);
+      poke(buffer_.size() - size, value, size);
+    }
+
+  public:
+    CFlatBufferBuilder() : buffer_(4, 0) {}
+
+    std::vector<std::uint8_t> const &data() const { return buffer_; }
+
+    /// @brief Writes a little endian value at a position in the buffer.
+
+    void poke(std::size_t position, std::uint64_t value, std::size_t size)
+    {
+      for (std::size_t index = 0; index < size; index++)
+      {
+        buffer_[position + index] = static_cast<std::uint8_t>(value >> (8 * index));
+      };
+    }
+
+    /// @brief Sets an offset field to refer to an object.
+
+    void link(std::size_t position, std::size_t target)
+    {
+      poke(position, target - position, 4);
+    }
+
+    /// @brief Sets the root table of the buffer.
+
+    void root(std::size_t target)
+    {
+      link(0, target);
+    }
+
+    /// @brief Writes a string and returns its position.
+
+    std::size_t string(char const *value)
+    {
+      std::size_t length = std::strlen(value);
+      std::size_t returnValue;
+
+      pad(4);
+      returnValue = buffer_.size();
+      put(length, 4);
+      buffer_.insert(buffer_.end(), value, value + length + 1);
+
+      return returnValue;
+    }
+
+    /// @brief Writes a zero filled vector and returns its position. The elements start 4 bytes after the position.
+
+    std::size_t vector(std::size_t count, std::size_t elementSize, std::size_t alignment = 4)
+    {
+      std::size_t returnValue;
+
+      pad(4);
+      while ((buffer_.size() + 4) % alignment != 0)
+      {
+        buffer_.push_back(0);
+      };
+      returnValue = buffer_.size();
+      put(count, 4);
+      buffer_.resize(buffer_.size() + count * elementSize, 0);
+
+      return returnValue;
+    }
+
+    /// @brief      Writes a table and its vtable and returns the position of the table.
+    /// @param[in]  fields: The fields of the table.
+    /// @param[out] offsets: The positions of the offset fields, in the order that they appear in fields.
+    /// @details    The fields are laid out largest first to minimise the padding.
+
+    std::size_t table(std::initializer_list<SField> fields, std::size_t *offsets = nullptr)
+    {
+      std::vector<std::pair<SField, std::size_t>> sorted;
+      std::size_t entries = 0;
+      std::size_t alignment = 4;
+      std::size_t offsetIndex = 0;
+      std::size_t vtable, returnValue;
+
+      for (SField const &field : fields)
+      {
+        sorted.emplace_back(field, (field.size == 0) ? offsetIndex++ : 0);
+        entries = std::max<std::size_t>(entries, field.id + 1);
+        alignment = std::max<std::size_t>(alignment, field.size);
+      };
+      std::stable_sort(sorted.begin(), sorted.end(),
+                       [] (std::pair<SField, std::size_t> const &lhs, std::pair<SField, std::size_t> const &rhs)
+                       { return (lhs.first.size ? lhs.first.size : 4) > (rhs.first.size ? rhs.first.size : 4); });
+
+      pad(2);
+      vtable = buffer_.size();
+      buffer_.resize(vtable + 4 + 2 * entries, 0);
+
+      pad(alignment);
+      returnValue = buffer_.size();
+      put(returnValue - vtable, 4);
+
+      for (auto const &field : sorted)
+      {
+        std::size_t size = field.first.size ? field.first.size : 4;
+
+        pad(size);
+        poke(vtable + 4 + 2 * field.first.id, buffer_.size() - returnValue, 2);
+        if (field.first.size == 0)
+        {
+          offsets[field.second] = buffer_.size();
+        };
+        put(field.first.value, size);
+      };
+
+      poke(vtable, 4 + 2 * entries, 2);
+      poke(vtable + 2, buffer_.size() - returnValue, 2);
+
+      return returnValue;
+    }
+  };
+
+  /// @brief      Writes the Schema table.
+  /// @param[in]  builder: The builder to write to.
+  /// @returns    The position of the table.
+  /// @throws     std::bad_alloc
+  /// @version    2026-10-19/GGB - Function created.
+
+  static std::size_t writeSchema(CFlatBufferBuilder &builder)
+  {
+    std::size_t schemaOffsets[1];
+    std::size_t returnValue = builder.table({ {0, 2, 0}, {1, 0, 0} }, schemaOffsets);        // Little endian, fields.
+    std::size_t fields = builder.vector(CArrowExporter::COLUMN_COUNT, 4);
+
+    builder.link(schemaOffsets[0], fields);
+
+    for (std::size_t index = 0; index < CArrowExporter::COLUMN_COUNT; index++)
+    {
+      SArrowColumn const &column = arrowColumns[index];
+      std::size_t fieldOffsets[4];
+      std::size_t field, type, metadata;
+      std::uint8_t typeCode = (column.type == AT_TIMESTAMP) ? TYPE_TIMESTAMP
+                                                            : ((column.type == AT_FLOAT64) ? TYPE_FLOATINGPOINT : TYPE_INT);
+
+        // name, nullable, type_type, type, children, custom_metadata
+
+      field = builder.table({ {0, 0, 0}, {1, 1, 1}, {2, 1, typeCode}, {3, 0, 0}, {5, 0, 0}, {6, 0, 0} }, fieldOffsets);
+      builder.link(fields + 4 + 4 * index, field);
+      builder.link(fieldOffsets[0], builder.string(column.name));
+
+      switch (column.type)
+      {
+        case AT_TIMESTAMP:
+          type = builder.table({ {0, 2, TIMEUNIT_SECOND} });
+          break;
+        case AT_FLOAT64:
+          type = builder.table({ {0, 2, PRECISION_DOUBLE} });
+          break;
+        default:
+          type = builder.table({ {0, 4, 8 * column.width}, {1, 1, 0} });                     // bitWidth, unsigned
+          break;
+      };
+      builder.link(fieldOffsets[1], type);
+      builder.link(fieldOffsets[2], builder.vector(0, 4));
+
+      if (*column.unit == 0)
+      {
+        builder.link(fieldOffsets[3], builder.vector(0, 4));
+      }
+      else
+      {
+        std::size_t keyValueOffsets[2];
+        std::size_t keyValue;
+
+        metadata = builder.vector(1, 4);
+        builder.link(fieldOffsets[3], metadata);
+        keyValue = builder.table({ {0, 0, 0}, {1, 0, 0} }, keyValueOffsets);
+        builder.link(metadata + 4, keyValue);
+        builder.link(keyValueOffsets[0], builder.string("unit"));
+        builder.link(keyValueOffsets[1], builder.string(column.unit));
+      };
+    };
+
+    return returnValue;
+  }
+
+  //********************************************************************************************************************************
+  //
+  // CArrowExporter
+  //
+  //********************************************************************************************************************************
+
+  /// @brief      Creates the file and writes the schema.
+  /// @param[in]  fileName: The file to create.
+  /// @param[in]  batchSize: The number of rows in each record batch.
+  /// @throws     0x0001 - APPLICATION: Unable to open data file.
+  /// @throws     0x000D - EXPORT: Unable to write the export file.
+  /// @version    2026-10-19/GGB - Function created.
+
+  CArrowExporter::CArrowExporter(boost::filesystem::path const &fileName, std::size_t batchSize)
+    : file_(std::fopen(fileName.string().c_str(), "wb")), batchSize_(std::max<std::size_t>(batchSize, 1))
+  {
+    CFlatBufferBuilder builder;
+    std::size_t messageOffsets[1];
+
+    if (file_ == nullptr)
+    {
+      WCL_ERROR(0x0001);
+    };
+
+    for (std::size_t index = 0; index < COLUMN_COUNT; index++)
+    {
+      columns_[index].resize(batchSize_ * arrowColumns[index].width);
+      validity_[index].resize((batchSize_ + 63) / 64, 0);
+      nulls_[index] = 0;
+    };
+
+    writeBytes(ARROW_MAGIC, sizeof(ARROW_MAGIC));
+
+      // version, header_type, header, bodyLength
+
+    builder.root(builder.table({ {0, 2, METADATA_V5}, {1, 1, HEADER_SCHEMA}, {2, 0, 0}, {3, 8, 0} }, messageOffsets));
+    builder.link(messageOffsets[0], writeSchema(builder));
+    writeMessage(builder.data(), 8);
+  }
+
+  /// @brief    Destructor. Completes the file if close() has not been called.
+  /// @throws   None.
+  /// @version  2026-10-19/GGB - Function created.
+
+  CArrowExporter::~CArrowExporter()
+  {
+    try
+    {
+      close();
+    }
+    catch(...)
+    {
+      if (file_ != nullptr)
+      {
+        std::fclose(file_);
+      };
+    };
+  }
+
+  /// @brief      Writes the last record batch and the footer, and closes the file.
+  /// @throws     0x000D - EXPORT: Unable to write the export file.
+  /// @version    2026-10-19/GGB - Function created.
+
+  void CArrowExporter::close()
+  {
+    static std::uint32_t const endOfStream[2] = { 0xFFFFFFFF, 0 };
+
+    if (!closed_)
+    {
+      CFlatBufferBuilder builder;
+      std::size_t footerOffsets[3];
+      std::size_t batches;
+      std::uint32_t footerLength;
+
+      closed_ = true;
+
+      if (batchRows_ != 0)
+      {
+        writeBatch();
+      };
+      writeBytes(endOfStream, sizeof(endOfStream));
+
+        // version, schema, dictionaries, recordBatches
+
+      builder.root(builder.table({ {0, 2, METADATA_V5}, {1, 0, 0}, {2, 0, 0}, {3, 0, 0} }, footerOffsets));
+      builder.link(footerOffsets[0], writeSchema(builder));
+      builder.link(footerOffsets[1], builder.vector(0, 24, 8));
+      batches = builder.vector(blocks_.size(), 24, 8);
+      builder.link(footerOffsets[2], batches);
+      for (std::size_t index = 0; index < blocks_.size(); index++)
+      {
+        builder.poke(batches + 4 + 24 * index, blocks_[index].offset, 8);
+        builder.poke(batches + 4 + 24 * index + 8, blocks_[index].metadataLength, 4);
+        builder.poke(batches + 4 + 24 * index + 16, blocks_[index].bodyLength, 8);
+      };
+
+      footerLength = static_cast<std::uint32_t>(builder.data().size());
+      writeBytes(builder.data().data(), builder.data().size());
+      writeBytes(&footerLength, sizeof(footerLength));
+      writeBytes(ARROW_MAGIC, 6);
+
+      if (std::fclose(file_) != 0)
+      {
+        file_ = nullptr;
+        WCL_ERROR(0x000D);
+      };
+      file_ = nullptr;
+    };
+  }
+
+  /// @brief      Adds a record to the current batch.
+  /// @param[in]  record: The record to add.
+  /// @throws     0x000D - EXPORT: Unable to write the export file.
+  /// @version    2026-10-19/GGB - Function created.
+
+  void CArrowExporter::write(STimeSeriesRecord const &record)
+  {
+    write(&record, 1);
+  }
+
+  /// @brief      Adds a block of records to the current batch. The records are transposed into the column buffers a column at a
+  ///             time, and a batch is written each time that the batch is full.
+  /// @param[in]  records: The records to add.
+  /// @param[in]  count: The number of records.
+  /// @throws     0x000D - EXPORT: Unable to write the export file.
+  /// @version    2026-10-19/GGB - Function created.
+
+  void CArrowExporter::write(STimeSeriesRecord const *records, std::size_t count)
+  {
+    while (count != 0)
+    {
+      std::size_t rows = std::min(count, batchSize_ - batchRows_);
+      std::size_t shift = batchRows_ % 64;
+
+        // Merge the validity bits of the chunk into the batch bitmaps. The timestamp column is always valid.
+
+      CRecordValidator::missing(records, rows, chunkValidity_);
+      for (std::size_t field = 0; field < VF_COUNT; field++)
+      {
+        std::uint64_t *bitmap = validity_[field + 1].data() + batchRows_ / 64;
+        std::vector<std::uint64_t> const &words = chunkValidity_.words[field];
+
+        for (std::size_t index = 0; index < words.size(); index++)
+        {
+          bitmap[index] |= words[index] << shift;
+          if ( (shift != 0) && (batchRows_ / 64 + index + 1 < validity_[field + 1].size()) )
+          {
+            bitmap[index + 1] |= words[index] >> (64 - shift);
+          };
+        };
+        nulls_[field + 1] += chunkValidity_.nulls[field];
+      };
+
+      for (std::size_t index = 0; index < COLUMN_COUNT; index++)
+      {
+        SArrowColumn const &column = arrowColumns[index];
+        std::uint8_t *output = columns_[index].data() + batchRows_ * column.width;
+
+        switch (column.type)
+        {
+          case AT_TIMESTAMP:
+          {
+            for (std::size_t row = 0; row < rows; row++)
+            {
+              std::int64_t seconds = static_cast<std::int64_t>(TTimestamp::fromMJD(static_cast<std::int32_t>(records[row].MJD()),
+                                                                                   records[row].time()).minutes()) * 60;
+
+              std::memcpy(output + row * 8, &seconds, 8);
+            };
+            break;
+          };
+          case AT_FLOAT64:
+          {
+            for (std::size_t row = 0; row < rows; row++)
+            {
+              std::memcpy(output + row * 8, reinterpret_cast<char const *>(&records[row]) + column.offset, 8);
+            };
+            break;
+          };
+          case AT_UINT16:
+          {
+            for (std::size_t row = 0; row < rows; row++)
+            {
+              std::memcpy(output + row * 2, reinterpret_cast<char const *>(&records[row]) + column.offset, 2);
+            };
+            break;
+          };
+          case AT_UINT8:
+          {
+            for (std::size_t row = 0; row < rows; row++)
+            {
+              output[row] = *(reinterpret_cast<std::uint8_t const *>(&records[row]) + column.offset);
+            };
+            break;
+          };
+        };
+      };
+
+      batchRows_ += rows;
+      rows_ += rows;
+      records += rows;
+      count -= rows;
+
+      if (batchRows_ == batchSize_)
+      {
+        writeBatch();
+      };
+    };
+  }
+
+  /// @brief      Writes the current batch as a RecordBatch message. Each column has a validity buffer (empty if the column has
+  ///             no nulls) and a data buffer, each aligned to 64 bytes in the body. The validity bitmaps are written as the little
+  ///             endian words that they are held in.
+  /// @throws     0x000D - EXPORT: Unable to write the export file.
+  /// @version    2026-10-19/GGB - Function created.
+
+  void CArrowExporter::writeBatch()
+  {
+    static std::uint8_t const zero[BODY_ALIGNMENT] = { 0 };
+
+    CFlatBufferBuilder builder;
+    std::size_t messageOffsets[1];
+    std::size_t batchOffsets[2];
+    std::size_t nodes, buffers;
+    std::uint64_t bodyLength = 0;
+    SBlock block;
+
+      // version, header_type, header, bodyLength (set below)
+
+    std::size_t message = builder.table({ {0, 2, METADATA_V5}, {1, 1, HEADER_RECORDBATCH}, {2, 0, 0}, {3, 8, 0} }, messageOffsets);
+    builder.root(message);
+
+      // length, nodes, buffers
+
+    std::size_t batch = builder.table({ {0, 8, batchRows_}, {1, 0, 0}, {2, 0, 0} }, batchOffsets);
+    builder.link(messageOffsets[0], batch);
+
+    nodes = builder.vector(COLUMN_COUNT, 16, 8);
+    builder.link(batchOffsets[0], nodes);
+    buffers = builder.vector(2 * COLUMN_COUNT, 16, 8);
+    builder.link(batchOffsets[1], buffers);
+
+    for (std::size_t index = 0; index < COLUMN_COUNT; index++)
+    {
+      std::uint64_t validityLength = (nulls_[index] == 0) ? 0 : (batchRows_ + 7) / 8;
+      std::uint64_t length = batchRows_ * arrowColumns[index].width;
+
+      builder.poke(nodes + 4 + 16 * index, batchRows_, 8);
+      builder.poke(nodes + 4 + 16 * index + 8, nulls_[index], 8);
+      builder.poke(buffers + 4 + 32 * index, bodyLength, 8);
+      builder.poke(buffers + 4 + 32 * index + 8, validityLength, 8);
+      bodyLength += (validityLength + BODY_ALIGNMENT - 1) / BODY_ALIGNMENT * BODY_ALIGNMENT;
+      builder.poke(buffers + 4 + 32 * index + 16, bodyLength, 8);
+      builder.poke(buffers + 4 + 32 * index + 24, length, 8);
+      bodyLength += (length + BODY_ALIGNMENT - 1) / BODY_ALIGNMENT * BODY_ALIGNMENT;
+    };
+
+      // The bodyLength field is the only 8 byte field of the message table, so it is the first field after the soffset.
+
+    builder.poke(message + 8, bodyLength, 8);
+
+    block.offset = offset_;
+    writeMessage(builder.data(), BODY_ALIGNMENT);
+    block.metadataLength = static_cast<std::uint32_t>(offset_ - block.offset);
+    block.bodyLength = bodyLength;
+
+    for (std::size_t index = 0; index < COLUMN_COUNT; index++)
+    {
+      std::size_t length = batchRows_ * arrowColumns[index].width;
+
+      if (nulls_[index] != 0)
+      {
+        std::size_t validityLength = (batchRows_ + 7) / 8;
+
+        writeBytes(validity_[index].data(), validityLength);
+        writeBytes(zero, (BODY_ALIGNMENT - validityLength % BODY_ALIGNMENT) % BODY_ALIGNMENT);
+      };
+      writeBytes(columns_[index].data(), length);
+      writeBytes(zero, (BODY_ALIGNMENT - length % BODY_ALIGNMENT) % BODY_ALIGNMENT);
+
+      std::fill(validity_[index].begin(), validity_[index].end(), 0);
+      nulls_[index] = 0;
+    };
+
+    blocks_.push_back(block);
+    batchRows_ = 0;
+  }
+
+  /// @brief      Writes bytes to the file.
+  /// @param[in]  data: The bytes to write.
+  /// @param[in]  length: The number of bytes.
+  /// @throws     0x000D - EXPORT: Unable to write the export file.
+  /// @version    2026-10-19/GGB - Function created.
+
+  void CArrowExporter::writeBytes(void const *data, std::size_t length)
+  {
+    if ( (length != 0) && (std::fwrite(data, 1, length, file_) != length) )
+    {
+      WCL_ERROR(0x000D);
+    };
+    offset_ += length;
+  }
+
+  /// @brief      Writes the continuation marker, length and flatbuffer of a message. The flatbuffer is padded so that the body
+  ///             starts at a multiple of the alignment.
+  /// @param[in]  metadata: The Message flatbuffer.
+  /// @param[in]  alignment: The alignment of the body (a multiple of 8).
+  /// @throws     0x000D - EXPORT: Unable to write the export file.
+  /// @version    2026-10-19/GGB - Function created.
+
+  void CArrowExporter::writeMessage(std::vector<std::uint8_t> const &metadata, std::size_t alignment)
+  {
+    static std::uint8_t const zero[BODY_ALIGNMENT] = { 0 };
+
+    std::uint32_t prefix[2];
+    std::size_t padding = (alignment - (offset_ + 8 + metadata.size()) % alignment) % alignment;
+
+    prefix[0] = 0xFFFFFFFF;
+    prefix[1] = static_cast<std::uint32_t>(metadata.size() + padding);
+    writeBytes(prefix, sizeof(prefix));
+    writeBytes(metadata.data(), metadata.size());
+    writeBytes(zero, padding);
+  }
+
+} // namespace WCL
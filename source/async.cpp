@@ -0,0 +1,418 @@
+﻿//*********************************************************************************************************************************
+//
+// PROJECT:							Weather Class Library (WCL)
+// FILE:								async
+// SUBSYSTEM:						Coroutine interface for file and database operations
+// LANGUAGE:						C++
+// TARGET OS:						WINDOWS/UNIX/LINUX/MAC
+// LIBRARY DEPENDANCE:	None.
+// NAMESPACE:						WCL
+// AUTHOR:							Gavin Blakeman.
+// LICENSE:             GPLv2
+//
+//                      Copyright 2026 Gavin Blakeman.
+//                      This file is part of the Weather Class Library (WCL).
+//
+//                      WCL is free software: you can redistribute it and/or modify it under the terms of the GNU General
+//                      Public License as published by the Free Software Foundation, either version 2 of the License, or (at your
+//                      option) any later version.
+//
+//                      WCL is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the
+//                      implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//                      for more details.
+//
+//                      You should have received a copy of the GNU General Public License along with WCL.  If not, see
+//                      <http://www.gnu.org/licenses/>.
+//
+// OVERVIEW:						Awaitable variants of the blocking file and store operations, so that many stations can be driven from a
+//                      few threads with straight line code.
+//                      CExecutor is a small thread pool. CStrand runs the work posted to it one at a time, in order, on the
+//                      threads of an executor; each file or store is used through its own strand so it is never used by two
+//                      threads at the same time. CAsyncCall runs a blocking call on a strand and resumes the awaiting coroutine on
+//                      a thread of the executor of the strand when the call returns.
+//                      CTask is a lazy coroutine type. A task is started by co_await, by syncWait() or by whenAll().
+//                      CAsyncWeatherLinkFile and CAsyncStore wrap a .wlk file and a store. A Qt database (CDatabase) can only be
+//                      used by the thread that opened it, so it must be given a one thread executor. Batched writes on a
+//                      worker pool are obtained by wrapping a CShardedWriter.
+//                      The interface needs C++20 coroutines. The library is built as C++17 unless qmake is run with
+//                      CONFIG+=wcl_coroutines, and this file is empty when coroutines are not available.
+//
+// CLASSES INCLUDED:    CExecutor
+//                      CStrand
+//                      CAsyncCall
+//                      CTask
+//                      CAsyncWeatherLinkFile
+//                      CAsyncStore
+//
+// CLASS HIERARCHY:     CExecutor
+//                      CStrand
+//                      CAsyncCall
+//                      CTask
+//                      CAsyncWeatherLinkFile
+//                      CAsyncStore
+//
+// HISTORY:             2026-10-19 GGB - File Created
+//
+//*********************************************************************************************************************************
+
+#include "include/async.h"
+
+#ifdef __cpp_impl_coroutine
+
+  // Standard C++ library header files.
+
+#include <algorithm>
+
+  // WCL header files
+
+#include "include/trace.h"
+
+namespace WCL
+{
+  /// @brief      Constructor. Starts the threads.
+  /// @param[in]  threads: The number of threads. (0 = hardware concurrency)
+  /// @throws     std::bad_alloc
+  /// @version    2026-10-19/GGB - Function created.
+
+  CExecutor::CExecutor(std::size_t threads)
+  {
+    if (threads == 0)
+    {
+      threads = std::max(1u, std::thread::hardware_concurrency());
+    };
+
+    for (std::size_t index = 0; index < threads; index++)
+    {
+      threads_.emplace_back(&CExecutor::worker, this);
+    };
+  }
+
+  /// @brief      Destructor. Runs the work that has been posted and stops the threads.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  CExecutor::~CExecutor()
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+
+      stop_ = true;
+      pending_.notify_all();
+    };
+
+    for (std::thread &thread : threads_)
+    {
+      thread.join();
+    };
+  }
+
+  /// @brief      Posts work to be run on one of the threads.
+  /// @param[in]  work: The work to run.
+  /// @throws     std::bad_alloc
+  /// @version    2026-10-19/GGB - Function created.
+
+  void CExecutor::post(std::function<void()> work)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    queue_.push_back(std::move(work));
+    pending_.notify_one();
+  }
+
+  /// @brief      The thread function. Runs the posted work in the order it was posted.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  void CExecutor::worker()
+  {
+    WCL_TRACE_THREAD("executor");
+
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    for (;;)
+    {
+      pending_.wait(lock, [this] { return stop_ || !queue_.empty(); });
+
+      if (queue_.empty())
+      {
+        break;
+      };
+
+      std::function<void()> work = std::move(queue_.front());
+
+      queue_.pop_front();
+      lock.unlock();
+      work();
+      lock.lock();
+    };
+  }
+
+  /// @brief      Posts work to be run after the work already posted to the strand.
+  /// @param[in]  work: The work to run.
+  /// @throws     std::bad_alloc
+  /// @version    2026-10-19/GGB - Function created.
+
+  void CStrand::post(std::function<void()> work)
+  {
+    bool start;
+
+    {
+      std::lock_guard<std::mutex> lock(state_->mutex);
+
+      state_->queue.push_back(std::move(work));
+      start = !state_->running;
+      state_->running = true;
+    };
+
+    if (start)
+    {
+      state_->executor.post([state = state_] { run(state); });
+    };
+  }
+
+  /// @brief      Runs the work posted to the strand until the queue is empty. Only one run() is active at a time. The loop
+  ///             only uses the shared state, so the strand may be destroyed by the work that it runs.
+  /// @param[in]  state: The state of the strand.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  void CStrand::run(std::shared_ptr<SState> const &state)
+  {
+    std::unique_lock<std::mutex> lock(state->mutex);
+
+    while (!state->queue.empty())
+    {
+      std::function<void()> work = std::move(state->queue.front());
+
+      state->queue.pop_front();
+      lock.unlock();
+      work();
+      lock.lock();
+    };
+
+    state->running = false;
+  }
+
+  /// @brief      Constructor.
+  /// @param[in]  fileName: The .wlk file.
+  /// @param[in]  executor: The executor that the file is read on.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  CAsyncWeatherLinkFile::CAsyncWeatherLinkFile(boost::filesystem::path const &fileName, CExecutor &executor)
+    : file_(fileName), strand_(executor)
+  {
+  }
+
+  /// @brief      Opens the file and reads the header.
+  /// @returns    Awaitable returning the result of CWeatherLinkDatabaseFile::openFile().
+  /// @throws     std::bad_alloc
+  /// @version    2026-10-19/GGB - Function created.
+
+  CAsyncCall<bool> CAsyncWeatherLinkFile::openFile()
+  {
+    return { strand_, [this] { return file_.openFile(); } };
+  }
+
+  /// @brief      Closes the file.
+  /// @returns    Awaitable returning the result of CWeatherLinkDatabaseFile::closeFile().
+  /// @throws     std::bad_alloc
+  /// @version    2026-10-19/GGB - Function created.
+
+  CAsyncCall<bool> CAsyncWeatherLinkFile::closeFile()
+  {
+    return { strand_, [this] { return file_.closeFile(); } };
+  }
+
+  /// @brief      Reads the first day record.
+  /// @returns    Awaitable returning the result of CWeatherLinkDatabaseFile::firstDayRecord().
+  /// @throws     std::bad_alloc
+  /// @version    2026-10-19/GGB - Function created.
+
+  CAsyncCall<bool> CAsyncWeatherLinkFile::firstDayRecord()
+  {
+    return { strand_, [this] { return file_.firstDayRecord(); } };
+  }
+
+  /// @brief      Reads the next day record.
+  /// @returns    Awaitable returning the result of CWeatherLinkDatabaseFile::nextDayRecord().
+  /// @throws     std::bad_alloc
+  /// @version    2026-10-19/GGB - Function created.
+
+  CAsyncCall<bool> CAsyncWeatherLinkFile::nextDayRecord()
+  {
+    return { strand_, [this] { return file_.nextDayRecord(); } };
+  }
+
+  /// @brief      Reads the header again, for a file that is being written.
+  /// @returns    Awaitable returning the result of CWeatherLinkDatabaseFile::reloadHeader().
+  /// @throws     std::bad_alloc
+  /// @version    2026-10-19/GGB - Function created.
+
+  CAsyncCall<bool> CAsyncWeatherLinkFile::reloadHeader()
+  {
+    return { strand_, [this] { return file_.reloadHeader(); } };
+  }
+
+  /// @brief      Reads a block of archive records of a day.
+  /// @param[in]  day: The day of the month.
+  /// @param[in]  first: The first record of the day to read.
+  /// @param[out] records: The buffer. Must remain valid until the await completes.
+  /// @param[in]  count: The size of the buffer.
+  /// @returns    Awaitable returning the number of records read.
+  /// @throws     std::bad_alloc
+  /// @version    2026-10-19/GGB - Function created.
+
+  CAsyncCall<std::size_t> CAsyncWeatherLinkFile::readArchiveRecords(int day, int first, SWeatherDataRecord *records,
+                                                                     std::size_t count)
+  {
+    return { strand_, [this, day, first, records, count] { return file_.readArchiveRecords(day, first, records, count); } };
+  }
+
+  /// @brief      Constructor.
+  /// @param[in]  store: The store. Must outlive this object.
+  /// @param[in]  executor: The executor that the store is used on.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  CAsyncStore::CAsyncStore(CWeatherStore &store, CExecutor &executor) : store_(store), strand_(executor)
+  {
+  }
+
+  /// @brief      Inserts an archive record downloaded from the console.
+  /// @param[in]  siteID: The site ID.
+  /// @param[in]  instrumentID: The instrument ID.
+  /// @param[in]  record: The record. A copy is inserted.
+  /// @returns    Awaitable returning true if the record was inserted.
+  /// @throws     std::bad_alloc
+  /// @version    2026-10-19/GGB - Function created.
+
+  CAsyncCall<bool> CAsyncStore::insertRecord(unsigned long siteID, unsigned long instrumentID, SArchiveRecord const &record)
+  {
+    return { strand_, [this, siteID, instrumentID, record = record]() mutable
+    {
+      return store_.insertRecord(siteID, instrumentID, record);
+    } };
+  }
+
+  /// @brief      Inserts an archive record read from a .wlk file.
+  /// @param[in]  siteID: The site ID.
+  /// @param[in]  instrumentID: The instrument ID.
+  /// @param[in]  record: The record. A copy is inserted.
+  /// @param[in]  JD: The date of the record.
+  /// @returns    Awaitable returning true if the record was inserted.
+  /// @throws     std::bad_alloc
+  /// @version    2026-10-19/GGB - Function created.
+
+  CAsyncCall<bool> CAsyncStore::insertRecord(unsigned long siteID, unsigned long instrumentID, SWeatherDataRecord const &record,
+                                             ACL::TJD const &JD)
+  {
+    return { strand_, [this, siteID, instrumentID, record, JD] { return store_.insertRecord(siteID, instrumentID, record, JD); } };
+  }
+
+  /// @brief      Inserts a block of archive records downloaded from the console as one batch. The batch is aborted if an insert
+  ///             fails.
+  /// @param[in]  siteID: The site ID.
+  /// @param[in]  instrumentID: The instrument ID.
+  /// @param[in]  records: The records.
+  /// @returns    Awaitable returning the number of records inserted.
+  /// @throws     std::bad_alloc
+  /// @version    2026-10-19/GGB - Function created.
+
+  CAsyncCall<std::size_t> CAsyncStore::insertRecords(unsigned long siteID, unsigned long instrumentID,
+                                                     std::vector<SArchiveRecord> records)
+  {
+    return { strand_, [this, siteID, instrumentID, records = std::move(records)]() mutable
+    {
+      std::size_t returnValue = 0;
+
+      try
+      {
+        store_.beginBatch();
+        for (SArchiveRecord &record : records)
+        {
+          returnValue += store_.insertRecord(siteID, instrumentID, record) ? 1 : 0;
+        };
+        store_.endBatch();
+      }
+      catch(...)
+      {
+        store_.abortBatch();
+        throw;
+      };
+
+      return returnValue;
+    } };
+  }
+
+  /// @brief      Inserts a block of archive records of one day, read from a .wlk file, as one batch. The batch is aborted if an
+  ///             insert fails.
+  /// @param[in]  siteID: The site ID.
+  /// @param[in]  instrumentID: The instrument ID.
+  /// @param[in]  records: The records.
+  /// @param[in]  JD: The date of the records.
+  /// @returns    Awaitable returning the number of records inserted.
+  /// @throws     std::bad_alloc
+  /// @version    2026-10-19/GGB - Function created.
+
+  CAsyncCall<std::size_t> CAsyncStore::insertRecords(unsigned long siteID, unsigned long instrumentID,
+                                                     std::vector<SWeatherDataRecord> records, ACL::TJD const &JD)
+  {
+    return { strand_, [this, siteID, instrumentID, records = std::move(records), JD]
+    {
+      std::size_t returnValue = 0;
+
+      try
+      {
+        store_.beginBatch();
+        for (SWeatherDataRecord const &record : records)
+        {
+          returnValue += store_.insertRecord(siteID, instrumentID, record, JD) ? 1 : 0;
+        };
+        store_.endBatch();
+      }
+      catch(...)
+      {
+        store_.abortBatch();
+        throw;
+      };
+
+      return returnValue;
+    } };
+  }
+
+  /// @brief      Gets the time of the last record of a station.
+  /// @param[in]  siteID: The site ID.
+  /// @param[in]  instrumentID: The instrument ID.
+  /// @param[out] MJD: The MJD of the last record. Must remain valid until the await completes.
+  /// @param[out] time: The time of the last record. Must remain valid until the await completes.
+  /// @returns    Awaitable returning true if a record was found.
+  /// @throws     std::bad_alloc
+  /// @version    2026-10-19/GGB - Function created.
+
+  CAsyncCall<bool> CAsyncStore::lastWeatherRecord(unsigned long siteID, unsigned long instrumentID, std::uint16_t &MJD,
+                                                  std::uint16_t &time)
+  {
+    return { strand_, [this, siteID, instrumentID, &MJD, &time]
+    {
+      return store_.lastWeatherRecord(siteID, instrumentID, MJD, time);
+    } };
+  }
+
+  /// @brief      Checks if a record exists.
+  /// @param[in]  siteID: The site ID.
+  /// @param[in]  instrumentID: The instrument ID.
+  /// @param[in]  JD: The date of the record.
+  /// @param[in]  time: The time of the record (HHMM).
+  /// @returns    Awaitable returning true if the record exists.
+  /// @throws     std::bad_alloc
+  /// @version    2026-10-19/GGB - Function created.
+
+  CAsyncCall<bool> CAsyncStore::recordExists(unsigned long siteID, unsigned long instrumentID, ACL::TJD JD, std::uint16_t time)
+  {
+    return { strand_, [this, siteID, instrumentID, JD, time] { return store_.recordExists(siteID, instrumentID, JD, time); } };
+  }
+
+} // namespace WCL
+
+#endif // __cpp_impl_coroutine
@@ -0,0 +1,441 @@
+﻿//*********************************************************************************************************************************
+//
+// PROJECT:							Weather Class Library (WCL)
+// FILE:								boundedImport
+// SUBSYSTEM:						Import of .wlk files within a fixed memory budget
+// LANGUAGE:						C++
+// TARGET OS:						WINDOWS/UNIX/LINUX/MAC
+// LIBRARY DEPENDANCE:	None.
+// NAMESPACE:						WCL
+// AUTHOR:							Gavin Blakeman.
+// LICENSE:             GPLv2
+//
+//                      Copyright 2026 Gavin Blakeman.
+//                      This file is part of the Weather Class Library (WCL).
+//
+//                      WCL is free software: you can redistribute it and/or modify it under the terms of the GNU General
+//                      Public License as published by the Free Software Foundation, either version 2 of the License, or (at your
+//                      option) any later version.
+//
+//                      WCL is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the
+//                      implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//                      for more details.
+//
+//                      You should have received a copy of the GNU General Public License along with WCL.  If not, see
+//                      <http://www.gnu.org/licenses/>.
+//
+// OVERVIEW:						Imports a large set of .wlk files with a fixed memory budget. The budget is divided into blocks of archive
+//                      records that are allocated once and recycled. Reader threads read the files directly into free blocks
+//                      and pass the full blocks to the writer, which writes each block to the store as one batch and returns it
+//                      to the free list. A reader stops when there is no free block, so a store that is slower than the readers
+//                      does not cause records to be buffered beyond the budget, while the blocks already read keep the store
+//                      busy.
+//                      All the files of a station are read by the same reader, in file (date) order, so the records of a station
+//                      reach the store in time order.
+//                      The statistics count the times each side waited for the other, which shows whether the import is limited
+//                      by reading or by the store.
+//
+// CLASSES INCLUDED:    SBoundedImportStatistics
+//                      CBoundedImport
+//
+// CLASS HIERARCHY:     CBoundedImport
+//
+// HISTORY:             2026-10-19 GGB - File Created
+//
+//*********************************************************************************************************************************
+
+#include "include/boundedImport.h"
+
+  // Standard C++ library header files.
+
+#include <algorithm>
+#include <map>
+#include <utility>
+
+  // Miscellaneous library header files.
+
+#include <GCL>
+
+  // WCL header files
+
+#include "include/replay.h"
+#include "include/trace.h"
+
+namespace WCL
+{
+  /// @brief      Constructor.
+  /// @param[in]  store: The store to write to. Must be safe to use from another thread when it is also used for live data.
+  /// @param[in]  memoryBudget: The memory used for the record blocks (bytes). At least one block more than the number of readers
+  ///             is used.
+  /// @param[in]  readers: The number of reader threads.
+  /// @param[in]  blockRecords: The number of records in a block. Each block is written to the store as one batch.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  CBoundedImport::CBoundedImport(CWeatherStore &store, std::size_t memoryBudget, std::size_t readers, std::size_t blockRecords)
+    : store_(store), blockRecords_(std::max<std::size_t>(1, blockRecords)), readerCount_(std::max<std::size_t>(1, readers))
+  {
+    blockCount_ = std::max(readerCount_ + 1, memoryBudget / (blockRecords_ * sizeof(SWeatherDataRecord)));
+  }
+
+  /// @brief      Adds all the .wlk files (named YYYY-MM.wlk) of a directory, in date order.
+  /// @param[in]  directory: The directory.
+  /// @param[in]  siteID: The site ID of the records.
+  /// @param[in]  instrumentID: The instrument ID of the records.
+  /// @returns    The number of files added.
+  /// @throws     boost::filesystem::filesystem_error
+  /// @throws     std::bad_alloc
+  /// @version    2026-10-19/GGB - Function created.
+
+  std::size_t CBoundedImport::addDirectory(boost::filesystem::path const &directory, unsigned long siteID,
+                                           unsigned long instrumentID)
+  {
+    std::vector<boost::filesystem::path> files;
+
+    for (auto const &entry : boost::filesystem::directory_iterator(directory))
+    {
+      int year, month;
+
+      if (CReplayDriver::fileDate(entry.path(), year, month))
+      {
+        files.push_back(entry.path());
+      };
+    };
+    std::sort(files.begin(), files.end());
+
+    for (auto const &file : files)
+    {
+      addFile(file, siteID, instrumentID);
+    };
+
+    return files.size();
+  }
+
+  /// @brief      Adds a file to be imported. The files of a station are imported in the order they are added.
+  /// @param[in]  fileName: The file. The name must be of the form YYYY-MM.wlk.
+  /// @param[in]  siteID: The site ID of the records.
+  /// @param[in]  instrumentID: The instrument ID of the records.
+  /// @throws     std::bad_alloc
+  /// @version    2026-10-19/GGB - Function created.
+
+  void CBoundedImport::addFile(boost::filesystem::path const &fileName, unsigned long siteID, unsigned long instrumentID)
+  {
+    files_.push_back(SFile{ fileName, siteID, instrumentID });
+  }
+
+  /// @brief      Takes a block from the free list. Waits while there is no free block.
+  /// @param[in]  siteID: The site ID of the records that will be placed in the block.
+  /// @param[in]  instrumentID: The instrument ID of the records that will be placed in the block.
+  /// @returns    The block, or nullptr if the import is stopping.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  CBoundedImport::SBlock *CBoundedImport::freeBlock(unsigned long siteID, unsigned long instrumentID)
+  {
+    SBlock *returnValue = nullptr;
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    if (free_.empty() && !stop_)
+    {
+      statistics_.readerWaits++;
+      freeAvailable_.wait(lock, [this] { return stop_ || !free_.empty(); });
+    };
+
+    if (!stop_)
+    {
+      returnValue = free_.back();
+      free_.pop_back();
+      returnValue->siteID = siteID;
+      returnValue->instrumentID = instrumentID;
+    };
+
+    return returnValue;
+  }
+
+  /// @brief      Passes a block to the writer. An empty block is returned to the free list.
+  /// @param[in]  block: The block.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  void CBoundedImport::fullBlock(SBlock *block)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (block->count == 0)
+    {
+      free_.push_back(block);
+      freeAvailable_.notify_one();
+    }
+    else
+    {
+      full_.push_back(block);
+      fullAvailable_.notify_one();
+    };
+  }
+
+  /// @brief      Reads the archive records of a file into blocks. A block holds the records of one station only.
+  /// @param[in]  file: The file.
+  /// @param[in]  block: The block being filled, or nullptr. Returns the block being filled.
+  /// @throws     std::bad_alloc
+  /// @version    2026-10-19/GGB - Function created.
+
+  void CBoundedImport::readFile(SFile const &file, SBlock *&block)
+  {
+    WCL_TRACE_SPAN("import", "CBoundedImport::readFile");
+
+    CWeatherLinkDatabaseFile wlk(file.path);
+    std::uint64_t records = 0;
+    int year, month;
+
+    if (!CReplayDriver::fileDate(file.path, year, month) || !wlk.openFile())
+    {
+      ERRORMESSAGE("WCL: Unable to read " + file.path.string() + ". File not imported.");
+
+      std::lock_guard<std::mutex> lock(mutex_);
+
+      statistics_.filesFailed++;
+      return;
+    };
+
+    if ((block != nullptr) && ((block->siteID != file.siteID) || (block->instrumentID != file.instrumentID)))
+    {
+      fullBlock(block);
+      block = nullptr;
+    };
+
+    SHeaderBlock const &header = wlk.getHeaderBlock();
+
+    for (int day = 1; day <= 31; day++)
+    {
+      int remaining = header.dayIndex[day].recordsInDay - 2;
+      int first = 0;
+
+      if (remaining > 0)
+      {
+        ACL::TJD JD(year, month, day);
+
+        while (remaining > 0)
+        {
+          if ((block != nullptr) && (block->count == blockRecords_))
+          {
+            fullBlock(block);
+            block = nullptr;
+          };
+          if (block == nullptr)
+          {
+            if ((block = freeBlock(file.siteID, file.instrumentID)) == nullptr)
+            {
+              return;
+            };
+          };
+
+          std::size_t count = std::min(static_cast<std::size_t>(remaining), blockRecords_ - block->count);
+          std::size_t read = wlk.readArchiveRecords(day, first, block->records.get() + block->count, count);
+
+          if (read != 0)
+          {
+            block->count += read;
+            block->days.push_back(SDay{ JD, block->count });
+            records += read;
+          };
+
+          if (read < count)
+          {
+            break;                          // The rest of the day is not archive records.
+          };
+          remaining -= static_cast<int>(count);
+          first += static_cast<int>(count);
+        };
+      };
+    };
+
+    wlk.closeFile();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    statistics_.files++;
+    statistics_.records += records;
+  }
+
+  /// @brief      Reader thread. Reads the files of the stations assigned to it, in order.
+  /// @param[in]  files: The files to read.
+  /// @throws     None. Errors are passed to run().
+  /// @version    2026-10-19/GGB - Function created.
+
+  void CBoundedImport::reader(std::vector<SFile const *> files)
+  {
+    WCL_TRACE_THREAD("import reader");
+
+    SBlock *block = nullptr;
+
+    try
+    {
+      for (SFile const *file : files)
+      {
+        readFile(*file, block);
+      };
+      if (block != nullptr)
+      {
+        fullBlock(block);
+      };
+    }
+    catch(...)
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+
+      if (!error_)
+      {
+        error_ = std::current_exception();
+      };
+      stop_ = true;
+      freeAvailable_.notify_all();
+    };
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    readersRunning_--;
+    fullAvailable_.notify_one();
+  }
+
+  /// @brief      Imports the files that have been added. The blocks are written to the store on the calling thread. The blocks are
+  ///             allocated when the import starts and released when it ends. The list of files is cleared.
+  /// @returns    The statistics of the import.
+  /// @throws     Any exception thrown by the store, or by a reader.
+  /// @throws     std::bad_alloc
+  /// @version    2026-10-19/GGB - Function created.
+
+  SBoundedImportStatistics CBoundedImport::run()
+  {
+    std::map<std::pair<unsigned long, unsigned long>, std::size_t> stationReader;
+    std::vector<std::vector<SFile const *>> work(readerCount_);
+    std::vector<std::thread> threads;
+
+    statistics_ = SBoundedImportStatistics();
+    statistics_.blockCount = blockCount_;
+    statistics_.blockBytes = blockRecords_ * sizeof(SWeatherDataRecord);
+    stop_ = false;
+    error_ = nullptr;
+
+    for (std::size_t index = 0; index < blockCount_; index++)
+    {
+      blocks_.emplace_back(new SBlock());
+      blocks_.back()->records.reset(new SWeatherDataRecord[blockRecords_]);
+      blocks_.back()->days.reserve(64);
+      free_.push_back(blocks_.back().get());
+    };
+
+      // The stations are dealt to the readers in the order they were added. All the files of a station go to the same reader.
+
+    for (SFile const &file : files_)
+    {
+      auto iterator = stationReader.emplace(std::make_pair(file.siteID, file.instrumentID), stationReader.size() % readerCount_);
+
+      work[iterator.first->second].push_back(&file);
+    };
+
+    readersRunning_ = 0;
+    for (auto &files : work)
+    {
+      if (!files.empty())
+      {
+        readersRunning_++;
+        threads.emplace_back(&CBoundedImport::reader, this, std::move(files));
+      };
+    };
+
+    while (true)
+    {
+      SBlock *block;
+
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+
+        if (full_.empty() && (readersRunning_ != 0) && !stop_)
+        {
+          statistics_.writerWaits++;
+          fullAvailable_.wait(lock, [this] { return stop_ || !full_.empty() || (readersRunning_ == 0); });
+        };
+        if (stop_ || full_.empty())
+        {
+          break;
+        };
+        block = full_.front();
+        full_.pop_front();
+      };
+
+      try
+      {
+        std::uint64_t inserted = writeBlock(*block);
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        statistics_.inserted += inserted;
+        statistics_.blocks++;
+        block->count = 0;
+        block->days.clear();
+        free_.push_back(block);
+        freeAvailable_.notify_one();
+      }
+      catch(...)
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        error_ = std::current_exception();
+        stop_ = true;
+        freeAvailable_.notify_all();
+        break;
+      };
+    };
+
+    for (std::thread &thread : threads)
+    {
+      thread.join();
+    };
+
+    free_.clear();
+    full_.clear();
+    blocks_.clear();
+    files_.clear();
+
+    if (error_)
+    {
+      std::rethrow_exception(error_);
+    };
+
+    return statistics_;
+  }
+
+  /// @brief      Writes the records of a block to the store as one batch. If an insert fails, the batch is aborted.
+  /// @param[in]  block: The block.
+  /// @returns    The number of records inserted.
+  /// @throws     Any exception thrown by the store.
+  /// @version    2026-10-19/GGB - Function created.
+
+  std::uint64_t CBoundedImport::writeBlock(SBlock &block)
+  {
+    WCL_TRACE_SPAN("import", "CBoundedImport::writeBlock");
+
+    std::uint64_t returnValue = 0;
+    std::size_t index = 0;
+
+    try
+    {
+      store_.beginBatch();
+      for (SDay const &day : block.days)
+      {
+        for (; index < day.end; index++)
+        {
+          returnValue += store_.insertRecord(block.siteID, block.instrumentID, block.records[index], day.JD) ? 1 : 0;
+        };
+      };
+      store_.endBatch();
+    }
+    catch(...)
+    {
+      store_.abortBatch();
+      throw;
+    };
+
+    return returnValue;
+  }
+
+} // namespace WCL
@@ -38,6 +38,7 @@
 
   // Standard C++ library header files.
 
+#include <cmath>
 #include <string>
 #include <tuple>
 
@@ -48,8 +49,12 @@
 
   // WCL header files
 
+#include "include/allocationCounter.h"
 #include "include/error.h"
+#include "include/observation.h"
 #include "include/settings.h"
+#include "include/timeSeriesStore.h"
+#include "include/trace.h"
 
 namespace WCL
 {
@@ -65,6 +70,8 @@ namespace WCL
 
   bool CDatabase::dailyRecordExists(std::uint32_t siteID, std::uint32_t instrumentID, ACL::TJD const &JD)
   {
+    WCL_TRACE_SPAN("database", "CDatabase::dailyRecordExists");
+
     bool returnValue = false;
     QSqlQuery query(database_);
     GCL::sqlWriter sqlWriter;
@@ -93,10 +100,13 @@ namespace WCL
 
   void CDatabase::disconnectFromDatabase()
   {
+    releaseQueries();
   }
 
   bool CDatabase::insertDailySummary(unsigned long siteID, unsigned long instrumentID, SDailySummary1 const &record1, SDailySummary2 const &record2, ACL::TJD const &JD)
   {
+    WCL_TRACE_SPAN("database", "CDatabase::insertDailySummary");
+
     QSqlError error;
     bool returnValue = false;
     QSqlQuery query(database_);
@@ -153,139 +163,166 @@ namespace WCL
     return returnValue;
   }
 
+  /// @brief      Returns the text of the archive insert statement. The column list is built from the observation fields.
+  /// @returns    The statement text.
+  /// @throws     std::bad_alloc
+  /// @version    2026-10-19/GGB - Function created.
+
+  static QString archiveInsertText()
+  {
+    std::string columns = "SITE_ID, INSTRUMENT_ID, MJD, TIME";
+    std::string values = "?, ?, ?, ?";
+
+    for (SObservationField const &field : observationFields)
+    {
+      columns += ", ";
+      columns += field.name;
+      values += ", ?";
+    };
+
+    return QString::fromStdString("INSERT INTO TBL_ARCHIVE(" + columns + ") VALUES (" + values + ")");
+  }
+
+  /// @brief      Inserts a converted record into the archive table. The values are bound in observation field order. Values that
+  ///             are marked as missing by the validator are stored as NULL.
+  /// @param[in]  siteID: The ID of the site.
+  /// @param[in]  instrumentID: The ID of the instrument.
+  /// @param[in]  JD: The date of the record.
+  /// @param[in]  record: The validated record.
+  /// @returns    true if the record was inserted.
+  /// @note       The query object is prepared once and kept, and the values are bound by position, so no objects are created per
+  ///             record.
+  /// @version    2026-10-19/GGB - Function created.
+
+  bool CDatabase::insertArchive(unsigned long siteID, unsigned long instrumentID, ACL::TJD const &JD, STimeSeriesRecord const &record)
+  {
+    WCL_TRACE_SPAN("database", "CDatabase::insertArchive");
+
+    bool returnValue = false;
+    QSqlQuery *query = preparedQuery(QUERY_ARCHIVE_INSERT);
+
+    if (query != nullptr)
+    {
+      int position = 0;
+
+      query->bindValue(position++, static_cast<qulonglong>(siteID));
+      query->bindValue(position++, static_cast<qulonglong>(instrumentID));
+      query->bindValue(position++, JD.MJD());
+      query->bindValue(position++, static_cast<unsigned int>(record.time()));
+
+      forEachObservationField([&](auto index)
+      {
+        constexpr SObservationField field = observationFields[decltype(index)::value];
+
+        if (CRecordValidator::missing(record, static_cast<EValidatedField>(decltype(index)::value)))
+        {
+          query->bindValue(position++, QVariant());
+        }
+        else if constexpr (field.type == OT_DOUBLE)
+        {
+          query->bindValue(position++, observationLoad<double>(record, field.offset));
+        }
+        else if constexpr (field.type == OT_UINT16)
+        {
+          query->bindValue(position++, static_cast<unsigned int>(observationLoad<std::uint16_t>(record, field.offset)));
+        }
+        else
+        {
+          query->bindValue(position++, static_cast<unsigned int>(observationLoad<std::uint8_t>(record, field.offset)));
+        };
+      });
+
+      returnValue = query->exec();
+    };
+
+    return returnValue;
+  }
+
   /// @brief Inserts a row (record) into the weather database.
   /// @details A check is made if the record already exists and if it does, the record will not be saved.
   //
   // 2015-03-29/GGB - Function created.
+  // 2026-10-19/GGB - Converted through the observation fields.
 
   bool CDatabase::insertRecord(unsigned long siteID, unsigned long instrumentID, SArchiveRecord &record)
   {
-    QSqlError error;
+    WCL_TRACE_SPAN("database", "CDatabase::insertRecord");
+
+    std::uint64_t const allocations = allocationCount();
     bool returnValue = false;
-    QSqlQuery query(database_);
     ACL::TJD JD(record.date.year + 2000, record.date.month, record.date.day);
-    GCL::sqlWriter sqlWriter;
+    STimeSeriesRecord tsr;
 
-    if (record.time < 2500 && !recordExists(siteID, instrumentID, JD, record.time))
+    if (CTimeSeriesStore::convert(record, tsr) && !recordExists(siteID, instrumentID, JD, tsr.time()))
     {
-      sqlWriter.resetQuery();
-      std::string sqlString = sqlWriter.insertInto("TBL_ARCHIVE").
-                              values({
-                                       {"SITE_ID", siteID},
-                                       {"INSTRUMENT_ID", instrumentID},
-                                       {"MJD", JD.MJD()},
-                                       {"TIME", static_cast<unsigned int>(record.time)},
-                                       {"outsideTemp", PCL::CTemperature::convert(static_cast<double>(record.temperatureOutside)/10, PCL::TU_F, PCL::TU_K)},
-                                       {"hiOutsideTemp", PCL::CTemperature::convert(static_cast<double>(record.temperatureHighOutside)/10, PCL::TU_F, PCL::TU_K)},
-                                       {"lowOutsideTemp", PCL::CTemperature::convert(static_cast<double>(record.temperatureLowOutside)/10, PCL::TU_F, PCL::TU_K)},
-                                       {"insideTemp", PCL::CTemperature::convert(static_cast<double>(record.temperatureInside)/10, PCL::TU_F, PCL::TU_K)},
-                                       {"barometer", PCL::CPressure::convert(static_cast<double>(record.barometer)/1000, PCL::PU::INHG, PCL::PU::PA)},
-                                       {"outsideHumidity", static_cast<unsigned int>(record.humidityOutside)},
-                                       {"insideHumidity", static_cast<unsigned int>(record.humidityInside)},
-                                       {"rain", static_cast<double>(record.rainfall) * 0.2},
-                                       {"hiRainRate", static_cast<double>(record.rainRateHigh) * 0.2},
-                                       {"windSpeed", PCL::CVelocity::convert(static_cast<double>(record.windSpeedAverage), PCL::VU_MPH, PCL::VU_MPS) },
-                                       {"hiWindSpeed", PCL::CVelocity::convert(static_cast<double>(record.windSpeedHigh), PCL::VU_MPH, PCL::VU_MPS) },
-                                       {"windDirection", static_cast<unsigned int>(record.prevailingWind)},
-                                       {"solarRad", static_cast<unsigned int>(record.solarRadiation)},
-                                       {"hiSolarRad", static_cast<unsigned int>(record.solarRadiationHigh)},
-                                       {"UV", static_cast<unsigned int>(record.averageUVIndex)},
-                                       {"hiUV", static_cast<unsigned int>(record.UVIndexHigh)}
-                                     }).string();
-
-      if (!query.exec(QString::fromStdString(sqlString)))
-      {
-        error = query.lastError();
-      }
-      else
-      {
-        returnValue = true;
-      }
+      validator(siteID, instrumentID).validate(tsr);
+      returnValue = insertArchive(siteID, instrumentID, JD, tsr);
     };
 
+    queryStatistics_.records++;
+    queryStatistics_.allocations += allocationCount() - allocations;
+
     return returnValue;
   }
 
+  /// @brief      Inserts a record read from a .wlk file into the weather database, if it does not already exist.
+  /// @param[in]  siteID: The ID of the site.
+  /// @param[in]  instrumentID: The ID of the instrument.
+  /// @param[in]  record: The record.
+  /// @param[in]  JD: The date of the record.
+  /// @returns    true if the record was inserted.
+  /// @throws     CODE_ERROR - Unknown rain collector type.
+  /// @version    2026-10-19/GGB - Converted through the observation fields.
+
   bool CDatabase::insertRecord(unsigned long siteID, unsigned long instrumentID, const SWeatherDataRecord &record, ACL::TJD const &JD)
   {
-    QSqlError error;
+    WCL_TRACE_SPAN("database", "CDatabase::insertRecord");
+
+    std::uint64_t const allocations = allocationCount();
     bool returnValue = false;
-    QSqlQuery query(database_);
-    double dRain, dRate;
-    unsigned int modifiedTime, time = record.packedTime;
-    GCL::sqlWriter sqlWriter;
+    STimeSeriesRecord tsr;
 
-      // Calculate the correct time value
+    CTimeSeriesStore::convert(record, static_cast<std::uint32_t>(std::llround(JD.MJD())), tsr);
 
-    modifiedTime = time / 60;                   // Hours
-    modifiedTime *= 100;
-    modifiedTime += time % 60;                  // Minutes
+    if (!recordExists(siteID, instrumentID, JD, tsr.time()))
+    {
+      validator(siteID, instrumentID).validate(tsr);
+      returnValue = insertArchive(siteID, instrumentID, JD, tsr);
+    };
 
-      // Determine the rain collector type.
+    queryStatistics_.records++;
+    queryStatistics_.allocations += allocationCount() - allocations;
 
-    switch(record.rain & 0xF000)
-    {
-      case 0x0000:
-        dRain = 2.54;
-        break;
-      case 0x1000:
-        dRain = 0.254;
-        break;
-      case 0x2000:
-        dRain = 0.2;
-        break;
-      case 0x3000:
-        dRain = 1.0;
-        break;
-      case 0x6000:
-        dRain = 0.1;
-        break;
-      default:
-        CODE_ERROR;
-        break;
-      };
+    return returnValue;
+  }
 
-      dRate = record.hiRainRate * dRain;
-      dRain *= record.rain & 0xFFF;
+  /// @brief      Starts a batch of inserts. The batch is written as one transaction.
+  /// @version    2026-10-19/GGB - Function created.
 
-    if (!recordExists(siteID, instrumentID, JD, modifiedTime))
-    {
-      sqlWriter.resetQuery();
-      std::string sqlString = sqlWriter.insertInto("TBL_ARCHIVE").
-                              values({
-                                       {"SITE_ID", siteID},
-                                       {"INSTRUMENT_ID", instrumentID},
-                                       {"MJD", JD.MJD()},
-                                       {"TIME", static_cast<unsigned int>(modifiedTime)},
-                                       {"outsideTemp", PCL::CTemperature::convert(static_cast<double>(record.outsideTemp)/10, PCL::TU_F, PCL::TU_K)},
-                                       {"hiOutsideTemp", PCL::CTemperature::convert(static_cast<double>(record.hiOutsideTemp)/10, PCL::TU_F, PCL::TU_K)},
-                                       {"lowOutsideTemp", PCL::CTemperature::convert(static_cast<double>(record.lowOutsideTemp)/10, PCL::TU_F, PCL::TU_K)},
-                                       {"insideTemp", PCL::CTemperature::convert(static_cast<double>(record.insideTemp)/10, PCL::TU_F, PCL::TU_K)},
-                                       {"barometer", PCL::CPressure::convert(static_cast<double>(record.barometer)/1000, PCL::PU::INHG, PCL::PU::PA)},
-                                       {"outsideHumidity", static_cast<double>(record.outsideHum) / 10},
-                                       {"insideHumidity", static_cast<double>(record.insideHum) / 10},
-                                       {"rain", dRain},
-                                       {"hiRainRate", dRate},
-                                       {"windSpeed", PCL::CVelocity::convert(static_cast<double>(record.windSpeed), PCL::VU_MPH, PCL::VU_MPS) },
-                                       {"hiWindSpeed", PCL::CVelocity::convert(static_cast<double>(record.hiWindSpeed), PCL::VU_MPH, PCL::VU_MPS) },
-                                       {"windDirection", static_cast<unsigned int>(record.windDirection)},
-                                       {"solarRad", static_cast<unsigned int>(record.solarRad)},
-                                       {"hiSolarRad", static_cast<unsigned int>(record.hiSolarRad)},
-                                       {"UV", static_cast<unsigned int>(record.UV)},
-                                       {"hiUV", static_cast<unsigned int>(record.hiUV)}
-                                     }).string();
+  void CDatabase::beginBatch()
+  {
+    database_.transaction();
+  }
 
-      if (!query.exec(QString::fromStdString(sqlString)))
-      {
-        error = query.lastError();
-      }
-      else
-      {
-        returnValue = true;
-      }
-    };
+  /// @brief      Ends a batch of inserts, committing the transaction.
+  /// @version    2026-10-19/GGB - Function created.
 
-    return returnValue;
+  void CDatabase::endBatch()
+  {
+    WCL_TRACE_SPAN("database", "CDatabase::endBatch");
+
+    database_.commit();
+  }
+
+  /// @brief      Ends a batch of inserts that failed, rolling back the transaction.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  void CDatabase::abortBatch() noexcept
+  {
+    WCL_TRACE_SPAN("database", "CDatabase::abortBatch");
+
+    database_.rollback();
   }
 
   /// @brief      Connects to the database.
@@ -294,7 +331,9 @@ namespace WCL
 
   void CDatabase::connectToDatabase()
   {
-    TRACEENTER;
+    WCL_TRACE_SPAN("database", "CDatabase::connectToDatabase");
+
+    releaseQueries();
 
     QString szDatabase(settings::settings.value(settings::WEATHER_DATABASE, QVariant("MYSQL")).toString());
 
@@ -323,7 +362,6 @@ namespace WCL
       DEBUGMESSAGE("Database type is not known.");
       WCL_ERROR(0x0003);
     };
-    TRACEEXIT;
   }
 
   /// @brief Gets the time of the last weather record.
@@ -332,6 +370,8 @@ namespace WCL
 
   bool CDatabase::lastWeatherRecord(unsigned long siteID, unsigned long instrumentID, uint16_t &MJD, uint16_t &time)
   {
+    WCL_TRACE_SPAN("database", "CDatabase::lastWeatherRecord");
+
     bool returnValue = false;
     QSqlQuery query(database_);
     GCL::sqlWriter sqlWriter;
@@ -398,7 +438,6 @@ namespace WCL
     }
     else
     {
-      szConnectionName = QString("WEATHER");
       database_ = QSqlDatabase::addDatabase(driverName.toString(), szConnectionName);
       database_.setDatabaseName(settings::settings.value(settings::WEATHER_SQLITE_DATABASENAME,
                                                            QVariant(QString("Data/WEATHER.sqlite"))).toString());
@@ -447,7 +486,8 @@ namespace WCL
 
   void CDatabase::MySQL()
   {
-    TRACEENTER;
+    WCL_TRACE_SPAN("database", "CDatabase::MySQL");
+
     QVariant driverName = settings::settings.value(settings::WEATHER_MYSQL_DRIVERNAME, QVariant(QString("QMYSQL")));
 
     if (driverName.isNull())
@@ -456,7 +496,6 @@ namespace WCL
     }
     else
     {
-      szConnectionName = QString("WEATHER");
       database_ = QSqlDatabase::addDatabase(driverName.toString(), szConnectionName);
       database_.setHostName(settings::settings.value(settings::WEATHER_MYSQL_HOSTADDRESS, QVariant(QString("server.theblakemans.id.au"))).toString());
       database_.setDatabaseName(settings::settings.value(settings::WEATHER_MYSQL_DATABASENAME, QVariant(QString("WEATHER"))).toString());
@@ -471,34 +510,31 @@ namespace WCL
         WCL_ERROR(0x0006);
       };
     };
-    TRACEEXIT;
   }
 
   /// Checks if a record exists.
   //
   // 2015-06-03/GGB - Function created.
+  // 2026-10-19/GGB - Uses a prepared query that is kept between calls.
 
   bool CDatabase::recordExists(unsigned long siteID, unsigned long instrumentID, ACL::TJD JD, uint16_t time)
   {
-    bool returnValue = false;
-    QSqlQuery query(database_);
-    GCL::sqlWriter sqlWriter;
+    WCL_TRACE_SPAN("database", "CDatabase::recordExists");
 
-    sqlWriter.resetQuery();
-    std::string sqlString = sqlWriter.select({"TBL_ARCHIVE.MJD", "TBL_ARCHIVE.TIME"}).from({"TBL_ARCHIVE"}).
-                            where({
-                                    GCL::sqlWriter::parameterTriple(std::string("MJD"), std::string("="), JD.MJD()),
-                                    GCL::sqlWriter::parameterTriple(std::string("TIME"), std::string("="), static_cast<unsigned int>(time)),
-                                    GCL::sqlWriter::parameterTriple(std::string("SITE_ID"), std::string("="), siteID),
-                                    GCL::sqlWriter::parameterTriple(std::string("INSTRUMENT_ID"), std::string("="), instrumentID),
-                                    }).string();
+    bool returnValue = false;
+    QSqlQuery *query = preparedQuery(QUERY_ARCHIVE_EXISTS);
 
-    if ( query.exec(QString::fromStdString(sqlString)) )
+    if (query != nullptr)
     {
-      query.first();
-      if (query.isValid())
+      query->bindValue(0, JD.MJD());
+      query->bindValue(1, static_cast<unsigned int>(time));
+      query->bindValue(2, static_cast<qulonglong>(siteID));
+      query->bindValue(3, static_cast<qulonglong>(instrumentID));
+
+      if (query->exec())
       {
-        returnValue = true;
+        returnValue = query->next();
+        query->finish();
       };
     };
 
@@ -514,9 +550,71 @@ namespace WCL
     return database_.open();
   }
 
+  /// @brief      Returns the prepared query object of a statement. The object is created and prepared on the first call and then
+  ///             reused until the connection is changed or closed.
+  /// @param[in]  queryID: The statement.
+  /// @returns    The query, or nullptr if it could not be prepared.
+  /// @throws     std::bad_alloc
+  /// @version    2026-10-19/GGB - Function created.
+
+  QSqlQuery *CDatabase::preparedQuery(EQuery queryID)
+  {
+    std::unique_ptr<QSqlQuery> &query = queries_[queryID];
+
+    if (query)
+    {
+      queryStatistics_.reused++;
+    }
+    else
+    {
+      static QString const sqlString[QUERY_COUNT] =
+      {
+        archiveInsertText(),
+        QString("SELECT 1 FROM TBL_ARCHIVE WHERE MJD = ? AND TIME = ? AND SITE_ID = ? AND INSTRUMENT_ID = ?")
+      };
+
+      query.reset(new QSqlQuery(database_));
+      if (query->prepare(sqlString[queryID]))
+      {
+        queryStatistics_.prepared++;
+      }
+      else
+      {
+        query.reset();
+      };
+    };
+
+    return query.get();
+  }
+
+  /// @brief      Releases the prepared query objects. Called before the connection is changed or closed.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  void CDatabase::releaseQueries()
+  {
+    for (auto &query : queries_)
+    {
+      query.reset();
+    };
+  }
+
+  /// @brief      Returns the validator of a series, creating it on first use.
+  /// @param[in]  siteID: The ID of the site.
+  /// @param[in]  instrumentID: The ID of the instrument.
+  /// @returns    The validator.
+  /// @throws     std::bad_alloc
+  /// @version    2026-10-19/GGB - Function created.
+
+  CRecordValidator &CDatabase::validator(unsigned long siteID, unsigned long instrumentID)
+  {
+    return validators_[std::make_pair(siteID, instrumentID)];
+  }
+
 
     void CDatabase::closeDatabase()
     {
+      releaseQueries();
       if (database_.isOpen())
       {
         database_.close();
@@ -0,0 +1,1019 @@
+﻿//*********************************************************************************************************************************
+//
+// PROJECT:							Weather Class Library (WCL)
+// FILE:								databaseSQLite
+// SUBSYSTEM:						Native SQLite database class
+// LANGUAGE:						C++
+// TARGET OS:						WINDOWS/UNIX/LINUX/MAC
+// LIBRARY DEPENDANCE:	sqlite3, ACL
+// NAMESPACE:						WCL
+// AUTHOR:							Gavin Blakeman.
+// LICENSE:             GPLv2
+//
+//                      Copyright 2026 Gavin Blakeman.
+//                      This file is part of the Weather Class Library (WCL).
+//
+//                      WCL is free software: you can redistribute it and/or modify it under the terms of the GNU General
+//                      Public License as published by the Free Software Foundation, either version 2 of the License, or (at your
+//                      option) any later version.
+//
+//                      WCL is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the
+//                      implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//                      for more details.
+//
+//                      You should have received a copy of the GNU General Public License along with WCL.  If not, see
+//                      <http://www.gnu.org/licenses/>.
+//
+// OVERVIEW:						Implements a database class that talks to sqlite3 directly rather than through the QtSql driver.
+//
+// CLASSES INCLUDED:    CDatabaseSQLite
+//
+// CLASS HIERARCHY:     CDatabaseSQLite
+//
+// HISTORY:             2026-10-19 GGB - File Created
+//
+//*********************************************************************************************************************************
+
+#include "include/databaseSQLite.h"
+
+  // Standard C++ library header files.
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <type_traits>
+
+  // Miscellaneous library header files.
+
+#include <GCL>
+
+  // WCL header files
+
+#include "include/error.h"
+#include "include/gapIndex.h"
+#include "include/observation.h"
+#include "include/settings.h"
+#include "include/stationCache.h"
+#include "include/timestamp.h"
+#include "include/trace.h"
+#include "include/unitTransform.h"
+
+namespace WCL
+{
+  /// @brief      Returns the observation columns of TBL_ARCHIVE, each preceded by ", ", in observation field order.
+  /// @param[in]  types: Include the SQL type of each column.
+  /// @returns    The column list.
+  /// @throws     std::bad_alloc
+  /// @version    2026-10-19/GGB - Function created.
+
+  static std::string observationColumns(bool types)
+  {
+    std::string returnValue;
+
+    for (SObservationField const &field : observationFields)
+    {
+      returnValue += ", ";
+      returnValue += field.name;
+      if (types)
+      {
+        returnValue += (field.type == OT_DOUBLE) ? " REAL" : " INTEGER";
+      };
+    };
+
+    return returnValue;
+  }
+
+  /// @brief      Returns a list of numbered parameters (?1, ?2, ...).
+  /// @param[in]  count: The number of parameters.
+  /// @returns    The parameter list.
+  /// @throws     std::bad_alloc
+  /// @version    2026-10-19/GGB - Function created.
+
+  static std::string parameters(std::size_t count)
+  {
+    std::string returnValue;
+
+    for (std::size_t index = 1; index <= count; index++)
+    {
+      returnValue += (index == 1) ? "?" : ", ?";
+      returnValue += std::to_string(index);
+    };
+
+    return returnValue;
+  }
+
+  /// @brief The SQL text for each of the cached statements. Indexed by EStatement. The archive column lists are built once from
+  ///        the observation fields.
+
+  static std::string const statementText[] =
+  {
+    "BEGIN",
+    "COMMIT",
+    "INSERT OR IGNORE INTO TBL_ARCHIVE(SITE_ID, INSTRUMENT_ID, MJD, TIME" + observationColumns(false) + ") VALUES (" +
+      parameters(4 + VF_COUNT) + ")",
+    "SELECT 1 FROM TBL_ARCHIVE WHERE SITE_ID = ?1 AND INSTRUMENT_ID = ?2 AND MJD = ?3 AND TIME = ?4",
+    "SELECT MJD, TIME FROM TBL_ARCHIVE WHERE SITE_ID = ?1 AND INSTRUMENT_ID = ?2 ORDER BY MJD DESC, TIME DESC LIMIT 1",
+    "INSERT OR IGNORE INTO TBL_DAYSUMMARY(SITE_ID, INSTRUMENT_ID, MJD, hiOutTemp, lowOutTemp, hiInTemp, lowInTemp, avgOutTemp, "
+      "avgInTemp, hiChill, lowChill, hiDew, lowDew, avgChill, avgDew, hiOutHum, lowOutHum, hiInHum, lowInHum, avgOutHum, hiBar, "
+      "lowBar, avgBar, hiSpeed, avgSpeed, dailyRainTotal, hiRainRate, dailyUVDose, hiUV, dailySolarEnergy, minSunlight) "
+      "VALUES (?1, ?2, ?3, ?4, ?5, ?6, ?7, ?8, ?9, ?10, ?11, ?12, ?13, ?14, ?15, ?16, ?17, ?18, ?19, ?20, ?21, ?22, ?23, ?24, "
+      "?25, ?26, ?27, ?28, ?29, ?30, ?31)",
+    "SELECT 1 FROM TBL_DAYSUMMARY WHERE SITE_ID = ?1 AND INSTRUMENT_ID = ?2 AND MJD = ?3",
+    "SELECT MJD, TIME" + observationColumns(false) + " FROM TBL_ARCHIVE "
+      "WHERE SITE_ID = ?1 AND INSTRUMENT_ID = ?2 AND MJD BETWEEN ?3 AND ?4 AND MJD * 10000 + TIME BETWEEN ?5 AND ?6 "
+      "ORDER BY MJD, TIME",
+    "SELECT MJD, TIME FROM TBL_ARCHIVE WHERE SITE_ID = ?1 AND INSTRUMENT_ID = ?2 AND MJD BETWEEN ?3 AND ?4",
+    "SELECT MJD FROM TBL_DAYSUMMARY WHERE SITE_ID = ?1 AND INSTRUMENT_ID = ?2 ORDER BY MJD",
+    "SELECT (SELECT MAX(rowid) FROM TBL_ARCHIVE), (SELECT MAX(rowid) FROM TBL_DAYSUMMARY)",
+    "INSERT INTO TBL_ARCHIVE_LOAD(SITE_ID, INSTRUMENT_ID, MJD, TIME" + observationColumns(false) + ") VALUES (" +
+      parameters(4 + VF_COUNT) + ")",
+  };
+
+  static int const BUSY_TIMEOUT = 10000;      ///< Milliseconds to wait for the write lock.
+
+  static char const *createArchiveIndex =
+    "CREATE UNIQUE INDEX IF NOT EXISTS IDX_ARCHIVE_KEY ON TBL_ARCHIVE(SITE_ID, INSTRUMENT_ID, MJD, TIME)";
+
+  static constexpr SAffine temperature = wireTransform<SDailySummary1, wireField<SDailySummary1>("hiOutTemp"), U_KELVIN>();
+  static constexpr SAffine humidity = wireTransform<SDailySummary1, wireField<SDailySummary1>("hiOutHum"), U_PERCENT>();
+  static constexpr SAffine pressure = wireTransform<SDailySummary1, wireField<SDailySummary1>("hiBar"), U_PASCAL>();
+  static constexpr SAffine speed = wireTransform<SDailySummary1, wireField<SDailySummary1>("hiSpeed"), U_METRE_PER_SECOND>();
+  static constexpr SAffine rainfall = wireTransform<SDailySummary1, wireField<SDailySummary1>("dailyRainTotal"), U_MILLIMETRE>();
+  static constexpr SAffine rainRate = wireTransform<SDailySummary1, wireField<SDailySummary1>("hiRainRate"), U_MILLIMETRE_PER_HOUR>();
+
+  /// @brief Reads an integer column. NULL is returned as the missing marker.
+
+  static inline std::uint16_t integer(sqlite3_stmt *stmt, int column, std::uint16_t marker)
+  {
+    return (sqlite3_column_type(stmt, column) == SQLITE_NULL) ? marker : static_cast<std::uint16_t>(sqlite3_column_int(stmt, column));
+  }
+
+  /// @brief Class constructor.
+  /// @throws None.
+  /// @version 2026-10-19/GGB - Function created.
+
+  CDatabaseSQLite::CDatabaseSQLite()
+  {
+    statements_.fill(nullptr);
+  }
+
+  /// @brief Class destructor. Ensures any open transaction is committed and the database is closed.
+  /// @throws None.
+  /// @version 2026-10-19/GGB - Function created.
+
+  CDatabaseSQLite::~CDatabaseSQLite()
+  {
+    try
+    {
+      closeDatabase();
+    }
+    catch(...)
+    {
+    };
+  }
+
+  /// @brief    Starts a batch of inserts. The batch is written as one transaction unless a bulk load is active.
+  /// @throws   0x000B - DATABASE: SQLite error.
+  /// @version  2026-10-19/GGB - Function created.
+
+  void CDatabaseSQLite::beginBatch()
+  {
+    if (!bulkLoad_)
+    {
+      beginTransaction();
+    };
+  }
+
+  /// @brief      Starts a bulk load. The archive rows are written to the load table and committed in large transactions.
+  /// @param[in]  transactionSize: The number of rows to insert per transaction.
+  /// @details    The load table has no index, so no duplicate check is made on insertion. The rows are merged into the archive
+  ///             when endBulkLoad() is called, and are not returned by the archive queries until then.
+  /// @throws     0x000B - DATABASE: SQLite error.
+  /// @version    2026-10-19/GGB - Function created.
+
+  void CDatabaseSQLite::beginBulkLoad(std::size_t transactionSize)
+  {
+    if (!bulkLoad_)
+    {
+      commitTransaction();
+      execute("PRAGMA synchronous = OFF");
+      bulkTransactionSize_ = transactionSize;
+      bulkLoad_ = true;
+      beginTransaction();
+    };
+  }
+
+  /// @brief    Starts a transaction if one is not already active.
+  /// @throws   0x000B - DATABASE: SQLite error.
+  /// @version  2026-10-19/GGB - Function created.
+
+  void CDatabaseSQLite::beginTransaction()
+  {
+    if (!inTransaction_)
+    {
+      step(statement(STMT_BEGIN));
+      inTransaction_ = true;
+      transactionRows_ = 0;
+    };
+  }
+
+  /// @brief    Closes the database. Any open transaction or bulk load is completed first.
+  /// @throws   0x000B - DATABASE: SQLite error.
+  /// @version  2026-10-19/GGB - Function created.
+
+  void CDatabaseSQLite::closeDatabase()
+  {
+    if (database_)
+    {
+      endBulkLoad();
+      commitTransaction();
+      if ((stationCache_ != nullptr) && stationCache_->modified())
+      {
+        stationCache_->save(*this);
+      };
+      finaliseStatements();
+      sqlite3_close_v2(database_);
+      database_ = nullptr;
+    };
+  }
+
+  /// @brief    Commits the active transaction (if any).
+  /// @throws   0x000B - DATABASE: SQLite error.
+  /// @version  2026-10-19/GGB - Function created.
+
+  void CDatabaseSQLite::commitTransaction()
+  {
+    WCL_TRACE_SPAN("sqlite", "CDatabaseSQLite::commitTransaction");
+
+    if (inTransaction_)
+    {
+      step(statement(STMT_COMMIT));
+      inTransaction_ = false;
+      transactionRows_ = 0;
+
+      for (auto const &mark : pendingMarks_)
+      {
+        mark.first->mark(mark.second);
+      };
+      pendingMarks_.clear();
+
+      if ((stationCache_ != nullptr) && !bulkLoad_)
+      {
+        stationCache_->saveIfDue(*this);
+      };
+    };
+  }
+
+  /// @brief    Opens the database using the information stored in the settings.
+  /// @throws   0x000A - DATABASE: Unable to open SQLite database
+  /// @version  2026-10-19/GGB - Function created.
+
+  void CDatabaseSQLite::connectToDatabase()
+  {
+    std::string fileName = settings::settings.value(settings::WEATHER_SQLITE_DATABASENAME,
+                                                    QVariant(QString("Data/WEATHER.sqlite"))).toString().toStdString();
+    int sync = settings::settings.value(settings::WEATHER_SQLITE_SYNCHRONOUS, QVariant(static_cast<int>(SYNC_NORMAL))).toInt();
+
+    if ( (sync < SYNC_OFF) || (sync > SYNC_EXTRA) )
+    {
+      WCL_ERROR(0x0002);	// Database settings not correct.
+    };
+
+    openDatabase(fileName, static_cast<ESynchronous>(sync));
+  }
+
+  /// @brief    Creates the tables and indexes if they do not already exist.
+  /// @throws   0x000B - DATABASE: SQLite error.
+  /// @version  2026-10-19/GGB - Function created.
+
+  void CDatabaseSQLite::createSchema()
+  {
+    execute((std::string("CREATE TABLE IF NOT EXISTS TBL_ARCHIVE(") +
+              "SITE_ID INTEGER NOT NULL, INSTRUMENT_ID INTEGER NOT NULL, MJD INTEGER NOT NULL, TIME INTEGER NOT NULL" +
+              observationColumns(true) + ")").c_str());
+    execute(createArchiveIndex);
+    execute((std::string("CREATE TABLE IF NOT EXISTS TBL_ARCHIVE_LOAD(") +
+              "SITE_ID INTEGER NOT NULL, INSTRUMENT_ID INTEGER NOT NULL, MJD INTEGER NOT NULL, TIME INTEGER NOT NULL" +
+              observationColumns(true) + ")").c_str());
+    execute("CREATE TABLE IF NOT EXISTS TBL_DAYSUMMARY("
+              "SITE_ID INTEGER NOT NULL, INSTRUMENT_ID INTEGER NOT NULL, MJD INTEGER NOT NULL, "
+              "hiOutTemp REAL, lowOutTemp REAL, hiInTemp REAL, lowInTemp REAL, avgOutTemp REAL, avgInTemp REAL, hiChill REAL, "
+              "lowChill REAL, hiDew REAL, lowDew REAL, avgChill REAL, avgDew REAL, hiOutHum REAL, lowOutHum REAL, hiInHum REAL, "
+              "lowInHum REAL, avgOutHum REAL, hiBar REAL, lowBar REAL, avgBar REAL, hiSpeed REAL, avgSpeed REAL, "
+              "dailyRainTotal REAL, hiRainRate REAL, dailyUVDose INTEGER, hiUV INTEGER, dailySolarEnergy INTEGER, "
+              "minSunlight INTEGER)");
+    execute("CREATE UNIQUE INDEX IF NOT EXISTS IDX_DAYSUMMARY_KEY ON TBL_DAYSUMMARY(SITE_ID, INSTRUMENT_ID, MJD)");
+
+    mergeLoad();      // Rows left by a bulk load that was not ended.
+  }
+
+  /// @brief      Checks if a daily summary exists.
+  /// @param[in]  siteID: The ID of the site.
+  /// @param[in]  instrumentID: The ID of the instrument.
+  /// @param[in]  JD: The date of the record to search.
+  /// @returns    true - If a record exists for the day.
+  /// @note       The days of a station held by the attached station cache are answered from the cache.
+  /// @throws     0x000B - DATABASE: SQLite error.
+  /// @version    2026-10-19/GGB - Function created.
+
+  bool CDatabaseSQLite::dailyRecordExists(std::uint32_t siteID, std::uint32_t instrumentID, ACL::TJD const &JD)
+  {
+    SStationState const *state = (stationCache_ != nullptr) ? stationCache_->find(siteID, instrumentID) : nullptr;
+    bool returnValue;
+
+    if (state != nullptr)
+    {
+      returnValue = state->summaryExists(static_cast<std::uint32_t>(std::llround(JD.MJD())));
+    }
+    else
+    {
+      sqlite3_stmt *stmt = statement(STMT_DAYSUMMARY_EXISTS);
+
+      sqlite3_bind_int64(stmt, 1, siteID);
+      sqlite3_bind_int64(stmt, 2, instrumentID);
+      sqlite3_bind_int64(stmt, 3, std::llround(JD.MJD()));
+
+      returnValue = step(stmt);
+      sqlite3_reset(stmt);
+    };
+
+    return returnValue;
+  }
+
+  /// @brief    Ends a batch of inserts, committing the transaction unless a bulk load is active.
+  /// @throws   0x000B - DATABASE: SQLite error.
+  /// @version  2026-10-19/GGB - Function created.
+
+  void CDatabaseSQLite::endBatch()
+  {
+    if (!bulkLoad_)
+    {
+      commitTransaction();
+    };
+  }
+
+  /// @brief    Ends a batch of inserts that failed, rolling back the transaction unless a bulk load is active. A bulk load
+  ///           removes duplicates when it ends, so the rows of the failed batch are kept and can be inserted again.
+  /// @throws   None.
+  /// @version  2026-10-19/GGB - Function created.
+
+  void CDatabaseSQLite::abortBatch() noexcept
+  {
+    if (!bulkLoad_)
+    {
+      rollbackTransaction();
+    };
+  }
+
+  /// @brief    Ends a bulk load. The transaction is committed and the loaded rows are merged into the archive.
+  /// @throws   0x000B - DATABASE: SQLite error.
+  /// @version  2026-10-19/GGB - Function created.
+
+  void CDatabaseSQLite::endBulkLoad()
+  {
+    WCL_TRACE_SPAN("sqlite", "CDatabaseSQLite::endBulkLoad");
+
+    if (bulkLoad_)
+    {
+      commitTransaction();
+      bulkLoad_ = false;
+
+      mergeLoad();
+      synchronous(synchronous_);
+    };
+  }
+
+  /// @brief      Executes a single SQL statement that does not return rows.
+  /// @param[in]  sql: The statement to execute.
+  /// @throws     0x000B - DATABASE: SQLite error.
+  /// @version    2026-10-19/GGB - Function created.
+
+  void CDatabaseSQLite::execute(char const *sql)
+  {
+    if (sqlite3_exec(database_, sql, nullptr, nullptr, nullptr) != SQLITE_OK)
+    {
+      ERRORMESSAGE(std::string("SQLite: ") + sqlite3_errmsg(database_));
+      WCL_ERROR(0x000B);
+    };
+  }
+
+  /// @brief    Finalises all the cached statements.
+  /// @throws   None.
+  /// @version  2026-10-19/GGB - Function created.
+
+  void CDatabaseSQLite::finaliseStatements()
+  {
+    for (auto &stmt : statements_)
+    {
+      sqlite3_finalize(stmt);
+      stmt = nullptr;
+    };
+  }
+
+  /// @brief      Attaches a gap index to a series. Each archive record inserted for the series is marked in the index when its
+  ///             transaction commits, so the index stays current without reloading it.
+  /// @param[in]  siteID: The site ID.
+  /// @param[in]  instrumentID: The instrument ID.
+  /// @param[in]  gapIndex: The index. nullptr detaches the index. The index must outlive the database object or be detached.
+  /// @throws     std::bad_alloc
+  /// @version    2026-10-19/GGB - Function created.
+
+  void CDatabaseSQLite::gapIndex(unsigned long siteID, unsigned long instrumentID, CGapIndex *gapIndex)
+  {
+    if (gapIndex == nullptr)
+    {
+      auto iterator = gapIndexes_.find(std::make_pair(siteID, instrumentID));
+
+      if (iterator != gapIndexes_.end())
+      {
+        CGapIndex *detached = iterator->second;
+
+        pendingMarks_.erase(std::remove_if(pendingMarks_.begin(), pendingMarks_.end(),
+                                           [detached](auto const &mark) { return mark.first == detached; }),
+                            pendingMarks_.end());
+        gapIndexes_.erase(iterator);
+      };
+    }
+    else
+    {
+      gapIndexes_[std::make_pair(siteID, instrumentID)] = gapIndex;
+    };
+  }
+
+  /// @brief      Inserts a row into the archive table using the cached insert statement. Values that are marked as missing by
+  ///             the validator are stored as NULL.
+  /// @param[in]  siteID: The site ID.
+  /// @param[in]  instrumentID: The instrument ID.
+  /// @param[in]  record: The validated record.
+  /// @returns    true if the row was inserted.
+  /// @throws     0x000B - DATABASE: SQLite error.
+  /// @version    2026-10-19/GGB - Function created.
+
+  bool CDatabaseSQLite::insertArchive(unsigned long siteID, unsigned long instrumentID, STimeSeriesRecord const &record)
+  {
+    WCL_TRACE_SPAN("sqlite", "CDatabaseSQLite::insertArchive");
+
+    sqlite3_stmt *stmt = statement(bulkLoad_ ? STMT_ARCHIVE_LOAD : STMT_ARCHIVE_INSERT);
+    int column = 1;
+
+    sqlite3_bind_int64(stmt, column++, siteID);
+    sqlite3_bind_int64(stmt, column++, instrumentID);
+    sqlite3_bind_int64(stmt, column++, record.MJD());
+    sqlite3_bind_int(stmt, column++, record.time());
+
+    forEachObservationField([&](auto index)
+    {
+      constexpr SObservationField field = observationFields[decltype(index)::value];
+
+      if constexpr (field.type == OT_DOUBLE)
+      {
+        double value = observationLoad<double>(record, field.offset);
+
+        if (std::isnan(value))
+        {
+          sqlite3_bind_null(stmt, column++);
+        }
+        else
+        {
+          sqlite3_bind_double(stmt, column++, value);
+        };
+      }
+      else
+      {
+        using value_type = typename std::conditional<field.type == OT_UINT16, std::uint16_t, std::uint8_t>::type;
+        value_type value = observationLoad<value_type>(record, field.offset);
+
+        if (value == field.marker)
+        {
+          sqlite3_bind_null(stmt, column++);
+        }
+        else
+        {
+          sqlite3_bind_int64(stmt, column++, value);
+        };
+      };
+    });
+
+    step(stmt);
+    if (stationCache_ != nullptr)
+    {
+      stationCache_->archiveInserted(siteID, instrumentID, record.key);
+    };
+
+    if (!gapIndexes_.empty())
+    {
+      auto iterator = gapIndexes_.find(std::make_pair(siteID, instrumentID));
+
+      if (iterator != gapIndexes_.end())
+      {
+        if (inTransaction_)
+        {
+          pendingMarks_.emplace_back(iterator->second, record.key);
+        }
+        else
+        {
+          iterator->second->mark(record.key);
+        };
+      };
+    };
+    rowInserted();
+
+    return (bulkLoad_ || sqlite3_changes(database_) != 0);
+  }
+
+  /// @brief      Inserts a daily summary into the database.
+  /// @param[in]  siteID: The site ID.
+  /// @param[in]  instrumentID: The instrument ID.
+  /// @param[in]  record1: The first daily summary record.
+  /// @param[in]  record2: The second daily summary record.
+  /// @param[in]  JD: The date of the summary.
+  /// @returns    true if the record was inserted. false if it already existed.
+  /// @throws     0x000B - DATABASE: SQLite error.
+  /// @version    2026-10-19/GGB - Function created.
+
+  bool CDatabaseSQLite::insertDailySummary(unsigned long siteID, unsigned long instrumentID, SDailySummary1 const &record1,
+                                           SDailySummary2 const &record2, ACL::TJD const &JD)
+  {
+    sqlite3_stmt *stmt = statement(STMT_DAYSUMMARY_INSERT);
+    int column = 1;
+    bool returnValue;
+    std::int16_t const temperatures[] = { record1.hiOutTemp, record1.lowOutTemp, record1.hiInTemp, record1.lowInTemp,
+                                          record1.avgOutTemp, record1.avgInTemp, record1.hiChill, record1.lowChill,
+                                          record1.hiDew, record1.lowDew, record1.avgChill, record1.avgDew };
+    std::int16_t const humidities[] = { record1.hiOutHum, record1.lowOutHum, record1.hiInHum, record1.lowInHum, record1.avgOutHum };
+    std::int16_t const pressures[] = { record1.hiBar, record1.lowBar, record1.avgBar };
+
+    sqlite3_bind_int64(stmt, column++, siteID);
+    sqlite3_bind_int64(stmt, column++, instrumentID);
+    sqlite3_bind_int64(stmt, column++, std::llround(JD.MJD()));
+
+    for (std::int16_t value : temperatures)
+    {
+      sqlite3_bind_double(stmt, column++, temperature(value));
+    };
+    for (std::int16_t value : humidities)
+    {
+      sqlite3_bind_double(stmt, column++, humidity(value));
+    };
+    for (std::int16_t value : pressures)
+    {
+      sqlite3_bind_double(stmt, column++, pressure(value));
+    };
+
+    sqlite3_bind_double(stmt, column++, speed(record1.hiSpeed));
+    sqlite3_bind_double(stmt, column++, speed(record1.avgSpeed));
+    sqlite3_bind_double(stmt, column++, rainfall(record1.dailyRainTotal));
+    sqlite3_bind_double(stmt, column++, rainRate(record1.hiRainRate));
+    sqlite3_bind_int(stmt, column++, static_cast<unsigned int>(record1.dailyUVDose));
+    sqlite3_bind_int(stmt, column++, static_cast<unsigned int>(record1.hiUV));
+    sqlite3_bind_int(stmt, column++, static_cast<unsigned int>(record2.dailySolarEnergy));
+    sqlite3_bind_int(stmt, column++, static_cast<unsigned int>(record2.minSunlight));
+
+    step(stmt);
+    returnValue = (sqlite3_changes(database_) != 0);
+    if (returnValue && (stationCache_ != nullptr))
+    {
+      stationCache_->summaryInserted(siteID, instrumentID, static_cast<std::uint32_t>(std::llround(JD.MJD())));
+    };
+    rowInserted();
+
+    return returnValue;
+  }
+
+  /// @brief      Inserts an archive record downloaded from the console.
+  /// @param[in]  siteID: The site ID.
+  /// @param[in]  instrumentID: The instrument ID.
+  /// @param[in]  record: The record to insert.
+  /// @returns    true if the record was inserted. false if it was invalid or already existed.
+  /// @throws     0x000B - DATABASE: SQLite error.
+  /// @version    2026-10-19/GGB - Function created.
+
+  bool CDatabaseSQLite::insertRecord(unsigned long siteID, unsigned long instrumentID, SArchiveRecord &record)
+  {
+    WCL_TRACE_SPAN("sqlite", "CDatabaseSQLite::insertRecord");
+
+    STimeSeriesRecord tsr;
+    bool returnValue = false;
+
+    if (CTimeSeriesStore::convert(record, tsr))
+    {
+      validator(siteID, instrumentID).validate(tsr);
+      returnValue = insertArchive(siteID, instrumentID, tsr);
+    };
+
+    return returnValue;
+  }
+
+  /// @brief      Inserts an archive record read from a .wlk file.
+  /// @param[in]  siteID: The site ID.
+  /// @param[in]  instrumentID: The instrument ID.
+  /// @param[in]  record: The record to insert.
+  /// @param[in]  JD: The date of the record.
+  /// @returns    true if the record was inserted. false if it already existed.
+  /// @throws     0x000B - DATABASE: SQLite error.
+  /// @throws     CODE_ERROR - Unknown rain collector type.
+  /// @version    2026-10-19/GGB - Function created.
+
+  bool CDatabaseSQLite::insertRecord(unsigned long siteID, unsigned long instrumentID, SWeatherDataRecord const &record,
+                                     ACL::TJD const &JD)
+  {
+    WCL_TRACE_SPAN("sqlite", "CDatabaseSQLite::insertRecord");
+
+    STimeSeriesRecord tsr;
+
+    CTimeSeriesStore::convert(record, static_cast<std::uint32_t>(std::llround(JD.MJD())), tsr);
+    validator(siteID, instrumentID).validate(tsr);
+
+    return insertArchive(siteID, instrumentID, tsr);
+  }
+
+  /// @brief      Gets the time of the last weather record for the site and instrument.
+  /// @param[out] MJD: The MJD of the last record.
+  /// @param[out] time: The time of the last record.
+  /// @returns    true if a record was found.
+  /// @note       A station held by the attached station cache is answered from the cache.
+  /// @throws     0x000B - DATABASE: SQLite error.
+  /// @version    2026-10-19/GGB - Function created.
+
+  bool CDatabaseSQLite::lastWeatherRecord(unsigned long siteID, unsigned long instrumentID, std::uint16_t &MJD, std::uint16_t &time)
+  {
+    WCL_TRACE_SPAN("sqlite", "CDatabaseSQLite::lastWeatherRecord");
+
+    bool returnValue = false;
+    SStationState const *state = (stationCache_ != nullptr) ? stationCache_->find(siteID, instrumentID) : nullptr;
+
+    if (state != nullptr)
+    {
+      MJD = state->lastMJD;
+      time = state->lastTime;
+      returnValue = state->hasLast;
+    }
+    else
+    {
+      sqlite3_stmt *stmt = statement(STMT_ARCHIVE_LAST);
+
+      sqlite3_bind_int64(stmt, 1, siteID);
+      sqlite3_bind_int64(stmt, 2, instrumentID);
+
+      if (step(stmt))
+      {
+        MJD = static_cast<std::uint16_t>(sqlite3_column_int(stmt, 0));
+        time = static_cast<std::uint16_t>(sqlite3_column_int(stmt, 1));
+        returnValue = true;
+      };
+      sqlite3_reset(stmt);
+    };
+
+    return returnValue;
+  }
+
+  /// @brief      Opens (or creates) the database file. The journal is placed in WAL mode. A writer waits up to BUSY_TIMEOUT for
+  ///             another connection to release the write lock.
+  /// @param[in]  fileName: The name of the database file.
+  /// @param[in]  sync: The synchronous level to use.
+  /// @throws     0x000A - DATABASE: Unable to open SQLite database
+  /// @throws     0x000B - DATABASE: SQLite error.
+  /// @version    2026-10-19/GGB - Function created.
+
+  void CDatabaseSQLite::openDatabase(std::string const &fileName, ESynchronous sync)
+  {
+    closeDatabase();
+
+    if (sqlite3_open_v2(fileName.c_str(), &database_, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE | SQLITE_OPEN_NOMUTEX,
+                        nullptr) != SQLITE_OK)
+    {
+      ERRORMESSAGE(std::string("SQLite: ") + sqlite3_errmsg(database_));
+      sqlite3_close_v2(database_);
+      database_ = nullptr;
+      WCL_ERROR(0x000A);
+    };
+
+    sqlite3_busy_timeout(database_, BUSY_TIMEOUT);
+    execute("PRAGMA journal_mode = WAL");
+    execute("PRAGMA temp_store = MEMORY");
+    execute("PRAGMA cache_size = -65536");      // 64MiB
+    synchronous(sync);
+    createSchema();
+  }
+
+  /// @brief      Reads the keys of the archive records for a range of days. Only the key columns are read, so the query is
+  ///             answered from the archive key index.
+  /// @param[in]  siteID: The site ID.
+  /// @param[in]  instrumentID: The instrument ID.
+  /// @param[in]  fromMJD: The first day to read.
+  /// @param[in]  toMJD: The last day to read (inclusive).
+  /// @param[in]  callback: Called with the MJD and time (HHMM) of each record.
+  /// @returns    The number of keys read.
+  /// @throws     0x000B - DATABASE: SQLite error.
+  /// @version    2026-10-19/GGB - Function created.
+
+  std::size_t CDatabaseSQLite::readKeys(unsigned long siteID, unsigned long instrumentID, std::uint32_t fromMJD, std::uint32_t toMJD,
+                                        std::function<void(std::uint32_t, std::uint16_t)> callback)
+  {
+    sqlite3_stmt *stmt = statement(STMT_ARCHIVE_KEYS);
+    std::size_t returnValue = 0;
+
+    sqlite3_bind_int64(stmt, 1, siteID);
+    sqlite3_bind_int64(stmt, 2, instrumentID);
+    sqlite3_bind_int64(stmt, 3, fromMJD);
+    sqlite3_bind_int64(stmt, 4, toMJD);
+
+    while (step(stmt))
+    {
+      callback(static_cast<std::uint32_t>(sqlite3_column_int64(stmt, 0)), static_cast<std::uint16_t>(sqlite3_column_int(stmt, 1)));
+      returnValue++;
+    };
+    sqlite3_reset(stmt);
+
+    return returnValue;
+  }
+
+  /// @brief      Reads the archive records in a range of keys, in key order. The rows are stepped one at a time, so the range can
+  ///             be of any size.
+  /// @param[in]  siteID: The site ID.
+  /// @param[in]  instrumentID: The instrument ID.
+  /// @param[in]  fromKey: The first key (MJD * 10000 + HHMM) to read.
+  /// @param[in]  toKey: The last key to read (inclusive).
+  /// @param[in]  callback: Called for each record. Return false to stop reading.
+  /// @returns    The number of records passed to the callback.
+  /// @note       NULL values are returned as NaN, or as the CRecordValidator missing marker for the integer columns.
+  /// @throws     0x000B - DATABASE: SQLite error.
+  /// @version    2026-10-19/GGB - Function created.
+
+  std::size_t CDatabaseSQLite::readRange(unsigned long siteID, unsigned long instrumentID, std::uint32_t fromKey,
+                                         std::uint32_t toKey, std::function<bool(STimeSeriesRecord const &)> callback)
+  {
+    WCL_TRACE_SPAN("sqlite", "CDatabaseSQLite::readRange");
+
+    sqlite3_stmt *stmt = statement(STMT_ARCHIVE_RANGE);
+    std::size_t returnValue = 0;
+    STimeSeriesRecord record;
+    bool more = true;
+
+    sqlite3_bind_int64(stmt, 1, siteID);
+    sqlite3_bind_int64(stmt, 2, instrumentID);
+    sqlite3_bind_int64(stmt, 3, fromKey / 10000);
+    sqlite3_bind_int64(stmt, 4, toKey / 10000);
+    sqlite3_bind_int64(stmt, 5, fromKey);
+    sqlite3_bind_int64(stmt, 6, toKey);
+
+    std::memset(&record, 0, sizeof(record));
+
+    while (more && step(stmt))
+    {
+      record.key = STimeSeriesRecord::makeKey(static_cast<std::uint32_t>(sqlite3_column_int64(stmt, 0)),
+                                              static_cast<std::uint16_t>(sqlite3_column_int(stmt, 1)));
+
+      forEachObservationField([&](auto index)
+      {
+        constexpr SObservationField field = observationFields[decltype(index)::value];
+        int column = static_cast<int>(decltype(index)::value) + 2;
+
+        if constexpr (field.type == OT_DOUBLE)
+        {
+          observationStore(record, field.offset, (sqlite3_column_type(stmt, column) == SQLITE_NULL)
+                                                   ? std::numeric_limits<double>::quiet_NaN()
+                                                   : sqlite3_column_double(stmt, column));
+        }
+        else if constexpr (field.type == OT_UINT16)
+        {
+          observationStore(record, field.offset, integer(stmt, column, field.marker));
+        }
+        else
+        {
+          observationStore(record, field.offset, static_cast<std::uint8_t>(integer(stmt, column, field.marker)));
+        };
+      });
+
+      more = callback(record);
+      returnValue++;
+    };
+    sqlite3_reset(stmt);
+
+    return returnValue;
+  }
+
+  /// @brief      Reads the days of a series that have a daily summary, in order.
+  /// @param[in]  siteID: The site ID.
+  /// @param[in]  instrumentID: The instrument ID.
+  /// @param[in]  callback: Called with the MJD of each day.
+  /// @returns    The number of days read.
+  /// @throws     0x000B - DATABASE: SQLite error.
+  /// @version    2026-10-19/GGB - Function created.
+
+  std::size_t CDatabaseSQLite::readSummaryDays(unsigned long siteID, unsigned long instrumentID,
+                                               std::function<void(std::uint32_t)> callback)
+  {
+    sqlite3_stmt *stmt = statement(STMT_DAYSUMMARY_DAYS);
+    std::size_t returnValue = 0;
+
+    sqlite3_bind_int64(stmt, 1, siteID);
+    sqlite3_bind_int64(stmt, 2, instrumentID);
+
+    while (step(stmt))
+    {
+      callback(static_cast<std::uint32_t>(sqlite3_column_int64(stmt, 0)));
+      returnValue++;
+    };
+    sqlite3_reset(stmt);
+
+    return returnValue;
+  }
+
+  /// @brief      Checks if a record exists.
+  /// @param[in]  siteID: The site ID.
+  /// @param[in]  instrumentID: The instrument ID.
+  /// @param[in]  JD: The date of the record.
+  /// @param[in]  time: The time of the record (HHMM).
+  /// @returns    true if the record exists.
+  /// @note       During a bulk load the key index does not exist and this becomes a table scan.
+  /// @throws     0x000B - DATABASE: SQLite error.
+  /// @version    2026-10-19/GGB - Function created.
+
+  bool CDatabaseSQLite::recordExists(unsigned long siteID, unsigned long instrumentID, ACL::TJD JD, std::uint16_t time)
+  {
+    WCL_TRACE_SPAN("sqlite", "CDatabaseSQLite::recordExists");
+
+    sqlite3_stmt *stmt = statement(STMT_ARCHIVE_EXISTS);
+    bool returnValue;
+
+    sqlite3_bind_int64(stmt, 1, siteID);
+    sqlite3_bind_int64(stmt, 2, instrumentID);
+    sqlite3_bind_int64(stmt, 3, std::llround(JD.MJD()));
+    sqlite3_bind_int(stmt, 4, time);
+
+    returnValue = step(stmt);
+    sqlite3_reset(stmt);
+
+    return returnValue;
+  }
+
+  /// @brief    Rolls back the active transaction (if any). The gap index marks of the transaction are dropped and the station
+  ///           cache is cleared, as it may hold the rows that were rolled back. The stations are reloaded from the database.
+  /// @throws   None.
+  /// @version  2026-10-19/GGB - Function created.
+
+  void CDatabaseSQLite::rollbackTransaction() noexcept
+  {
+    WCL_TRACE_SPAN("sqlite", "CDatabaseSQLite::rollbackTransaction");
+
+    if (inTransaction_)
+    {
+      if (!sqlite3_get_autocommit(database_))
+      {
+        sqlite3_exec(database_, "ROLLBACK", nullptr, nullptr, nullptr);
+      };
+      inTransaction_ = false;
+      transactionRows_ = 0;
+      pendingMarks_.clear();
+
+      if (stationCache_ != nullptr)
+      {
+        stationCache_->clear();
+      };
+    };
+  }
+
+  /// @brief    Merges the rows of the load table into the archive and empties the load table. The rows are inserted in key
+  ///           order, so the archive key index is written in order. A row whose key is already in the archive, or that was
+  ///           loaded earlier, is ignored. Only the load table is scanned, whatever the size of the archive.
+  /// @throws   0x000B - DATABASE: SQLite error.
+  /// @version  2026-10-19/GGB - Function created.
+
+  void CDatabaseSQLite::mergeLoad()
+  {
+    WCL_TRACE_SPAN("sqlite", "CDatabaseSQLite::mergeLoad");
+
+    std::string const columns = "SITE_ID, INSTRUMENT_ID, MJD, TIME" + observationColumns(false);
+
+    beginTransaction();
+    execute(("INSERT OR IGNORE INTO TBL_ARCHIVE(" + columns + ") SELECT " + columns + " FROM TBL_ARCHIVE_LOAD "
+             "ORDER BY SITE_ID, INSTRUMENT_ID, MJD, TIME, rowid").c_str());
+    execute("DELETE FROM TBL_ARCHIVE_LOAD");
+    commitTransaction();
+  }
+
+  /// @brief    Counts the rows in the current transaction, committing when the bulk transaction size is reached.
+  /// @throws   0x000B - DATABASE: SQLite error.
+  /// @version  2026-10-19/GGB - Function created.
+
+  void CDatabaseSQLite::rowInserted()
+  {
+    if (inTransaction_ && bulkLoad_ && (++transactionRows_ >= bulkTransactionSize_))
+    {
+      commitTransaction();
+      beginTransaction();
+    };
+  }
+
+  /// @brief      Returns the cached prepared statement. The statement is prepared on first use.
+  /// @param[in]  stmt: The statement required.
+  /// @returns    The prepared statement, reset and with bindings cleared.
+  /// @throws     0x000B - DATABASE: SQLite error.
+  /// @version    2026-10-19/GGB - Function created.
+
+  sqlite3_stmt *CDatabaseSQLite::statement(EStatement stmt)
+  {
+    sqlite3_stmt *&returnValue = statements_[stmt];
+
+    if (returnValue == nullptr)
+    {
+      if (sqlite3_prepare_v3(database_, statementText[stmt].c_str(), -1, SQLITE_PREPARE_PERSISTENT, &returnValue,
+                             nullptr) != SQLITE_OK)
+      {
+        ERRORMESSAGE(std::string("SQLite: ") + sqlite3_errmsg(database_));
+        WCL_ERROR(0x000B);
+      };
+    }
+    else
+    {
+      sqlite3_reset(returnValue);
+      sqlite3_clear_bindings(returnValue);
+    };
+
+    return returnValue;
+  }
+
+  /// @brief      Steps a statement.
+  /// @param[in]  stmt: The statement to step.
+  /// @returns    true if a row is available. false if the statement is complete.
+  /// @throws     0x000B - DATABASE: SQLite error.
+  /// @version    2026-10-19/GGB - Function created.
+
+  bool CDatabaseSQLite::step(sqlite3_stmt *stmt)
+  {
+    bool returnValue = false;
+    int rc = sqlite3_step(stmt);
+
+    if (rc == SQLITE_ROW)
+    {
+      returnValue = true;
+    }
+    else if (rc == SQLITE_DONE)
+    {
+      sqlite3_reset(stmt);
+    }
+    else
+    {
+      ERRORMESSAGE(std::string("SQLite: ") + sqlite3_errmsg(database_));
+      sqlite3_reset(stmt);
+      WCL_ERROR(0x000B);
+    };
+
+    return returnValue;
+  }
+
+  /// @brief      Sets the synchronous level of the database.
+  /// @param[in]  sync: The synchronous level. During a bulk load the new level is applied when the load ends.
+  /// @throws     0x000B - DATABASE: SQLite error.
+  /// @version    2026-10-19/GGB - Function created.
+
+  void CDatabaseSQLite::synchronous(ESynchronous sync)
+  {
+    static char const *pragma[] = { "PRAGMA synchronous = OFF", "PRAGMA synchronous = NORMAL",
+                                    "PRAGMA synchronous = FULL", "PRAGMA synchronous = EXTRA" };
+
+    synchronous_ = sync;
+    if (!bulkLoad_)
+    {
+      execute(pragma[sync]);
+    };
+  }
+
+  /// @brief      Returns the validator of a series. The validator holds the last accepted values for the spike test.
+  /// @param[in]  siteID: The site ID.
+  /// @param[in]  instrumentID: The instrument ID.
+  /// @returns    The validator.
+  /// @throws     std::bad_alloc
+  /// @version    2026-10-19/GGB - Function created.
+
+  CRecordValidator &CDatabaseSQLite::validator(unsigned long siteID, unsigned long instrumentID)
+  {
+    return validators_[std::make_pair(siteID, instrumentID)];
+  }
+
+  /// @brief      Returns the watermark of the database: the largest rowid of the archive and daily summary tables. Rows are
+  ///             only added with larger rowids, so the watermark changes when rows are inserted. MAX(rowid) is read from the end
+  ///             of the table b-tree, so the query does not depend on the size of the tables.
+  /// @returns    The watermark. Zero for an empty table.
+  /// @throws     0x000B - DATABASE: SQLite error.
+  /// @version    2026-10-19/GGB - Function created.
+
+  SStoreWatermark CDatabaseSQLite::watermark()
+  {
+    sqlite3_stmt *stmt = statement(STMT_WATERMARK);
+    SStoreWatermark returnValue;
+
+    if (step(stmt))
+    {
+      returnValue.archiveRows = sqlite3_column_int64(stmt, 0);
+      returnValue.summaryRows = sqlite3_column_int64(stmt, 1);
+    };
+    sqlite3_reset(stmt);
+
+    return returnValue;
+  }
+
+} // namespace WCL
@@ -80,6 +80,9 @@ namespace WCL
       {0x0005, "DATABSE: Unable to open OracleXE database."},
       {0x0006, "DATABASE: Unable to Open MySQL database."},
       {0x000A, "DATABASE: Unable to open SQLite database"},
+      {0x000B, "DATABASE: SQLite error."},
+      {0x000C, "WINDROSE: Invalid wind rose layout."},
+      {0x000D, "EXPORT: Unable to write the export file."},
       {0x3002, "DATABASE: Unknown rain guage size."},
     };
 
@@ -0,0 +1,529 @@
+﻿//*********************************************************************************************************************************
+//
+// PROJECT:							Weather Class Library (WCL)
+// FILE:								exporter
+// SUBSYSTEM:						CSV and JSON lines export of archive records
+// LANGUAGE:						C++
+// TARGET OS:						WINDOWS/UNIX/LINUX/MAC
+// LIBRARY DEPENDANCE:	boost::filesystem
+// NAMESPACE:						WCL
+// AUTHOR:							Gavin Blakeman.
+// LICENSE:             GPLv2
+//
+//                      Copyright 2026 Gavin Blakeman.
+//                      This file is part of the Weather Class Library (WCL).
+//
+//                      WCL is free software: you can redistribute it and/or modify it under the terms of the GNU General
+//                      Public License as published by the Free Software Foundation, either version 2 of the License, or (at your
+//                      option) any later version.
+//
+//                      WCL is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the
+//                      implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//                      for more details.
+//
+//                      You should have received a copy of the GNU General Public License along with WCL.  If not, see
+//                      <http://www.gnu.org/licenses/>.
+//
+// OVERVIEW:						Implements the CSV and JSON lines exporter.
+//
+// CLASSES INCLUDED:    CRecordSink
+//                      CRecordExporter
+//
+// CLASS HIERARCHY:     CRecordSink
+//                        - CRecordExporter
+//
+// HISTORY:             2026-10-19 GGB - File Created
+//
+//*********************************************************************************************************************************
+
+#include "include/exporter.h"
+
+  // Standard C++ library header files.
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+
+  // Miscellaneous library header files.
+
+#include <GCL>
+
+  // WCL header files
+
+#include "include/error.h"
+#include "include/observation.h"
+#include "include/replay.h"
+#include "include/timestamp.h"
+#include "include/validation.h"
+#include "include/WeatherLink.h"
+
+namespace WCL
+{
+  static std::size_t const MAX_ROW_LENGTH = 4096;       ///< Space kept free in the buffer before formatting a row.
+  static std::uint32_t const EXPORT_CHUNK_DAYS = 31;    ///< Days read at a time from the time series store.
+
+  static_assert(static_cast<std::size_t>(CRecordExporter::COL_COUNT) ==
+                static_cast<std::size_t>(CRecordExporter::COL_OUTSIDE_TEMP) + static_cast<std::size_t>(VF_COUNT),
+                "Value columns must be in observation field order.");
+
+  /// @brief      Writes a number with a fixed number of digits.
+  /// @param[in]  out: The output position.
+  /// @param[in]  value: The value to write.
+  /// @param[in]  digits: The number of digits.
+  /// @returns    The position after the digits.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  static inline char *fixedDigits(char *out, int value, int digits)
+  {
+    for (int index = digits - 1; index >= 0; index--)
+    {
+      out[index] = static_cast<char>('0' + value % 10);
+      value /= 10;
+    };
+
+    return out + digits;
+  }
+
+  //********************************************************************************************************************************
+  //
+  // CRecordSink
+  //
+  //********************************************************************************************************************************
+
+  /// @brief      Exports all the archive records of a .wlk file. The records are validated and written a day at a time.
+  /// @param[in]  fileName: The file. The name must be of the form YYYY-MM.wlk.
+  /// @returns    The number of records exported.
+  /// @throws     0x0001 - APPLICATION: Unable to open data file.
+  /// @throws     0x000D - EXPORT: Unable to write the export file.
+  /// @throws     CODE_ERROR - Unknown rain collector type.
+  /// @version    2026-10-19/GGB - Function created.
+
+  std::size_t CRecordSink::exportFile(boost::filesystem::path const &fileName)
+  {
+    CWeatherLinkDatabaseFile file(fileName);
+    std::vector<STimeSeriesRecord> records;
+    std::size_t returnValue = 0;
+    int year, month;
+
+    if (!CReplayDriver::fileDate(fileName, year, month) || !file.openFile())
+    {
+      WCL_ERROR(0x0001);
+    };
+
+    while (file.nextDayRecord())
+    {
+      std::uint32_t MJD = static_cast<std::uint32_t>(TTimestamp(year, month, file.getDay()).MJD());
+
+      records.clear();
+      while (file.nextArchiveRecord())
+      {
+        records.emplace_back();
+        CTimeSeriesStore::convert(file.getArchiveRecord(), MJD, records.back());
+      };
+      validator_.validate(records.data(), records.size());
+      write(records.data(), records.size());
+      returnValue += records.size();
+    };
+
+    return returnValue;
+  }
+
+  /// @brief      Exports a range of records from the SQLite database.
+  /// @param[in]  database: The database.
+  /// @param[in]  siteID: The site ID.
+  /// @param[in]  instrumentID: The instrument ID.
+  /// @param[in]  fromKey: The first key (MJD * 10000 + HHMM).
+  /// @param[in]  toKey: The last key (inclusive).
+  /// @returns    The number of records exported.
+  /// @throws     0x000B - DATABASE: SQLite error.
+  /// @throws     0x000D - EXPORT: Unable to write the export file.
+  /// @version    2026-10-19/GGB - Function created.
+
+  std::size_t CRecordSink::exportRange(CDatabaseSQLite &database, unsigned long siteID, unsigned long instrumentID,
+                                       std::uint32_t fromKey, std::uint32_t toKey)
+  {
+    return database.readRange(siteID, instrumentID, fromKey, toKey,
+                              [this] (STimeSeriesRecord const &record) { write(record); return true; });
+  }
+
+  /// @brief      Exports a range of records from the time series store. The range is read a month at a time.
+  /// @param[in]  store: The store.
+  /// @param[in]  siteID: The site ID.
+  /// @param[in]  instrumentID: The instrument ID.
+  /// @param[in]  fromKey: The first key (MJD * 10000 + HHMM).
+  /// @param[in]  toKey: The last key (inclusive).
+  /// @returns    The number of records exported.
+  /// @throws     0x000D - EXPORT: Unable to write the export file.
+  /// @version    2026-10-19/GGB - Function created.
+
+  std::size_t CRecordSink::exportRange(CTimeSeriesStore &store, unsigned long siteID, unsigned long instrumentID,
+                                       std::uint32_t fromKey, std::uint32_t toKey)
+  {
+    std::vector<STimeSeriesRecord> records;
+    std::size_t returnValue = 0;
+
+    for (std::uint32_t MJD = fromKey / 10000; MJD <= toKey / 10000; MJD += EXPORT_CHUNK_DAYS)
+    {
+      std::uint32_t first = std::max(fromKey, MJD * 10000);
+      std::uint32_t last = std::min(toKey, (MJD + EXPORT_CHUNK_DAYS) * 10000 - 1);
+
+      records.clear();
+      store.readRange(siteID, instrumentID, first, last, records);
+      write(records.data(), records.size());
+      returnValue += records.size();
+    };
+
+    return returnValue;
+  }
+
+  /// @brief      Writes a block of records. The default writes the records one at a time.
+  /// @param[in]  records: The records to write.
+  /// @param[in]  count: The number of records.
+  /// @throws     0x000D - EXPORT: Unable to write the export file.
+  /// @version    2026-10-19/GGB - Function created.
+
+  void CRecordSink::write(STimeSeriesRecord const *records, std::size_t count)
+  {
+    for (std::size_t index = 0; index < count; index++)
+    {
+      write(records[index]);
+    };
+  }
+
+  //********************************************************************************************************************************
+  //
+  // CRecordExporter
+  //
+  //********************************************************************************************************************************
+
+  /// @brief      Constructs an exporter writing to a file.
+  /// @param[in]  fileName: The file to create.
+  /// @param[in]  format: The output format.
+  /// @param[in]  bufferSize: The size of the output buffer.
+  /// @throws     0x0001 - APPLICATION: Unable to open data file.
+  /// @version    2026-10-19/GGB - Function created.
+
+  CRecordExporter::CRecordExporter(boost::filesystem::path const &fileName, EFormat format, std::size_t bufferSize)
+    : file_(std::fopen(fileName.string().c_str(), "wb")), ownsFile_(true), format_(format),
+      buffer_(std::max(bufferSize, 2 * MAX_ROW_LENGTH))
+  {
+    if (file_ == nullptr)
+    {
+      WCL_ERROR(0x0001);
+    };
+
+    std::setvbuf(file_, nullptr, _IONBF, 0);      // All the buffering is done in buffer_.
+    columns({ COL_TIMESTAMP, COL_OUTSIDE_TEMP, COL_HI_OUTSIDE_TEMP, COL_LOW_OUTSIDE_TEMP, COL_INSIDE_TEMP, COL_BAROMETER,
+              COL_OUTSIDE_HUMIDITY, COL_INSIDE_HUMIDITY, COL_RAIN, COL_HI_RAIN_RATE, COL_WIND_SPEED, COL_HI_WIND_SPEED,
+              COL_WIND_DIRECTION, COL_SOLAR_RAD, COL_HI_SOLAR_RAD, COL_UV, COL_HI_UV });
+  }
+
+  /// @brief      Constructs an exporter writing to an open stream (eg stdout). The stream is not closed by the exporter.
+  /// @param[in]  file: The stream to write to.
+  /// @param[in]  format: The output format.
+  /// @param[in]  bufferSize: The size of the output buffer.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  CRecordExporter::CRecordExporter(std::FILE *file, EFormat format, std::size_t bufferSize) : file_(file), ownsFile_(false),
+    format_(format), buffer_(std::max(bufferSize, 2 * MAX_ROW_LENGTH))
+  {
+    columns({ COL_TIMESTAMP, COL_OUTSIDE_TEMP, COL_HI_OUTSIDE_TEMP, COL_LOW_OUTSIDE_TEMP, COL_INSIDE_TEMP, COL_BAROMETER,
+              COL_OUTSIDE_HUMIDITY, COL_INSIDE_HUMIDITY, COL_RAIN, COL_HI_RAIN_RATE, COL_WIND_SPEED, COL_HI_WIND_SPEED,
+              COL_WIND_DIRECTION, COL_SOLAR_RAD, COL_HI_SOLAR_RAD, COL_UV, COL_HI_UV });
+  }
+
+  /// @brief    Destructor. Writes any buffered rows and closes the file.
+  /// @throws   None.
+  /// @version  2026-10-19/GGB - Function created.
+
+  CRecordExporter::~CRecordExporter()
+  {
+    try
+    {
+      flush();
+    }
+    catch(...)
+    {
+    };
+
+    if (ownsFile_)
+    {
+      std::fclose(file_);
+    };
+  }
+
+  /// @brief      Returns the name of a column. The names match the columns of TBL_ARCHIVE and are taken from the observation
+  ///             fields for the value columns.
+  /// @param[in]  column: The column.
+  /// @returns    The name.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  char const *CRecordExporter::columnName(EColumn column)
+  {
+    static char const *const keyColumns[] = { "timestamp", "MJD", "time" };
+
+    return (column < COL_OUTSIDE_TEMP) ? keyColumns[column] : observationFields[column - COL_OUTSIDE_TEMP].name;
+  }
+
+  /// @brief      Selects the columns to export. Must be called before the first row is written.
+  /// @param[in]  columns: The columns, in output order.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  void CRecordExporter::columns(std::vector<EColumn> const &columns)
+  {
+    if (!headerWritten_)
+    {
+      columns_ = columns;
+      setFormats();
+    };
+  }
+
+  /// @brief      Writes the buffered rows to the file.
+  /// @throws     0x000D - EXPORT: Unable to write the export file.
+  /// @version    2026-10-19/GGB - Function created.
+
+  void CRecordExporter::flush()
+  {
+    if (used_ != 0)
+    {
+      if (std::fwrite(buffer_.data(), 1, used_, file_) != used_)
+      {
+        used_ = 0;
+        WCL_ERROR(0x000D);
+      };
+      used_ = 0;
+    };
+  }
+
+  /// @brief      Formats the value of a column.
+  /// @param[in]  first: The output position.
+  /// @param[in]  last: The end of the output buffer.
+  /// @param[in]  column: The column to format.
+  /// @param[in]  record: The record.
+  /// @returns    The position after the value. Missing values are empty in CSV and null in JSON.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  char *CRecordExporter::formatValue(char *first, char *last, EColumn column, STimeSeriesRecord const &record) const
+  {
+    switch (column)
+    {
+      case COL_TIMESTAMP:
+      {
+        int year, month, day;
+        std::uint16_t time = record.time();
+
+        TTimestamp::fromMJD(static_cast<std::int32_t>(record.MJD()), time).date(year, month, day);
+        if (format_ == FORMAT_JSON_LINES)
+        {
+          *first++ = '"';
+        };
+        first = fixedDigits(first, year, 4);
+        *first++ = '-';
+        first = fixedDigits(first, month, 2);
+        *first++ = '-';
+        first = fixedDigits(first, day, 2);
+        *first++ = 'T';
+        first = fixedDigits(first, time / 100, 2);
+        *first++ = ':';
+        first = fixedDigits(first, time % 100, 2);
+        if (format_ == FORMAT_JSON_LINES)
+        {
+          *first++ = '"';
+        };
+        return first;
+      };
+      case COL_MJD:
+        return std::to_chars(first, last, record.MJD()).ptr;
+      case COL_TIME:
+        return std::to_chars(first, last, record.time()).ptr;
+      default:
+      {
+        EValidatedField field = static_cast<EValidatedField>(column - COL_OUTSIDE_TEMP);
+        SObservationField const &descriptor = observationFields[field];
+
+        if (CRecordValidator::missing(record, field))
+        {
+          if (format_ == FORMAT_JSON_LINES)
+          {
+            std::memcpy(first, "null", 4);
+            first += 4;
+          };
+          return first;
+        };
+
+        switch (descriptor.type)
+        {
+          case OT_DOUBLE:
+            return std::to_chars(first, last, columnFormat_[column].transform(observationLoad<double>(record, descriptor.offset)),
+                                 std::chars_format::fixed, columnFormat_[column].precision).ptr;
+          case OT_UINT16:
+            return std::to_chars(first, last, observationLoad<std::uint16_t>(record, descriptor.offset)).ptr;
+          case OT_UINT8:
+            return std::to_chars(first, last, observationLoad<std::uint8_t>(record, descriptor.offset)).ptr;
+          default:
+            CODE_ERROR;
+            return first;
+        };
+      };
+    };
+  }
+
+  /// @brief      Sets the scale, offset and precision of each column for the selected units.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  void CRecordExporter::setFormats()
+  {
+    static SColumnFormat const temperature[] = { {unitTransform(U_KELVIN, U_KELVIN), 2},
+                                                 {unitTransform(U_KELVIN, U_CELSIUS), 2},
+                                                 {unitTransform(U_KELVIN, U_FAHRENHEIT), 2} };
+    static SColumnFormat const pressure[] = { {unitTransform(U_PASCAL, U_PASCAL), 0},
+                                              {unitTransform(U_PASCAL, U_HECTOPASCAL), 2},
+                                              {unitTransform(U_PASCAL, U_INHG), 3} };
+    static SColumnFormat const speed[] = { {unitTransform(U_METRE_PER_SECOND, U_METRE_PER_SECOND), 2},
+                                           {unitTransform(U_METRE_PER_SECOND, U_KILOMETRE_PER_HOUR), 2},
+                                           {unitTransform(U_METRE_PER_SECOND, U_MILE_PER_HOUR), 2},
+                                           {unitTransform(U_METRE_PER_SECOND, U_KNOT), 2} };
+    static SColumnFormat const rain[] = { {unitTransform(U_MILLIMETRE, U_MILLIMETRE), 2}, {unitTransform(U_MILLIMETRE, U_INCH), 3} };
+    static SColumnFormat const rainRate[] = { {unitTransform(U_MILLIMETRE_PER_HOUR, U_MILLIMETRE_PER_HOUR), 2},
+                                              {unitTransform(U_MILLIMETRE_PER_HOUR, U_INCH_PER_HOUR), 3} };
+
+    columnFormat_.fill(SColumnFormat());
+
+    for (std::size_t field = 0; field < VF_COUNT; field++)
+    {
+      SColumnFormat &format = columnFormat_[COL_OUTSIDE_TEMP + field];
+
+      switch (dimension(observationFields[field].unit))
+      {
+        case D_TEMPERATURE:
+          format = temperature[units_.temperature];
+          break;
+        case D_PRESSURE:
+          format = pressure[units_.pressure];
+          break;
+        case D_SPEED:
+          format = speed[units_.speed];
+          break;
+        case D_LENGTH:
+          format = rain[units_.rain];
+          break;
+        case D_RATE:
+          format = rainRate[units_.rain];
+          break;
+        case D_FRACTION:
+          format.precision = 1;
+          break;
+        default:
+          break;
+      };
+    };
+  }
+
+  /// @brief      Selects the units of the exported values. Must be called before the first row is written.
+  /// @param[in]  units: The units.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  void CRecordExporter::units(SUnits const &units)
+  {
+    if (!headerWritten_)
+    {
+      units_ = units;
+      setFormats();
+    };
+  }
+
+  /// @brief      Writes a record.
+  /// @param[in]  record: The record to write.
+  /// @throws     0x000D - EXPORT: Unable to write the export file.
+  /// @version    2026-10-19/GGB - Function created.
+
+  void CRecordExporter::write(STimeSeriesRecord const &record)
+  {
+    if (!headerWritten_)
+    {
+      writeHeader();
+    };
+
+    if (buffer_.size() - used_ < MAX_ROW_LENGTH)
+    {
+      flush();
+    };
+
+    char *first = buffer_.data() + used_;
+    char *last = buffer_.data() + buffer_.size();
+    bool separator = false;
+
+    if (format_ == FORMAT_JSON_LINES)
+    {
+      *first++ = '{';
+    };
+
+    for (EColumn column : columns_)
+    {
+      if (separator)
+      {
+        *first++ = ',';
+      };
+      separator = true;
+
+      if (format_ == FORMAT_JSON_LINES)
+      {
+        std::size_t length = std::strlen(columnName(column));
+
+        *first++ = '"';
+        std::memcpy(first, columnName(column), length);
+        first += length;
+        *first++ = '"';
+        *first++ = ':';
+      };
+
+      first = formatValue(first, last, column, record);
+    };
+
+    if (format_ == FORMAT_JSON_LINES)
+    {
+      *first++ = '}';
+    };
+    *first++ = '\n';
+
+    used_ = static_cast<std::size_t>(first - buffer_.data());
+    rows_++;
+  }
+
+  /// @brief      Writes the CSV header line. Nothing is written for JSON lines.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  void CRecordExporter::writeHeader()
+  {
+    headerWritten_ = true;
+
+    if (format_ == FORMAT_CSV)
+    {
+      char *first = buffer_.data() + used_;
+
+      for (std::size_t index = 0; index < columns_.size(); index++)
+      {
+        std::size_t length = std::strlen(columnName(columns_[index]));
+
+        if (index != 0)
+        {
+          *first++ = ',';
+        };
+        std::memcpy(first, columnName(columns_[index]), length);
+        first += length;
+      };
+      *first++ = '\n';
+
+      used_ = static_cast<std::size_t>(first - buffer_.data());
+    };
+  }
+
+} // namespace WCL
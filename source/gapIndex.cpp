@@ -0,0 +1,535 @@
+﻿//*********************************************************************************************************************************
+//
+// PROJECT:							Weather Class Library (WCL)
+// FILE:								gapIndex
+// SUBSYSTEM:						Gap detection and backfill planning
+// LANGUAGE:						C++
+// TARGET OS:						WINDOWS/UNIX/LINUX/MAC
+// LIBRARY DEPENDANCE:	None.
+// NAMESPACE:						WCL
+// AUTHOR:							Gavin Blakeman.
+// LICENSE:             GPLv2
+//
+//                      Copyright 2026 Gavin Blakeman.
+//                      This file is part of the Weather Class Library (WCL).
+//
+//                      WCL is free software: you can redistribute it and/or modify it under the terms of the GNU General
+//                      Public License as published by the Free Software Foundation, either version 2 of the License, or (at your
+//                      option) any later version.
+//
+//                      WCL is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the
+//                      implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//                      for more details.
+//
+//                      You should have received a copy of the GNU General Public License along with WCL.  If not, see
+//                      <http://www.gnu.org/licenses/>.
+//
+// OVERVIEW:						Keeps an occupancy bitmap of the archive intervals of one series so that the missing intervals can be
+//                      listed without querying the archive table.
+//                      Each day is a fixed number of 64 bit words (5 words for a 5 minute interval) holding one bit per
+//                      interval, and the days are stored contiguously so a year of a series is about 15kB. The index is
+//                      loaded with one scan of the archive key index (CDatabaseSQLite::readKeys) or from a CTimeSeriesStore,
+//                      and can be kept current by attaching it to a CDatabaseSQLite with gapIndex(), which marks each inserted
+//                      record.
+//                      gaps() scans the words in the range, skipping complete words, so that years of data are scanned in a few
+//                      milliseconds. plan() turns the gaps into the fewest requests that will fill them: a single DMPAFT for the
+//                      gaps that are still in the console archive memory (the console returns every record after the
+//                      timestamp), and one request per .wlk file (one file per month) for the older gaps.
+//
+// CLASSES INCLUDED:    SGap
+//                      SBackfillOptions
+//                      SBackfillRequest
+//                      CGapIndex
+//
+// CLASS HIERARCHY:     CGapIndex
+//
+// HISTORY:             2026-10-19 GGB - File Created
+//
+//*********************************************************************************************************************************
+
+#include "include/gapIndex.h"
+
+  // Standard C++ library header files.
+
+#include <algorithm>
+#include <bitset>
+#include <map>
+#include <utility>
+
+  // Miscellanous library header files.
+
+#include <GCL>
+
+  // WCL header files
+
+#include "include/databaseSQLite.h"
+#include "include/GeneralFunctions.h"
+#include "include/timeSeriesStore.h"
+
+namespace WCL
+{
+  static std::int32_t const GROWTH_DAYS = 366;        ///< Days added when the index grows towards earlier dates.
+  static std::int32_t const LOAD_CHUNK_DAYS = 31;     ///< Days read from a time series store at a time.
+
+  /// @brief      Constructor.
+  /// @param[in]  interval: The archive interval (minutes). Must divide a day.
+  /// @throws     CODE_ERROR - Invalid interval.
+  /// @version    2026-10-19/GGB - Function created.
+
+  CGapIndex::CGapIndex(int interval) : interval_(interval)
+  {
+    if ((interval_ <= 0) || (TTimestamp::MINUTES_PER_DAY % interval_ != 0))
+    {
+      CODE_ERROR;
+    };
+
+    slotsPerDay_ = TTimestamp::MINUTES_PER_DAY / interval_;
+    wordsPerDay_ = (static_cast<std::size_t>(slotsPerDay_) + 63) / 64;
+  }
+
+  /// @brief      Replaces the contents of the index with words saved from another index with the same interval.
+  /// @param[in]  firstDay: Days since 1970-01-01 of the first day.
+  /// @param[in]  dayCount: The number of days.
+  /// @param[in]  words: wordsPerDay() words for each day.
+  /// @throws     std::bad_alloc
+  /// @version    2026-10-19/GGB - Function created.
+
+  void CGapIndex::assign(std::int32_t firstDay, std::int32_t dayCount, std::uint64_t const *words)
+  {
+    firstDay_ = firstDay;
+    dayCount_ = dayCount;
+    words_.assign(words, words + static_cast<std::size_t>(dayCount) * wordsPerDay_);
+
+    count_ = 0;
+    for (std::uint64_t word : words_)
+    {
+      count_ += std::bitset<64>(word).count();
+    };
+  }
+
+  /// @brief      Removes all the marks from the index.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  void CGapIndex::clear()
+  {
+    words_.clear();
+    firstDay_ = 0;
+    dayCount_ = 0;
+    count_ = 0;
+  }
+
+  /// @brief      Returns the timestamp of the request to send after the DMPAFT command to download the records after a time.
+  /// @param[in]  after: The console sends the records that are newer than this time.
+  /// @returns    The request, including the CRC.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  SDMPAFTRequest CGapIndex::DMPAFTRequest(TTimestamp after)
+  {
+    SDMPAFTRequest returnValue;
+    int year, month, day;
+    std::uint16_t CRC;
+    std::uint8_t *bytes = reinterpret_cast<std::uint8_t *>(&returnValue);
+
+    after.date(year, month, day);
+    returnValue.dateStamp = static_cast<std::uint16_t>(day + month * 32 + (year - 2000) * 512);
+    returnValue.timeStamp = after.HHMM();
+
+    CRC = calculateCRC(bytes, 0, 4);
+    bytes[4] = static_cast<std::uint8_t>(CRC >> 8);
+    bytes[5] = static_cast<std::uint8_t>(CRC & 0xFF);
+
+    return returnValue;
+  }
+
+  /// @brief      Extends the stored days to include a day.
+  /// @param[in]  day: Days since 1970-01-01.
+  /// @throws     std::bad_alloc
+  /// @version    2026-10-19/GGB - Function created.
+
+  void CGapIndex::extend(std::int32_t day)
+  {
+    if (dayCount_ == 0)
+    {
+      firstDay_ = day;
+      dayCount_ = 1;
+      words_.assign(wordsPerDay_, 0);
+    }
+    else if (day < firstDay_)
+    {
+        // Records are usually marked in time order, so space for a year is added to avoid moving the words for each day.
+
+      std::int32_t days = std::max(firstDay_ - day, GROWTH_DAYS);
+
+      words_.insert(words_.begin(), static_cast<std::size_t>(days) * wordsPerDay_, 0);
+      firstDay_ -= days;
+      dayCount_ += days;
+    }
+    else if (day >= firstDay_ + dayCount_)
+    {
+      dayCount_ = day - firstDay_ + 1;
+      words_.resize(static_cast<std::size_t>(dayCount_) * wordsPerDay_, 0);
+    };
+  }
+
+  /// @brief      Lists the gaps in a range of time.
+  /// @param[in]  from: The start of the range.
+  /// @param[in]  to: The end of the range (inclusive).
+  /// @param[out] gaps: The gaps are appended in time order. A gap that crosses the end of a day is a single gap.
+  /// @returns    The number of missing intervals.
+  /// @note       Complete and empty words are handled without testing the bits, so the time taken depends on the number of
+  ///             gaps rather than the number of intervals.
+  /// @throws     std::bad_alloc
+  /// @version    2026-10-19/GGB - Function created.
+
+  std::size_t CGapIndex::gaps(TTimestamp from, TTimestamp to, std::vector<SGap> &gaps) const
+  {
+    std::size_t returnValue = 0;
+    bool open = false;
+    TTimestamp first;
+
+    auto slotTime = [this](std::int32_t day, int slot)
+    {
+      return TTimestamp(day * TTimestamp::MINUTES_PER_DAY + slot * interval_);
+    };
+    auto closeGap = [&](TTimestamp last)
+    {
+      std::size_t slots = static_cast<std::size_t>((last - first) / interval_) + 1;
+
+      gaps.push_back(SGap{first, last, slots});
+      returnValue += slots;
+      open = false;
+    };
+
+    if (!from.valid() || !to.valid() || (to < from))
+    {
+      return 0;
+    };
+
+    std::int32_t fromDay = from.days();
+    std::int32_t toDay = to.days();
+    int fromSlot = from.minuteOfDay() / interval_;
+    int toSlot = to.minuteOfDay() / interval_;
+
+    for (std::int32_t day = fromDay; day <= toDay; day++)
+    {
+      int lo = (day == fromDay) ? fromSlot : 0;
+      int hi = (day == toDay) ? toSlot + 1 : slotsPerDay_;
+      std::uint64_t const *dayWords = nullptr;
+
+      if ((day >= firstDay_) && (day < firstDay_ + dayCount_))
+      {
+        dayWords = &words_[static_cast<std::size_t>(day - firstDay_) * wordsPerDay_];
+      };
+
+      for (int word = lo / 64; word * 64 < hi; word++)
+      {
+        int base = word * 64;
+        int b = std::max(lo, base) - base;
+        int e = std::min(hi, base + 64) - base;
+        std::uint64_t range = ((e == 64) ? ~std::uint64_t(0) : ((std::uint64_t(1) << e) - 1)) & (~std::uint64_t(0) << b);
+        std::uint64_t present = (dayWords != nullptr) ? (dayWords[word] & range) : 0;
+        std::uint64_t missing = ~present & range;
+
+        if (missing == range)
+        {
+          if (!open)
+          {
+            first = slotTime(day, base + b);
+            open = true;
+          };
+        }
+        else if (missing == 0)
+        {
+          if (open)
+          {
+            closeGap(slotTime(day, base + b) - interval_);
+          };
+        }
+        else
+        {
+          int bit = b;
+
+          while (bit < e)
+          {
+            std::uint64_t remaining = (open ? present : missing) & (~std::uint64_t(0) << bit);
+
+            if (remaining == 0)
+            {
+              break;
+            };
+
+            bit = __builtin_ctzll(remaining);
+            if (open)
+            {
+              closeGap(slotTime(day, base + bit) - interval_);
+            }
+            else
+            {
+              first = slotTime(day, base + bit);
+              open = true;
+            };
+          };
+        };
+      };
+    };
+
+    if (open)
+    {
+      closeGap(slotTime(toDay, toSlot));
+    };
+
+    return returnValue;
+  }
+
+  /// @brief      Marks the records of a series that are in the archive table. The whole of each day in the range is read.
+  /// @param[in]  database: The database to read.
+  /// @param[in]  siteID: The site ID.
+  /// @param[in]  instrumentID: The instrument ID.
+  /// @param[in]  from: The start of the range.
+  /// @param[in]  to: The end of the range.
+  /// @returns    The number of records read.
+  /// @note       The existing marks are kept. Call clear() first to rebuild the index.
+  /// @throws     0x000B - DATABASE: SQLite error.
+  /// @throws     std::bad_alloc
+  /// @version    2026-10-19/GGB - Function created.
+
+  std::size_t CGapIndex::load(CDatabaseSQLite &database, unsigned long siteID, unsigned long instrumentID, TTimestamp from,
+                              TTimestamp to)
+  {
+    return database.readKeys(siteID, instrumentID, static_cast<std::uint32_t>(from.MJD()), static_cast<std::uint32_t>(to.MJD()),
+                             [this](std::uint32_t MJD, std::uint16_t time)
+                             {
+                               mark(TTimestamp::fromMJD(static_cast<std::int32_t>(MJD), time));
+                             });
+  }
+
+  /// @brief      Marks the records of a series that are in a time series store. The whole of each day in the range is read.
+  /// @param[in]  store: The store to read.
+  /// @param[in]  siteID: The site ID.
+  /// @param[in]  instrumentID: The instrument ID.
+  /// @param[in]  from: The start of the range.
+  /// @param[in]  to: The end of the range.
+  /// @returns    The number of records read.
+  /// @note       The existing marks are kept. Call clear() first to rebuild the index.
+  /// @throws     0x0001 - APPLICATION: Unable to open data file.
+  /// @throws     std::bad_alloc
+  /// @version    2026-10-19/GGB - Function created.
+
+  std::size_t CGapIndex::load(CTimeSeriesStore &store, unsigned long siteID, unsigned long instrumentID, TTimestamp from,
+                              TTimestamp to)
+  {
+    std::size_t returnValue = 0;
+    std::vector<STimeSeriesRecord> records;
+    std::uint32_t toMJD = static_cast<std::uint32_t>(to.MJD());
+
+    for (std::uint32_t MJD = static_cast<std::uint32_t>(from.MJD()); MJD <= toMJD; MJD += LOAD_CHUNK_DAYS)
+    {
+      std::uint32_t lastMJD = std::min(MJD + LOAD_CHUNK_DAYS - 1, toMJD);
+
+      records.clear();
+      returnValue += store.readRange(siteID, instrumentID, STimeSeriesRecord::makeKey(MJD, 0),
+                                     STimeSeriesRecord::makeKey(lastMJD, 2359), records);
+      for (auto const &record : records)
+      {
+        mark(record.key);
+      };
+    };
+
+    return returnValue;
+  }
+
+  /// @brief      Marks the interval of a record as present.
+  /// @param[in]  timestamp: The time of the record. Times between intervals mark the interval that contains them.
+  /// @returns    true if the interval was not already marked.
+  /// @throws     std::bad_alloc
+  /// @version    2026-10-19/GGB - Function created.
+
+  bool CGapIndex::mark(TTimestamp timestamp)
+  {
+    bool returnValue = false;
+
+    if (timestamp.valid())
+    {
+      std::int32_t day = timestamp.days();
+      int slot = timestamp.minuteOfDay() / interval_;
+
+      extend(day);
+
+      std::uint64_t &word = words_[static_cast<std::size_t>(day - firstDay_) * wordsPerDay_ + slot / 64];
+      std::uint64_t bit = std::uint64_t(1) << (slot % 64);
+
+      if ((word & bit) == 0)
+      {
+        word |= bit;
+        count_++;
+        returnValue = true;
+      };
+    };
+
+    return returnValue;
+  }
+
+  /// @brief      Marks the interval of a record as present.
+  /// @param[in]  key: The key of the record. (MJD * 10000 + HHMM)
+  /// @returns    true if the interval was not already marked.
+  /// @throws     std::bad_alloc
+  /// @version    2026-10-19/GGB - Function created.
+
+  bool CGapIndex::mark(std::uint32_t key)
+  {
+    return mark(TTimestamp::fromMJD(static_cast<std::int32_t>(key / 10000), static_cast<std::uint16_t>(key % 10000)));
+  }
+
+  /// @brief      Checks if the interval that contains a time is marked.
+  /// @param[in]  timestamp: The time to check.
+  /// @returns    true if the interval is marked.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  bool CGapIndex::occupied(TTimestamp timestamp) const
+  {
+    bool returnValue = false;
+
+    if (timestamp.valid())
+    {
+      std::int32_t day = timestamp.days();
+      int slot = timestamp.minuteOfDay() / interval_;
+
+      if ((day >= firstDay_) && (day < firstDay_ + dayCount_))
+      {
+        returnValue = ((words_[static_cast<std::size_t>(day - firstDay_) * wordsPerDay_ + slot / 64] >> (slot % 64)) & 1) != 0;
+      };
+    };
+
+    return returnValue;
+  }
+
+  /// @brief      Plans the fewest requests that fill a list of gaps.
+  /// @param[in]  gaps: The gaps to fill, as returned by gaps().
+  /// @param[in]  options: The sources that are available.
+  /// @param[out] requests: The requests are appended. The .wlk requests are first (in date order), then the DMPAFT request, then
+  ///             the parts of the gaps that cannot be filled.
+  /// @returns    The number of missing intervals that the requests will fill.
+  /// @note       The console returns every record after the DMPAFT timestamp, so a single DMPAFT from the interval before the
+  ///             earliest gap still in the console memory fills all the later gaps. The older gaps are filled from the .wlk file
+  ///             of each month, reading only the days that have gaps.
+  /// @throws     std::bad_alloc
+  /// @version    2026-10-19/GGB - Function created.
+
+  std::size_t CGapIndex::plan(std::vector<SGap> const &gaps, SBackfillOptions const &options,
+                              std::vector<SBackfillRequest> &requests) const
+  {
+    std::size_t returnValue = 0;
+    bool console = options.consoleNewest.valid() && (options.consoleCapacity != 0);
+    TTimestamp consoleNewest, consoleOldest;
+    SBackfillRequest DMPAFT{};
+    std::map<std::pair<int, int>, SBackfillRequest> files;
+    std::vector<SBackfillRequest> unavailable;
+
+    auto slots = [this](TTimestamp first, TTimestamp last)
+    {
+      return static_cast<std::size_t>((last - first) / interval_) + 1;
+    };
+    auto addUnavailable = [&](TTimestamp first, TTimestamp last)
+    {
+      SBackfillRequest request{};
+
+      request.source = BS_UNAVAILABLE;
+      request.first = first;
+      request.last = last;
+      request.slots = slots(first, last);
+      unavailable.push_back(request);
+    };
+    auto addFiles = [&](TTimestamp first, TTimestamp last)
+    {
+      for (std::int32_t day = first.days(); day <= last.days(); day++)
+      {
+        TTimestamp dayFirst = std::max(first, TTimestamp(day * TTimestamp::MINUTES_PER_DAY));
+        TTimestamp dayLast = std::min(last, TTimestamp((day + 1) * TTimestamp::MINUTES_PER_DAY - interval_));
+        int year, month, dayOfMonth;
+
+        dayFirst.date(year, month, dayOfMonth);
+
+        SBackfillRequest &request = files[std::make_pair(year, month)];
+
+        if (request.slots == 0)
+        {
+          request.source = BS_WLK;
+          request.first = dayFirst;
+          request.year = year;
+          request.month = month;
+        };
+        request.last = dayLast;
+        request.days |= std::uint32_t(1) << (dayOfMonth - 1);
+        request.slots += slots(dayFirst, dayLast);
+      };
+    };
+
+    if (console)
+    {
+      consoleNewest = options.consoleNewest - (options.consoleNewest.minuteOfDay() % interval_);
+      consoleOldest = consoleNewest - static_cast<TTimestamp::value_type>((options.consoleCapacity - 1) * interval_);
+    };
+
+    for (auto const &gap : gaps)
+    {
+      TTimestamp olderLast = gap.last;
+
+      if (console)
+      {
+        TTimestamp first = std::max(gap.first, consoleOldest);
+        TTimestamp last = std::min(gap.last, consoleNewest);
+
+        if (first <= last)
+        {
+          if (DMPAFT.slots == 0)
+          {
+            DMPAFT.source = BS_DMPAFT;
+            DMPAFT.first = first;
+          };
+          DMPAFT.last = last;
+          DMPAFT.slots += slots(first, last);
+        };
+
+        if (gap.last > consoleNewest)
+        {
+          addUnavailable(std::max(gap.first, consoleNewest + interval_), gap.last);
+        };
+
+        olderLast = std::min(gap.last, consoleOldest - interval_);
+      };
+
+      if (gap.first <= olderLast)
+      {
+        if (options.wlkFiles)
+        {
+          addFiles(gap.first, olderLast);
+        }
+        else
+        {
+          addUnavailable(gap.first, olderLast);
+        };
+      };
+    };
+
+    for (auto const &file : files)
+    {
+      requests.push_back(file.second);
+      returnValue += file.second.slots;
+    };
+
+    if (DMPAFT.slots != 0)
+    {
+      DMPAFT.dmpaft = DMPAFTRequest(DMPAFT.first - interval_);
+      requests.push_back(DMPAFT);
+      returnValue += DMPAFT.slots;
+    };
+
+    requests.insert(requests.end(), unavailable.begin(), unavailable.end());
+
+    return returnValue;
+  }
+
+} // namespace WCL
@@ -0,0 +1,456 @@
+﻿//*********************************************************************************************************************************
+//
+// PROJECT:							Weather Class Library (WCL)
+// FILE:								importCatalog
+// SUBSYSTEM:						Incremental import of .wlk files
+// LANGUAGE:						C++
+// TARGET OS:						WINDOWS/UNIX/LINUX/MAC
+// LIBRARY DEPENDANCE:	boost::filesystem
+// NAMESPACE:						WCL
+// AUTHOR:							Gavin Blakeman.
+// LICENSE:             GPLv2
+//
+//                      Copyright 2026 Gavin Blakeman.
+//                      This file is part of the Weather Class Library (WCL).
+//
+//                      WCL is free software: you can redistribute it and/or modify it under the terms of the GNU General
+//                      Public License as published by the Free Software Foundation, either version 2 of the License, or (at your
+//                      option) any later version.
+//
+//                      WCL is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the
+//                      implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//                      for more details.
+//
+//                      You should have received a copy of the GNU General Public License along with WCL.  If not, see
+//                      <http://www.gnu.org/licenses/>.
+//
+// OVERVIEW:						Implements the import catalog.
+//
+// CLASSES INCLUDED:    CImportCatalog
+//
+// CLASS HIERARCHY:     CImportCatalog
+//
+// HISTORY:             2026-10-19 GGB - File Created
+//
+//*********************************************************************************************************************************
+
+#include "include/importCatalog.h"
+
+  // Standard C++ library header files.
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+  // Miscellaneous library header files.
+
+#include <GCL>
+
+  // WCL header files
+
+#include "include/replay.h"
+#include "include/WeatherLink.h"
+
+namespace WCL
+{
+  static char const CATALOG_VERSION[] = "WCLCATALOG 1";
+
+  /// @brief      Constructs the catalog. The catalog is not loaded.
+  /// @param[in]  catalogFile: The file holding the catalog.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  CImportCatalog::CImportCatalog(boost::filesystem::path const &catalogFile) : catalogFile_(catalogFile)
+  {
+  }
+
+  /// @brief      Returns the 64 bit FNV-1a hash of a block of data.
+  /// @param[in]  data: The data to hash.
+  /// @param[in]  length: The number of bytes.
+  /// @returns    The hash value.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  std::uint64_t CImportCatalog::hash(void const *data, std::size_t length)
+  {
+    std::uint8_t const *bytes = static_cast<std::uint8_t const *>(data);
+    std::uint64_t returnValue = 0xCBF29CE484222325;
+
+    for (std::size_t index = 0; index < length; index++)
+    {
+      returnValue = (returnValue ^ bytes[index]) * 0x100000001B3;
+    };
+
+    return returnValue;
+  }
+
+  /// @brief      Imports the changed days of a file into a store and updates the catalog.
+  /// @param[in]  fileName: The .wlk file to import. The name must be of the form YYYY-MM.wlk.
+  /// @param[in]  store: The store to write the records to.
+  /// @param[in]  siteID: The site ID of the records.
+  /// @param[in]  instrumentID: The instrument ID of the records.
+  /// @param[out] statistics: Updated with the files, days and records processed.
+  /// @returns    The number of records written to the store.
+  /// @details    The catalog entry is only updated once all the changed days have been written, so a failed import is repeated
+  ///             in full on the next run.
+  /// @throws     Any exception thrown by the store.
+  /// @version    2026-10-19/GGB - Function created.
+
+  std::size_t CImportCatalog::importFile(boost::filesystem::path const &fileName, CWeatherStore &store, unsigned long siteID,
+                                         unsigned long instrumentID, SImportStatistics &statistics)
+  {
+    std::size_t returnValue = 0;
+    int year, month;
+
+    statistics.filesScanned++;
+
+    if (!CReplayDriver::fileDate(fileName, year, month))
+    {
+      ERRORMESSAGE("WCL: File name " + fileName.string() + " is not of the form YYYY-MM.wlk. File not imported.");
+    }
+    else if (unchanged(fileName))
+    {
+      statistics.filesSkipped++;
+    }
+    else
+    {
+      std::vector<char> buffer;
+      SCatalogEntry entry;
+      std::vector<int> changedDays;
+
+      if (scan(fileName, buffer, entry, changedDays))
+      {
+        SHeaderBlock header;
+
+        std::memcpy(&header, buffer.data(), sizeof(header));
+        for (int day : changedDays)
+        {
+          ACL::TJD JD(year, month, day);
+          std::size_t offset = sizeof(SHeaderBlock) + sizeof(SDailySummary1) * (header.dayIndex[day].startPos + 2);
+          SWeatherDataRecord record;
+
+          for (int index = 0; index < header.dayIndex[day].recordsInDay - 2; index++)
+          {
+            std::memcpy(&record, buffer.data() + offset + sizeof(SWeatherDataRecord) * index, sizeof(record));
+            if (record.dataType == 1)
+            {
+              store.insertRecord(siteID, instrumentID, record, JD);
+              returnValue++;
+            };
+          };
+        };
+
+        statistics.daysImported += changedDays.size();
+        statistics.daysSkipped += std::count_if(entry.dayHash.begin() + 1, entry.dayHash.end(),
+                                                [] (std::uint64_t value) { return value != 0; }) - changedDays.size();
+        update(fileName, entry);
+      }
+      else
+      {
+        ERRORMESSAGE("WCL: Unable to read " + fileName.string() + ". File not imported.");
+      };
+    };
+
+    statistics.records += returnValue;
+
+    return returnValue;
+  }
+
+  /// @brief      Imports all the .wlk files in a directory, skipping the files and days that are unchanged. The catalog is saved
+  ///             after each file that is imported.
+  /// @param[in]  directory: The directory holding the .wlk files.
+  /// @param[in]  store: The store to write the records to.
+  /// @param[in]  siteID: The site ID of the records.
+  /// @param[in]  instrumentID: The instrument ID of the records.
+  /// @returns    The statistics of the import.
+  /// @throws     boost::filesystem::filesystem_error
+  /// @throws     Any exception thrown by the store.
+  /// @version    2026-10-19/GGB - Function created.
+
+  SImportStatistics CImportCatalog::importDirectory(boost::filesystem::path const &directory, CWeatherStore &store,
+                                                    unsigned long siteID, unsigned long instrumentID)
+  {
+    SImportStatistics returnValue;
+    std::vector<boost::filesystem::path> files;
+
+    for (auto const &entry : boost::filesystem::directory_iterator(directory))
+    {
+      int year, month;
+
+      if (CReplayDriver::fileDate(entry.path(), year, month))
+      {
+        files.push_back(entry.path());
+      };
+    };
+    std::sort(files.begin(), files.end());
+
+    for (auto const &file : files)
+    {
+      importFile(file, store, siteID, instrumentID, returnValue);
+      if (modified_)
+      {
+        save();
+      };
+    };
+
+    return returnValue;
+  }
+
+  /// @brief      Returns the key used for a file in the catalog.
+  /// @param[in]  fileName: The file.
+  /// @returns    The absolute path of the file.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  std::string CImportCatalog::key(boost::filesystem::path const &fileName)
+  {
+    return boost::filesystem::absolute(fileName).generic_string();
+  }
+
+  /// @brief      Loads the catalog from the catalog file. A missing file gives an empty catalog.
+  /// @returns    true - The catalog was loaded (or the file does not exist).
+  /// @returns    false - The file is not a catalog, or is corrupt. The catalog is empty.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  bool CImportCatalog::load()
+  {
+    std::ifstream ifs(catalogFile_.string());
+    std::string line;
+
+    entries_.clear();
+    modified_ = false;
+
+    if (!ifs)
+    {
+      return !boost::filesystem::exists(catalogFile_);
+    }
+    else if (!std::getline(ifs, line) || (line != CATALOG_VERSION))
+    {
+      return false;
+    }
+    else
+    {
+      while (std::getline(ifs, line))
+      {
+        std::istringstream iss(line);
+        SCatalogEntry entry;
+        long long writeTime;
+        std::string fileName;
+
+        iss >> entry.size >> writeTime >> std::hex >> entry.headerHash;
+        for (std::size_t day = 1; day < entry.dayHash.size(); day++)
+        {
+          iss >> entry.dayHash[day];
+        };
+        iss >> std::dec >> std::ws;
+        std::getline(iss, fileName);
+
+        if (iss.fail() || fileName.empty())
+        {
+          entries_.clear();
+          return false;
+        };
+
+        entry.writeTime = static_cast<std::time_t>(writeTime);
+        entries_[fileName] = entry;
+      };
+
+      return true;
+    };
+  }
+
+  /// @brief      Reads the whole of a file into a buffer.
+  /// @param[in]  fileName: The file to read.
+  /// @param[out] buffer: The contents of the file.
+  /// @returns    true if the file was read.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  bool CImportCatalog::readFile(boost::filesystem::path const &fileName, std::vector<char> &buffer)
+  {
+    std::ifstream ifs(fileName.string(), std::ifstream::in | std::ifstream::binary | std::ifstream::ate);
+
+    if (!ifs)
+    {
+      return false;
+    }
+    else
+    {
+      buffer.resize(static_cast<std::size_t>(ifs.tellg()));
+      ifs.seekg(0);
+      ifs.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+
+      return (static_cast<std::size_t>(ifs.gcount()) == buffer.size());
+    };
+  }
+
+  /// @brief      Removes a file from the catalog. The next import reads the whole file.
+  /// @param[in]  fileName: The file to remove.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  void CImportCatalog::remove(boost::filesystem::path const &fileName)
+  {
+    modified_ = (entries_.erase(key(fileName)) != 0) || modified_;
+  }
+
+  /// @brief      Saves the catalog. The catalog is written to a temporary file that then replaces the catalog file.
+  /// @returns    true if the catalog was saved.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  bool CImportCatalog::save()
+  {
+    boost::filesystem::path temporary = catalogFile_;
+    boost::system::error_code ec;
+
+    temporary += ".tmp";
+
+    {
+      std::ofstream ofs(temporary.string(), std::ofstream::out | std::ofstream::trunc);
+
+      ofs << CATALOG_VERSION << "\n";
+      for (auto const &entry : entries_)
+      {
+        ofs << entry.second.size << " " << static_cast<long long>(entry.second.writeTime) << std::hex;
+        ofs << " " << entry.second.headerHash;
+        for (std::size_t day = 1; day < entry.second.dayHash.size(); day++)
+        {
+          ofs << " " << entry.second.dayHash[day];
+        };
+        ofs << std::dec << " " << entry.first << "\n";
+      };
+
+      if (!ofs.flush())
+      {
+        ERRORMESSAGE("WCL: Unable to write the import catalog " + temporary.string());
+        return false;
+      };
+    }
+
+    boost::filesystem::rename(temporary, catalogFile_, ec);
+    if (ec)
+    {
+      ERRORMESSAGE("WCL: Unable to replace the import catalog " + catalogFile_.string());
+      return false;
+    }
+    else
+    {
+      modified_ = false;
+      return true;
+    };
+  }
+
+  /// @brief      Reads a file and determines the days that have changed since it was last imported.
+  /// @param[in]  fileName: The .wlk file.
+  /// @param[out] buffer: The contents of the file.
+  /// @param[out] entry: The catalog entry for the current contents of the file.
+  /// @param[out] changedDays: The days that have records and whose hash differs from the catalog.
+  /// @returns    false if the file could not be read, or the day index does not match the file size.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  bool CImportCatalog::scan(boost::filesystem::path const &fileName, std::vector<char> &buffer, SCatalogEntry &entry,
+                            std::vector<int> &changedDays) const
+  {
+    boost::system::error_code ec;
+    SHeaderBlock header;
+
+    changedDays.clear();
+    entry = SCatalogEntry();
+    entry.writeTime = boost::filesystem::last_write_time(fileName, ec);
+
+    if (ec || !readFile(fileName, buffer) || (buffer.size() < sizeof(SHeaderBlock)))
+    {
+      return false;
+    }
+    else
+    {
+      auto previous = entries_.find(key(fileName));
+
+      std::memcpy(&header, buffer.data(), sizeof(header));
+      entry.size = buffer.size();
+      entry.headerHash = hash(&header, sizeof(header));
+
+        // The modification time only has a resolution of one second. If the file was modified in the last few seconds, it
+        // could be modified again without the time changing, so the time is not stored and the next import checks the days.
+
+      if (entry.writeTime >= std::time(nullptr) - 2)
+      {
+        entry.writeTime = 0;
+      };
+
+      for (int day = 1; day <= 31; day++)
+      {
+        if (header.dayIndex[day].recordsInDay > 0)
+        {
+          std::size_t offset = sizeof(SHeaderBlock) + sizeof(SDailySummary1) * static_cast<std::size_t>(header.dayIndex[day].startPos);
+          std::size_t length = sizeof(SDailySummary1) * static_cast<std::size_t>(header.dayIndex[day].recordsInDay);
+
+          if ( (header.dayIndex[day].startPos < 0) || (offset + length > buffer.size()) )
+          {
+            return false;
+          };
+
+            // The hash is never zero for a day with records, so zero can mark the days without records.
+
+          entry.dayHash[day] = std::max<std::uint64_t>(hash(buffer.data() + offset, length), 1);
+
+          if ( (previous == entries_.end()) || (previous->second.dayHash[day] != entry.dayHash[day]) )
+          {
+            changedDays.push_back(day);
+          };
+        };
+      };
+
+      return true;
+    };
+  }
+
+  /// @brief      Checks if a file is unchanged since it was last imported. Only the directory entry and the header are read.
+  /// @param[in]  fileName: The .wlk file.
+  /// @returns    true if the size, modification time and header hash match the catalog.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  bool CImportCatalog::unchanged(boost::filesystem::path const &fileName) const
+  {
+    auto entry = entries_.find(key(fileName));
+    boost::system::error_code ec;
+    bool returnValue = false;
+
+    if (entry != entries_.end())
+    {
+      std::uintmax_t size = boost::filesystem::file_size(fileName, ec);
+      std::time_t writeTime = ec ? 0 : boost::filesystem::last_write_time(fileName, ec);
+
+      if (!ec && (size == entry->second.size) && (writeTime == entry->second.writeTime))
+      {
+        std::ifstream ifs(fileName.string(), std::ifstream::in | std::ifstream::binary);
+        SHeaderBlock header;
+
+        if (ifs.read(reinterpret_cast<char *>(&header), sizeof(header)))
+        {
+          returnValue = (hash(&header, sizeof(header)) == entry->second.headerHash);
+        };
+      };
+    };
+
+    return returnValue;
+  }
+
+  /// @brief      Updates the catalog entry for a file.
+  /// @param[in]  fileName: The file.
+  /// @param[in]  entry: The new entry.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  void CImportCatalog::update(boost::filesystem::path const &fileName, SCatalogEntry const &entry)
+  {
+    entries_[key(fileName)] = entry;
+    modified_ = true;
+  }
+
+} // namespace WCL
@@ -0,0 +1,430 @@
+﻿//*********************************************************************************************************************************
+//
+// PROJECT:							Weather Class Library (WCL)
+// FILE:								meteorology
+// SUBSYSTEM:						Derived meteorological quantities
+// LANGUAGE:						C++
+// TARGET OS:						WINDOWS/UNIX/LINUX/MAC
+// LIBRARY DEPENDANCE:	None.
+// NAMESPACE:						WCL::meteorology
+// AUTHOR:							Gavin Blakeman.
+// LICENSE:             GPLv2
+//
+//                      Copyright 2026 Gavin Blakeman.
+//                      This file is part of the Weather Class Library (WCL).
+//
+//                      WCL is free software: you can redistribute it and/or modify it under the terms of the GNU General
+//                      Public License as published by the Free Software Foundation, either version 2 of the License, or (at your
+//                      option) any later version.
+//
+//                      WCL is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the
+//                      implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//                      for more details.
+//
+//                      You should have received a copy of the GNU General Public License along with WCL.  If not, see
+//                      <http://www.gnu.org/licenses/>.
+//
+// OVERVIEW:						Implements the batch kernels for the derived meteorological quantities.
+//
+// CLASSES INCLUDED:    None.
+//
+// CLASS HIERARCHY:     None.
+//
+// HISTORY:             2026-10-19 GGB - File Created
+//
+//*********************************************************************************************************************************
+
+#include "include/meteorology.h"
+
+  // Standard C++ library header files.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+  // WCL header files
+
+#include "include/unitTransform.h"
+#include "include/wireFormat.h"
+
+namespace WCL
+{
+  namespace meteorology
+  {
+      // The unit conversions are taken from the unit and wire tables, so that the kernels use the same scales as the record
+      // conversion.
+
+    static constexpr SAffine celsiusToF = unitTransform(U_CELSIUS, U_FAHRENHEIT);
+    static constexpr SAffine fToCelsius = unitTransform(U_FAHRENHEIT, U_CELSIUS);
+    static constexpr SAffine kelvinToCelsius = unitTransform(U_KELVIN, U_CELSIUS);
+    static constexpr float MPH_PER_METRE_PER_SECOND = static_cast<float>(unitTransform(U_METRE_PER_SECOND, U_MILE_PER_HOUR).a);
+
+      // The approximations below are written without branches (the conditionals compile to selects) and without calls so that
+      // the loops that use them can be vectorised.
+
+    /// @brief Reinterprets the bits of a float as an integer.
+
+    static inline std::int32_t asInt(float value)
+    {
+      std::int32_t returnValue;
+
+      std::memcpy(&returnValue, &value, sizeof(returnValue));
+      return returnValue;
+    }
+
+    /// @brief Reinterprets the bits of an integer as a float.
+
+    static inline float asFloat(std::int32_t value)
+    {
+      float returnValue;
+
+      std::memcpy(&returnValue, &value, sizeof(returnValue));
+      return returnValue;
+    }
+
+    /// @brief      Natural logarithm for x > 0. Relative error < 2e-7.
+    /// @details    x = m * 2^e with m in [sqrt(0.5), sqrt(2)). ln(m) = 2 atanh(s), s = (m - 1) / (m + 1).
+
+    static inline float fastLog(float x)
+    {
+      std::int32_t bits = asInt(x) - 0x3F3504F3;              // Offset so that m is centred on 1.
+      std::int32_t exponent = bits >> 23;
+      float m = asFloat((bits & 0x007FFFFF) + 0x3F3504F3);
+      float s = (m - 1.0f) / (m + 1.0f);
+      float s2 = s * s;
+      float p = 2.0f + s2 * (0.66666667f + s2 * (0.4f + s2 * (0.28571429f + s2 * 0.22222222f)));
+
+      return static_cast<float>(exponent) * 0.69314718f + s * p;
+    }
+
+    /// @brief      Exponential. Relative error < 3e-7 for |x| < 80.
+    /// @details    exp(x) = 2^n * 2^f with n = round(x / ln2) and f in [-0.5, 0.5].
+
+    static inline float fastExp(float x)
+    {
+      x = std::min(std::max(x, -87.0f), 88.0f);
+
+      float t = x * 1.44269504f;
+      float n = (t + 12582912.0f) - 12582912.0f;            // Round to nearest without a call to floor().
+      float f = (t - n) * 0.69314718f;
+      float p = 1.0f + f * (1.0f + f * (0.5f + f * (0.16666667f + f * (0.041666668f + f * (0.0083333338f + f * 0.0013888889f)))));
+
+      return p * asFloat((static_cast<std::int32_t>(n) + 127) << 23);
+    }
+
+    /// @brief      Power x^y for x > 0.
+
+    static inline float fastPow(float x, float y)
+    {
+      return fastExp(y * fastLog(x));
+    }
+
+    /// @brief      Arctangent. Absolute error < 1e-6.
+    /// @details    For |x| > 1, atan(x) = pi/2 - atan(1/x). The reduced argument is evaluated with a minimax polynomial.
+
+    static inline float fastAtan(float x)
+    {
+      float ax = std::fabs(x);
+      bool invert = ax > 1.0f;
+      float z = invert ? 1.0f / ax : ax;
+      float z2 = z * z;
+      float p = z * (0.99997726f + z2 * (-0.33262347f + z2 * (0.19354346f + z2 * (-0.11643287f + z2 * (0.05265332f + z2 * -0.01172120f)))));
+
+      p = invert ? 1.57079633f - p : p;
+      return std::copysign(p, x);
+    }
+
+    /// @brief      Returns the value, or NaN if it is outside the limits of an observation field. The Davis missing sentinels
+    ///             convert to values far outside the limits.
+    /// @param[in]  value: The value, in the unit TO.
+    /// @param[in]  field: The observation field.
+
+    template<EUnit TO>
+    static inline float checked(float value, EValidatedField field)
+    {
+      SAffine const transform = unitTransform(observationFields[field].unit, TO);
+      float lo = static_cast<float>(transform(observationFields[field].limits.minimum));
+      float hi = static_cast<float>(transform(observationFields[field].limits.maximum));
+
+      return (value >= lo && value <= hi) ? value : std::numeric_limits<float>::quiet_NaN();
+    }
+
+    /// @brief      Decodes the wire field of an observation from a Davis record and converts it to a unit, with the scale and
+    ///             unit given by the wire table.
+    /// @param[in]  record: The record.
+
+    template<typename T, EValidatedField FIELD, EUnit TO>
+    static inline float wireObservation(T const &record)
+    {
+      return static_cast<float>(wireConvert<T, observationWireField<T>(FIELD), TO>(reinterpret_cast<std::uint8_t const *>(&record)));
+    }
+
+    /// @brief      Extracts the input columns from Davis records.
+
+    template<typename T>
+    static void wireColumns(T const *records, std::size_t count, SColumns &out)
+    {
+      out.resize(count);
+
+      for (std::size_t index = 0; index < count; index++)
+      {
+        out.temperature[index] = checked<U_CELSIUS>(wireObservation<T, VF_OUTSIDE_TEMP, U_CELSIUS>(records[index]), VF_OUTSIDE_TEMP);
+        out.humidity[index] = checked<U_PERCENT>(wireObservation<T, VF_OUTSIDE_HUMIDITY, U_PERCENT>(records[index]),
+                                                 VF_OUTSIDE_HUMIDITY);
+        out.windSpeed[index] = checked<U_METRE_PER_SECOND>(wireObservation<T, VF_WIND_SPEED, U_METRE_PER_SECOND>(records[index]),
+                                                           VF_WIND_SPEED);
+        out.solarRadiation[index] = checked<U_NONE>(wireObservation<T, VF_SOLAR_RAD, U_NONE>(records[index]), VF_SOLAR_RAD);
+      };
+    }
+
+    /// @brief Converts C to F.
+
+    static inline float toF(float temperature)
+    {
+      return temperature * static_cast<float>(celsiusToF.a) + static_cast<float>(celsiusToF.b);
+    }
+
+    /// @brief Converts F to C.
+
+    static inline float toC(float temperature)
+    {
+      return temperature * static_cast<float>(fToCelsius.a) + static_cast<float>(fToCelsius.b);
+    }
+
+    /// @brief      NWS heat index. Temperature and result in F.
+
+    static inline float heatIndexF(float T, float RH)
+    {
+      float simple = 0.5f * (T + 61.0f + (T - 68.0f) * 1.2f + RH * 0.094f);
+      float full = -42.379f + 2.04901523f * T + 10.14333127f * RH - 0.22475541f * T * RH - 0.00683783f * T * T
+                   - 0.05481717f * RH * RH + 0.00122874f * T * T * RH + 0.00085282f * T * RH * RH
+                   - 0.00000199f * T * T * RH * RH;
+      float dryAdjustment = ((13.0f - RH) * 0.25f) * std::sqrt(std::max(0.0f, 17.0f - std::fabs(T - 95.0f)) / 17.0f);
+      float wetAdjustment = ((RH - 85.0f) * 0.1f) * ((87.0f - T) * 0.2f);
+
+      full -= (RH < 13.0f && T >= 80.0f && T <= 112.0f) ? dryAdjustment : 0.0f;
+      full += (RH > 85.0f && T >= 80.0f && T <= 87.0f) ? wetAdjustment : 0.0f;
+
+      return ((simple + T) * 0.5f < 80.0f) ? simple : full;
+    }
+
+    /// @brief Resizes all the columns.
+
+    void SColumns::resize(std::size_t size)
+    {
+      temperature.resize(size);
+      humidity.resize(size);
+      windSpeed.resize(size);
+      solarRadiation.resize(size);
+    }
+
+    /// @brief      Extracts the input columns from archive records downloaded from the console.
+    /// @param[in]  records: The archive records.
+    /// @param[in]  count: The number of records.
+    /// @param[out] out: The columns. Missing values are NaN.
+    /// @throws     std::bad_alloc
+    /// @version    2026-10-19/GGB - Function created.
+
+    void columns(SArchiveRecord const *records, std::size_t count, SColumns &out)
+    {
+      wireColumns(records, count, out);
+    }
+
+    /// @brief      Extracts the input columns from time series records.
+    /// @param[in]  records: The records.
+    /// @param[in]  count: The number of records.
+    /// @param[out] out: The columns. Missing values are NaN.
+    /// @note       The records do not need to have been validated. Unvalidated records still hold the converted sentinels, which
+    ///             are outside the limits.
+    /// @throws     std::bad_alloc
+    /// @version    2026-10-19/GGB - Function created.
+
+    void columns(STimeSeriesRecord const *records, std::size_t count, SColumns &out)
+    {
+      out.resize(count);
+
+      for (std::size_t index = 0; index < count; index++)
+      {
+        out.temperature[index] = checked<U_CELSIUS>(static_cast<float>(kelvinToCelsius(records[index].outsideTemp)),
+                                                    VF_OUTSIDE_TEMP);
+        out.humidity[index] = checked<U_PERCENT>(static_cast<float>(records[index].outsideHumidity), VF_OUTSIDE_HUMIDITY);
+        out.windSpeed[index] = checked<U_METRE_PER_SECOND>(static_cast<float>(records[index].windSpeed), VF_WIND_SPEED);
+        out.solarRadiation[index] = (records[index].solarRad == CRecordValidator::MISSING_SOLAR) ?
+                                    std::numeric_limits<float>::quiet_NaN() :
+                                    checked<U_NONE>(static_cast<float>(records[index].solarRad), VF_SOLAR_RAD);
+      };
+    }
+
+    /// @brief      Extracts the input columns from .wlk archive records.
+    /// @param[in]  records: The archive records.
+    /// @param[in]  count: The number of records.
+    /// @param[out] out: The columns. Missing values are NaN.
+    /// @throws     std::bad_alloc
+    /// @version    2026-10-19/GGB - Function created.
+
+    void columns(SWeatherDataRecord const *records, std::size_t count, SColumns &out)
+    {
+      wireColumns(records, count, out);
+    }
+
+    /// @brief      Calculates the dew point.
+    /// @param[in]  temperature: Temperature (C)
+    /// @param[in]  humidity: Relative humidity (%)
+    /// @param[out] out: Dew point (C)
+    /// @param[in]  count: Number of values.
+    /// @throws     None.
+    /// @version    2026-10-19/GGB - Function created.
+
+    void dewPoint(float const *temperature, float const *humidity, float *out, std::size_t count)
+    {
+      float const b = 17.625f;
+      float const c = 243.04f;
+
+      for (std::size_t index = 0; index < count; index++)
+      {
+        float RH = std::min(std::max(humidity[index], 1.0f), 100.0f);
+        float T = temperature[index];
+        float gamma = fastLog(RH * 0.01f) + b * T / (c + T);
+
+        out[index] = (humidity[index] == humidity[index]) ? c * gamma / (b - gamma) : humidity[index];   // fastLog(NaN) is not NaN.
+      };
+    }
+
+    /// @brief      Calculates the heat index.
+    /// @param[in]  temperature: Temperature (C)
+    /// @param[in]  humidity: Relative humidity (%)
+    /// @param[out] out: Heat index (C)
+    /// @param[in]  count: Number of values.
+    /// @throws     None.
+    /// @version    2026-10-19/GGB - Function created.
+
+    void heatIndex(float const *temperature, float const *humidity, float *out, std::size_t count)
+    {
+      for (std::size_t index = 0; index < count; index++)
+      {
+        out[index] = toC(heatIndexF(toF(temperature[index]), humidity[index]));
+      };
+    }
+
+    /// @brief      Calculates the high, low and average of a column. NaN values are ignored.
+    /// @param[in]  values: The column.
+    /// @param[in]  count: The number of values.
+    /// @returns    The summary. All NaN if there are no values.
+    /// @throws     None.
+    /// @version    2026-10-19/GGB - Function created.
+
+    SSummary summarise(float const *values, std::size_t count)
+    {
+      float high = -std::numeric_limits<float>::infinity();
+      float low = std::numeric_limits<float>::infinity();
+      double sum = 0;
+      std::size_t n = 0;
+
+      for (std::size_t index = 0; index < count; index++)
+      {
+        float value = values[index];
+        bool valid = (value == value);
+
+        high = valid ? std::max(high, value) : high;
+        low = valid ? std::min(low, value) : low;
+        sum += valid ? value : 0.0f;
+        n += valid ? 1 : 0;
+      };
+
+      if (n == 0)
+      {
+        float const NaN = std::numeric_limits<float>::quiet_NaN();
+        return { NaN, NaN, NaN };
+      };
+
+      return { high, low, static_cast<float>(sum / n) };
+    }
+
+    /// @brief      Calculates the THSW index (Steadman apparent temperature with solar radiation).
+    /// @param[in]  temperature: Temperature (C)
+    /// @param[in]  humidity: Relative humidity (%)
+    /// @param[in]  windSpeed: Wind speed (m/s)
+    /// @param[in]  solarRadiation: Solar radiation (W/m^2)
+    /// @param[out] out: THSW index (C)
+    /// @param[in]  count: Number of values.
+    /// @throws     None.
+    /// @version    2026-10-19/GGB - Function created.
+
+    void THSW(float const *temperature, float const *humidity, float const *windSpeed, float const *solarRadiation, float *out,
+              std::size_t count)
+    {
+      for (std::size_t index = 0; index < count; index++)
+      {
+        float T = temperature[index];
+        float V = windSpeed[index];
+        float e = humidity[index] * 0.06105f * fastExp(17.27f * T / (237.7f + T));     // Vapour pressure (hPa)
+
+        out[index] = T + 0.348f * e - 0.70f * V + 0.70f * solarRadiation[index] / (V + 10.0f) - 4.25f;
+      };
+    }
+
+    /// @brief      Calculates the THW index.
+    /// @param[in]  temperature: Temperature (C)
+    /// @param[in]  humidity: Relative humidity (%)
+    /// @param[in]  windSpeed: Wind speed (m/s)
+    /// @param[out] out: THW index (C)
+    /// @param[in]  count: Number of values.
+    /// @throws     None.
+    /// @version    2026-10-19/GGB - Function created.
+
+    void THW(float const *temperature, float const *humidity, float const *windSpeed, float *out, std::size_t count)
+    {
+      for (std::size_t index = 0; index < count; index++)
+      {
+        float wind = windSpeed[index] * MPH_PER_METRE_PER_SECOND;
+
+        out[index] = toC(heatIndexF(toF(temperature[index]), humidity[index]) - 1.072f * wind);
+      };
+    }
+
+    /// @brief      Calculates the wet bulb temperature.
+    /// @param[in]  temperature: Temperature (C)
+    /// @param[in]  humidity: Relative humidity (%)
+    /// @param[out] out: Wet bulb temperature (C)
+    /// @param[in]  count: Number of values.
+    /// @throws     None.
+    /// @version    2026-10-19/GGB - Function created.
+
+    void wetBulb(float const *temperature, float const *humidity, float *out, std::size_t count)
+    {
+      for (std::size_t index = 0; index < count; index++)
+      {
+        float T = temperature[index];
+        float RH = humidity[index];
+
+        out[index] = T * fastAtan(0.151977f * std::sqrt(RH + 8.313659f)) + fastAtan(T + RH) - fastAtan(RH - 1.676331f)
+                     + 0.00391838f * RH * std::sqrt(RH) * fastAtan(0.023101f * RH) - 4.686035f;
+      };
+    }
+
+    /// @brief      Calculates the wind chill.
+    /// @param[in]  temperature: Temperature (C)
+    /// @param[in]  windSpeed: Wind speed (m/s)
+    /// @param[out] out: Wind chill (C)
+    /// @param[in]  count: Number of values.
+    /// @throws     None.
+    /// @version    2026-10-19/GGB - Function created.
+
+    void windChill(float const *temperature, float const *windSpeed, float *out, std::size_t count)
+    {
+      for (std::size_t index = 0; index < count; index++)
+      {
+        float T = toF(temperature[index]);
+        float V = windSpeed[index] * MPH_PER_METRE_PER_SECOND;
+        float V16 = fastPow(std::max(V, 1.0f), 0.16f);
+        float chill = 35.74f + 0.6215f * T - 35.75f * V16 + 0.4275f * T * V16;
+
+        chill = (T <= 50.0f && V >= 3.0f) ? toC(chill) : temperature[index];
+        out[index] = (V == V) ? chill : V;
+      };
+    }
+
+  } // namespace meteorology
+} // namespace WCL
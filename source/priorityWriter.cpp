@@ -0,0 +1,490 @@
+﻿//*********************************************************************************************************************************
+//
+// PROJECT:							Weather Class Library (WCL)
+// FILE:								priorityWriter
+// SUBSYSTEM:						Priority scheduling of live and backfill writes to one store
+// LANGUAGE:						C++
+// TARGET OS:						WINDOWS/UNIX/LINUX/MAC
+// LIBRARY DEPENDANCE:	None.
+// NAMESPACE:						WCL
+// AUTHOR:							Gavin Blakeman.
+// LICENSE:             GPLv2
+//
+//                      Copyright 2026 Gavin Blakeman.
+//                      This file is part of the Weather Class Library (WCL).
+//
+//                      WCL is free software: you can redistribute it and/or modify it under the terms of the GNU General
+//                      Public License as published by the Free Software Foundation, either version 2 of the License, or (at your
+//                      option) any later version.
+//
+//                      WCL is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the
+//                      implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//                      for more details.
+//
+//                      You should have received a copy of the GNU General Public License along with WCL.  If not, see
+//                      <http://www.gnu.org/licenses/>.
+//
+// OVERVIEW:						Shares one store between the live ingest and the backfill. The live queue is always written first.
+//
+// CLASSES INCLUDED:    CPriorityWriter
+//
+// CLASS HIERARCHY:     CPriorityWriter
+//                      CWeatherStore
+//                        - CPriorityWriter::CClassStore
+//
+// HISTORY:             2026-10-19 GGB - File Created
+//
+//*********************************************************************************************************************************
+
+#include "include/priorityWriter.h"
+
+  // Standard C++ library header files.
+
+#include <algorithm>
+
+  // WCL header files
+
+#include "include/trace.h"
+
+namespace WCL
+{
+  /// @brief      Queues an archive record downloaded from the console.
+  /// @param[in]  siteID: The site ID.
+  /// @param[in]  instrumentID: The instrument ID.
+  /// @param[in]  record: The record.
+  /// @returns    true. The record is written by the writer thread. statistics() returns the records inserted.
+  /// @throws     The error held by the writer.
+  /// @version    2026-10-19/GGB - Function created.
+
+  bool CPriorityWriter::CClassStore::insertRecord(unsigned long siteID, unsigned long instrumentID, SArchiveRecord &record)
+  {
+    writer_.enqueue(priority_, SItem{ siteID, instrumentID, record, {} });
+
+    return true;
+  }
+
+  /// @brief      Queues an archive record read from a .wlk file.
+  /// @param[in]  siteID: The site ID.
+  /// @param[in]  instrumentID: The instrument ID.
+  /// @param[in]  record: The record.
+  /// @param[in]  JD: The date of the record.
+  /// @returns    true. The record is written by the writer thread. statistics() returns the records inserted.
+  /// @throws     The error held by the writer.
+  /// @version    2026-10-19/GGB - Function created.
+
+  bool CPriorityWriter::CClassStore::insertRecord(unsigned long siteID, unsigned long instrumentID,
+                                                  SWeatherDataRecord const &record, ACL::TJD const &JD)
+  {
+    writer_.enqueue(priority_, SItem{ siteID, instrumentID, SWlkRecord{ record, JD }, {} });
+
+    return true;
+  }
+
+  /// @brief      Ends a group of inserts. The queued records of the class are written without waiting for the flush interval.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  void CPriorityWriter::CClassStore::endBatch()
+  {
+    writer_.requestFlush(priority_);
+  }
+
+  /// @brief      Gets the time of the last record of a station. The records of the class queued before the call are written
+  ///             first.
+  /// @param[in]  siteID: The site ID.
+  /// @param[in]  instrumentID: The instrument ID.
+  /// @param[out] MJD: The MJD of the last record.
+  /// @param[out] time: The time of the last record.
+  /// @returns    true if a record was found.
+  /// @throws     The error held by the writer.
+  /// @version    2026-10-19/GGB - Function created.
+
+  bool CPriorityWriter::CClassStore::lastWeatherRecord(unsigned long siteID, unsigned long instrumentID, std::uint16_t &MJD,
+                                                       std::uint16_t &time)
+  {
+    return writer_.query(priority_, [&](CWeatherStore &store)
+    {
+      return store.lastWeatherRecord(siteID, instrumentID, MJD, time);
+    });
+  }
+
+  /// @brief      Checks if a record exists. The records of the class queued before the call are written first.
+  /// @param[in]  siteID: The site ID.
+  /// @param[in]  instrumentID: The instrument ID.
+  /// @param[in]  JD: The date of the record.
+  /// @param[in]  time: The time of the record (HHMM).
+  /// @returns    true if the record exists.
+  /// @throws     The error held by the writer.
+  /// @version    2026-10-19/GGB - Function created.
+
+  bool CPriorityWriter::CClassStore::recordExists(unsigned long siteID, unsigned long instrumentID, ACL::TJD JD, std::uint16_t time)
+  {
+    return writer_.query(priority_, [&](CWeatherStore &store)
+    {
+      return store.recordExists(siteID, instrumentID, JD, time);
+    });
+  }
+
+  /// @brief      Constructor. Starts the writer thread.
+  /// @param[in]  factory: Creates the store. Called on the writer thread.
+  /// @param[in]  live: The limits of the live class.
+  /// @param[in]  backfill: The limits of the backfill class.
+  /// @param[in]  slice: The time a backfill batch should take. This is the longest time that live work waits for a backfill
+  ///             batch.
+  /// @throws     std::bad_alloc
+  /// @version    2026-10-19/GGB - Function created.
+
+  CPriorityWriter::CPriorityWriter(factory_t factory, SPriorityLimits const &live, SPriorityLimits const &backfill,
+                                   std::chrono::milliseconds slice)
+    : factory_(factory), slice_(std::max(std::chrono::microseconds(slice), std::chrono::microseconds(1)))
+  {
+    classes_[PC_LIVE].limits = live;
+    classes_[PC_BACKFILL].limits = backfill;
+
+    for (std::size_t priority = 0; priority < PC_COUNT; priority++)
+    {
+      SClass &c = classes_[priority];
+
+      c.limits.batchSize = std::max<std::size_t>(1, c.limits.batchSize);
+      c.limits.queueLimit = std::max(c.limits.queueLimit, c.limits.batchSize);
+      c.batchSize = (priority == PC_LIVE) ? c.limits.batchSize : 1;     // The backfill grows to the slice time.
+      c.readyAt = std::chrono::steady_clock::now();
+      stores_[priority] = std::make_unique<CClassStore>(*this, static_cast<EPriorityClass>(priority));
+    };
+
+    thread_ = std::thread(&CPriorityWriter::writer, this);
+  }
+
+  /// @brief      Destructor. Writes the queued records, ignoring the rate limits, and stops the writer thread. Errors are not
+  ///             reported.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  CPriorityWriter::~CPriorityWriter()
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+
+      stop_ = true;
+      pending_.notify_one();
+    }
+
+    thread_.join();
+  }
+
+  /// @brief      Adds an item to the queue of a class. Blocks while the queue is full.
+  /// @param[in]  priority: The class.
+  /// @param[in]  item: The item to queue.
+  /// @throws     The error held by the writer.
+  /// @version    2026-10-19/GGB - Function created.
+
+  void CPriorityWriter::enqueue(EPriorityClass priority, SItem &&item)
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    SClass &c = classes_[priority];
+    bool isQuery = std::holds_alternative<query_t>(item.value);
+
+    space_.wait(lock, [&] { return error_ || (c.queue.size() < c.limits.queueLimit); });
+
+    if (error_)
+    {
+      std::rethrow_exception(error_);
+    };
+
+    item.queued = std::chrono::steady_clock::now();
+    c.queue.push_back(std::move(item));
+
+    if (isQuery)
+    {
+      c.flushRequested = true;
+    }
+    else
+    {
+      c.statistics.queued++;
+      c.statistics.maxQueue = std::max(c.statistics.maxQueue, c.queue.size());
+    };
+
+    if (isQuery || (c.queue.size() == 1) || (c.queue.size() == c.batchSize))
+    {
+      pending_.notify_one();
+    };
+  }
+
+  /// @brief      Writes the queued records of all the classes and waits until they have been written.
+  /// @throws     The error held by the writer.
+  /// @version    2026-10-19/GGB - Function created.
+
+  void CPriorityWriter::flush()
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    for (SClass &c : classes_)
+    {
+      c.flushRequested = !c.queue.empty();
+    };
+    pending_.notify_one();
+
+    space_.wait(lock, [&]
+    {
+      return !writing_ && std::all_of(classes_.begin(), classes_.end(), [](SClass const &c) { return c.queue.empty(); });
+    });
+
+    if (error_)
+    {
+      std::rethrow_exception(error_);
+    };
+  }
+
+  /// @brief      Runs a query on the store, on the writer thread, after the queued records of the class.
+  /// @param[in]  priority: The class.
+  /// @param[in]  function: The query.
+  /// @returns    The result of the query.
+  /// @throws     The error held by the writer, or the error raised by the query.
+  /// @version    2026-10-19/GGB - Function created.
+
+  bool CPriorityWriter::query(EPriorityClass priority, std::function<bool(CWeatherStore &)> function)
+  {
+    query_t task(std::move(function));
+    std::future<bool> result = task.get_future();
+
+    enqueue(priority, SItem{ 0, 0, std::move(task), {} });
+
+    try
+    {
+      return result.get();
+    }
+    catch(std::future_error const &)
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+
+      if (error_)
+      {
+        std::rethrow_exception(error_);
+      };
+      throw;
+    };
+  }
+
+  /// @brief      Requests that the queued records of a class are written without waiting for a full batch.
+  /// @param[in]  priority: The class.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  void CPriorityWriter::requestFlush(EPriorityClass priority)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    SClass &c = classes_[priority];
+
+    if (!c.queue.empty())
+    {
+      c.flushRequested = true;
+      pending_.notify_one();
+    };
+  }
+
+  /// @brief      Selects the class to write next. Called with the lock held.
+  /// @param[in]  now: The current time.
+  /// @param[out] wake: Set to the earliest time that a class that is waiting for its rate limit or flush interval can be written.
+  ///             Unchanged if there is no such class.
+  /// @returns    The highest priority class that can be written. -1 if no class can be written.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  int CPriorityWriter::select(std::chrono::steady_clock::time_point now, std::chrono::steady_clock::time_point &wake)
+  {
+    for (std::size_t priority = 0; priority < PC_COUNT; priority++)
+    {
+      SClass &c = classes_[priority];
+
+      if (!c.queue.empty())
+      {
+        std::chrono::steady_clock::time_point due = c.queue.front().queued + c.limits.flushInterval;
+
+        if (stop_ || ( (now >= c.readyAt) && (c.flushRequested || (c.queue.size() >= c.batchSize) || (now >= due)) ))
+        {
+          return static_cast<int>(priority);
+        };
+
+        if (c.flushRequested || (c.queue.size() >= c.batchSize))
+        {
+          due = c.readyAt;
+        };
+        wake = std::min(wake, std::max(due, c.readyAt));
+      };
+    };
+
+    return -1;
+  }
+
+  /// @brief      Returns the statistics of each class.
+  /// @returns    The statistics, indexed by EPriorityClass.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  std::array<SPriorityStatistics, PC_COUNT> CPriorityWriter::statistics()
+  {
+    std::array<SPriorityStatistics, PC_COUNT> returnValue;
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    for (std::size_t priority = 0; priority < PC_COUNT; priority++)
+    {
+      returnValue[priority] = classes_[priority].statistics;
+    };
+
+    return returnValue;
+  }
+
+  /// @brief      Writes a batch to the store as one transaction. Called by the writer thread without the lock held.
+  /// @param[in]  c: The class of the batch.
+  /// @param[in]  batch: The items to write, in queue order.
+  /// @param[in]  failed: The writer holds an error. The records are dropped and the queries are not run.
+  /// @returns    The time taken to write the batch.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  std::chrono::microseconds CPriorityWriter::writeBatch(SClass &c, std::vector<SItem> &batch, bool failed)
+  {
+    WCL_TRACE_SPAN("writer", "CPriorityWriter::writeBatch");
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    std::uint64_t records = 0;
+    std::uint64_t inserted = 0;
+    std::exception_ptr error;
+
+    if (!failed)
+    {
+      try
+      {
+        store_->beginBatch();
+        for (SItem &item : batch)
+        {
+          if (SArchiveRecord *record = std::get_if<SArchiveRecord>(&item.value))
+          {
+            records++;
+            inserted += store_->insertRecord(item.siteID, item.instrumentID, *record) ? 1 : 0;
+          }
+          else if (SWlkRecord *record = std::get_if<SWlkRecord>(&item.value))
+          {
+            records++;
+            inserted += store_->insertRecord(item.siteID, item.instrumentID, record->record, record->JD) ? 1 : 0;
+          }
+          else
+          {
+            std::get<query_t>(item.value)(*store_);
+          };
+        };
+        store_->endBatch();
+      }
+      catch(...)
+      {
+        store_->abortBatch();
+        error = std::current_exception();
+      };
+    };
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    c.statistics.written += records;
+    c.statistics.inserted += inserted;
+    c.statistics.batches++;
+    if (error && !error_)
+    {
+      error_ = error;
+    };
+
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+  }
+
+  /// @brief      The writer thread. Creates the store and writes the highest priority class that is ready. After each batch, the
+  ///             rate limit of the class is applied and the size of the next backfill batch is set from the time per record.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  void CPriorityWriter::writer()
+  {
+    std::vector<SItem> batch;
+
+    WCL_TRACE_THREAD("priority writer");
+
+    try
+    {
+      store_ = factory_();
+    }
+    catch(...)
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+
+      error_ = std::current_exception();
+      space_.notify_all();
+    };
+
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    while (!(stop_ && std::all_of(classes_.begin(), classes_.end(), [](SClass const &c) { return c.queue.empty(); })))
+    {
+      std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+      std::chrono::steady_clock::time_point wake = std::chrono::steady_clock::time_point::max();
+      int priority = select(now, wake);
+
+      if (priority < 0)
+      {
+        if (wake == std::chrono::steady_clock::time_point::max())
+        {
+          pending_.wait(lock);
+        }
+        else
+        {
+          pending_.wait_until(lock, wake);
+        };
+      }
+      else
+      {
+        SClass &c = classes_[priority];
+        std::size_t count = std::min(c.queue.size(), c.batchSize);
+        bool failed = error_ || !store_;
+        std::size_t records;
+        std::chrono::microseconds elapsed;
+
+        batch.assign(std::make_move_iterator(c.queue.begin()), std::make_move_iterator(c.queue.begin() + count));
+        c.queue.erase(c.queue.begin(), c.queue.begin() + count);
+        if (c.queue.empty())
+        {
+          c.flushRequested = false;
+        };
+        c.statistics.maxWait = std::max(c.statistics.maxWait,
+                                        std::chrono::duration_cast<std::chrono::microseconds>(now - batch.front().queued));
+        records = std::count_if(batch.begin(), batch.end(),
+                                [](SItem const &item) { return !std::holds_alternative<query_t>(item.value); });
+
+        writing_ = true;
+        space_.notify_all();              // The producers can fill the queue while the batch is written.
+        lock.unlock();
+
+        elapsed = writeBatch(c, batch, failed);
+        batch.clear();
+
+        lock.lock();
+        writing_ = false;
+
+        if (c.limits.rate > 0)
+        {
+          std::chrono::duration<double> interval(static_cast<double>(records) / c.limits.rate);
+
+          c.readyAt = std::max(c.readyAt, now) + std::chrono::duration_cast<std::chrono::steady_clock::duration>(interval);
+        };
+
+        if ((priority != PC_LIVE) && !failed && (records != 0))
+        {
+            // Size the next batch so that it takes about the slice time.
+
+          double perRecord = std::max(1.0, static_cast<double>(elapsed.count())) / static_cast<double>(records);
+
+          c.batchSize = std::clamp<std::size_t>(static_cast<std::size_t>(slice_.count() / perRecord), 1, c.limits.batchSize);
+        };
+
+        space_.notify_all();
+      };
+    };
+  }
+
+} // namespace WCL
@@ -0,0 +1,377 @@
+﻿//*********************************************************************************************************************************
+//
+// PROJECT:							Weather Class Library (WCL)
+// FILE:								replay
+// SUBSYSTEM:						Historical replay driver
+// LANGUAGE:						C++
+// TARGET OS:						WINDOWS/UNIX/LINUX/MAC
+// LIBRARY DEPENDANCE:	Boost
+// NAMESPACE:						WCL
+// AUTHOR:							Gavin Blakeman.
+// LICENSE:             GPLv2
+//
+//                      Copyright 2026 Gavin Blakeman.
+//                      This file is part of the Weather Class Library (WCL).
+//
+//                      WCL is free software: you can redistribute it and/or modify it under the terms of the GNU General
+//                      Public License as published by the Free Software Foundation, either version 2 of the License, or (at your
+//                      option) any later version.
+//
+//                      WCL is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the
+//                      implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//                      for more details.
+//
+//                      You should have received a copy of the GNU General Public License along with WCL.  If not, see
+//                      <http://www.gnu.org/licenses/>.
+//
+// OVERVIEW:						Implements the historical replay driver.
+//
+// CLASSES INCLUDED:    CReplayDriver
+//
+// CLASS HIERARCHY:     CReplayDriver
+//
+// HISTORY:             2026-10-19 GGB - File Created
+//
+//*********************************************************************************************************************************
+
+#include "include/replay.h"
+
+  // Standard C++ library header files.
+
+#include <algorithm>
+#include <cstdio>
+#include <limits>
+
+  // Miscellaneous library header files.
+
+#include <GCL>
+
+  // WCL header files
+
+#include "include/timestamp.h"
+#include "include/trace.h"
+
+namespace WCL
+{
+  /// @brief      Class constructor.
+  /// @param[in]  callback: The function called for each record. The callback is called from the station threads and must be
+  ///             thread-safe if more than one station is replayed.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  CReplayDriver::CReplayDriver(callback_t callback) : callback_(callback), stop_(false)
+  {
+  }
+
+  /// @brief Class destructor. Stops any running replay.
+  /// @throws None.
+  /// @version 2026-10-19/GGB - Function created.
+
+  CReplayDriver::~CReplayDriver()
+  {
+    stop();
+  }
+
+  /// @brief      Adds a station to replay from a directory of .wlk files, or a single .wlk file.
+  /// @param[in]  siteID: The site ID.
+  /// @param[in]  instrumentID: The instrument ID.
+  /// @param[in]  path: The directory or file.
+  /// @throws     boost::filesystem::filesystem_error
+  /// @version    2026-10-19/GGB - Function created.
+
+  void CReplayDriver::addStation(unsigned long siteID, unsigned long instrumentID, boost::filesystem::path const &path)
+  {
+    std::vector<boost::filesystem::path> files;
+
+    if (boost::filesystem::is_directory(path))
+    {
+      for (auto const &entry : boost::filesystem::directory_iterator(path))
+      {
+        int year, month;
+
+        if (fileDate(entry.path(), year, month))
+        {
+          files.push_back(entry.path());
+        };
+      };
+    }
+    else
+    {
+      files.push_back(path);
+    };
+
+    addStation(siteID, instrumentID, files);
+  }
+
+  /// @brief      Adds a station to replay from a list of .wlk files.
+  /// @param[in]  siteID: The site ID.
+  /// @param[in]  instrumentID: The instrument ID.
+  /// @param[in]  files: The files to replay. They are sorted into date order.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  void CReplayDriver::addStation(unsigned long siteID, unsigned long instrumentID, std::vector<boost::filesystem::path> const &files)
+  {
+    std::unique_ptr<SStation> station = std::make_unique<SStation>();
+
+    station->siteID = siteID;
+    station->instrumentID = instrumentID;
+    station->statistics.siteID = siteID;
+    station->statistics.instrumentID = instrumentID;
+    station->files = files;
+    std::sort(station->files.begin(), station->files.end(),
+              [] (boost::filesystem::path const &lhs, boost::filesystem::path const &rhs)
+              {
+                return lhs.filename() < rhs.filename();
+              });
+
+    stations_.push_back(std::move(station));
+  }
+
+  /// @brief      Extracts the year and month from a file name of the form YYYY-MM.wlk
+  /// @param[in]  path: The file name.
+  /// @param[out] year: The year.
+  /// @param[out] month: The month.
+  /// @returns    true if the file name has the correct format.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  bool CReplayDriver::fileDate(boost::filesystem::path const &path, int &year, int &month)
+  {
+    std::string extension = path.extension().string();
+    char trailing;
+
+    std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+
+    return ( (extension == ".wlk") &&
+             (std::sscanf(path.stem().string().c_str(), "%4d-%2d%c", &year, &month, &trailing) == 2) &&
+             (month >= 1) && (month <= 12) );
+  }
+
+  /// @brief    Returns the first minute of the earliest file of all the stations. All stations share this origin so that they
+  ///           remain aligned in data time.
+  /// @throws   None.
+  /// @version  2026-10-19/GGB - Function created.
+
+  std::int64_t CReplayDriver::firstMinute() const
+  {
+    std::int64_t returnValue = std::numeric_limits<std::int64_t>::max();
+
+    for (auto const &station : stations_)
+    {
+      int year, month;
+
+      if (!station->files.empty() && fileDate(station->files.front(), year, month))
+      {
+        returnValue = std::min<std::int64_t>(returnValue, TTimestamp(year, month, 1).minutes());
+      };
+    };
+
+    return (returnValue == std::numeric_limits<std::int64_t>::max()) ? 0 : returnValue;
+  }
+
+  /// @brief      Replays all the files for a station. This is the station thread function.
+  /// @param[in]  station: The station to replay.
+  /// @details    The records of each day are sorted by time before being emitted. When pacing, the thread sleeps until the record
+  ///             is due. The lag is the time between when the record was due and when the callback returned.
+  ///             An exception thrown by the callback (or while reading a file) stops the replay of the station. It is reported
+  ///             and the station statistics are marked as failed.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  void CReplayDriver::replayStation(SStation &station)
+  {
+    std::vector<SWeatherDataRecord> dayRecords;
+    SReplayRecord replayRecord;
+
+    WCL_TRACE_THREAD("replay " + std::to_string(station.siteID) + "/" + std::to_string(station.instrumentID));
+    replayRecord.siteID = station.siteID;
+    replayRecord.instrumentID = station.instrumentID;
+
+    try
+    {
+      for (auto const &fileName : station.files)
+      {
+        CWeatherLinkDatabaseFile file(fileName);
+
+        if (stop_)
+        {
+          break;
+        };
+
+        if (!fileDate(fileName, replayRecord.year, replayRecord.month) || !file.openFile())
+        {
+          std::lock_guard<std::mutex> lock(station.statisticsMutex);
+          station.statistics.filesFailed++;
+          continue;
+        };
+
+        while (!stop_ && file.nextDayRecord())
+        {
+          dayRecords.clear();
+          while (file.nextArchiveRecord())
+          {
+            dayRecords.push_back(file.getArchiveRecord());
+          };
+          std::stable_sort(dayRecords.begin(), dayRecords.end(), [] (SWeatherDataRecord const &lhs, SWeatherDataRecord const &rhs)
+          {
+            return lhs.packedTime < rhs.packedTime;
+          });
+
+          replayRecord.day = file.getDay();
+          std::int64_t dayMinute = TTimestamp(replayRecord.year, replayRecord.month, replayRecord.day).minutes();
+
+          for (auto const &record : dayRecords)
+          {
+            std::chrono::steady_clock::time_point due;
+            double lag = 0;
+
+            replayRecord.minute = dayMinute + record.packedTime;
+            replayRecord.record = &record;
+
+            if (speedFactor_ > 0)
+            {
+              due = startTime_ + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                      std::chrono::duration<double>((replayRecord.minute - startMinute_) * 60.0 / speedFactor_));
+
+                // Sleep in short slices so that a stop request is seen promptly.
+
+              while (!stop_ && std::chrono::steady_clock::now() < due)
+              {
+                std::this_thread::sleep_until(std::min(due, std::chrono::steady_clock::now() + std::chrono::milliseconds(100)));
+              };
+              if (stop_)
+              {
+                break;
+              };
+            };
+
+            callback_(replayRecord);
+
+            if (speedFactor_ > 0)
+            {
+              lag = std::max(0.0, std::chrono::duration<double>(std::chrono::steady_clock::now() - due).count());
+            };
+
+            {
+              std::lock_guard<std::mutex> lock(station.statisticsMutex);
+              station.statistics.records++;
+              station.totalLag += lag;
+              station.statistics.maxLag = std::max(station.statistics.maxLag, lag);
+            }
+          };
+        };
+
+        std::lock_guard<std::mutex> lock(station.statisticsMutex);
+        station.statistics.filesRead++;
+      };
+    }
+    catch(...)
+    {
+      ERRORMESSAGE("WCL: Exception replaying station " + std::to_string(station.siteID) + "/" +
+                   std::to_string(station.instrumentID) + ". Station stopped.");
+
+      std::lock_guard<std::mutex> lock(station.statisticsMutex);
+      station.statistics.failed = true;
+    };
+
+    std::lock_guard<std::mutex> lock(station.statisticsMutex);
+    station.statistics.complete = true;
+    station.statistics.elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime_).count();
+  }
+
+  /// @brief      Sets the speed-up factor.
+  /// @param[in]  factor: The speed-up factor. 1 is real time, 0 (or less) is as fast as possible.
+  /// @note       The speed factor must be set before the replay is started.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  void CReplayDriver::speedFactor(double factor)
+  {
+    if (!running_)
+    {
+      speedFactor_ = factor;
+    };
+  }
+
+  /// @brief    Starts the replay. One thread is started for each station.
+  /// @throws   std::system_error if a thread cannot be started.
+  /// @version  2026-10-19/GGB - Function created.
+
+  void CReplayDriver::start()
+  {
+    if (!running_)
+    {
+      stop_ = false;
+      running_ = true;
+      startMinute_ = firstMinute();
+      startTime_ = std::chrono::steady_clock::now();
+
+      for (auto &station : stations_)
+      {
+        station->thread = std::thread(&CReplayDriver::replayStation, this, std::ref(*station));
+      };
+    };
+  }
+
+  /// @brief      Returns the statistics for each of the stations.
+  /// @returns    Vector of the statistics in the order the stations were added.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  std::vector<SReplayStatistics> CReplayDriver::statistics() const
+  {
+    std::vector<SReplayStatistics> returnValue;
+    double now = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime_).count();
+
+    for (auto const &station : stations_)
+    {
+      std::lock_guard<std::mutex> lock(station->statisticsMutex);
+      SReplayStatistics s = station->statistics;
+
+      if (!s.complete)
+      {
+        s.elapsed = running_ ? now : 0;
+      };
+      if (s.elapsed > 0)
+      {
+        s.recordsPerSecond = s.records / s.elapsed;
+      };
+      if (s.records != 0)
+      {
+        s.meanLag = station->totalLag / s.records;
+      };
+
+      returnValue.push_back(s);
+    };
+
+    return returnValue;
+  }
+
+  /// @brief    Stops the replay and waits for the station threads to finish.
+  /// @throws   None.
+  /// @version  2026-10-19/GGB - Function created.
+
+  void CReplayDriver::stop()
+  {
+    stop_ = true;
+    wait();
+  }
+
+  /// @brief    Waits for all the stations to complete their replay.
+  /// @throws   None.
+  /// @version  2026-10-19/GGB - Function created.
+
+  void CReplayDriver::wait()
+  {
+    for (auto &station : stations_)
+    {
+      if (station->thread.joinable())
+      {
+        station->thread.join();
+      };
+    };
+    running_ = false;
+  }
+
+} // namespace WCL
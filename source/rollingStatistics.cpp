@@ -0,0 +1,403 @@
+﻿//*********************************************************************************************************************************
+//
+// PROJECT:							Weather Class Library (WCL)
+// FILE:								rollingStatistics
+// SUBSYSTEM:						Streaming (sliding window) statistics
+// LANGUAGE:						C++
+// TARGET OS:						WINDOWS/UNIX/LINUX/MAC
+// LIBRARY DEPENDANCE:	None.
+// NAMESPACE:						WCL
+// AUTHOR:							Gavin Blakeman.
+// LICENSE:             GPLv2
+//
+//                      Copyright 2026 Gavin Blakeman.
+//                      This file is part of the Weather Class Library (WCL).
+//
+//                      WCL is free software: you can redistribute it and/or modify it under the terms of the GNU General
+//                      Public License as published by the Free Software Foundation, either version 2 of the License, or (at your
+//                      option) any later version.
+//
+//                      WCL is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the
+//                      implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//                      for more details.
+//
+//                      You should have received a copy of the GNU General Public License along with WCL.  If not, see
+//                      <http://www.gnu.org/licenses/>.
+//
+// OVERVIEW:						Implements the sliding window statistics.
+//
+// CLASSES INCLUDED:    CRollingStatistics
+//
+// CLASS HIERARCHY:     CRollingStatistics
+//
+// HISTORY:             2026-10-19 GGB - File Created
+//
+//*********************************************************************************************************************************
+
+#include "include/rollingStatistics.h"
+
+  // Standard C++ library header files.
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace WCL
+{
+  static double const NaN = std::numeric_limits<double>::quiet_NaN();
+
+  /// @brief      Adds a value to the sum using Neumaier's variant of Kahan summation.
+  /// @param[in]  value: The value to add.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  void CRollingStatistics::CCompensatedSum::add(double value)
+  {
+    double t = sum_ + value;
+
+    if (std::fabs(sum_) >= std::fabs(value))
+    {
+      compensation_ += (sum_ - t) + value;
+    }
+    else
+    {
+      compensation_ += (value - t) + sum_;
+    };
+    sum_ = t;
+  }
+
+  /// @brief      Adds a sample to a field and updates all the windows of the field.
+  /// @param[in]  fieldID: The field.
+  /// @param[in]  time: The time of the sample. Samples must be added in time order.
+  /// @param[in]  value: The sample value. NaN values (missing data) are not added but still advance the windows.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  void CRollingStatistics::add(fieldID_t fieldID, time_t time, double value)
+  {
+    SField &field = fields_[fieldID];
+
+    if (!std::isnan(value))
+    {
+      SSample sample = { time, value, field.nextSequence++ };
+      double delta;
+
+      if (!field.hasOffset)
+      {
+        field.offset = value;
+        field.hasOffset = true;
+      };
+      delta = value - field.offset;
+      field.samples.push_back(sample);
+
+      for (windowID_t windowID : field.windows)
+      {
+        SWindow &window = windows_[windowID];
+
+        window.sum.add(delta);
+        window.sumSquares.add(delta * delta);
+        window.count++;
+
+        while (!window.minimum.empty() && window.minimum.back().value >= value)
+        {
+          window.minimum.pop_back();
+        };
+        window.minimum.push_back(sample);
+
+        while (!window.maximum.empty() && window.maximum.back().value <= value)
+        {
+          window.maximum.pop_back();
+        };
+        window.maximum.push_back(sample);
+      };
+    };
+
+    std::uint64_t retain = field.nextSequence;
+
+    for (windowID_t windowID : field.windows)
+    {
+      expire(windows_[windowID], field, time);
+      retain = std::min(retain, windows_[windowID].startSequence);
+    };
+
+      // Release the samples that are no longer in any window.
+
+    while (!field.samples.empty() && field.samples.front().sequence < retain)
+    {
+      field.samples.pop_front();
+    };
+  }
+
+  /// @brief      Adds a field.
+  /// @param[in]  name: The name of the field.
+  /// @returns    The ID of the field.
+  /// @throws     std::bad_alloc
+  /// @version    2026-10-19/GGB - Function created.
+
+  CRollingStatistics::fieldID_t CRollingStatistics::addField(std::string const &name)
+  {
+    fields_.emplace_back();
+    fields_.back().name = name;
+
+    return fields_.size() - 1;
+  }
+
+  /// @brief      Adds a window to a field.
+  /// @param[in]  fieldID: The field.
+  /// @param[in]  length: The length of the window. The window covers (now - length, now].
+  /// @returns    The ID of the window.
+  /// @details    A window added after samples have been added to the field starts empty.
+  /// @throws     std::bad_alloc
+  /// @version    2026-10-19/GGB - Function created.
+
+  CRollingStatistics::windowID_t CRollingStatistics::addWindow(fieldID_t fieldID, time_t length)
+  {
+    SWindow window;
+
+    window.field = fieldID;
+    window.length = length;
+    window.startSequence = fields_[fieldID].nextSequence;
+
+    windows_.push_back(window);
+    fields_[fieldID].windows.push_back(windows_.size() - 1);
+
+    return windows_.size() - 1;
+  }
+
+  /// @brief      Advances all windows to the specified time without adding a sample. This expires samples when the feed stops.
+  /// @param[in]  time: The current time.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  void CRollingStatistics::advance(time_t time)
+  {
+    for (fieldID_t fieldID = 0; fieldID < fields_.size(); fieldID++)
+    {
+      add(fieldID, time, NaN);
+    };
+  }
+
+  /// @brief      Returns the number of samples in the window.
+  /// @param[in]  windowID: The window.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  std::size_t CRollingStatistics::count(windowID_t windowID) const
+  {
+    return windows_[windowID].count;
+  }
+
+  /// @brief      Returns the change over the window (newest value - oldest value). Used for tendencies.
+  /// @param[in]  windowID: The window.
+  /// @returns    The change, or NaN if the window is empty.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  double CRollingStatistics::change(windowID_t windowID) const
+  {
+    return last(windowID) - first(windowID);
+  }
+
+  /// @brief      Removes the samples that have fallen out of the window.
+  /// @param[in]  window: The window.
+  /// @param[in]  field: The field that owns the window.
+  /// @param[in]  now: The current time.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  void CRollingStatistics::expire(SWindow &window, SField const &field, time_t now)
+  {
+    while (window.count != 0)
+    {
+      SSample const &sample = field.samples[window.startSequence - field.samples.front().sequence];
+
+      if (sample.time > now - window.length)
+      {
+        break;
+      };
+
+      double delta = sample.value - field.offset;
+
+      window.sum.add(-delta);
+      window.sumSquares.add(-delta * delta);
+      window.count--;
+      window.startSequence++;
+
+      while (!window.minimum.empty() && window.minimum.front().sequence < window.startSequence)
+      {
+        window.minimum.pop_front();
+      };
+      while (!window.maximum.empty() && window.maximum.front().sequence < window.startSequence)
+      {
+        window.maximum.pop_front();
+      };
+    };
+
+    if (window.count == 0)
+    {
+      window.sum.reset();         // Remove any accumulated rounding.
+      window.sumSquares.reset();
+      window.startSequence = field.nextSequence;
+    };
+  }
+
+  /// @brief      Finds a field by name.
+  /// @param[in]  name: The name of the field.
+  /// @returns    The field ID, or static_cast<fieldID_t>(-1) if there is no field with the name.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  CRollingStatistics::fieldID_t CRollingStatistics::field(std::string const &name) const
+  {
+    auto iter = std::find_if(fields_.begin(), fields_.end(), [&name] (SField const &f) { return f.name == name; });
+
+    return (iter == fields_.end()) ? static_cast<fieldID_t>(-1) : static_cast<fieldID_t>(iter - fields_.begin());
+  }
+
+  /// @brief      Returns the oldest value in the window.
+  /// @param[in]  windowID: The window.
+  /// @returns    The oldest value, or NaN if the window is empty.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  double CRollingStatistics::first(windowID_t windowID) const
+  {
+    SSample const *sample = oldest(windows_[windowID]);
+
+    return sample ? sample->value : NaN;
+  }
+
+  /// @brief      Returns the newest value in the window.
+  /// @param[in]  windowID: The window.
+  /// @returns    The newest value, or NaN if the window is empty.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  double CRollingStatistics::last(windowID_t windowID) const
+  {
+    SWindow const &window = windows_[windowID];
+
+    return (window.count == 0) ? NaN : fields_[window.field].samples.back().value;
+  }
+
+  /// @brief      Returns the maximum value in the window.
+  /// @param[in]  windowID: The window.
+  /// @returns    The maximum, or NaN if the window is empty.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  double CRollingStatistics::maximum(windowID_t windowID) const
+  {
+    SWindow const &window = windows_[windowID];
+
+    return (window.count == 0) ? NaN : window.maximum.front().value;
+  }
+
+  /// @brief      Returns the mean of the values in the window.
+  /// @param[in]  windowID: The window.
+  /// @returns    The mean, or NaN if the window is empty.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  double CRollingStatistics::mean(windowID_t windowID) const
+  {
+    SWindow const &window = windows_[windowID];
+
+    return (window.count == 0) ? NaN : fields_[window.field].offset + window.sum.value() / window.count;
+  }
+
+  /// @brief      Returns the minimum value in the window.
+  /// @param[in]  windowID: The window.
+  /// @returns    The minimum, or NaN if the window is empty.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  double CRollingStatistics::minimum(windowID_t windowID) const
+  {
+    SWindow const &window = windows_[windowID];
+
+    return (window.count == 0) ? NaN : window.minimum.front().value;
+  }
+
+  /// @brief      Returns the oldest sample in the window.
+  /// @param[in]  window: The window.
+  /// @returns    Pointer to the sample, or nullptr if the window is empty.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  CRollingStatistics::SSample const *CRollingStatistics::oldest(SWindow const &window) const
+  {
+    SField const &field = fields_[window.field];
+
+    return (window.count == 0) ? nullptr : &field.samples[window.startSequence - field.samples.front().sequence];
+  }
+
+  /// @brief    Removes all the samples. The fields and windows are retained.
+  /// @throws   None.
+  /// @version  2026-10-19/GGB - Function created.
+
+  void CRollingStatistics::reset()
+  {
+    for (SField &field : fields_)
+    {
+      field.samples.clear();
+      field.hasOffset = false;
+    };
+
+    for (SWindow &window : windows_)
+    {
+      window.count = 0;
+      window.sum.reset();
+      window.sumSquares.reset();
+      window.minimum.clear();
+      window.maximum.clear();
+      window.startSequence = fields_[window.field].nextSequence;
+    };
+  }
+
+  /// @brief      Returns the sample standard deviation of the values in the window.
+  /// @param[in]  windowID: The window.
+  /// @returns    The standard deviation, or NaN if there are fewer than two values.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  double CRollingStatistics::standardDeviation(windowID_t windowID) const
+  {
+    return std::sqrt(variance(windowID));
+  }
+
+  /// @brief      Returns the sum of the values in the window. (eg rain over the last hour)
+  /// @param[in]  windowID: The window.
+  /// @returns    The sum. Zero if the window is empty.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  double CRollingStatistics::sum(windowID_t windowID) const
+  {
+    SWindow const &window = windows_[windowID];
+
+    return fields_[window.field].offset * window.count + window.sum.value();
+  }
+
+  /// @brief      Returns the sample variance of the values in the window.
+  /// @param[in]  windowID: The window.
+  /// @returns    The variance, or NaN if there are fewer than two values.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  double CRollingStatistics::variance(windowID_t windowID) const
+  {
+    SWindow const &window = windows_[windowID];
+    double n = static_cast<double>(window.count);
+
+    if (window.count < 2)
+    {
+      return NaN;
+    };
+
+    double s = window.sum.value();
+
+    return std::max(0.0, (window.sumSquares.value() - s * s / n) / (n - 1));
+  }
+
+} // namespace WCL
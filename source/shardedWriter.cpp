@@ -0,0 +1,427 @@
+﻿//*********************************************************************************************************************************
+//
+// PROJECT:							Weather Class Library (WCL)
+// FILE:								shardedWriter
+// SUBSYSTEM:						Concurrent archive writers sharded by station
+// LANGUAGE:						C++
+// TARGET OS:						WINDOWS/UNIX/LINUX/MAC
+// LIBRARY DEPENDANCE:	None.
+// NAMESPACE:						WCL
+// AUTHOR:							Gavin Blakeman.
+// LICENSE:             GPLv2
+//
+//                      Copyright 2026 Gavin Blakeman.
+//                      This file is part of the Weather Class Library (WCL).
+//
+//                      WCL is free software: you can redistribute it and/or modify it under the terms of the GNU General
+//                      Public License as published by the Free Software Foundation, either version 2 of the License, or (at your
+//                      option) any later version.
+//
+//                      WCL is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the
+//                      implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//                      for more details.
+//
+//                      You should have received a copy of the GNU General Public License along with WCL.  If not, see
+//                      <http://www.gnu.org/licenses/>.
+//
+// OVERVIEW:						Writes archive records to several stores in parallel. Each (site, instrument) pair is hashed to one of N
+//                      shards. Each shard has its own writer thread, its own store (and so its own database connection) and its
+//                      own queue. The stores are created by a factory on the writer thread, as a Qt database connection can only
+//                      be used on the thread that created it.
+//                      The queue of a shard is written in order by one thread, so the records of a station are written in the
+//                      order they were inserted. The queue is written as a batch (one transaction) when it reaches the batch
+//                      size or when the oldest queued record is older than the flush interval. A producer blocks when the queue
+//                      of its shard reaches the queue limit, so the memory used is bounded when the store cannot keep up.
+//                      Queries (lastWeatherRecord(), recordExists()) are queued behind the records of the shard and run on the
+//                      writer thread, so they see all the records inserted before them.
+//                      An error raised by a store is held by the shard and rethrown to the next caller that uses the shard. The
+//                      records of the failed batch are not retried.
+//
+// CLASSES INCLUDED:    CShardedWriter
+//
+// CLASS HIERARCHY:     CWeatherStore
+//                        - CShardedWriter
+//
+// HISTORY:             2026-10-19 GGB - File Created
+//
+//*********************************************************************************************************************************
+
+#include "include/shardedWriter.h"
+
+  // Standard C++ library header files.
+
+#include <algorithm>
+
+  // WCL header files
+
+#include "include/trace.h"
+
+namespace WCL
+{
+  /// @brief      Constructor. Starts the writer threads.
+  /// @param[in]  shards: The number of shards. (0 = hardware concurrency)
+  /// @param[in]  factory: Creates the store of a shard. Called on the writer thread of the shard with the shard number.
+  /// @param[in]  batchSize: The number of records written as one batch.
+  /// @param[in]  flushInterval: The longest time a record is queued before the queue is written.
+  /// @param[in]  queueLimit: The number of queued records at which a producer blocks. (0 = 4 batches)
+  /// @throws     std::bad_alloc
+  /// @version    2026-10-19/GGB - Function created.
+
+  CShardedWriter::CShardedWriter(std::size_t shards, factory_t factory, std::size_t batchSize,
+                                 std::chrono::milliseconds flushInterval, std::size_t queueLimit)
+    : factory_(factory), batchSize_(std::max<std::size_t>(1, batchSize)),
+      queueLimit_((queueLimit == 0) ? 4 * batchSize_ : std::max(queueLimit, batchSize_)), flushInterval_(flushInterval)
+  {
+    if (shards == 0)
+    {
+      shards = std::max(1u, std::thread::hardware_concurrency());
+    };
+
+    for (std::size_t index = 0; index < shards; index++)
+    {
+      shards_.emplace_back(new SShard());
+      shards_.back()->queue.reserve(batchSize_);
+    };
+    for (std::size_t index = 0; index < shards; index++)
+    {
+      shards_[index]->thread = std::thread(&CShardedWriter::writer, this, std::ref(*shards_[index]), index);
+    };
+  }
+
+  /// @brief      Destructor. Writes the queued records and stops the writer threads. Errors are not reported.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  CShardedWriter::~CShardedWriter()
+  {
+    for (auto &shard : shards_)
+    {
+      std::lock_guard<std::mutex> lock(shard->mutex);
+
+      shard->stop = true;
+      shard->pending.notify_one();
+    };
+
+    for (auto &shard : shards_)
+    {
+      shard->thread.join();
+    };
+  }
+
+  /// @brief      Adds an item to the queue of a shard. Blocks while the queue is full.
+  /// @param[in]  shard: The shard.
+  /// @param[in]  item: The item to queue.
+  /// @throws     The error held by the shard.
+  /// @version    2026-10-19/GGB - Function created.
+
+  void CShardedWriter::enqueue(SShard &shard, SItem &&item)
+  {
+    std::unique_lock<std::mutex> lock(shard.mutex);
+    bool isQuery = std::holds_alternative<query_t>(item.value);
+
+    shard.space.wait(lock, [&] { return shard.error || (shard.queue.size() < queueLimit_); });
+
+    if (shard.error)
+    {
+      std::rethrow_exception(shard.error);
+    };
+
+    if (shard.queue.empty())
+    {
+      shard.oldest = std::chrono::steady_clock::now();
+    };
+    shard.queue.push_back(std::move(item));
+
+    if (isQuery)
+    {
+      shard.flushRequested = true;
+    }
+    else
+    {
+      shard.statistics.queued++;
+      shard.statistics.maxQueue = std::max(shard.statistics.maxQueue, shard.queue.size());
+    };
+
+    if (isQuery || (shard.queue.size() == 1) || (shard.queue.size() == batchSize_))
+    {
+      shard.pending.notify_one();
+    };
+  }
+
+  /// @brief      Writes the queued records of all the shards and waits until they have been written.
+  /// @throws     The error held by a shard.
+  /// @version    2026-10-19/GGB - Function created.
+
+  void CShardedWriter::flush()
+  {
+    for (auto &shard : shards_)
+    {
+      std::lock_guard<std::mutex> lock(shard->mutex);
+
+      shard->flushRequested = true;
+      shard->pending.notify_one();
+    };
+
+    for (auto &shard : shards_)
+    {
+      std::unique_lock<std::mutex> lock(shard->mutex);
+
+      shard->space.wait(lock, [&] { return shard->queue.empty() && !shard->writing; });
+
+      if (shard->error)
+      {
+        std::rethrow_exception(shard->error);
+      };
+    };
+  }
+
+  /// @brief      Queues an archive record downloaded from the console.
+  /// @param[in]  siteID: The site ID.
+  /// @param[in]  instrumentID: The instrument ID.
+  /// @param[in]  record: The record.
+  /// @returns    true. The record is written by the writer thread of the shard. statistics() returns the records inserted.
+  /// @throws     The error held by the shard.
+  /// @version    2026-10-19/GGB - Function created.
+
+  bool CShardedWriter::insertRecord(unsigned long siteID, unsigned long instrumentID, SArchiveRecord &record)
+  {
+    enqueue(*shards_[shard(siteID, instrumentID)], SItem{ siteID, instrumentID, record });
+
+    return true;
+  }
+
+  /// @brief      Queues an archive record read from a .wlk file.
+  /// @param[in]  siteID: The site ID.
+  /// @param[in]  instrumentID: The instrument ID.
+  /// @param[in]  record: The record.
+  /// @param[in]  JD: The date of the record.
+  /// @returns    true. The record is written by the writer thread of the shard. statistics() returns the records inserted.
+  /// @throws     The error held by the shard.
+  /// @version    2026-10-19/GGB - Function created.
+
+  bool CShardedWriter::insertRecord(unsigned long siteID, unsigned long instrumentID, SWeatherDataRecord const &record,
+                                    ACL::TJD const &JD)
+  {
+    enqueue(*shards_[shard(siteID, instrumentID)], SItem{ siteID, instrumentID, SWlkRecord{ record, JD } });
+
+    return true;
+  }
+
+  /// @brief      Gets the time of the last record of a station. The records queued before the call are written first.
+  /// @param[in]  siteID: The site ID.
+  /// @param[in]  instrumentID: The instrument ID.
+  /// @param[out] MJD: The MJD of the last record.
+  /// @param[out] time: The time of the last record.
+  /// @returns    true if a record was found.
+  /// @throws     The error held by the shard.
+  /// @version    2026-10-19/GGB - Function created.
+
+  bool CShardedWriter::lastWeatherRecord(unsigned long siteID, unsigned long instrumentID, std::uint16_t &MJD, std::uint16_t &time)
+  {
+    return query(siteID, instrumentID, [&](CWeatherStore &store)
+    {
+      return store.lastWeatherRecord(siteID, instrumentID, MJD, time);
+    });
+  }
+
+  /// @brief      Runs a query on the store of the shard of a station, on the writer thread, after the queued records.
+  /// @param[in]  siteID: The site ID.
+  /// @param[in]  instrumentID: The instrument ID.
+  /// @param[in]  function: The query.
+  /// @returns    The result of the query.
+  /// @throws     The error held by the shard, or the error raised by the query.
+  /// @version    2026-10-19/GGB - Function created.
+
+  bool CShardedWriter::query(unsigned long siteID, unsigned long instrumentID, std::function<bool(CWeatherStore &)> function)
+  {
+    SShard &s = *shards_[shard(siteID, instrumentID)];
+    query_t task(std::move(function));
+    std::future<bool> result = task.get_future();
+
+    enqueue(s, SItem{ siteID, instrumentID, std::move(task) });
+
+    try
+    {
+      return result.get();
+    }
+    catch(std::future_error const &)
+    {
+      std::lock_guard<std::mutex> lock(s.mutex);
+
+      if (s.error)
+      {
+        std::rethrow_exception(s.error);
+      };
+      throw;
+    };
+  }
+
+  /// @brief      Checks if a record exists. The records queued before the call are written first.
+  /// @param[in]  siteID: The site ID.
+  /// @param[in]  instrumentID: The instrument ID.
+  /// @param[in]  JD: The date of the record.
+  /// @param[in]  time: The time of the record (HHMM).
+  /// @returns    true if the record exists.
+  /// @throws     The error held by the shard.
+  /// @version    2026-10-19/GGB - Function created.
+
+  bool CShardedWriter::recordExists(unsigned long siteID, unsigned long instrumentID, ACL::TJD JD, std::uint16_t time)
+  {
+    return query(siteID, instrumentID, [&](CWeatherStore &store)
+    {
+      return store.recordExists(siteID, instrumentID, JD, time);
+    });
+  }
+
+  /// @brief      Returns the shard that a station is written by.
+  /// @param[in]  siteID: The site ID.
+  /// @param[in]  instrumentID: The instrument ID.
+  /// @returns    The shard number.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  std::size_t CShardedWriter::shard(unsigned long siteID, unsigned long instrumentID) const
+  {
+    std::uint64_t key = (static_cast<std::uint64_t>(siteID) << 32) ^ static_cast<std::uint64_t>(instrumentID);
+
+    key ^= key >> 33;                     // Mix the bits so that consecutive IDs spread over the shards.
+    key *= 0xFF51AFD7ED558CCDULL;
+    key ^= key >> 33;
+
+    return static_cast<std::size_t>(key % shards_.size());
+  }
+
+  /// @brief      Returns the statistics of each shard.
+  /// @returns    The statistics, indexed by shard.
+  /// @throws     std::bad_alloc
+  /// @version    2026-10-19/GGB - Function created.
+
+  std::vector<SShardStatistics> CShardedWriter::statistics()
+  {
+    std::vector<SShardStatistics> returnValue;
+
+    for (auto &shard : shards_)
+    {
+      std::lock_guard<std::mutex> lock(shard->mutex);
+
+      returnValue.push_back(shard->statistics);
+    };
+
+    return returnValue;
+  }
+
+  /// @brief      Writes a batch to the store of a shard as one transaction. Called by the writer thread without the lock held.
+  /// @param[in]  shard: The shard.
+  /// @param[in]  batch: The items to write, in queue order.
+  /// @param[in]  failed: The shard holds an error. The records are dropped and the queries are not run.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  void CShardedWriter::writeBatch(SShard &shard, std::vector<SItem> &batch, bool failed)
+  {
+    WCL_TRACE_SPAN("writer", "CShardedWriter::writeBatch");
+
+    std::uint64_t records = 0;
+    std::uint64_t inserted = 0;
+    std::exception_ptr error;
+
+    if (!failed)
+    {
+      try
+      {
+        shard.store->beginBatch();
+        for (SItem &item : batch)
+        {
+          if (SArchiveRecord *record = std::get_if<SArchiveRecord>(&item.value))
+          {
+            records++;
+            inserted += shard.store->insertRecord(item.siteID, item.instrumentID, *record) ? 1 : 0;
+          }
+          else if (SWlkRecord *record = std::get_if<SWlkRecord>(&item.value))
+          {
+            records++;
+            inserted += shard.store->insertRecord(item.siteID, item.instrumentID, record->record, record->JD) ? 1 : 0;
+          }
+          else
+          {
+            std::get<query_t>(item.value)(*shard.store);
+          };
+        };
+        shard.store->endBatch();
+      }
+      catch(...)
+      {
+        shard.store->abortBatch();
+        error = std::current_exception();
+      };
+    };
+
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    shard.statistics.written += records;
+    shard.statistics.inserted += inserted;
+    shard.statistics.batches++;
+    if (error && !shard.error)
+    {
+      shard.error = error;
+    };
+  }
+
+  /// @brief      The writer thread of a shard. Creates the store and writes the queue when it reaches the batch size, when the
+  ///             oldest record reaches the flush interval, when a flush or a query is requested and when stopping.
+  /// @param[in]  shard: The shard.
+  /// @param[in]  index: The shard number.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  void CShardedWriter::writer(SShard &shard, std::size_t index)
+  {
+    std::vector<SItem> batch;
+
+    WCL_TRACE_THREAD("shard writer " + std::to_string(index));
+    batch.reserve(batchSize_);
+
+    try
+    {
+      shard.store = factory_(index);
+    }
+    catch(...)
+    {
+      std::lock_guard<std::mutex> lock(shard.mutex);
+
+      shard.error = std::current_exception();
+      shard.space.notify_all();
+    };
+
+    std::unique_lock<std::mutex> lock(shard.mutex);
+
+    while (!(shard.stop && shard.queue.empty()))
+    {
+      if (shard.queue.empty())
+      {
+        shard.pending.wait(lock, [&] { return shard.stop || !shard.queue.empty(); });
+      }
+      else
+      {
+        shard.pending.wait_until(lock, shard.oldest + flushInterval_,
+                                 [&] { return shard.stop || shard.flushRequested || (shard.queue.size() >= batchSize_); });
+
+        bool failed = shard.error || !shard.store;
+
+        batch.swap(shard.queue);
+        shard.flushRequested = false;
+        shard.writing = true;
+        shard.space.notify_all();         // The producers can fill the queue while the batch is written.
+        lock.unlock();
+
+        writeBatch(shard, batch, failed);
+        batch.clear();
+
+        lock.lock();
+        shard.writing = false;
+        shard.space.notify_all();
+      };
+    };
+  }
+
+} // namespace WCL
@@ -0,0 +1,447 @@
+﻿//*********************************************************************************************************************************
+//
+// PROJECT:							Weather Class Library (WCL)
+// FILE:								stationCache
+// SUBSYSTEM:						Warm start cache of the station state held by the database
+// LANGUAGE:						C++
+// TARGET OS:						WINDOWS/UNIX/LINUX/MAC
+// LIBRARY DEPENDANCE:	boost::filesystem, boost::interprocess
+// NAMESPACE:						WCL
+// AUTHOR:							Gavin Blakeman.
+// LICENSE:             GPLv2
+//
+//                      Copyright 2026 Gavin Blakeman.
+//                      This file is part of the Weather Class Library (WCL).
+//
+//                      WCL is free software: you can redistribute it and/or modify it under the terms of the GNU General
+//                      Public License as published by the Free Software Foundation, either version 2 of the License, or (at your
+//                      option) any later version.
+//
+//                      WCL is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the
+//                      implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//                      for more details.
+//
+//                      You should have received a copy of the GNU General Public License along with WCL.  If not, see
+//                      <http://www.gnu.org/licenses/>.
+//
+// OVERVIEW:						Holds the state of each station that the ingest daemon otherwise queries from the database when it starts.
+//
+// CLASSES INCLUDED:    SStationState
+//                      CStationCache
+//
+// CLASS HIERARCHY:     CStationCache
+//
+// HISTORY:             2026-10-19 GGB - File Created
+//
+//*********************************************************************************************************************************
+
+#include "include/stationCache.h"
+
+  // Standard C++ library header files.
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <string>
+
+  // Miscellaneous library header files.
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <GCL>
+
+  // WCL header files
+
+#include "include/databaseSQLite.h"
+#include "include/importCatalog.h"
+#include "include/observation.h"
+#include "include/trace.h"
+
+namespace WCL
+{
+  static char const snapshotMagic[8] = { 'W', 'C', 'L', 'S', 'T', 'A', 'T', 'E' };
+
+  struct SSnapshotHeader
+  {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t stationCount;
+    std::int32_t interval;                  ///< Interval of the gap indexes (minutes).
+    std::uint32_t reserved;
+    std::int64_t archiveRows;               ///< Watermark of the database when the snapshot was written.
+    std::int64_t summaryRows;
+    std::uint64_t payloadSize;              ///< Bytes following the header.
+    std::uint64_t payloadHash;              ///< FNV-1a hash of the bytes following the header.
+  };
+
+    // Each station is followed by summaryCount MJD values (padded to a multiple of 8 bytes) and the words of the gap index.
+
+  struct SSnapshotStation
+  {
+    std::uint64_t siteID;
+    std::uint64_t instrumentID;
+    std::uint32_t summaryCount;
+    std::int32_t gapFirstDay;
+    std::int32_t gapDayCount;
+    std::uint16_t lastMJD;
+    std::uint16_t lastTime;
+    std::uint8_t hasLast;
+    std::uint8_t reserved[7];
+  };
+
+  static_assert(sizeof(SSnapshotHeader) == 56, "Snapshot header layout changed. Increment CStationCache::VERSION.");
+  static_assert(sizeof(SSnapshotStation) == 40, "Snapshot station layout changed. Increment CStationCache::VERSION.");
+
+  /// @brief      Determines if a day has a daily summary.
+  /// @param[in]  MJD: The day.
+  /// @returns    true if the day has a daily summary.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  bool SStationState::summaryExists(std::uint32_t MJD) const
+  {
+    return std::binary_search(summaryDays.begin(), summaryDays.end(), MJD);
+  }
+
+  /// @brief      Constructor.
+  /// @param[in]  snapshotFile: The file the snapshot is written to and loaded from.
+  /// @param[in]  saveInterval: The shortest time between the snapshots written by saveIfDue().
+  /// @param[in]  interval: The archive interval (minutes) of the gap indexes.
+  /// @throws     CODE_ERROR - Invalid interval.
+  /// @version    2026-10-19/GGB - Function created.
+
+  CStationCache::CStationCache(boost::filesystem::path const &snapshotFile, std::chrono::seconds saveInterval, int interval)
+    : snapshotFile_(snapshotFile), saveInterval_(saveInterval), lastSave_(std::chrono::steady_clock::now()), interval_(interval)
+  {
+    CGapIndex check(interval_);     // Throws if the interval is not valid.
+  }
+
+  /// @brief      Records that an archive record has been inserted into the database.
+  /// @param[in]  siteID: The site ID.
+  /// @param[in]  instrumentID: The instrument ID.
+  /// @param[in]  key: The key (MJD * 10000 + HHMM) of the record.
+  /// @note       The cache is marked as modified even if the station is not cached, as the watermark of the database has moved.
+  /// @throws     std::bad_alloc
+  /// @version    2026-10-19/GGB - Function created.
+
+  void CStationCache::archiveInserted(unsigned long siteID, unsigned long instrumentID, std::uint32_t key)
+  {
+    auto iterator = stations_.find(std::make_pair(siteID, instrumentID));
+
+    modified_ = true;
+
+    if (iterator != stations_.end())
+    {
+      SStationState &state = iterator->second;
+
+      if (!state.hasLast || (key > STimeSeriesRecord::makeKey(state.lastMJD, state.lastTime)))
+      {
+        state.hasLast = true;
+        state.lastMJD = static_cast<std::uint16_t>(key / 10000);
+        state.lastTime = static_cast<std::uint16_t>(key % 10000);
+      };
+      state.gaps.mark(key);
+    };
+  }
+
+  /// @brief      Reads the state of a station from the database and adds it to the cache, replacing any cached state.
+  /// @param[in]  database: The database to read. Must not be in a transaction with uncommitted rows of the station.
+  /// @param[in]  siteID: The site ID.
+  /// @param[in]  instrumentID: The instrument ID.
+  /// @param[in]  from: The start of the range loaded into the gap index.
+  /// @param[in]  to: The end of the range loaded into the gap index.
+  /// @throws     0x000B - DATABASE: SQLite error.
+  /// @throws     std::bad_alloc
+  /// @version    2026-10-19/GGB - Function created.
+
+  void CStationCache::build(CDatabaseSQLite &database, unsigned long siteID, unsigned long instrumentID, TTimestamp from,
+                            TTimestamp to)
+  {
+    WCL_TRACE_SPAN("cache", "CStationCache::build");
+
+    SStationState state(interval_);
+
+      // The station is removed first, so that the database answers the queries rather than the cache.
+
+    stations_.erase(std::make_pair(siteID, instrumentID));
+
+    state.hasLast = database.lastWeatherRecord(siteID, instrumentID, state.lastMJD, state.lastTime);
+    database.readSummaryDays(siteID, instrumentID, [&state](std::uint32_t MJD) { state.summaryDays.push_back(MJD); });
+    state.gaps.load(database, siteID, instrumentID, from, to);
+
+    stations_.emplace(std::make_pair(siteID, instrumentID), std::move(state));
+    modified_ = true;
+  }
+
+  /// @brief      Removes all the stations from the cache.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  void CStationCache::clear()
+  {
+    stations_.clear();
+  }
+
+  /// @brief      Returns the cached state of a station.
+  /// @param[in]  siteID: The site ID.
+  /// @param[in]  instrumentID: The instrument ID.
+  /// @returns    The state. nullptr if the station is not cached.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  SStationState const *CStationCache::find(unsigned long siteID, unsigned long instrumentID) const
+  {
+    auto iterator = stations_.find(std::make_pair(siteID, instrumentID));
+
+    return (iterator == stations_.end()) ? nullptr : &iterator->second;
+  }
+
+  /// @brief      Loads the cache from the snapshot file. The file is mapped and checked against the database before it is used.
+  /// @param[in]  database: The database the snapshot was written from.
+  /// @returns    true if the snapshot was loaded. false if there is no snapshot or it cannot be used (the version, the hash or
+  ///             the watermark do not match). The cache is then empty and the stations must be rebuilt with build().
+  /// @throws     0x000B - DATABASE: SQLite error.
+  /// @throws     std::bad_alloc
+  /// @version    2026-10-19/GGB - Function created.
+
+  bool CStationCache::load(CDatabaseSQLite &database)
+  {
+    WCL_TRACE_SPAN("cache", "CStationCache::load");
+
+    boost::system::error_code ec;
+    std::uintmax_t fileSize = boost::filesystem::file_size(snapshotFile_, ec);
+    std::unique_ptr<boost::interprocess::file_mapping> mapping;
+    std::unique_ptr<boost::interprocess::mapped_region> region;
+    SSnapshotHeader header;
+    SStoreWatermark current;
+    char const *payload;
+    std::size_t offset = 0;
+    std::size_t wordsPerDay = CGapIndex(interval_).wordsPerDay();
+
+    clear();
+    modified_ = false;
+
+    if (ec || (fileSize < sizeof(SSnapshotHeader)))
+    {
+      return false;
+    };
+
+    try
+    {
+      mapping = std::make_unique<boost::interprocess::file_mapping>(snapshotFile_.string().c_str(), boost::interprocess::read_only);
+      region = std::make_unique<boost::interprocess::mapped_region>(*mapping, boost::interprocess::read_only);
+    }
+    catch(boost::interprocess::interprocess_exception const &)
+    {
+      ERRORMESSAGE("WCL: Unable to map the station cache snapshot " + snapshotFile_.string());
+      return false;
+    };
+
+    std::memcpy(&header, region->get_address(), sizeof(SSnapshotHeader));
+    payload = static_cast<char const *>(region->get_address()) + sizeof(SSnapshotHeader);
+    current = database.watermark();
+
+    if ( (std::memcmp(header.magic, snapshotMagic, sizeof(snapshotMagic)) != 0) || (header.version != VERSION) ||
+         (header.interval != interval_) || (header.payloadSize != fileSize - sizeof(SSnapshotHeader)) ||
+         (CImportCatalog::hash(payload, header.payloadSize) != header.payloadHash) )
+    {
+      ERRORMESSAGE("WCL: The station cache snapshot " + snapshotFile_.string() + " is not valid. Rebuilding from the database.");
+      return false;
+    };
+
+    if (SStoreWatermark{header.archiveRows, header.summaryRows} != current)
+    {
+      ERRORMESSAGE("WCL: The station cache snapshot " + snapshotFile_.string() + " is out of date. Rebuilding from the database.");
+      return false;
+    };
+
+      // Returns the next bytes of the payload. nullptr if the payload is too short.
+
+    auto take = [&](std::size_t bytes) -> char const *
+    {
+      char const *returnValue = nullptr;
+
+      if (bytes <= header.payloadSize - offset)
+      {
+        returnValue = payload + offset;
+        offset += bytes;
+      };
+
+      return returnValue;
+    };
+
+    for (std::uint32_t index = 0; index < header.stationCount; index++)
+    {
+      SSnapshotStation station;
+      SStationState state(interval_);
+      char const *source;
+
+      if ((source = take(sizeof(SSnapshotStation))) == nullptr)
+      {
+        break;
+      };
+      std::memcpy(&station, source, sizeof(SSnapshotStation));
+
+      if ( (station.gapDayCount < 0) ||
+           ((source = take((static_cast<std::size_t>(station.summaryCount) * sizeof(std::uint32_t) + 7) / 8 * 8)) == nullptr) )
+      {
+        break;
+      };
+      state.summaryDays.resize(station.summaryCount);
+      std::memcpy(state.summaryDays.data(), source, station.summaryCount * sizeof(std::uint32_t));
+
+      if ((source = take(static_cast<std::size_t>(station.gapDayCount) * wordsPerDay * sizeof(std::uint64_t))) == nullptr)
+      {
+        break;
+      };
+      state.gaps.assign(station.gapFirstDay, station.gapDayCount, reinterpret_cast<std::uint64_t const *>(source));
+
+      state.hasLast = (station.hasLast != 0);
+      state.lastMJD = station.lastMJD;
+      state.lastTime = station.lastTime;
+
+      stations_.emplace(std::make_pair(static_cast<unsigned long>(station.siteID), static_cast<unsigned long>(station.instrumentID)),
+                        std::move(state));
+    };
+
+    if ((stations_.size() != header.stationCount) || (offset != header.payloadSize))
+    {
+      ERRORMESSAGE("WCL: The station cache snapshot " + snapshotFile_.string() + " is not valid. Rebuilding from the database.");
+      clear();
+      return false;
+    };
+
+    lastSave_ = std::chrono::steady_clock::now();
+    return true;
+  }
+
+  /// @brief      Writes the snapshot. The snapshot is written to a temporary file that then replaces the snapshot file.
+  /// @param[in]  database: The database the cache is attached to. The watermark is read from the database.
+  /// @returns    true if the snapshot was written.
+  /// @note       Must be called outside a transaction, so that the watermark only includes committed rows.
+  /// @throws     0x000B - DATABASE: SQLite error.
+  /// @throws     std::bad_alloc
+  /// @version    2026-10-19/GGB - Function created.
+
+  bool CStationCache::save(CDatabaseSQLite &database)
+  {
+    WCL_TRACE_SPAN("cache", "CStationCache::save");
+
+    SSnapshotHeader header{};
+    SStoreWatermark current = database.watermark();
+    std::vector<char> payload;
+    boost::filesystem::path temporary = snapshotFile_;
+    boost::system::error_code ec;
+
+    auto append = [&payload](void const *data, std::size_t bytes)
+    {
+      char const *source = static_cast<char const *>(data);
+
+      payload.insert(payload.end(), source, source + bytes);
+      payload.resize((payload.size() + 7) / 8 * 8, 0);
+    };
+
+    lastSave_ = std::chrono::steady_clock::now();
+
+    for (auto const &entry : stations_)
+    {
+      SSnapshotStation station{};
+      SStationState const &state = entry.second;
+
+      station.siteID = entry.first.first;
+      station.instrumentID = entry.first.second;
+      station.summaryCount = static_cast<std::uint32_t>(state.summaryDays.size());
+      station.gapFirstDay = state.gaps.firstDay();
+      station.gapDayCount = state.gaps.dayCount();
+      station.lastMJD = state.lastMJD;
+      station.lastTime = state.lastTime;
+      station.hasLast = state.hasLast ? 1 : 0;
+
+      append(&station, sizeof(SSnapshotStation));
+      append(state.summaryDays.data(), state.summaryDays.size() * sizeof(std::uint32_t));
+      append(state.gaps.words().data(), state.gaps.words().size() * sizeof(std::uint64_t));
+    };
+
+    std::memcpy(header.magic, snapshotMagic, sizeof(snapshotMagic));
+    header.version = VERSION;
+    header.stationCount = static_cast<std::uint32_t>(stations_.size());
+    header.interval = interval_;
+    header.archiveRows = current.archiveRows;
+    header.summaryRows = current.summaryRows;
+    header.payloadSize = payload.size();
+    header.payloadHash = CImportCatalog::hash(payload.data(), payload.size());
+
+    temporary += ".tmp";
+
+    {
+      std::ofstream ofs(temporary.string(), std::ofstream::out | std::ofstream::trunc | std::ofstream::binary);
+
+      ofs.write(reinterpret_cast<char const *>(&header), sizeof(SSnapshotHeader));
+      ofs.write(payload.data(), static_cast<std::streamsize>(payload.size()));
+
+      if (!ofs.flush())
+      {
+        ERRORMESSAGE("WCL: Unable to write the station cache snapshot " + temporary.string());
+        return false;
+      };
+    }
+
+    boost::filesystem::rename(temporary, snapshotFile_, ec);
+    if (ec)
+    {
+      ERRORMESSAGE("WCL: Unable to replace the station cache snapshot " + snapshotFile_.string());
+      return false;
+    }
+    else
+    {
+      modified_ = false;
+      return true;
+    };
+  }
+
+  /// @brief      Writes the snapshot if the cache has been modified and the save interval has passed since the last snapshot.
+  /// @param[in]  database: The database the cache is attached to.
+  /// @returns    true if the snapshot was written.
+  /// @throws     0x000B - DATABASE: SQLite error.
+  /// @throws     std::bad_alloc
+  /// @version    2026-10-19/GGB - Function created.
+
+  bool CStationCache::saveIfDue(CDatabaseSQLite &database)
+  {
+    bool returnValue = false;
+
+    if (modified_ && (std::chrono::steady_clock::now() - lastSave_ >= saveInterval_))
+    {
+      returnValue = save(database);
+    };
+
+    return returnValue;
+  }
+
+  /// @brief      Records that a daily summary has been inserted into the database.
+  /// @param[in]  siteID: The site ID.
+  /// @param[in]  instrumentID: The instrument ID.
+  /// @param[in]  MJD: The day of the summary.
+  /// @throws     std::bad_alloc
+  /// @version    2026-10-19/GGB - Function created.
+
+  void CStationCache::summaryInserted(unsigned long siteID, unsigned long instrumentID, std::uint32_t MJD)
+  {
+    auto iterator = stations_.find(std::make_pair(siteID, instrumentID));
+
+    modified_ = true;
+
+    if (iterator != stations_.end())
+    {
+      std::vector<std::uint32_t> &days = iterator->second.summaryDays;
+      auto position = std::lower_bound(days.begin(), days.end(), MJD);
+
+      if ((position == days.end()) || (*position != MJD))
+      {
+        days.insert(position, MJD);
+      };
+    };
+  }
+
+} // namespace WCL
@@ -0,0 +1,441 @@
+﻿//*********************************************************************************************************************************
+//
+// PROJECT:							Weather Class Library (WCL)
+// FILE:								streamMerge
+// SUBSYSTEM:						Merging of the .wlk and console archive streams
+// LANGUAGE:						C++
+// TARGET OS:						WINDOWS/UNIX/LINUX/MAC
+// LIBRARY DEPENDANCE:	boost::filesystem
+// NAMESPACE:						WCL
+// AUTHOR:							Gavin Blakeman.
+// LICENSE:             GPLv2
+//
+//                      Copyright 2026 Gavin Blakeman.
+//                      This file is part of the Weather Class Library (WCL).
+//
+//                      WCL is free software: you can redistribute it and/or modify it under the terms of the GNU General
+//                      Public License as published by the Free Software Foundation, either version 2 of the License, or (at your
+//                      option) any later version.
+//
+//                      WCL is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the
+//                      implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//                      for more details.
+//
+//                      You should have received a copy of the GNU General Public License along with WCL.  If not, see
+//                      <http://www.gnu.org/licenses/>.
+//
+// OVERVIEW:						Implements the merge of the record streams.
+//
+// CLASSES INCLUDED:    CWlkFileSource
+//                      CArchiveRecordSource
+//                      CStreamMerge
+//
+// CLASS HIERARCHY:     CMergeSource
+//                        - CWlkFileSource
+//                        - CArchiveRecordSource
+//                      CStreamMerge
+//
+// HISTORY:             2026-10-19 GGB - File Created
+//
+//*********************************************************************************************************************************
+
+#include "include/streamMerge.h"
+
+  // Standard C++ library header files.
+
+#include <algorithm>
+
+  // Miscellaneous library header files.
+
+#include <GCL>
+
+  // WCL header files
+
+#include "include/replay.h"
+#include "include/timestamp.h"
+#include "include/wireFormat.h"
+
+namespace WCL
+{
+  //********************************************************************************************************************************
+  //
+  // CWlkFileSource
+  //
+  //********************************************************************************************************************************
+
+  /// @brief      Constructs the source from a list of .wlk files.
+  /// @param[in]  files: The files. The names must be of the form YYYY-MM.wlk. The files are sorted into date order.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  CWlkFileSource::CWlkFileSource(std::vector<boost::filesystem::path> const &files) : files_(files)
+  {
+    std::sort(files_.begin(), files_.end(),
+              [] (boost::filesystem::path const &lhs, boost::filesystem::path const &rhs)
+              {
+                return lhs.filename() < rhs.filename();
+              });
+  }
+
+  /// @brief      Constructs the source from a directory of .wlk files or a single file.
+  /// @param[in]  path: The directory or file.
+  /// @throws     boost::filesystem::filesystem_error
+  /// @version    2026-10-19/GGB - Function created.
+
+  CWlkFileSource::CWlkFileSource(boost::filesystem::path const &path)
+  {
+    if (boost::filesystem::is_directory(path))
+    {
+      for (auto const &entry : boost::filesystem::directory_iterator(path))
+      {
+        int year, month;
+
+        if (CReplayDriver::fileDate(entry.path(), year, month))
+        {
+          files_.push_back(entry.path());
+        };
+      };
+      std::sort(files_.begin(), files_.end(),
+                [] (boost::filesystem::path const &lhs, boost::filesystem::path const &rhs)
+                {
+                  return lhs.filename() < rhs.filename();
+                });
+    }
+    else
+    {
+      files_.push_back(path);
+    };
+  }
+
+  /// @brief      Returns the next record.
+  /// @param[out] record: The record.
+  /// @returns    false when there are no more records.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  bool CWlkFileSource::next(SMergedRecord &record)
+  {
+    while (recordIndex_ >= dayRecords_.size())
+    {
+      if (!nextDay())
+      {
+        return false;
+      };
+    };
+
+    record.year = year_;
+    record.month = month_;
+    record.day = day_;
+    record.console = false;
+    record.weatherRecord = dayRecords_[recordIndex_++];
+    record.minute = TTimestamp(year_, month_, day_).minutes() + record.weatherRecord.packedTime;
+
+    return true;
+  }
+
+  /// @brief      Loads the records of the next day, opening the next file when required.
+  /// @returns    false when there are no more days.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  bool CWlkFileSource::nextDay()
+  {
+    dayRecords_.clear();
+    recordIndex_ = 0;
+
+    while (true)
+    {
+      if (!file_)
+      {
+        if (fileIndex_ >= files_.size())
+        {
+          return false;
+        };
+
+        boost::filesystem::path const &fileName = files_[fileIndex_++];
+
+        file_.reset(new CWeatherLinkDatabaseFile(fileName));
+        if (!CReplayDriver::fileDate(fileName, year_, month_) || !file_->openFile())
+        {
+          ERRORMESSAGE("WCL: Unable to read " + fileName.string() + ". File not merged.");
+          file_.reset();
+          continue;
+        };
+      };
+
+      if (file_->nextDayRecord())
+      {
+        day_ = file_->getDay();
+        while (file_->nextArchiveRecord())
+        {
+          dayRecords_.push_back(file_->getArchiveRecord());
+        };
+        std::stable_sort(dayRecords_.begin(), dayRecords_.end(),
+                         [] (SWeatherDataRecord const &lhs, SWeatherDataRecord const &rhs) { return lhs.packedTime < rhs.packedTime; });
+
+        return true;
+      }
+      else
+      {
+        file_.reset();
+      };
+    };
+  }
+
+  //********************************************************************************************************************************
+  //
+  // CArchiveRecordSource
+  //
+  //********************************************************************************************************************************
+
+  /// @brief      Constructs the source from a vector of archive records.
+  /// @param[in]  records: The records.
+  /// @throws     std::bad_alloc
+  /// @version    2026-10-19/GGB - Function created.
+
+  CArchiveRecordSource::CArchiveRecordSource(std::vector<SArchiveRecord> const &records)
+    : CArchiveRecordSource(records.data(), records.size())
+  {
+  }
+
+  /// @brief      Constructs the source from an array of archive records.
+  /// @param[in]  records: The records.
+  /// @param[in]  count: The number of records.
+  /// @details    The console archive is a ring buffer, so a download is not necessarily in time order. The records are sorted by
+  ///             time and unused records (date or time of 0xFFFF) are removed.
+  /// @throws     std::bad_alloc
+  /// @version    2026-10-19/GGB - Function created.
+
+  CArchiveRecordSource::CArchiveRecordSource(SArchiveRecord const *records, std::size_t count)
+  {
+    std::vector<TTimestamp> timestamps(count);
+    std::vector<std::size_t> order;
+
+    order.reserve(TTimestamp::decode(records, count, timestamps.data()));
+    for (std::size_t index = 0; index < count; index++)
+    {
+      if (timestamps[index].valid())
+      {
+        order.push_back(index);
+      };
+    };
+
+    std::stable_sort(order.begin(), order.end(),
+                     [&timestamps] (std::size_t lhs, std::size_t rhs) { return timestamps[lhs] < timestamps[rhs]; });
+
+    records_.reserve(order.size());
+    for (std::size_t index : order)
+    {
+      records_.push_back(records[index]);
+    };
+  }
+
+  /// @brief      Returns the next record.
+  /// @param[out] record: The record.
+  /// @returns    false when there are no more records.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  bool CArchiveRecordSource::next(SMergedRecord &record)
+  {
+    if (recordIndex_ >= records_.size())
+    {
+      return false;
+    }
+    else
+    {
+      record.archiveRecord = records_[recordIndex_++];
+      record.console = true;
+      wireDate(wireValue<SArchiveRecord, ARF_DATE>(reinterpret_cast<std::uint8_t const *>(&record.archiveRecord)), record.year,
+               record.month, record.day);
+      timestamp(record.archiveRecord, record.minute);
+
+      return true;
+    };
+  }
+
+  /// @brief      Determines the timestamp of a console archive record.
+  /// @param[in]  record: The record.
+  /// @param[out] minute: The minutes since 1970-01-01 00:00.
+  /// @returns    false if the date or time of the record is not valid.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  bool CArchiveRecordSource::timestamp(SArchiveRecord const &record, std::int64_t &minute)
+  {
+    TTimestamp timestamp = TTimestamp::decode(record);
+
+    minute = timestamp.minutes();
+
+    return timestamp.valid();
+  }
+
+  //********************************************************************************************************************************
+  //
+  // CStreamMerge
+  //
+  //********************************************************************************************************************************
+
+  /// @brief      Adds a source to the merge. Sources must be added before the first record is read.
+  /// @param[in]  source: The source.
+  /// @param[in]  precedence: The precedence of the source. When sources have records for the same minute, the record from the
+  ///             source with the highest precedence is kept.
+  /// @returns    The index of the source.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  std::size_t CStreamMerge::addSource(std::unique_ptr<CMergeSource> source, int precedence)
+  {
+    SSource newSource{};
+
+    newSource.source = std::move(source);
+    newSource.precedence = precedence;
+    newSource.valid = false;
+    sources_.push_back(std::move(newSource));
+
+    return sources_.size() - 1;
+  }
+
+  /// @brief      Reads the next record of a source and pushes the source onto the heap if there is a record.
+  /// @param[in]  index: The source.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  void CStreamMerge::advance(std::size_t index)
+  {
+    SSource &source = sources_[index];
+
+    source.valid = source.source->next(source.head);
+    if (source.valid)
+    {
+      source.head.source = index;
+      heap_.push_back(index);
+      std::push_heap(heap_.begin(), heap_.end(), [this] (std::size_t lhs, std::size_t rhs) { return before(rhs, lhs); });
+    };
+  }
+
+  /// @brief      Determines if the head of one source is emitted before the head of another.
+  /// @param[in]  lhs: The first source.
+  /// @param[in]  rhs: The second source.
+  /// @returns    true if the head of lhs is earlier, or at the same time with a higher precedence, or the same precedence and a
+  ///             lower index.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  bool CStreamMerge::before(std::size_t lhs, std::size_t rhs) const
+  {
+    SSource const &left = sources_[lhs];
+    SSource const &right = sources_[rhs];
+
+    if (left.head.minute != right.head.minute)
+    {
+      return left.head.minute < right.head.minute;
+    }
+    else if (left.precedence != right.precedence)
+    {
+      return left.precedence > right.precedence;
+    }
+    else
+    {
+      return lhs < rhs;
+    };
+  }
+
+  /// @brief      Returns the next record of the merged stream.
+  /// @param[out] record: The record.
+  /// @returns    false when all the sources are exhausted.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  bool CStreamMerge::next(SMergedRecord &record)
+  {
+    if (!started_)
+    {
+      started_ = true;
+      for (std::size_t index = 0; index < sources_.size(); index++)
+      {
+        advance(index);
+      };
+    };
+
+    while (!heap_.empty())
+    {
+      std::pop_heap(heap_.begin(), heap_.end(), [this] (std::size_t lhs, std::size_t rhs) { return before(rhs, lhs); });
+
+      std::size_t index = heap_.back();
+      bool emit = !haveLast_ || (sources_[index].head.minute > lastMinute_);
+
+      heap_.pop_back();
+
+      if (emit)
+      {
+        record = sources_[index].head;
+        haveLast_ = true;
+        lastMinute_ = record.minute;
+      }
+      else if (sources_[index].head.minute == lastMinute_)
+      {
+        duplicates_++;
+      }
+      else
+      {
+        discarded_++;
+      };
+
+      advance(index);
+
+      if (emit)
+      {
+        return true;
+      };
+    };
+
+    return false;
+  }
+
+  /// @brief      Passes all the records of the merged stream to a function.
+  /// @param[in]  callback: The function to call for each record.
+  /// @returns    The number of records.
+  /// @throws     Any exception thrown by the callback.
+  /// @version    2026-10-19/GGB - Function created.
+
+  std::size_t CStreamMerge::run(callback_t callback)
+  {
+    SMergedRecord record;
+    std::size_t returnValue = 0;
+
+    while (next(record))
+    {
+      callback(record);
+      returnValue++;
+    };
+
+    return returnValue;
+  }
+
+  /// @brief      Writes all the records of the merged stream to a store.
+  /// @param[in]  store: The store.
+  /// @param[in]  siteID: The site ID.
+  /// @param[in]  instrumentID: The instrument ID.
+  /// @returns    The number of records.
+  /// @throws     Any exception thrown by the store.
+  /// @version    2026-10-19/GGB - Function created.
+
+  std::size_t CStreamMerge::run(CWeatherStore &store, unsigned long siteID, unsigned long instrumentID)
+  {
+    return run([&store, siteID, instrumentID] (SMergedRecord const &record)
+    {
+      if (record.console)
+      {
+        SArchiveRecord archiveRecord = record.archiveRecord;
+
+        store.insertRecord(siteID, instrumentID, archiveRecord);
+      }
+      else
+      {
+        store.insertRecord(siteID, instrumentID, record.weatherRecord, ACL::TJD(record.year, record.month, record.day));
+      };
+    });
+  }
+
+} // namespace WCL
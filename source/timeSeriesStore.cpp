@@ -0,0 +1,902 @@
+﻿//*********************************************************************************************************************************
+//
+// PROJECT:							Weather Class Library (WCL)
+// FILE:								timeSeriesStore
+// SUBSYSTEM:						Embedded append-only storage engine
+// LANGUAGE:						C++
+// TARGET OS:						WINDOWS/UNIX/LINUX/MAC
+// LIBRARY DEPENDANCE:	Boost, ACL
+// NAMESPACE:						WCL
+// AUTHOR:							Gavin Blakeman.
+// LICENSE:             GPLv2
+//
+//                      Copyright 2026 Gavin Blakeman.
+//                      This file is part of the Weather Class Library (WCL).
+//
+//                      WCL is free software: you can redistribute it and/or modify it under the terms of the GNU General
+//                      Public License as published by the Free Software Foundation, either version 2 of the License, or (at your
+//                      option) any later version.
+//
+//                      WCL is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the
+//                      implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//                      for more details.
+//
+//                      You should have received a copy of the GNU General Public License along with WCL.  If not, see
+//                      <http://www.gnu.org/licenses/>.
+//
+// OVERVIEW:						Implements the embedded append-only storage engine.
+//
+// CLASSES INCLUDED:    CTimeSeriesStore
+//
+// CLASS HIERARCHY:     CWeatherStore
+//                        - CTimeSeriesStore
+//
+// HISTORY:             2026-10-19 GGB - File Created
+//
+//*********************************************************************************************************************************
+
+#include "include/timeSeriesStore.h"
+
+  // Standard C++ library header files.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+  // Miscellaneous library header files.
+
+#include <GCL>
+
+  // WCL header files
+
+#include "include/error.h"
+#include "include/timestamp.h"
+#include "include/trace.h"
+#include "include/wireFormat.h"
+
+namespace WCL
+{
+  /// @brief Header written at the start of each segment file.
+
+  struct SSegmentHeader
+  {
+    char magic[8];
+    std::uint32_t recordSize;
+    std::uint32_t flags;
+  };
+
+  static_assert(sizeof(SSegmentHeader) == 16, "SSegmentHeader must be 16 bytes to keep the records aligned.");
+
+  static char const segmentMagic[8] = {'W', 'C', 'L', 'T', 'S', '0', '0', '1'};
+
+  /// @brief Creates the name of a segment file from the segment number.
+
+  static boost::filesystem::path segmentName(boost::filesystem::path const &directory, std::uint32_t number, char const *extension)
+  {
+    char name[32];
+
+    std::snprintf(name, sizeof(name), "segment-%08u.%s", number, extension);
+
+    return directory / name;
+  }
+
+  //********************************************************************************************************************************
+  //
+  // CTimeSeriesStore::SSegment
+  //
+  //********************************************************************************************************************************
+
+  /// @brief Segment destructor. Unmaps the file, and deletes it if it has been replaced by compaction.
+  /// @throws None.
+  /// @version 2026-10-19/GGB - Function created.
+
+  CTimeSeriesStore::SSegment::~SSegment()
+  {
+    region.reset();
+    mapping.reset();
+
+    if (obsolete)
+    {
+      boost::system::error_code ec;
+      boost::filesystem::remove(fileName, ec);
+    };
+  }
+
+  /// @brief Returns a pointer to the first record in the mapped segment.
+  /// @throws None.
+  /// @version 2026-10-19/GGB - Function created.
+
+  STimeSeriesRecord const *CTimeSeriesStore::SSegment::records() const
+  {
+    return reinterpret_cast<STimeSeriesRecord const *>(static_cast<char const *>(region->get_address()) + sizeof(SSegmentHeader));
+  }
+
+  /// @brief      Updates the key statistics of the segment for a record.
+  /// @param[in]  record: The record being added to the segment.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  void CTimeSeriesStore::SSegment::append(STimeSeriesRecord const &record)
+  {
+    if (recordCount != 0 && record.key <= maxKey)
+    {
+      sorted = false;
+    };
+    if (recordCount % STRIDE == 0)
+    {
+      sparseIndex.push_back(record.key);
+    };
+
+    minKey = std::min(minKey, record.key);
+    maxKey = std::max(maxKey, record.key);
+    recordCount++;
+  }
+
+  /// @brief      Determines if a key is in the segment.
+  /// @param[in]  key: The key to search for.
+  /// @returns    true if the key is present.
+  /// @details    For sorted segments the sparse index bounds the scan to STRIDE records.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  bool CTimeSeriesStore::SSegment::find(std::uint32_t key) const
+  {
+    std::size_t first = 0, last = recordCount;
+    STimeSeriesRecord const *data = records();
+
+    if (key < minKey || key > maxKey)
+    {
+      return false;
+    };
+
+    if (sorted)
+    {
+      first = (std::upper_bound(sparseIndex.begin(), sparseIndex.end(), key) - sparseIndex.begin() - 1) * STRIDE;
+      last = std::min(first + STRIDE, recordCount);
+    };
+
+    for (std::size_t index = first; index < last; index++)
+    {
+      if (data[index].key == key)
+      {
+        return true;
+      };
+    };
+
+    return false;
+  }
+
+  /// @brief      Copies the records within the key range to the output vector.
+  /// @param[in]  from: The first key in the range.
+  /// @param[in]  to: The last key in the range.
+  /// @param[out] out: The vector to append the records to.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  void CTimeSeriesStore::SSegment::range(std::uint32_t from, std::uint32_t to, std::vector<STimeSeriesRecord> &out) const
+  {
+    std::size_t index = 0;
+    STimeSeriesRecord const *data = records();
+
+    if (to < minKey || from > maxKey)
+    {
+      return;
+    };
+
+    if (sorted)
+    {
+      std::size_t block = std::lower_bound(sparseIndex.begin(), sparseIndex.end(), from) - sparseIndex.begin();
+
+      index = (block == 0) ? 0 : (block - 1) * STRIDE;
+      for (; (index < recordCount) && (data[index].key <= to); index++)
+      {
+        if (data[index].key >= from)
+        {
+          out.push_back(data[index]);
+        };
+      };
+    }
+    else
+    {
+      for (; index < recordCount; index++)
+      {
+        if (data[index].key >= from && data[index].key <= to)
+        {
+          out.push_back(data[index]);
+        };
+      };
+    };
+  }
+
+  //********************************************************************************************************************************
+  //
+  // CTimeSeriesStore
+  //
+  //********************************************************************************************************************************
+
+  /// @brief      Class constructor.
+  /// @param[in]  rootDirectory: The directory to store the series in. Created if it does not exist.
+  /// @param[in]  maxSegmentRecords: The number of records in a segment before it is sealed.
+  /// @param[in]  compactionInterval: The interval between compaction passes.
+  /// @throws     0x0001 - APPLICATION: Unable to open data file.
+  /// @version    2026-10-19/GGB - Function created.
+
+  CTimeSeriesStore::CTimeSeriesStore(boost::filesystem::path const &rootDirectory, std::size_t maxSegmentRecords,
+                                     std::chrono::seconds compactionInterval)
+    : rootDirectory_(rootDirectory), maxSegmentRecords_(std::max(maxSegmentRecords, STRIDE)), stopCompaction_(false),
+      compactionInterval_(compactionInterval)
+  {
+    boost::system::error_code ec;
+
+    boost::filesystem::create_directories(rootDirectory_, ec);
+    if (ec)
+    {
+      WCL_ERROR(0x0001);
+    };
+
+    compactionThread_ = std::thread(&CTimeSeriesStore::compactionLoop, this);
+  }
+
+  /// @brief Class destructor. Stops the compaction thread and closes all the active segments.
+  /// @throws None.
+  /// @version 2026-10-19/GGB - Function created.
+
+  CTimeSeriesStore::~CTimeSeriesStore()
+  {
+    {
+      std::lock_guard<std::mutex> lock(compactionMutex_);
+      stopCompaction_ = true;
+    }
+    compactionCondition_.notify_all();
+    compactionThread_.join();
+
+    flush();
+  }
+
+  /// @brief      Validates and appends a record to the series if it does not already exist.
+  /// @param[in]  siteID: The site ID.
+  /// @param[in]  instrumentID: The instrument ID.
+  /// @param[in]  newRecord: The record to append.
+  /// @returns    true if the record was appended. false if it already existed.
+  /// @throws     0x0001 - APPLICATION: Unable to open data file.
+  /// @version    2026-10-19/GGB - Function created.
+
+  bool CTimeSeriesStore::append(unsigned long siteID, unsigned long instrumentID, STimeSeriesRecord const &newRecord)
+  {
+    WCL_TRACE_SPAN("store", "CTimeSeriesStore::append");
+
+    SSeries &s = series(siteID, instrumentID);
+    std::lock_guard<std::mutex> lock(s.seriesMutex);
+    STimeSeriesRecord record = newRecord;
+
+    if (existsLocked(s, record.key))
+    {
+      return false;
+    };
+
+    s.validator.validate(record);
+
+    if (!s.activeFile.is_open())
+    {
+      openActive(s);
+    };
+
+    s.activeFile.write(reinterpret_cast<char const *>(&record), sizeof(STimeSeriesRecord));
+    s.activeRecords.push_back(record);
+    s.activeKeys.insert(std::upper_bound(s.activeKeys.begin(), s.activeKeys.end(), record.key), record.key);
+
+    if (!s.hasLast || record.key > s.lastKey)
+    {
+      s.lastKey = record.key;
+      s.hasLast = true;
+    };
+
+    if (s.activeRecords.size() >= maxSegmentRecords_)
+    {
+      sealActive(s);
+    };
+
+    return true;
+  }
+
+  /// @brief    Requests an immediate compaction pass.
+  /// @throws   None.
+  /// @version  2026-10-19/GGB - Function created.
+
+  void CTimeSeriesStore::compact()
+  {
+    {
+      std::lock_guard<std::mutex> lock(compactionMutex_);
+      compactionRequested_ = true;
+    }
+    compactionCondition_.notify_all();
+  }
+
+  /// @brief    Background loop that compacts the series at the compaction interval.
+  /// @throws   None.
+  /// @version  2026-10-19/GGB - Function created.
+
+  void CTimeSeriesStore::compactionLoop()
+  {
+    WCL_TRACE_THREAD("compaction");
+
+    std::unique_lock<std::mutex> lock(compactionMutex_);
+
+    while (!stopCompaction_)
+    {
+      compactionCondition_.wait_for(lock, compactionInterval_, [this] () { return stopCompaction_ || compactionRequested_; });
+      compactionRequested_ = false;
+
+      if (!stopCompaction_)
+      {
+        std::vector<SSeries *> work;
+
+        lock.unlock();
+        {
+          std::lock_guard<std::mutex> storeLock(storeMutex_);
+          for (auto &s : series_)
+          {
+            work.push_back(s.second.get());
+          };
+        }
+
+        for (SSeries *s : work)
+        {
+          try
+          {
+            compactSeries(*s);
+          }
+          catch(...)
+          {
+            ERRORMESSAGE("Time series compaction failed for " + s->directory.string());
+          };
+        };
+        lock.lock();
+      };
+    };
+  }
+
+  /// @brief      Merges the sealed segments that are small or unsorted into a single sorted segment.
+  /// @param[in]  s: The series to compact.
+  /// @details    The series lock is only held while selecting the segments and when swapping in the new segment. Sealed segments
+  ///             are never modified, so they can be read without the lock. Where a key appears more than once the first written
+  ///             record is kept. If the merged segment cannot be written the segments are left unchanged.
+  /// @throws     0x0001 - APPLICATION: Unable to open data file.
+  /// @throws     std::bad_alloc
+  /// @version    2026-10-19/GGB - Function created.
+
+  void CTimeSeriesStore::compactSeries(SSeries &s)
+  {
+    WCL_TRACE_SPAN("store", "CTimeSeriesStore::compactSeries");
+
+    std::vector<segmentPtr_t> candidates;
+    std::vector<STimeSeriesRecord> records;
+    std::size_t totalRecords = 0;
+    bool unsorted = false;
+
+    {
+      std::lock_guard<std::mutex> lock(s.seriesMutex);
+
+      for (auto const &segment : s.sealed)
+      {
+        if ( (!segment->sorted || segment->recordCount < maxSegmentRecords_) &&
+             (totalRecords + segment->recordCount <= 4 * maxSegmentRecords_) )
+        {
+          candidates.push_back(segment);
+          totalRecords += segment->recordCount;
+          unsorted = unsorted || !segment->sorted;
+        };
+      };
+
+      if ( s.compacting || candidates.empty() || (candidates.size() == 1 && !unsorted) )
+      {
+        return;
+      };
+      s.compacting = true;
+    }
+
+    segmentPtr_t merged;
+
+    try
+    {
+      records.reserve(totalRecords);
+      for (auto const &segment : candidates)
+      {
+        records.insert(records.end(), segment->records(), segment->records() + segment->recordCount);
+      };
+
+      std::stable_sort(records.begin(), records.end(),
+                       [] (STimeSeriesRecord const &lhs, STimeSeriesRecord const &rhs) { return lhs.key < rhs.key; });
+      records.erase(std::unique(records.begin(), records.end(),
+                                [] (STimeSeriesRecord const &lhs, STimeSeriesRecord const &rhs) { return lhs.key == rhs.key; }),
+                    records.end());
+
+      merged = writeSegment(s, records);
+    }
+    catch(...)
+    {
+        // The candidates are left in sealed, so a later compaction can try again.
+
+      std::lock_guard<std::mutex> lock(s.seriesMutex);
+
+      s.compacting = false;
+      throw;
+    };
+
+    {
+      std::lock_guard<std::mutex> lock(s.seriesMutex);
+
+      for (auto const &segment : candidates)
+      {
+        segment->obsolete = true;
+        s.sealed.erase(std::find(s.sealed.begin(), s.sealed.end(), segment));
+      };
+      s.sealed.push_back(merged);
+      s.compacting = false;
+    }
+  }
+
+  /// @brief      Converts an archive record downloaded from the console to a time series record in SI units.
+  /// @param[in]  record: The record to convert.
+  /// @param[out] tsr: The converted record.
+  /// @returns    false if the record time is not valid.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  bool CTimeSeriesStore::convert(SArchiveRecord const &record, STimeSeriesRecord &tsr)
+  {
+    if (record.time >= 2500)
+    {
+      return false;
+    }
+    else
+    {
+      std::uint8_t const *bytes = reinterpret_cast<std::uint8_t const *>(&record);
+      int year, month, day;
+
+      wireDate(wireValue<SArchiveRecord, ARF_DATE>(bytes), year, month, day);
+
+      TTimestamp timestamp(year, month, day);
+
+      std::memset(&tsr, 0, sizeof(tsr));
+      tsr.key = STimeSeriesRecord::makeKey(static_cast<std::uint32_t>(timestamp.MJD()), record.time);
+      decodeObservation<SArchiveRecord>(bytes, tsr);
+      tsr.rain = static_cast<double>(record.rainfall) * 0.2;
+      tsr.hiRainRate = static_cast<double>(record.rainRateHigh) * 0.2;
+
+      return true;
+    };
+  }
+
+  /// @brief      Converts an archive record read from a .wlk file to a time series record in SI units.
+  /// @param[in]  record: The record to convert.
+  /// @param[in]  MJD: The date of the record.
+  /// @param[out] tsr: The converted record.
+  /// @throws     CODE_ERROR - Unknown rain collector type.
+  /// @version    2026-10-19/GGB - Function created.
+
+  void CTimeSeriesStore::convert(SWeatherDataRecord const &record, std::uint32_t MJD, STimeSeriesRecord &tsr)
+  {
+    std::uint8_t const *bytes = reinterpret_cast<std::uint8_t const *>(&record);
+    double dRain;
+
+    switch(record.rain & 0xF000)
+    {
+      case 0x0000:
+        dRain = 2.54;
+        break;
+      case 0x1000:
+        dRain = 0.254;
+        break;
+      case 0x2000:
+        dRain = 0.2;
+        break;
+      case 0x3000:
+        dRain = 1.0;
+        break;
+      case 0x6000:
+        dRain = 0.1;
+        break;
+      default:
+        CODE_ERROR;
+        break;
+    };
+
+    std::memset(&tsr, 0, sizeof(tsr));
+    tsr.key = STimeSeriesRecord::makeKey(MJD, TTimestamp::packedTimeToHHMM(record.packedTime));
+    decodeObservation<SWeatherDataRecord>(bytes, tsr);
+    tsr.rain = dRain * (record.rain & 0xFFF);
+    tsr.hiRainRate = dRain * record.hiRainRate;
+  }
+
+  /// @brief      Determines if a key exists in the series. The series lock must be held.
+  /// @param[in]  s: The series.
+  /// @param[in]  key: The key to search for.
+  /// @returns    true if the key exists.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  bool CTimeSeriesStore::existsLocked(SSeries &s, std::uint32_t key) const
+  {
+    if (!s.hasLast || key > s.lastKey)
+    {
+      return false;     // The normal case of appending new data.
+    }
+    else if (std::binary_search(s.activeKeys.begin(), s.activeKeys.end(), key))
+    {
+      return true;
+    }
+    else
+    {
+      return std::any_of(s.sealed.begin(), s.sealed.end(), [key] (segmentPtr_t const &segment) { return segment->find(key); });
+    };
+  }
+
+  /// @brief    Flushes the active segment files to the operating system.
+  /// @throws   None.
+  /// @version  2026-10-19/GGB - Function created.
+
+  void CTimeSeriesStore::flush()
+  {
+    std::lock_guard<std::mutex> storeLock(storeMutex_);
+
+    for (auto &s : series_)
+    {
+      std::lock_guard<std::mutex> lock(s.second->seriesMutex);
+      s.second->activeFile.flush();
+    };
+  }
+
+  /// @brief      Inserts an archive record downloaded from the console.
+  /// @param[in]  siteID: The site ID.
+  /// @param[in]  instrumentID: The instrument ID.
+  /// @param[in]  record: The record to insert.
+  /// @returns    true if the record was inserted.
+  /// @throws     0x0001 - APPLICATION: Unable to open data file.
+  /// @version    2026-10-19/GGB - Function created.
+
+  bool CTimeSeriesStore::insertRecord(unsigned long siteID, unsigned long instrumentID, SArchiveRecord &record)
+  {
+    STimeSeriesRecord tsr;
+
+    return convert(record, tsr) && append(siteID, instrumentID, tsr);
+  }
+
+  /// @brief      Inserts an archive record read from a .wlk file.
+  /// @param[in]  siteID: The site ID.
+  /// @param[in]  instrumentID: The instrument ID.
+  /// @param[in]  record: The record to insert.
+  /// @param[in]  JD: The date of the record.
+  /// @returns    true if the record was inserted.
+  /// @throws     0x0001 - APPLICATION: Unable to open data file.
+  /// @throws     CODE_ERROR - Unknown rain collector type.
+  /// @version    2026-10-19/GGB - Function created.
+
+  bool CTimeSeriesStore::insertRecord(unsigned long siteID, unsigned long instrumentID, SWeatherDataRecord const &record,
+                                      ACL::TJD const &JD)
+  {
+    STimeSeriesRecord tsr;
+
+    convert(record, static_cast<std::uint32_t>(std::llround(JD.MJD())), tsr);
+
+    return append(siteID, instrumentID, tsr);
+  }
+
+  /// @brief      Inserts a record that has already been converted.
+  /// @param[in]  siteID: The site ID.
+  /// @param[in]  instrumentID: The instrument ID.
+  /// @param[in]  record: The record to insert.
+  /// @returns    true if the record was inserted.
+  /// @throws     0x0001 - APPLICATION: Unable to open data file.
+  /// @version    2026-10-19/GGB - Function created.
+
+  bool CTimeSeriesStore::insertRecord(unsigned long siteID, unsigned long instrumentID, STimeSeriesRecord const &record)
+  {
+    return append(siteID, instrumentID, record);
+  }
+
+  /// @brief      Gets the time of the last weather record.
+  /// @param[in]  siteID: The site ID.
+  /// @param[in]  instrumentID: The instrument ID.
+  /// @param[out] MJD: The MJD of the last record.
+  /// @param[out] time: The time of the last record.
+  /// @returns    true if the series has any records.
+  /// @throws     0x0001 - APPLICATION: Unable to open data file.
+  /// @version    2026-10-19/GGB - Function created.
+
+  bool CTimeSeriesStore::lastWeatherRecord(unsigned long siteID, unsigned long instrumentID, std::uint16_t &MJD, std::uint16_t &time)
+  {
+    SSeries &s = series(siteID, instrumentID);
+    std::lock_guard<std::mutex> lock(s.seriesMutex);
+
+    if (s.hasLast)
+    {
+      MJD = static_cast<std::uint16_t>(s.lastKey / 10000);
+      time = static_cast<std::uint16_t>(s.lastKey % 10000);
+    };
+
+    return s.hasLast;
+  }
+
+  /// @brief      Maps a segment file and builds the segment statistics and sparse index.
+  /// @param[in]  fileName: The segment file.
+  /// @returns    The loaded segment.
+  /// @details    A partial record at the end of the file (from an interrupted write) is ignored. A file that is shorter than the
+  ///             header or does not start with the segment magic was being created when the process stopped. It holds no
+  ///             records, so it is returned as an empty, obsolete segment and the file is removed when the segment is released.
+  /// @throws     0x0001 - APPLICATION: Unable to open data file.
+  /// @version    2026-10-19/GGB - Function created.
+
+  CTimeSeriesStore::segmentPtr_t CTimeSeriesStore::loadSegment(boost::filesystem::path const &fileName)
+  {
+    segmentPtr_t segment = std::make_shared<SSegment>();
+    std::uintmax_t fileSize = boost::filesystem::file_size(fileName);
+    SSegmentHeader const *header;
+    STimeSeriesRecord const *data;
+    std::size_t recordCount;
+
+    segment->fileName = fileName;
+
+    if (fileSize < sizeof(SSegmentHeader))
+    {
+      segment->obsolete = true;
+      return segment;
+    };
+
+    segment->mapping = std::make_unique<boost::interprocess::file_mapping>(fileName.string().c_str(), boost::interprocess::read_only);
+    segment->region = std::make_unique<boost::interprocess::mapped_region>(*segment->mapping, boost::interprocess::read_only);
+
+    header = static_cast<SSegmentHeader const *>(segment->region->get_address());
+    if (std::memcmp(header->magic, segmentMagic, sizeof(segmentMagic)) != 0)
+    {
+      segment->obsolete = true;
+      return segment;
+    };
+
+    if (header->recordSize != sizeof(STimeSeriesRecord))
+    {
+      WCL_ERROR(0x0001);
+    };
+
+    recordCount = (fileSize - sizeof(SSegmentHeader)) / sizeof(STimeSeriesRecord);
+    data = segment->records();
+    for (std::size_t index = 0; index < recordCount; index++)
+    {
+      segment->append(data[index]);
+    };
+
+    if (!segment->sorted)
+    {
+      segment->sparseIndex.clear();
+    };
+
+    return segment;
+  }
+
+  /// @brief      Loads the existing segments for a series.
+  /// @param[in]  s: The series to load.
+  /// @details    Any segment that was being written when the store was last closed is loaded as a sealed segment and will be
+  ///             merged by the compaction thread.
+  /// @throws     0x0001 - APPLICATION: Unable to open data file.
+  /// @version    2026-10-19/GGB - Function created.
+
+  void CTimeSeriesStore::loadSeries(SSeries &s)
+  {
+    std::vector<boost::filesystem::path> files;
+    boost::system::error_code ec;
+
+    boost::filesystem::create_directories(s.directory, ec);
+    if (ec)
+    {
+      WCL_ERROR(0x0001);
+    };
+
+    for (auto const &entry : boost::filesystem::directory_iterator(s.directory))
+    {
+      std::string name = entry.path().filename().string();
+      unsigned int number;
+
+      if (std::sscanf(name.c_str(), "segment-%8u.dat", &number) == 1 && entry.path().extension() == ".dat")
+      {
+        files.push_back(entry.path());
+        s.nextNumber = std::max<std::uint32_t>(s.nextNumber, number + 1);
+      }
+      else if (entry.path().extension() == ".tmp")
+      {
+        boost::filesystem::remove(entry.path(), ec);      // Incomplete compaction output.
+      };
+    };
+
+    std::sort(files.begin(), files.end());
+
+    for (auto const &file : files)
+    {
+      segmentPtr_t segment = loadSegment(file);
+
+      if (segment->recordCount != 0)
+      {
+        if (!s.hasLast || segment->maxKey > s.lastKey)
+        {
+          s.lastKey = segment->maxKey;
+          s.hasLast = true;
+        };
+        s.sealed.push_back(segment);
+      }
+      else
+      {
+        segment->obsolete = true;
+      };
+    };
+  }
+
+  /// @brief      Creates a new active segment file.
+  /// @param[in]  s: The series. The series lock must be held.
+  /// @throws     0x0001 - APPLICATION: Unable to open data file.
+  /// @version    2026-10-19/GGB - Function created.
+
+  void CTimeSeriesStore::openActive(SSeries &s)
+  {
+    SSegmentHeader header;
+
+    s.activeNumber = s.nextNumber++;
+    s.activeFile.open(segmentName(s.directory, s.activeNumber, "dat").string(),
+                      std::ofstream::out | std::ofstream::binary | std::ofstream::trunc);
+    if (!s.activeFile)
+    {
+      WCL_ERROR(0x0001);
+    };
+
+    std::memcpy(header.magic, segmentMagic, sizeof(segmentMagic));
+    header.recordSize = sizeof(STimeSeriesRecord);
+    header.flags = 0;
+    s.activeFile.write(reinterpret_cast<char const *>(&header), sizeof(header));
+    s.activeFile.flush();       // A crash before the first records are flushed leaves a valid, empty segment.
+    if (!s.activeFile)
+    {
+      WCL_ERROR(0x0001);
+    };
+  }
+
+  /// @brief      Reads the records in a range of keys.
+  /// @param[in]  siteID: The site ID.
+  /// @param[in]  instrumentID: The instrument ID.
+  /// @param[in]  from: The first key. (MJD * 10000 + HHMM)
+  /// @param[in]  to: The last key. (MJD * 10000 + HHMM)
+  /// @param[out] out: The vector to append the records to. The appended records are in key order.
+  /// @returns    The number of records appended.
+  /// @throws     0x0001 - APPLICATION: Unable to open data file.
+  /// @version    2026-10-19/GGB - Function created.
+
+  std::size_t CTimeSeriesStore::readRange(unsigned long siteID, unsigned long instrumentID, std::uint32_t from, std::uint32_t to,
+                                          std::vector<STimeSeriesRecord> &out)
+  {
+    WCL_TRACE_SPAN("store", "CTimeSeriesStore::readRange");
+
+    SSeries &s = series(siteID, instrumentID);
+    std::lock_guard<std::mutex> lock(s.seriesMutex);
+    std::size_t start = out.size();
+    auto compare = [] (STimeSeriesRecord const &lhs, STimeSeriesRecord const &rhs) { return lhs.key < rhs.key; };
+
+    for (auto const &segment : s.sealed)
+    {
+      segment->range(from, to, out);
+    };
+
+    for (auto const &record : s.activeRecords)
+    {
+      if (record.key >= from && record.key <= to)
+      {
+        out.push_back(record);
+      };
+    };
+
+    std::stable_sort(out.begin() + start, out.end(), compare);
+    out.erase(std::unique(out.begin() + start, out.end(),
+                          [] (STimeSeriesRecord const &lhs, STimeSeriesRecord const &rhs) { return lhs.key == rhs.key; }),
+              out.end());
+
+    return out.size() - start;
+  }
+
+  /// @brief      Checks if a record exists.
+  /// @param[in]  siteID: The site ID.
+  /// @param[in]  instrumentID: The instrument ID.
+  /// @param[in]  JD: The date of the record.
+  /// @param[in]  time: The time of the record (HHMM).
+  /// @returns    true if the record exists.
+  /// @throws     0x0001 - APPLICATION: Unable to open data file.
+  /// @version    2026-10-19/GGB - Function created.
+
+  bool CTimeSeriesStore::recordExists(unsigned long siteID, unsigned long instrumentID, ACL::TJD JD, std::uint16_t time)
+  {
+    SSeries &s = series(siteID, instrumentID);
+    std::lock_guard<std::mutex> lock(s.seriesMutex);
+
+    return existsLocked(s, STimeSeriesRecord::makeKey(static_cast<std::uint32_t>(std::llround(JD.MJD())), time));
+  }
+
+  /// @brief      Closes the active segment and adds it to the sealed segments.
+  /// @param[in]  s: The series. The series lock must be held.
+  /// @throws     0x0001 - APPLICATION: Unable to open data file.
+  /// @version    2026-10-19/GGB - Function created.
+
+  void CTimeSeriesStore::sealActive(SSeries &s)
+  {
+    s.activeFile.close();
+    s.sealed.push_back(loadSegment(segmentName(s.directory, s.activeNumber, "dat")));
+    s.activeRecords.clear();
+    s.activeKeys.clear();
+
+    compact();
+  }
+
+  /// @brief      Returns the series for the site and instrument. The series is loaded from disk on first use.
+  /// @param[in]  siteID: The site ID.
+  /// @param[in]  instrumentID: The instrument ID.
+  /// @returns    Reference to the series.
+  /// @throws     0x0001 - APPLICATION: Unable to open data file.
+  /// @version    2026-10-19/GGB - Function created.
+
+  CTimeSeriesStore::SSeries &CTimeSeriesStore::series(unsigned long siteID, unsigned long instrumentID)
+  {
+    std::lock_guard<std::mutex> lock(storeMutex_);
+    std::unique_ptr<SSeries> &s = series_[seriesKey_t(siteID, instrumentID)];
+
+    if (!s)
+    {
+      std::unique_ptr<SSeries> newSeries = std::make_unique<SSeries>();
+
+      newSeries->directory = rootDirectory_ / (std::to_string(siteID) + "-" + std::to_string(instrumentID));
+      loadSeries(*newSeries);
+      s = std::move(newSeries);
+    };
+
+    return *s;
+  }
+
+  /// @brief      Writes a sorted set of records to a new segment file.
+  /// @param[in]  s: The series.
+  /// @param[in]  records: The records to write.
+  /// @returns    The new segment.
+  /// @details    The file is written under a temporary name and renamed when complete, so a partial segment is never loaded.
+  /// @throws     0x0001 - APPLICATION: Unable to open data file.
+  /// @version    2026-10-19/GGB - Function created.
+
+  CTimeSeriesStore::segmentPtr_t CTimeSeriesStore::writeSegment(SSeries &s, std::vector<STimeSeriesRecord> const &records)
+  {
+    WCL_TRACE_SPAN("store", "CTimeSeriesStore::writeSegment");
+
+    std::uint32_t number;
+    SSegmentHeader header;
+
+    {
+      std::lock_guard<std::mutex> lock(s.seriesMutex);
+      number = s.nextNumber++;
+    }
+
+    boost::filesystem::path tempName = segmentName(s.directory, number, "tmp");
+    boost::filesystem::path fileName = segmentName(s.directory, number, "dat");
+
+    {
+      std::ofstream file(tempName.string(), std::ofstream::out | std::ofstream::binary | std::ofstream::trunc);
+
+      std::memcpy(header.magic, segmentMagic, sizeof(segmentMagic));
+      header.recordSize = sizeof(STimeSeriesRecord);
+      header.flags = 0;
+      file.write(reinterpret_cast<char const *>(&header), sizeof(header));
+      file.write(reinterpret_cast<char const *>(records.data()), records.size() * sizeof(STimeSeriesRecord));
+
+      if (!file)
+      {
+        WCL_ERROR(0x0001);
+      };
+    }
+
+    boost::filesystem::rename(tempName, fileName);
+
+    return loadSegment(fileName);
+  }
+
+} // namespace WCL
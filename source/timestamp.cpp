@@ -0,0 +1,174 @@
+﻿//*********************************************************************************************************************************
+//
+// PROJECT:							Weather Class Library (WCL)
+// FILE:								timestamp
+// SUBSYSTEM:						Integer timestamps
+// LANGUAGE:						C++
+// TARGET OS:						WINDOWS/UNIX/LINUX/MAC
+// LIBRARY DEPENDANCE:	None.
+// NAMESPACE:						WCL
+// AUTHOR:							Gavin Blakeman.
+// LICENSE:             GPLv2
+//
+//                      Copyright 2026 Gavin Blakeman.
+//                      This file is part of the Weather Class Library (WCL).
+//
+//                      WCL is free software: you can redistribute it and/or modify it under the terms of the GNU General
+//                      Public License as published by the Free Software Foundation, either version 2 of the License, or (at your
+//                      option) any later version.
+//
+//                      WCL is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the
+//                      implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//                      for more details.
+//
+//                      You should have received a copy of the GNU General Public License along with WCL.  If not, see
+//                      <http://www.gnu.org/licenses/>.
+//
+// OVERVIEW:						Implements the batch timestamp decoders.
+//
+// CLASSES INCLUDED:    TTimestamp
+//
+// CLASS HIERARCHY:     TTimestamp
+//
+// HISTORY:             2026-10-19 GGB - File Created
+//
+//*********************************************************************************************************************************
+
+#include "include/timestamp.h"
+
+  // WCL header files
+
+#include "include/wireFormat.h"
+
+namespace WCL
+{
+  /// @brief      Returns the raw 16 bit value of a packed date.
+  /// @param[in]  date: The date.
+  /// @returns    The raw value.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+  /// @version    2026-10-19/GGB - Decoded from the bytes so that the host byte order does not matter.
+
+  static inline std::uint16_t rawDate(SDate const &date)
+  {
+    return wireValue<SDate, 0>(reinterpret_cast<std::uint8_t const *>(&date));
+  }
+
+  /// @brief      Checks if a console archive record has a valid date.
+  /// @param[in]  record: The record.
+  /// @returns    false if the record is unused (0xFFFF) or the date is out of range.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  static inline bool validDate(SArchiveRecord const &record)
+  {
+    std::uint16_t date = rawDate(record.date);
+    unsigned int month = wireBits<SDate, DB_MONTH>(date);
+
+    return (date != 0xFFFF) && (month >= 1) && (month <= 12) && (wireBits<SDate, DB_DAY>(date) >= 1);
+  }
+
+  /// @brief      Checks if a console archive record has a valid time.
+  /// @param[in]  record: The record.
+  /// @returns    false if the time is unused (0xFFFF) or out of range.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  static inline bool validTime(SArchiveRecord const &record)
+  {
+    return (record.time < 2400) && (record.time % 100 < 60);
+  }
+
+  /// @brief      Decodes the timestamp of a console archive record.
+  /// @param[in]  record: The record.
+  /// @returns    The timestamp. Invalid if the record is unused (0xFFFF) or the date or time is out of range.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  TTimestamp TTimestamp::decode(SArchiveRecord const &record)
+  {
+    if (!validDate(record) || !validTime(record))
+    {
+      return TTimestamp();
+    }
+    else
+    {
+      int year, month, day;
+
+      wireDate(rawDate(record.date), year, month, day);
+
+      return TTimestamp(year, month, day) + HHMMToMinutes(record.time);
+    };
+  }
+
+  /// @brief      Decodes the timestamps of a block of console archive records.
+  /// @param[in]  records: The records.
+  /// @param[in]  count: The number of records.
+  /// @param[out] timestamps: The timestamps. Invalid records give an invalid timestamp.
+  /// @returns    The number of valid timestamps.
+  /// @details    Consecutive records are usually on the same date, so the calendar conversion is only done when the date changes.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  std::size_t TTimestamp::decode(SArchiveRecord const *records, std::size_t count, TTimestamp *timestamps)
+  {
+    std::size_t returnValue = 0;
+    std::uint16_t lastDate = 0xFFFF;
+    value_type dayMinutes = INVALID;
+
+    for (std::size_t index = 0; index < count; index++)
+    {
+      SArchiveRecord const &record = records[index];
+      std::uint16_t date = rawDate(record.date);
+
+      if (date != lastDate)
+      {
+        lastDate = date;
+        if (validDate(record))
+        {
+          int year, month, day;
+
+          wireDate(date, year, month, day);
+          dayMinutes = daysFromCivil(year, month, day) * MINUTES_PER_DAY;
+        }
+        else
+        {
+          dayMinutes = INVALID;
+        };
+      };
+
+      if ( (dayMinutes == INVALID) || !validTime(record) )
+      {
+        timestamps[index] = TTimestamp();
+      }
+      else
+      {
+        timestamps[index] = TTimestamp(dayMinutes + HHMMToMinutes(record.time));
+        returnValue++;
+      };
+    };
+
+    return returnValue;
+  }
+
+  /// @brief      Decodes the timestamps of the archive records of a day of a .wlk file.
+  /// @param[in]  year: The year of the file.
+  /// @param[in]  month: The month of the file.
+  /// @param[in]  day: The day index of the records.
+  /// @param[in]  records: The records.
+  /// @param[in]  count: The number of records.
+  /// @param[out] timestamps: The timestamps.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  void TTimestamp::decode(int year, int month, int day, SWeatherDataRecord const *records, std::size_t count, TTimestamp *timestamps)
+  {
+    value_type dayMinutes = daysFromCivil(year, month, day) * MINUTES_PER_DAY;
+
+    for (std::size_t index = 0; index < count; index++)
+    {
+      timestamps[index] = TTimestamp(dayMinutes + records[index].packedTime);
+    };
+  }
+
+} // namespace WCL
@@ -0,0 +1,375 @@
+﻿//*********************************************************************************************************************************
+//
+// PROJECT:							Weather Class Library (WCL)
+// FILE:								trace
+// SUBSYSTEM:						Span tracing in Chrome trace format
+// LANGUAGE:						C++
+// TARGET OS:						WINDOWS/UNIX/LINUX/MAC
+// LIBRARY DEPENDANCE:	None.
+// NAMESPACE:						WCL
+// AUTHOR:							Gavin Blakeman.
+// LICENSE:             GPLv2
+//
+//                      Copyright 2026 Gavin Blakeman.
+//                      This file is part of the Weather Class Library (WCL).
+//
+//                      WCL is free software: you can redistribute it and/or modify it under the terms of the GNU General
+//                      Public License as published by the Free Software Foundation, either version 2 of the License, or (at your
+//                      option) any later version.
+//
+//                      WCL is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the
+//                      implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//                      for more details.
+//
+//                      You should have received a copy of the GNU General Public License along with WCL.  If not, see
+//                      <http://www.gnu.org/licenses/>.
+//
+// OVERVIEW:						Records timed spans (start and end time of a scope) so that the overlap of downloading, decoding, converting
+//                      and inserting can be seen on a timeline. The spans are written with the WCL_TRACE_SPAN() macro, which
+//                      creates a CTraceSpan that records the span when the scope exits.
+//                      Each thread records into its own ring buffer, so recording takes no lock. When a buffer is full the oldest
+//                      spans are overwritten. dump() writes the spans of all the threads as Chrome trace JSON, which can be loaded
+//                      into chrome://tracing or Perfetto. dump() may be called while the threads are still recording.
+//                      The buffer of a thread that has exited is released once its spans have been dumped or cleared.
+//                      Tracing is compiled in when WCL_TRACING is defined (qmake CONFIG+=wcl_tracing). Otherwise the macros
+//                      expand to nothing and cost nothing.
+//
+// CLASSES INCLUDED:    CTrace
+//                      CTraceSpan
+//
+// CLASS HIERARCHY:     CTrace
+//                      CTraceSpan
+//
+// HISTORY:             2026-10-19 GGB - File Created
+//
+//*********************************************************************************************************************************
+
+#include "include/trace.h"
+
+  // Standard C++ library header files.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+  // Miscellaneous library header files.
+
+#include <GCL>
+
+  // WCL header files
+
+#include "include/error.h"
+
+namespace WCL
+{
+  static_assert((CTrace::EVENTS_PER_THREAD & (CTrace::EVENTS_PER_THREAD - 1)) == 0, "EVENTS_PER_THREAD must be a power of 2.");
+
+  /// The fields are atomic as dump() can read a slot while the owning thread overwrites it. All the accesses are relaxed.
+
+  struct STraceEvent
+  {
+    std::atomic<char const *> category;
+    std::atomic<char const *> name;
+    std::atomic<std::int64_t> start;
+    std::atomic<std::int64_t> end;
+  };
+
+  struct STraceBuffer
+  {
+    std::unique_ptr<STraceEvent[]> events;
+    std::atomic<std::uint64_t> head;        ///< Number of spans recorded. Only written by the owning thread.
+    std::uint64_t cleared = 0;              ///< Value of head when clear() was called. Protected by the registry mutex.
+    std::size_t threadID;
+    std::string threadName;                 ///< Protected by the registry mutex.
+    bool exited = false;                    ///< The owning thread has exited. Protected by the registry mutex.
+  };
+
+  /// Holds the buffer of a thread and marks it when the thread exits, so that the registry can release it.
+
+  struct SThreadBuffer
+  {
+    std::shared_ptr<STraceBuffer> buffer;
+
+    ~SThreadBuffer();
+  };
+
+  static std::chrono::steady_clock::time_point const traceEpoch = std::chrono::steady_clock::now();
+  static std::mutex registryMutex;
+  static std::vector<std::shared_ptr<STraceBuffer>> registry;
+  static std::size_t nextThreadID = 1;
+
+  /// @brief      Called when a thread exits. A buffer without spans left to dump is released at once. Otherwise it is released
+  ///             by the next dump() or clear().
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  SThreadBuffer::~SThreadBuffer()
+  {
+    if (buffer)
+    {
+      std::lock_guard<std::mutex> lock(registryMutex);
+
+      buffer->exited = true;
+      if (buffer->head.load(std::memory_order_relaxed) == buffer->cleared)
+      {
+        registry.erase(std::remove(registry.begin(), registry.end(), buffer), registry.end());
+      };
+    };
+  }
+
+  /// @brief      Releases the buffers of the threads that have exited. The registry mutex must be held.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  static void releaseExited()
+  {
+    registry.erase(std::remove_if(registry.begin(), registry.end(),
+                                  [](std::shared_ptr<STraceBuffer> const &buffer) { return buffer->exited; }),
+                   registry.end());
+  }
+
+  /// @brief      Returns the ring buffer of the calling thread, creating and registering it on the first call.
+  /// @returns    The buffer.
+  /// @throws     std::bad_alloc
+  /// @version    2026-10-19/GGB - Function created.
+
+  static STraceBuffer &threadBuffer()
+  {
+    static thread_local SThreadBuffer thread;
+
+    if (!thread.buffer)
+    {
+      std::shared_ptr<STraceBuffer> newBuffer = std::make_shared<STraceBuffer>();
+      std::lock_guard<std::mutex> lock(registryMutex);
+
+      newBuffer->events.reset(new STraceEvent[CTrace::EVENTS_PER_THREAD]);
+      newBuffer->head.store(0, std::memory_order_relaxed);
+      newBuffer->threadID = nextThreadID++;
+      registry.push_back(newBuffer);
+      thread.buffer = std::move(newBuffer);
+    };
+
+    return *thread.buffer;
+  }
+
+  /// @brief      Writes a string as a JSON string.
+  /// @param[in]  file: The file to write to.
+  /// @param[in]  string: The string.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  static void writeString(std::FILE *file, char const *string)
+  {
+    std::fputc('"', file);
+    for (; *string != 0; string++)
+    {
+      unsigned char c = static_cast<unsigned char>(*string);
+
+      if ((c == '"') || (c == '\\'))
+      {
+        std::fputc('\\', file);
+        std::fputc(c, file);
+      }
+      else if (c < 0x20)
+      {
+        std::fprintf(file, "\\u%04x", c);
+      }
+      else
+      {
+        std::fputc(c, file);
+      };
+    };
+    std::fputc('"', file);
+  }
+
+  /// @brief      Discards the spans recorded so far. The head of each buffer is only written by its thread, so the spans are
+  ///             discarded by remembering the head, and dump() skips the spans before it. The buffers of the threads that have
+  ///             exited are released.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  void CTrace::clear()
+  {
+    std::lock_guard<std::mutex> lock(registryMutex);
+
+    for (auto &buffer : registry)
+    {
+      buffer->cleared = buffer->head.load(std::memory_order_acquire);
+    };
+    releaseExited();
+  }
+
+  /// @brief      Writes the recorded spans of all the threads as a Chrome trace JSON object. The buffers of the threads that have
+  ///             exited are released once they have been written.
+  /// @param[in]  file: The file to write to.
+  /// @returns    The number of spans written.
+  /// @throws     0x000D - EXPORT: Unable to write the export file.
+  /// @throws     std::bad_alloc
+  /// @version    2026-10-19/GGB - Function created.
+
+  std::size_t CTrace::dump(std::FILE *file)
+  {
+    struct SEvent
+    {
+      char const *category;
+      char const *name;
+      std::int64_t start;
+      std::int64_t end;
+    };
+
+    std::size_t returnValue = 0;
+    std::vector<SEvent> events;
+    bool first = true;
+    std::lock_guard<std::mutex> lock(registryMutex);
+
+    std::fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", file);
+
+    for (auto &buffer : registry)
+    {
+      std::uint64_t head = buffer->head.load(std::memory_order_acquire);
+      std::uint64_t tail = std::max<std::uint64_t>((head > EVENTS_PER_THREAD) ? head - EVENTS_PER_THREAD : 0, buffer->cleared);
+
+      events.clear();
+      for (std::uint64_t index = tail; index < head; index++)
+      {
+        STraceEvent const &event = buffer->events[index & (EVENTS_PER_THREAD - 1)];
+
+        events.push_back(SEvent{ event.category.load(std::memory_order_relaxed), event.name.load(std::memory_order_relaxed),
+                                 event.start.load(std::memory_order_relaxed), event.end.load(std::memory_order_relaxed) });
+      };
+
+        // The owning thread may have overwritten the oldest slots while they were copied. The slot being written when head was
+        // read again is that of index (head - EVENTS_PER_THREAD), so everything up to and including it is dropped.
+
+      std::atomic_thread_fence(std::memory_order_acquire);
+      std::uint64_t newHead = buffer->head.load(std::memory_order_relaxed);
+      std::size_t skip = 0;
+
+      if (newHead >= tail + EVENTS_PER_THREAD)
+      {
+        skip = static_cast<std::size_t>(std::min<std::uint64_t>(newHead - EVENTS_PER_THREAD - tail + 1, events.size()));
+      };
+
+      std::fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%zu,\"args\":{\"name\":",
+                   first ? "" : ",", buffer->threadID);
+      writeString(file, buffer->threadName.empty() ? ("thread " + std::to_string(buffer->threadID)).c_str()
+                                                   : buffer->threadName.c_str());
+      std::fputs("}}", file);
+      first = false;
+
+      for (std::size_t index = skip; index < events.size(); index++)
+      {
+        SEvent const &event = events[index];
+
+        std::fputs(",{\"name\":", file);
+        writeString(file, event.name);
+        std::fputs(",\"cat\":", file);
+        writeString(file, event.category);
+        std::fprintf(file, ",\"ph\":\"X\",\"pid\":1,\"tid\":%zu,\"ts\":%.3f,\"dur\":%.3f}", buffer->threadID,
+                     static_cast<double>(event.start) / 1000.0, static_cast<double>(event.end - event.start) / 1000.0);
+        returnValue++;
+      };
+    };
+
+    std::fputs("]}\n", file);
+
+    if (std::ferror(file))
+    {
+      WCL_ERROR(0x000D);
+    };
+
+    releaseExited();
+
+    return returnValue;
+  }
+
+  /// @brief      Writes the recorded spans of all the threads to a Chrome trace JSON file.
+  /// @param[in]  fileName: The file to write.
+  /// @returns    The number of spans written.
+  /// @throws     0x0001 - APPLICATION: Unable to open data file.
+  /// @throws     0x000D - EXPORT: Unable to write the export file.
+  /// @throws     std::bad_alloc
+  /// @version    2026-10-19/GGB - Function created.
+
+  std::size_t CTrace::dump(boost::filesystem::path const &fileName)
+  {
+    std::size_t returnValue;
+    std::FILE *file = std::fopen(fileName.string().c_str(), "wb");
+
+    if (file == nullptr)
+    {
+      WCL_ERROR(0x0001);
+    };
+
+    try
+    {
+      returnValue = dump(file);
+    }
+    catch(...)
+    {
+      std::fclose(file);
+      throw;
+    };
+
+    if (std::fclose(file) != 0)
+    {
+      WCL_ERROR(0x000D);
+    };
+
+    return returnValue;
+  }
+
+  /// @brief      Returns the time since the library was loaded.
+  /// @returns    The time (ns).
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  std::int64_t CTrace::now() noexcept
+  {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - traceEpoch).count();
+  }
+
+  /// @brief      Records a span in the ring buffer of the calling thread.
+  /// @param[in]  category: The category. Must be a string literal.
+  /// @param[in]  name: The name. Must be a string literal.
+  /// @param[in]  start: The start time (ns).
+  /// @param[in]  end: The end time (ns).
+  /// @throws     None. The span is dropped if the buffer cannot be allocated.
+  /// @version    2026-10-19/GGB - Function created.
+
+  void CTrace::record(char const *category, char const *name, std::int64_t start, std::int64_t end) noexcept
+  {
+    try
+    {
+      STraceBuffer &buffer = threadBuffer();
+      std::uint64_t head = buffer.head.load(std::memory_order_relaxed);
+      STraceEvent &event = buffer.events[head & (EVENTS_PER_THREAD - 1)];
+
+      event.category.store(category, std::memory_order_relaxed);
+      event.name.store(name, std::memory_order_relaxed);
+      event.start.store(start, std::memory_order_relaxed);
+      event.end.store(end, std::memory_order_relaxed);
+      buffer.head.store(head + 1, std::memory_order_release);
+    }
+    catch(...)
+    {
+    };
+  }
+
+  /// @brief      Sets the name that the calling thread is shown with in the trace.
+  /// @param[in]  name: The name.
+  /// @throws     std::bad_alloc
+  /// @version    2026-10-19/GGB - Function created.
+
+  void CTrace::threadName(std::string const &name)
+  {
+    STraceBuffer &buffer = threadBuffer();
+    std::lock_guard<std::mutex> lock(registryMutex);
+
+    buffer.threadName = name;
+  }
+
+} // namespace WCL
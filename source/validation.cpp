@@ -0,0 +1,435 @@
+﻿//*********************************************************************************************************************************
+//
+// PROJECT:							Weather Class Library (WCL)
+// FILE:								validation
+// SUBSYSTEM:						Data quality validation of archive records
+// LANGUAGE:						C++
+// TARGET OS:						WINDOWS/UNIX/LINUX/MAC
+// LIBRARY DEPENDANCE:	None.
+// NAMESPACE:						WCL
+// AUTHOR:							Gavin Blakeman.
+// LICENSE:             GPLv2
+//
+//                      Copyright 2026 Gavin Blakeman.
+//                      This file is part of the Weather Class Library (WCL).
+//
+//                      WCL is free software: you can redistribute it and/or modify it under the terms of the GNU General
+//                      Public License as published by the Free Software Foundation, either version 2 of the License, or (at your
+//                      option) any later version.
+//
+//                      WCL is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the
+//                      implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//                      for more details.
+//
+//                      You should have received a copy of the GNU General Public License along with WCL.  If not, see
+//                      <http://www.gnu.org/licenses/>.
+//
+// OVERVIEW:						Implements the record validator.
+//
+// CLASSES INCLUDED:    SValidity
+//                      CRecordValidator
+//
+// CLASS HIERARCHY:     CRecordValidator
+//
+// HISTORY:             2026-10-19 GGB - File Created
+//
+//*********************************************************************************************************************************
+
+#include "include/validation.h"
+
+  // Standard C++ library header files.
+
+#include <algorithm>
+#include <bitset>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+  // WCL header files
+
+#include "include/observation.h"
+#include "include/timestamp.h"
+
+namespace WCL
+{
+  /// @brief      Tests a field of up to 64 records for values within [minimum, maximum]. NaN fails the test.
+  /// @param[in]  records: The records.
+  /// @param[in]  rows: The number of records (<= 64).
+  /// @param[in]  offset: The offset of the field.
+  /// @param[in]  minimum: The smallest valid value.
+  /// @param[in]  maximum: The largest valid value.
+  /// @returns    The validity bits. Bit n is set if record n is valid.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  template<typename T>
+  static inline std::uint64_t rangeWord(STimeSeriesRecord const *records, std::size_t rows, std::size_t offset, double minimum,
+                                        double maximum)
+  {
+    std::uint64_t returnValue = 0;
+
+    for (std::size_t row = 0; row < rows; row++)
+    {
+      double value = static_cast<double>(observationLoad<T>(records[row], offset));
+
+      returnValue |= static_cast<std::uint64_t>((value >= minimum) & (value <= maximum)) << row;
+    };
+
+    return returnValue;
+  }
+
+  /// @brief      Tests an integer field of up to 64 records for values that are not the missing marker.
+  /// @param[in]  records: The records.
+  /// @param[in]  rows: The number of records (<= 64).
+  /// @param[in]  offset: The offset of the field.
+  /// @param[in]  marker: The missing value marker.
+  /// @returns    The validity bits. Bit n is set if record n is valid.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  template<typename T>
+  static inline std::uint64_t markerWord(STimeSeriesRecord const *records, std::size_t rows, std::size_t offset, T marker)
+  {
+    std::uint64_t returnValue = 0;
+
+    for (std::size_t row = 0; row < rows; row++)
+    {
+      returnValue |= static_cast<std::uint64_t>(observationLoad<T>(records[row], offset) != marker) << row;
+    };
+
+    return returnValue;
+  }
+
+  /// @brief      Counts the invalid values of each field.
+  /// @param[in]  validity: The validity bitmaps.
+  /// @returns    The total number of invalid values.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  static std::size_t countNulls(SValidity &validity)
+  {
+    std::size_t returnValue = 0;
+
+    for (std::size_t field = 0; field < VF_COUNT; field++)
+    {
+      std::size_t valid = 0;
+
+      for (std::uint64_t word : validity.words[field])
+      {
+        valid += std::bitset<64>(word).count();
+      };
+      validity.nulls[field] = validity.count - valid;
+      returnValue += validity.nulls[field];
+    };
+
+    return returnValue;
+  }
+
+  //********************************************************************************************************************************
+  //
+  // SValidity
+  //
+  //********************************************************************************************************************************
+
+  /// @brief      Sizes the bitmaps for a number of records. The storage is only reallocated when it grows.
+  /// @param[in]  count: The number of records.
+  /// @throws     std::bad_alloc
+  /// @version    2026-10-19/GGB - Function created.
+
+  void SValidity::resize(std::size_t newCount)
+  {
+    count = newCount;
+    for (std::vector<std::uint64_t> &field : words)
+    {
+      field.resize((newCount + 63) / 64);
+    };
+    nulls.fill(0);
+  }
+
+  //********************************************************************************************************************************
+  //
+  // CRecordValidator
+  //
+  //********************************************************************************************************************************
+
+  /// @brief    Constructs a validator with the default limits.
+  /// @throws   None.
+  /// @version  2026-10-19/GGB - Function created.
+
+  CRecordValidator::CRecordValidator()
+  {
+    for (std::size_t field = 0; field < VF_COUNT; field++)
+    {
+      limits_[field] = observationFields[field].limits;
+    };
+    reset();
+  }
+
+  /// @brief      Writes the validation result into the records. Invalid real values are set to NaN and invalid integer values are
+  ///             set to the missing marker of the field.
+  /// @param[in]  records: The records.
+  /// @param[in]  count: The number of records.
+  /// @param[in]  validity: The validity bitmaps of the records.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  void CRecordValidator::apply(STimeSeriesRecord *records, std::size_t count, SValidity const &validity)
+  {
+    static double const NaN = std::numeric_limits<double>::quiet_NaN();
+
+    for (std::size_t field = 0; field < VF_COUNT; field++)
+    {
+      SObservationField const &descriptor = observationFields[field];
+
+      if (validity.nulls[field] != 0)
+      {
+        for (std::size_t row = 0; row < count; row++)
+        {
+          if (!validity.valid(static_cast<EValidatedField>(field), row))
+          {
+            char *value = reinterpret_cast<char *>(&records[row]) + descriptor.offset;
+
+            switch (descriptor.type)
+            {
+              case OT_DOUBLE:
+                std::memcpy(value, &NaN, sizeof(NaN));
+                break;
+              case OT_UINT16:
+                std::memcpy(value, &descriptor.marker, sizeof(std::uint16_t));
+                break;
+              case OT_UINT8:
+                *value = static_cast<char>(descriptor.marker);
+                break;
+            };
+          };
+        };
+      };
+    };
+  }
+
+  /// @brief      Sets the limits of a field.
+  /// @param[in]  field: The field.
+  /// @param[in]  limits: The new limits.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  void CRecordValidator::limits(EValidatedField field, SFieldLimits const &limits)
+  {
+    limits_[field] = limits;
+  }
+
+  /// @brief      Produces the validity bitmaps of values that are already marked as missing (NaN or the missing marker). No range or
+  ///             spike test is done. This is used by the writers to find the NULL values of validated records.
+  /// @param[in]  records: The records.
+  /// @param[in]  count: The number of records.
+  /// @param[out] validity: The validity bitmaps.
+  /// @returns    The number of missing values.
+  /// @throws     std::bad_alloc
+  /// @version    2026-10-19/GGB - Function created.
+
+  std::size_t CRecordValidator::missing(STimeSeriesRecord const *records, std::size_t count, SValidity &validity)
+  {
+    static double const infinity = std::numeric_limits<double>::infinity();
+
+    validity.resize(count);
+
+    for (std::size_t block = 0; block < count; block += 64)
+    {
+      STimeSeriesRecord const *blockRecords = records + block;
+      std::size_t rows = std::min<std::size_t>(count - block, 64);
+
+      for (std::size_t field = 0; field < VF_COUNT; field++)
+      {
+        SObservationField const &descriptor = observationFields[field];
+        std::uint64_t &word = validity.words[field][block / 64];
+
+        switch (descriptor.type)
+        {
+          case OT_DOUBLE:
+            word = rangeWord<double>(blockRecords, rows, descriptor.offset, -infinity, infinity);
+            break;
+          case OT_UINT16:
+            word = markerWord<std::uint16_t>(blockRecords, rows, descriptor.offset, descriptor.marker);
+            break;
+          case OT_UINT8:
+            word = markerWord<std::uint8_t>(blockRecords, rows, descriptor.offset, static_cast<std::uint8_t>(descriptor.marker));
+            break;
+        };
+      };
+    };
+
+    return countNulls(validity);
+  }
+
+  /// @brief      Checks if a field of a record is marked as missing.
+  /// @param[in]  record: The record.
+  /// @param[in]  field: The field.
+  /// @returns    true if the value is NaN or the missing marker.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  bool CRecordValidator::missing(STimeSeriesRecord const &record, EValidatedField field)
+  {
+    SObservationField const &descriptor = observationFields[field];
+    bool returnValue = false;
+
+    switch (descriptor.type)
+    {
+      case OT_DOUBLE:
+        returnValue = std::isnan(observationLoad<double>(record, descriptor.offset));
+        break;
+      case OT_UINT16:
+        returnValue = (observationLoad<std::uint16_t>(record, descriptor.offset) == descriptor.marker);
+        break;
+      case OT_UINT8:
+        returnValue = (observationLoad<std::uint8_t>(record, descriptor.offset) == descriptor.marker);
+        break;
+    };
+
+    return returnValue;
+  }
+
+  /// @brief    Forgets the last accepted values, so that the next record is not spike tested.
+  /// @throws   None.
+  /// @version  2026-10-19/GGB - Function created.
+
+  void CRecordValidator::reset()
+  {
+    lastValue_.fill(0);
+    for (std::int32_t &time : lastTime_)
+    {
+      time = TTimestamp::INVALID;
+    };
+  }
+
+  /// @brief      Clears the validity bits of values that change from the last accepted value by more than the step limit.
+  /// @param[in]  records: The records of the block, in time order.
+  /// @param[in]  rows: The number of records in the block (<= 64).
+  /// @param[in]  word: The index of the validity word of the block.
+  /// @param[in]  validity: The validity bitmaps from the range test.
+  /// @details    The allowed change is the step limit for each 5 minutes between the records. Records more than SPIKE_WINDOW
+  ///             minutes after the last accepted value are accepted without a test. A rejected value does not replace the last
+  ///             accepted value, so a single spike is removed and the series continues from the value before it.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  void CRecordValidator::spikeTest(STimeSeriesRecord const *records, std::size_t rows, std::size_t word, SValidity &validity)
+  {
+    std::int32_t minutes[64];
+    bool timesDecoded = false;
+
+    for (std::size_t field = 0; field < VF_COUNT; field++)
+    {
+      double step = limits_[field].step;
+
+      if ( (step > 0) && (observationFields[field].type == OT_DOUBLE) )
+      {
+        std::uint64_t &bits = validity.words[field][word];
+
+        if (!timesDecoded)
+        {
+          for (std::size_t row = 0; row < rows; row++)
+          {
+            minutes[row] = TTimestamp::fromMJD(static_cast<std::int32_t>(records[row].MJD()), records[row].time()).minutes();
+          };
+          timesDecoded = true;
+        };
+
+        for (std::size_t row = 0; row < rows; row++)
+        {
+          if ((bits >> row) & 1)
+          {
+            double value = observationLoad<double>(records[row], observationFields[field].offset);
+            std::int32_t elapsed = minutes[row] - lastTime_[field];
+
+            if ( (lastTime_[field] != TTimestamp::INVALID) && (elapsed > 0) && (elapsed <= SPIKE_WINDOW) &&
+                 (std::fabs(value - lastValue_[field]) > step * ((elapsed + 4) / 5)) )
+            {
+              bits &= ~(std::uint64_t(1) << row);
+            }
+            else
+            {
+              lastValue_[field] = value;
+              lastTime_[field] = minutes[row];
+            };
+          };
+        };
+      };
+    };
+  }
+
+  /// @brief      Validates a block of records of one series.
+  /// @param[in]  records: The records, in time order.
+  /// @param[in]  count: The number of records.
+  /// @param[out] validity: The validity bitmaps.
+  /// @returns    The number of invalid values.
+  /// @details    The records are processed 64 at a time so that all the fields are tested while the records are in the L1 cache.
+  /// @throws     std::bad_alloc
+  /// @version    2026-10-19/GGB - Function created.
+
+  std::size_t CRecordValidator::validate(STimeSeriesRecord const *records, std::size_t count, SValidity &validity)
+  {
+    validity.resize(count);
+
+    for (std::size_t block = 0; block < count; block += 64)
+    {
+      STimeSeriesRecord const *blockRecords = records + block;
+      std::size_t rows = std::min<std::size_t>(count - block, 64);
+
+      for (std::size_t field = 0; field < VF_COUNT; field++)
+      {
+        SObservationField const &descriptor = observationFields[field];
+        SFieldLimits const &limits = limits_[field];
+        std::uint64_t &word = validity.words[field][block / 64];
+
+        switch (descriptor.type)
+        {
+          case OT_DOUBLE:
+            word = rangeWord<double>(blockRecords, rows, descriptor.offset, limits.minimum, limits.maximum);
+            break;
+          case OT_UINT16:
+            word = rangeWord<std::uint16_t>(blockRecords, rows, descriptor.offset, limits.minimum, limits.maximum);
+            break;
+          case OT_UINT8:
+            word = rangeWord<std::uint8_t>(blockRecords, rows, descriptor.offset, limits.minimum, limits.maximum);
+            break;
+        };
+      };
+
+      spikeTest(blockRecords, rows, block / 64, validity);
+    };
+
+    return countNulls(validity);
+  }
+
+  /// @brief      Validates a block of records of one series and marks the invalid values as missing.
+  /// @param[in]  records: The records, in time order.
+  /// @param[in]  count: The number of records.
+  /// @returns    The number of invalid values.
+  /// @throws     std::bad_alloc
+  /// @version    2026-10-19/GGB - Function created.
+
+  std::size_t CRecordValidator::validate(STimeSeriesRecord *records, std::size_t count)
+  {
+    std::size_t returnValue = validate(const_cast<STimeSeriesRecord const *>(records), count, validity_);
+
+    if (returnValue != 0)
+    {
+      apply(records, count, validity_);
+    };
+
+    return returnValue;
+  }
+
+  /// @brief      Validates a single record and marks the invalid values as missing.
+  /// @param[in]  record: The record.
+  /// @returns    true if all the values are valid.
+  /// @throws     std::bad_alloc
+  /// @version    2026-10-19/GGB - Function created.
+
+  bool CRecordValidator::validate(STimeSeriesRecord &record)
+  {
+    return (validate(&record, 1) == 0);
+  }
+
+} // namespace WCL
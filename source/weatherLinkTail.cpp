@@ -0,0 +1,424 @@
+﻿//*********************************************************************************************************************************
+//
+// PROJECT:							Weather Class Library (WCL)
+// FILE:								weatherLinkTail
+// SUBSYSTEM:						Incremental reading of the current .wlk file
+// LANGUAGE:						C++
+// TARGET OS:						WINDOWS/UNIX/LINUX/MAC
+// LIBRARY DEPENDANCE:	boost::filesystem
+// NAMESPACE:						WCL
+// AUTHOR:							Gavin Blakeman.
+// LICENSE:             GPLv2
+//
+//                      Copyright 2026 Gavin Blakeman.
+//                      This file is part of the Weather Class Library (WCL).
+//
+//                      WCL is free software: you can redistribute it and/or modify it under the terms of the GNU General
+//                      Public License as published by the Free Software Foundation, either version 2 of the License, or (at your
+//                      option) any later version.
+//
+//                      WCL is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the
+//                      implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//                      for more details.
+//
+//                      You should have received a copy of the GNU General Public License along with WCL.  If not, see
+//                      <http://www.gnu.org/licenses/>.
+//
+// OVERVIEW:						Implements the tail of the current .wlk file.
+//
+// CLASSES INCLUDED:    CWeatherLinkTail
+//
+// CLASS HIERARCHY:     CWeatherLinkTail
+//
+// HISTORY:             2026-10-19 GGB - File Created
+//
+//*********************************************************************************************************************************
+
+#include "include/weatherLinkTail.h"
+
+  // Standard C++ library header files.
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+  // Miscellaneous library header files.
+
+#include <GCL>
+
+  // WCL header files
+
+#include "include/error.h"
+#include "include/replay.h"
+
+namespace WCL
+{
+  /// @brief      Constructs the tail.
+  /// @param[in]  fileName: The .wlk file to follow. The name must be of the form YYYY-MM.wlk. The file need not exist yet.
+  /// @param[in]  callback: Called for each new archive record, on the tail thread.
+  /// @throws     0x0001 - APPLICATION: Unable to open data file. (The file name is not of the form YYYY-MM.wlk)
+  /// @version    2026-10-19/GGB - Function created.
+
+  CWeatherLinkTail::CWeatherLinkTail(boost::filesystem::path const &fileName, callback_t callback) : fileName_(fileName),
+    callback_(std::move(callback)), records_(0), settle_(250), pollInterval_(5000), stop_(false)
+  {
+    if (!CReplayDriver::fileDate(fileName_, year_, month_))
+    {
+      WCL_ERROR(0x0001);
+    };
+  }
+
+  /// @brief      Constructs a tail that writes the new records to a store.
+  /// @param[in]  fileName: The .wlk file to follow. The name must be of the form YYYY-MM.wlk. The file need not exist yet.
+  /// @param[in]  store: The store to write the records to. Duplicate records are ignored by the store.
+  /// @param[in]  siteID: The site ID of the records.
+  /// @param[in]  instrumentID: The instrument ID of the records.
+  /// @throws     0x0001 - APPLICATION: Unable to open data file. (The file name is not of the form YYYY-MM.wlk)
+  /// @version    2026-10-19/GGB - Function created.
+
+  CWeatherLinkTail::CWeatherLinkTail(boost::filesystem::path const &fileName, CWeatherStore &store, unsigned long siteID,
+                                     unsigned long instrumentID)
+    : CWeatherLinkTail(fileName, [&store, siteID, instrumentID](ACL::TJD const &JD, SWeatherDataRecord const &record)
+                                 {
+                                   store.insertRecord(siteID, instrumentID, record, JD);
+                                 })
+  {
+  }
+
+  /// @brief    Destructor. Stops the tail thread.
+  /// @throws   None.
+  /// @version  2026-10-19/GGB - Function created.
+
+  CWeatherLinkTail::~CWeatherLinkTail()
+  {
+    stop();
+  }
+
+  /// @brief      Returns the name of the file for the month following the current file.
+  /// @returns    The path of the next file.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  boost::filesystem::path CWeatherLinkTail::nextFile() const
+  {
+    char name[16];
+
+    std::snprintf(name, sizeof(name), "%04d-%02d.wlk", (month_ == 12) ? year_ + 1 : year_, (month_ % 12) + 1);
+
+    return fileName_.parent_path() / name;
+  }
+
+  /// @brief      Opens the current file if it is not already open.
+  /// @returns    true - The file is open.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  bool CWeatherLinkTail::openFile()
+  {
+    if (!file_ && boost::filesystem::exists(fileName_))
+    {
+      file_.reset(new CWeatherLinkDatabaseFile(fileName_));
+      if (!file_->openFile())
+      {
+        file_.reset();
+      };
+    };
+
+    return static_cast<bool>(file_);
+  }
+
+  /// @brief      Sets the position of the last record that has already been processed. The next update delivers the records after
+  ///             this position. Used to resume from the last record in the database.
+  /// @param[in]  day: The day of the last record. (0 = start of the file)
+  /// @param[in]  archiveIndex: The archive index of the last record within the day. (-1 = start of the day)
+  /// @throws     None.
+  /// @note       Must not be called while the tail thread is running.
+  /// @version    2026-10-19/GGB - Function created.
+
+  void CWeatherLinkTail::position(int day, int archiveIndex)
+  {
+    day_ = day;
+    archiveIndex_ = archiveIndex;
+    havePreviousHeader_ = false;
+  }
+
+  /// @brief      Reads and delivers the archive records of a day from an index onwards.
+  /// @param[in]  day: The day.
+  /// @param[in]  firstIndex: The first archive index to read.
+  /// @returns    The number of records delivered.
+  /// @details    Reading stops at the first record that is not valid, which occurs if the header has been written before the
+  ///             records. The position is not moved past that record, so it is read again on the next update.
+  /// @throws     Any exception thrown by the callback.
+  /// @version    2026-10-19/GGB - Function created.
+
+  std::size_t CWeatherLinkTail::readDay(int day, int firstIndex)
+  {
+    int available = file_->getHeaderBlock().dayIndex[day].recordsInDay - 2;
+    std::size_t returnValue = 0;
+
+    if (available > firstIndex)
+    {
+      ACL::TJD JD(year_, month_, day);
+
+      buffer_.resize(static_cast<std::size_t>(available - firstIndex));
+      returnValue = file_->readArchiveRecords(day, firstIndex, buffer_.data(), buffer_.size());
+
+      for (std::size_t index = 0; index < returnValue; index++)
+      {
+        callback_(JD, buffer_[index]);
+        day_ = day;
+        archiveIndex_ = firstIndex + static_cast<int>(index);
+        records_++;
+      };
+    };
+
+    return returnValue;
+  }
+
+  /// @brief      Delivers all the records that have been added to the file since the last update. This is called by the tail
+  ///             thread, but can also be called directly when the thread is not running.
+  /// @returns    The number of records delivered.
+  /// @details    Only the header block is read unless a day index entry has changed. For the changed days, only the records after
+  ///             the last position are read. If the file for the next month exists, the current file is completed and the tail
+  ///             moves to the next file.
+  /// @throws     Any exception thrown by the callback.
+  /// @version    2026-10-19/GGB - Function created.
+
+  std::size_t CWeatherLinkTail::update()
+  {
+    std::size_t returnValue = 0;
+    bool nextMonth = true;
+
+    while (nextMonth && openFile())
+    {
+      if (file_->reloadHeader())
+      {
+        SHeaderBlock const &header = file_->getHeaderBlock();
+        bool complete = true;
+
+        for (int day = std::max(day_, 1); complete && (day <= 31); day++)
+        {
+          bool changed = !havePreviousHeader_ ||
+                         (header.dayIndex[day].recordsInDay != previousHeader_.dayIndex[day].recordsInDay) ||
+                         (header.dayIndex[day].startPos != previousHeader_.dayIndex[day].startPos);
+          int firstIndex = (day == day_) ? archiveIndex_ + 1 : 0;
+
+          if (changed || (day == day_))
+          {
+            std::size_t delivered = readDay(day, firstIndex);
+
+            returnValue += delivered;
+            complete = (static_cast<int>(delivered) >= header.dayIndex[day].recordsInDay - 2 - firstIndex);
+          };
+        };
+
+          // Keep the previous header if a day could not be completely read, so that the day is retried.
+
+        if (complete)
+        {
+          previousHeader_ = header;
+          havePreviousHeader_ = true;
+        };
+      };
+
+      nextMonth = boost::filesystem::exists(nextFile());
+      if (nextMonth)
+      {
+        int year = (month_ == 12) ? year_ + 1 : year_;
+        int month = (month_ % 12) + 1;
+
+        fileName_ = nextFile();
+        year_ = year;
+        month_ = month;
+        file_.reset();
+        day_ = 0;
+        archiveIndex_ = -1;
+        havePreviousHeader_ = false;
+      };
+    };
+
+    return returnValue;
+  }
+
+  /// @brief      Starts the tail thread. The records already in the file after the position are delivered immediately.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  void CWeatherLinkTail::start()
+  {
+    if (!thread_.joinable())
+    {
+      stop_ = false;
+
+#ifdef __linux__
+      inotifyFD_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+      stopFD_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+      boost::filesystem::path directory = fileName_.parent_path().empty() ? boost::filesystem::path(".") : fileName_.parent_path();
+
+      if ( (inotifyFD_ < 0) || (stopFD_ < 0) ||
+           (inotify_add_watch(inotifyFD_, directory.c_str(), IN_MODIFY | IN_CLOSE_WRITE | IN_CREATE | IN_MOVED_TO) < 0) )
+      {
+        ERRORMESSAGE("WCL: Unable to watch " + directory.string() + " with inotify. Polling the file instead.");
+        if (inotifyFD_ >= 0)
+        {
+          ::close(inotifyFD_);
+          inotifyFD_ = -1;
+        };
+      };
+#endif
+
+      thread_ = std::thread(&CWeatherLinkTail::tail, this);
+    };
+  }
+
+  /// @brief      Stops the tail thread.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  void CWeatherLinkTail::stop()
+  {
+    {
+      std::lock_guard<std::mutex> lock(stopMutex_);
+      stop_ = true;
+    }
+    stopCondition_.notify_all();
+
+#ifdef __linux__
+    if (stopFD_ >= 0)
+    {
+      std::uint64_t value = 1;
+
+      if (::write(stopFD_, &value, sizeof(value)) < 0)
+      {
+        ERRORMESSAGE("WCL: Unable to signal the tail thread.");
+      };
+    };
+#endif
+
+    if (thread_.joinable())
+    {
+      thread_.join();
+    };
+
+#ifdef __linux__
+    if (inotifyFD_ >= 0)
+    {
+      ::close(inotifyFD_);
+      inotifyFD_ = -1;
+    };
+    if (stopFD_ >= 0)
+    {
+      ::close(stopFD_);
+      stopFD_ = -1;
+    };
+#endif
+  }
+
+  /// @brief      The tail thread function.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  void CWeatherLinkTail::tail()
+  {
+    try
+    {
+      update();
+
+      while (waitForChange())
+      {
+        update();
+      };
+    }
+    catch(...)
+    {
+      ERRORMESSAGE("WCL: Exception in the tail of " + fileName_.string() + ". Tail stopped.");
+    };
+  }
+
+  /// @brief      Waits until the file, or the file for the next month, changes.
+  /// @returns    true - The file may have changed.
+  /// @returns    false - The tail has been stopped.
+  /// @details    With inotify, events are collected until there has been no event for the settle time. This lets the WeatherLink
+  ///             software finish writing the records and the header before they are read.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  bool CWeatherLinkTail::waitForChange()
+  {
+#ifdef __linux__
+    if (inotifyFD_ >= 0)
+    {
+      bool changed = false;
+      int timeout = -1;
+
+      while (!stop_)
+      {
+        pollfd fds[2] = { {inotifyFD_, POLLIN, 0}, {stopFD_, POLLIN, 0} };
+        int result = ::poll(fds, 2, timeout);
+
+        if (result == 0)
+        {
+          return true;      // Settled.
+        }
+        else if ( (result < 0) || (fds[1].revents & POLLIN) )
+        {
+          continue;
+        };
+
+        alignas(inotify_event) char events[4096];
+        ssize_t length;
+        std::string current = fileName_.filename().string();
+        std::string next = nextFile().filename().string();
+
+        while ((length = ::read(inotifyFD_, events, sizeof(events))) > 0)
+        {
+          for (char *pointer = events; pointer < events + length; )
+          {
+            inotify_event const *event = reinterpret_cast<inotify_event const *>(pointer);
+
+            if ( (event->len != 0) && ((current == event->name) || (next == event->name)) )
+            {
+              changed = true;
+            };
+            pointer += sizeof(inotify_event) + event->len;
+          };
+        };
+
+        if (changed)
+        {
+          timeout = static_cast<int>(settle_.count());
+        };
+      };
+
+      return false;
+    };
+#endif
+
+    std::unique_lock<std::mutex> lock(stopMutex_);
+
+    while (!stopCondition_.wait_for(lock, pollInterval_, [this] { return stop_.load(); }))
+    {
+      boost::system::error_code ec;
+      std::uintmax_t size = boost::filesystem::file_size(fileName_, ec);
+      std::time_t writeTime = ec ? 0 : boost::filesystem::last_write_time(fileName_, ec);
+
+      if ( (size != lastSize_) || (writeTime != lastWriteTime_) || boost::filesystem::exists(nextFile()) )
+      {
+        lastSize_ = size;
+        lastWriteTime_ = writeTime;
+        return true;
+      };
+    };
+
+    return false;
+  }
+
+} // namespace WCL
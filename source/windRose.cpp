@@ -0,0 +1,405 @@
+﻿//*********************************************************************************************************************************
+//
+// PROJECT:							Weather Class Library (WCL)
+// FILE:								windRose
+// SUBSYSTEM:						Wind direction/speed histograms
+// LANGUAGE:						C++
+// TARGET OS:						WINDOWS/UNIX/LINUX/MAC
+// LIBRARY DEPENDANCE:	None.
+// NAMESPACE:						WCL
+// AUTHOR:							Gavin Blakeman.
+// LICENSE:             GPLv2
+//
+//                      Copyright 2026 Gavin Blakeman.
+//                      This file is part of the Weather Class Library (WCL).
+//
+//                      WCL is free software: you can redistribute it and/or modify it under the terms of the GNU General
+//                      Public License as published by the Free Software Foundation, either version 2 of the License, or (at your
+//                      option) any later version.
+//
+//                      WCL is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the
+//                      implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//                      for more details.
+//
+//                      You should have received a copy of the GNU General Public License along with WCL.  If not, see
+//                      <http://www.gnu.org/licenses/>.
+//
+// OVERVIEW:						Implements the wind rose histograms and the daily histogram cache.
+//
+// CLASSES INCLUDED:    CWindRoseLayout
+//                      CWindHistogram
+//                      CWindRoseCache
+//
+// CLASS HIERARCHY:     CWindRoseLayout
+//                      CWindHistogram
+//                      CWindRoseCache
+//
+// HISTORY:             2026-10-19 GGB - File Created
+//
+//*********************************************************************************************************************************
+
+#include "include/windRose.h"
+
+  // Standard C++ library header files.
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <thread>
+
+  // Miscellaneous library header files.
+
+#include <GCL>
+
+  // WCL header files
+
+#include "include/error.h"
+
+namespace WCL
+{
+  static std::size_t const DIRECTION_CODES = 16;       ///< Davis direction codes 0..15 (22.5 degree steps from north)
+  static double const MPH_TO_MPS = 0.44704;
+
+  /// @brief      Constructs the layout and builds the lookup tables.
+  /// @param[in]  sectors: The number of direction sectors. (1 - 254)
+  /// @param[in]  speedEdges: The upper edges of the speed bins (m/s), in increasing order. Speeds above the last edge are counted
+  ///             in an extra bin.
+  /// @param[in]  rotation: The angle (degrees clockwise from north) of the centre of the first sector.
+  /// @throws     0x000C - WINDROSE: Invalid wind rose layout.
+  /// @details    Direction codes outside 0..15 (including 255 - no direction) are mapped to the calm row. The console reports no
+  ///             direction when the wind is calm, so the calm row holds both the calm and missing directions.
+  /// @version    2026-10-19/GGB - Function created.
+
+  CWindRoseLayout::CWindRoseLayout(std::size_t sectors, std::vector<double> const &speedEdges, double rotation)
+    : sectors_(sectors), rotation_(rotation), speedEdges_(speedEdges)
+  {
+    if ( (sectors_ == 0) || (sectors_ > 254) || (speedEdges_.size() > 254) ||
+         !std::is_sorted(speedEdges_.begin(), speedEdges_.end()) )
+    {
+      WCL_ERROR(0x000C);
+    };
+
+    double width = 360.0 / static_cast<double>(sectors_);
+
+    sectorTable_.fill(static_cast<std::uint8_t>(sectors_));
+    for (std::size_t code = 0; code < DIRECTION_CODES; code++)
+    {
+      double angle = std::fmod(static_cast<double>(code) * 22.5 - rotation_ + width / 2 + 720.0, 360.0);
+
+      sectorTable_[code] = static_cast<std::uint8_t>(std::min(static_cast<std::size_t>(angle / width), sectors_ - 1));
+    };
+
+    for (std::size_t mph = 0; mph < speedTable_.size(); mph++)
+    {
+      double speed = static_cast<double>(mph) * MPH_TO_MPS;
+
+      speedTable_[mph] = static_cast<std::uint8_t>(std::upper_bound(speedEdges_.begin(), speedEdges_.end(), speed) -
+                                                   speedEdges_.begin());
+    };
+  }
+
+  /// @brief      Constructs an empty histogram.
+  /// @param[in]  layout: The layout of the histogram.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  CWindHistogram::CWindHistogram(windRoseLayoutPtr_t layout) : layout_(std::move(layout)),
+    counts_(layout_->rows() * layout_->speedBins(), 0)
+  {
+  }
+
+  /// @brief      Adds a column of direction codes and speeds to the histogram.
+  /// @param[in]  direction: The direction codes.
+  /// @param[in]  speed: The wind speeds (mph).
+  /// @param[in]  count: The number of values.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  void CWindHistogram::accumulate(std::uint8_t const *direction, std::uint8_t const *speed, std::size_t count)
+  {
+    CWindRoseLayout const &layout = *layout_;
+    std::size_t bins = layout.speedBins();
+    std::uint32_t *counts = counts_.data();
+
+    for (std::size_t index = 0; index < count; index++)
+    {
+      counts[layout.sector(direction[index]) * bins + layout.speedBin(speed[index])]++;
+    };
+  }
+
+  /// @brief      Adds the wind data from a block of .wlk records.
+  /// @param[in]  records: The records.
+  /// @param[in]  count: The number of records.
+  /// @param[in]  high: Use the high wind speed and direction rather than the average speed and prevailing direction.
+  /// @throws     None.
+  /// @note       Speeds are clamped to 255mph.
+  /// @version    2026-10-19/GGB - Function created.
+
+  void CWindHistogram::accumulate(SWeatherDataRecord const *records, std::size_t count, bool high)
+  {
+    CWindRoseLayout const &layout = *layout_;
+    std::size_t bins = layout.speedBins();
+    std::uint32_t *counts = counts_.data();
+
+    for (std::size_t index = 0; index < count; index++)
+    {
+      SWeatherDataRecord const &record = records[index];
+      std::uint8_t direction = static_cast<std::uint8_t>(high ? record.hiWindDirection : record.windDirection);
+      std::uint16_t speed = static_cast<std::uint16_t>(high ? record.hiWindSpeed : record.windSpeed);
+
+      counts[layout.sector(direction) * bins + layout.speedBin(static_cast<std::uint8_t>(std::min<std::uint16_t>(speed, 255)))]++;
+    };
+  }
+
+  /// @brief      Adds the wind data from a block of console archive records.
+  /// @param[in]  records: The records.
+  /// @param[in]  count: The number of records.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  void CWindHistogram::accumulate(SArchiveRecord const *records, std::size_t count)
+  {
+    CWindRoseLayout const &layout = *layout_;
+    std::size_t bins = layout.speedBins();
+    std::uint32_t *counts = counts_.data();
+
+    for (std::size_t index = 0; index < count; index++)
+    {
+      counts[layout.sector(records[index].prevailingWind) * bins + layout.speedBin(records[index].windSpeedAverage)]++;
+    };
+  }
+
+  /// @brief      Adds a column of direction codes and speeds, splitting the work over a number of threads.
+  /// @param[in]  direction: The direction codes.
+  /// @param[in]  speed: The wind speeds (mph).
+  /// @param[in]  count: The number of values.
+  /// @param[in]  threads: The number of threads to use. (0 = hardware concurrency)
+  /// @throws     None.
+  /// @details    Each thread fills a private histogram and the partial histograms are merged at the end, so there is no
+  ///             sharing between the threads.
+  /// @version    2026-10-19/GGB - Function created.
+
+  void CWindHistogram::accumulateParallel(std::uint8_t const *direction, std::uint8_t const *speed, std::size_t count,
+                                          std::size_t threads)
+  {
+    if (threads == 0)
+    {
+      threads = std::max(1u, std::thread::hardware_concurrency());
+    };
+    threads = std::min(threads, std::max<std::size_t>(1, count / 65536));
+
+    if (threads <= 1)
+    {
+      accumulate(direction, speed, count);
+    }
+    else
+    {
+      std::vector<CWindHistogram> partials(threads, CWindHistogram(layout_));
+      std::vector<std::thread> workers;
+      std::size_t chunk = (count + threads - 1) / threads;
+
+      for (std::size_t thread = 0; thread < threads; thread++)
+      {
+        std::size_t first = std::min(count, thread * chunk);
+        std::size_t last = std::min(count, first + chunk);
+
+        workers.emplace_back([&partials, thread, direction, speed, first, last]
+        {
+          partials[thread].accumulate(direction + first, speed + first, last - first);
+        });
+      };
+
+      for (auto &worker : workers)
+      {
+        worker.join();
+      };
+      for (auto const &partial : partials)
+      {
+        merge(partial);
+      };
+    };
+  }
+
+  /// @brief      Adds the counts of another histogram into this histogram.
+  /// @param[in]  other: The histogram to add.
+  /// @throws     0x000C - WINDROSE: Invalid wind rose layout.
+  /// @version    2026-10-19/GGB - Function created.
+
+  void CWindHistogram::merge(CWindHistogram const &other)
+  {
+    if (other.counts_.size() != counts_.size())
+    {
+      WCL_ERROR(0x000C);
+    };
+
+    std::transform(counts_.begin(), counts_.end(), other.counts_.begin(), counts_.begin(), std::plus<std::uint32_t>());
+  }
+
+  /// @brief      Sets all the counts to zero.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  void CWindHistogram::clear()
+  {
+    std::fill(counts_.begin(), counts_.end(), 0);
+  }
+
+  /// @brief      Returns the total number of samples, including the calm row.
+  /// @returns    The number of samples.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  std::uint64_t CWindHistogram::total() const
+  {
+    return std::accumulate(counts_.begin(), counts_.end(), std::uint64_t(0));
+  }
+
+  /// @brief      Returns the number of samples in a sector (row).
+  /// @param[in]  row: The sector. (calmRow() for the calm/no direction samples)
+  /// @returns    The number of samples.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  std::uint64_t CWindHistogram::sectorTotal(std::size_t row) const
+  {
+    auto first = counts_.begin() + static_cast<std::ptrdiff_t>(row * layout_->speedBins());
+
+    return std::accumulate(first, first + static_cast<std::ptrdiff_t>(layout_->speedBins()), std::uint64_t(0));
+  }
+
+  /// @brief      Returns the fraction of all the samples that fall in a bin.
+  /// @param[in]  row: The sector.
+  /// @param[in]  speedBin: The speed bin.
+  /// @returns    The frequency (0 - 1). Zero if the histogram is empty.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  double CWindHistogram::frequency(std::size_t row, std::size_t speedBin) const
+  {
+    std::uint64_t samples = total();
+
+    return (samples == 0) ? 0 : static_cast<double>(count(row, speedBin)) / static_cast<double>(samples);
+  }
+
+  /// @brief      Constructs the cache.
+  /// @param[in]  layout: The layout of the cached histograms.
+  /// @param[in]  loader: Called to fill the histogram of a day that is not in the cache.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  CWindRoseCache::CWindRoseCache(windRoseLayoutPtr_t layout, loader_t loader) : layout_(std::move(layout)),
+    loader_(std::move(loader))
+  {
+  }
+
+  /// @brief      Returns the histogram for a day, loading it if it is not cached.
+  /// @param[in]  siteID: The site.
+  /// @param[in]  instrumentID: The instrument.
+  /// @param[in]  MJD: The day.
+  /// @returns    The histogram of the day.
+  /// @throws     Any exception thrown by the loader.
+  /// @details    The loader is called without the lock held, so that a number of days can be loaded concurrently.
+  /// @version    2026-10-19/GGB - Function created.
+
+  CWindHistogram CWindRoseCache::day(unsigned long siteID, unsigned long instrumentID, std::uint32_t MJD)
+  {
+    seriesKey_t key(siteID, instrumentID);
+
+    {
+      std::lock_guard<std::mutex> lock(cacheMutex_);
+      auto series = cache_.find(key);
+
+      if (series != cache_.end())
+      {
+        auto entry = series->second.find(MJD);
+
+        if (entry != series->second.end())
+        {
+          return entry->second;
+        };
+      };
+    }
+
+    CWindHistogram histogram(layout_);
+
+    loader_(siteID, instrumentID, MJD, histogram);
+
+    std::lock_guard<std::mutex> lock(cacheMutex_);
+    cache_[key].emplace(MJD, histogram);
+
+    return histogram;
+  }
+
+  /// @brief      Returns the combined histogram for a range of days.
+  /// @param[in]  siteID: The site.
+  /// @param[in]  instrumentID: The instrument.
+  /// @param[in]  firstMJD: The first day.
+  /// @param[in]  lastMJD: The last day. (inclusive)
+  /// @returns    The histogram of the range.
+  /// @throws     Any exception thrown by the loader.
+  /// @version    2026-10-19/GGB - Function created.
+
+  CWindHistogram CWindRoseCache::range(unsigned long siteID, unsigned long instrumentID, std::uint32_t firstMJD,
+                                       std::uint32_t lastMJD)
+  {
+    CWindHistogram returnValue(layout_);
+
+    for (std::uint32_t MJD = firstMJD; MJD <= lastMJD; MJD++)
+    {
+      returnValue.merge(day(siteID, instrumentID, MJD));
+    };
+
+    return returnValue;
+  }
+
+  /// @brief      Stores a histogram computed elsewhere (eg during an import) into the cache.
+  /// @param[in]  siteID: The site.
+  /// @param[in]  instrumentID: The instrument.
+  /// @param[in]  MJD: The day.
+  /// @param[in]  histogram: The histogram of the day.
+  /// @throws     0x000C - WINDROSE: Invalid wind rose layout.
+  /// @version    2026-10-19/GGB - Function created.
+
+  void CWindRoseCache::store(unsigned long siteID, unsigned long instrumentID, std::uint32_t MJD, CWindHistogram const &histogram)
+  {
+    if ( (histogram.layout()->rows() != layout_->rows()) || (histogram.layout()->speedBins() != layout_->speedBins()) )
+    {
+      WCL_ERROR(0x000C);
+    };
+
+    std::lock_guard<std::mutex> lock(cacheMutex_);
+    auto &series = cache_[seriesKey_t(siteID, instrumentID)];
+
+    series.erase(MJD);
+    series.emplace(MJD, histogram);
+  }
+
+  /// @brief      Removes a day from the cache. Called when the data for the day changes.
+  /// @param[in]  siteID: The site.
+  /// @param[in]  instrumentID: The instrument.
+  /// @param[in]  MJD: The day.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  void CWindRoseCache::invalidate(unsigned long siteID, unsigned long instrumentID, std::uint32_t MJD)
+  {
+    std::lock_guard<std::mutex> lock(cacheMutex_);
+    auto series = cache_.find(seriesKey_t(siteID, instrumentID));
+
+    if (series != cache_.end())
+    {
+      series->second.erase(MJD);
+    };
+  }
+
+  /// @brief      Removes all the entries from the cache.
+  /// @throws     None.
+  /// @version    2026-10-19/GGB - Function created.
+
+  void CWindRoseCache::clear()
+  {
+    std::lock_guard<std::mutex> lock(cacheMutex_);
+    cache_.clear();
+  }
+
+} // namespace WCL
@@ -0,0 +1,49 @@
+#-----------------------------------------------------------------------------------------------------------------------------------
+#
+# PROJECT:            Weather Class Library
+# FILE:								meteorology.pro
+# SUBSYSTEM:          Project File
+# LANGUAGE:						C++
+# TARGET OS:          WINDOWS/UNIX/LINUX/MAC
+# LIBRARY DEPENDANCE:	None.
+# NAMESPACE:          N/A
+# AUTHOR:							Gavin Blakeman.
+# LICENSE:            GPLv2
+#
+#                     Copyright 2026 Gavin Blakeman.
+#                     This file is part of the Weather Class Library (WCL).
+#
+#                     WCL is free software: you can redistribute it and/or modify it under the terms of the GNU General
+#                     Public License as published by the Free Software Foundation, either version 2 of the License, or (at your
+#                     option) any later version.
+#
+#                     WCL is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the
+#                     implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+#                     for more details.
+#
+#                     You should have received a copy of the GNU General Public License along with WCL.  If not, see
+#                     <http://www.gnu.org/licenses/>.
+#
+# OVERVIEW:						Project file for the precision tests of the meteorology kernels. The kernels are compiled into the test
+#                     directly, with the same floating point flags as the library. Run the program after building it. It returns
+#                     a non-zero exit code if a test fails.
+#
+# HISTORY:            2026-10-19/GGB - File created
+#
+#-----------------------------------------------------------------------------------------------------------------------------------
+
+TARGET = testMeteorology
+TEMPLATE = app
+CONFIG += console
+CONFIG -= qt app_bundle
+
+QMAKE_CXXFLAGS += -std=c++17
+QMAKE_CXXFLAGS += -fno-math-errno -fno-trapping-math
+
+INCLUDEPATH += \
+  "../.." \
+  "/home/gavin/Documents/Projects/software/Library/Boost/boost_1_71_0"
+
+SOURCES += \
+    testMeteorology.cpp \
+    ../../source/meteorology.cpp
@@ -0,0 +1,301 @@
+﻿//*********************************************************************************************************************************
+//
+// PROJECT:							Weather Class Library (WCL)
+// FILE:								testMeteorology
+// SUBSYSTEM:						Precision tests of the meteorology kernels
+// LANGUAGE:						C++
+// TARGET OS:						WINDOWS/UNIX/LINUX/MAC
+// LIBRARY DEPENDANCE:	None.
+// NAMESPACE:						WCL
+// AUTHOR:							Gavin Blakeman.
+// LICENSE:             GPLv2
+//
+//                      Copyright 2026 Gavin Blakeman.
+//                      This file is part of the Weather Class Library (WCL).
+//
+//                      WCL is free software: you can redistribute it and/or modify it under the terms of the GNU General
+//                      Public License as published by the Free Software Foundation, either version 2 of the License, or (at your
+//                      option) any later version.
+//
+//                      WCL is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the
+//                      implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+//                      for more details.
+//
+//                      You should have received a copy of the GNU General Public License along with WCL.  If not, see
+//                      <http://www.gnu.org/licenses/>.
+//
+// OVERVIEW:						Compares each kernel in meteorology.cpp against the reference formula evaluated in double precision with
+//                      the standard library functions, over a grid that covers the range of the station sensors, and checks that
+//                      the largest error is within the bound stated in meteorology.h (0.01C). Also checks that missing values
+//                      become NaN and are ignored by summarise().
+//                      The program prints the largest error of each kernel and returns a non-zero exit code if a check fails.
+//
+// HISTORY:             2026-10-19 GGB - File Created
+//
+//*********************************************************************************************************************************
+
+  // Standard C++ library header files.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+  // WCL header files
+
+#include "include/meteorology.h"
+
+using namespace WCL;
+
+static double const ERROR_BOUND = 0.01;       ///< Largest error allowed (C).
+static int failures = 0;
+
+  // Reference formulae. Double precision and the standard library functions.
+
+static double toF(double temperature) { return temperature * 1.8 + 32.0; }
+static double toC(double temperature) { return (temperature - 32.0) / 1.8; }
+
+static double refDewPoint(double T, double RH)
+{
+  double gamma = std::log(std::min(std::max(RH, 1.0), 100.0) / 100.0) + 17.625 * T / (243.04 + T);
+
+  return 243.04 * gamma / (17.625 - gamma);
+}
+
+static double refHeatIndexF(double T, double RH)
+{
+  double simple = 0.5 * (T + 61.0 + (T - 68.0) * 1.2 + RH * 0.094);
+  double full = -42.379 + 2.04901523 * T + 10.14333127 * RH - 0.22475541 * T * RH - 0.00683783 * T * T - 0.05481717 * RH * RH +
+                0.00122874 * T * T * RH + 0.00085282 * T * RH * RH - 0.00000199 * T * T * RH * RH;
+
+  if (RH < 13.0 && T >= 80.0 && T <= 112.0)
+  {
+    full -= ((13.0 - RH) / 4.0) * std::sqrt((17.0 - std::fabs(T - 95.0)) / 17.0);
+  }
+  else if (RH > 85.0 && T >= 80.0 && T <= 87.0)
+  {
+    full += ((RH - 85.0) / 10.0) * ((87.0 - T) / 5.0);
+  };
+
+  return ((simple + T) / 2.0 < 80.0) ? simple : full;
+}
+
+static double refHeatIndex(double T, double RH)
+{
+  return toC(refHeatIndexF(toF(T), RH));
+}
+
+static double refWindChill(double T, double V)
+{
+  double F = toF(T);
+  double mph = V / 0.44704;
+
+  if (F > 50.0 || mph < 3.0)
+  {
+    return T;
+  };
+
+  double V16 = std::pow(mph, 0.16);
+
+  return toC(35.74 + 0.6215 * F - 35.75 * V16 + 0.4275 * F * V16);
+}
+
+static double refTHW(double T, double RH, double V)
+{
+  return toC(refHeatIndexF(toF(T), RH) - 1.072 * V / 0.44704);
+}
+
+static double refTHSW(double T, double RH, double V, double Q)
+{
+  double e = RH / 100.0 * 6.105 * std::exp(17.27 * T / (237.7 + T));
+
+  return T + 0.348 * e - 0.70 * V + 0.70 * Q / (V + 10.0) - 4.25;
+}
+
+static double refWetBulb(double T, double RH)
+{
+  return T * std::atan(0.151977 * std::sqrt(RH + 8.313659)) + std::atan(T + RH) - std::atan(RH - 1.676331) +
+         0.00391838 * std::pow(RH, 1.5) * std::atan(0.023101 * RH) - 4.686035;
+}
+
+/// @brief      Reports the largest error of a kernel and records a failure if it is larger than the bound.
+/// @param[in]  name: The name of the kernel.
+/// @param[in]  out: The kernel results.
+/// @param[in]  reference: The reference results.
+
+static void compare(char const *name, std::vector<float> const &out, std::vector<double> const &reference)
+{
+  double maxError = 0;
+
+  for (std::size_t index = 0; index < out.size(); index++)
+  {
+    double error = std::fabs(out[index] - reference[index]);
+
+    maxError = (error == error) ? std::max(maxError, error) : 1e9;
+  };
+
+  std::printf("%-12s %8zu values  max error %.6fC  %s\n", name, out.size(), maxError, (maxError < ERROR_BOUND) ? "PASS" : "FAIL");
+  if (!(maxError < ERROR_BOUND))
+  {
+    failures++;
+  };
+}
+
+/// @brief      Records a failure if a condition is false.
+
+static void check(char const *name, bool condition)
+{
+  std::printf("%-40s %s\n", name, condition ? "PASS" : "FAIL");
+  if (!condition)
+  {
+    failures++;
+  };
+}
+
+int main()
+{
+  meteorology::SColumns grid;
+  std::vector<float> out;
+  std::vector<double> reference;
+  std::size_t count;
+
+    // Temperature -40C to 50C, humidity 1% to 100%, wind 0 to 40m/s and solar radiation 0 to 1400W/m^2.
+
+  for (int T = -400; T <= 500; T += 5)
+  {
+    for (int RH = 1; RH <= 100; RH++)
+    {
+      for (int V = 0; V <= 40; V += 4)
+      {
+        grid.temperature.push_back(T * 0.1f);
+        grid.humidity.push_back(static_cast<float>(RH));
+        grid.windSpeed.push_back(static_cast<float>(V));
+        grid.solarRadiation.push_back(static_cast<float>((T + RH + V) % 15 * 100));
+      };
+    };
+  };
+  count = grid.size();
+  out.resize(count);
+  reference.resize(count);
+
+  meteorology::dewPoint(grid.temperature.data(), grid.humidity.data(), out.data(), count);
+  for (std::size_t index = 0; index < count; index++)
+  {
+    reference[index] = refDewPoint(grid.temperature[index], grid.humidity[index]);
+  };
+  compare("dewPoint", out, reference);
+
+  meteorology::heatIndex(grid.temperature.data(), grid.humidity.data(), out.data(), count);
+  for (std::size_t index = 0; index < count; index++)
+  {
+    reference[index] = refHeatIndex(grid.temperature[index], grid.humidity[index]);
+  };
+  compare("heatIndex", out, reference);
+
+  meteorology::windChill(grid.temperature.data(), grid.windSpeed.data(), out.data(), count);
+  for (std::size_t index = 0; index < count; index++)
+  {
+    reference[index] = refWindChill(grid.temperature[index], grid.windSpeed[index]);
+  };
+  compare("windChill", out, reference);
+
+  meteorology::THW(grid.temperature.data(), grid.humidity.data(), grid.windSpeed.data(), out.data(), count);
+  for (std::size_t index = 0; index < count; index++)
+  {
+    reference[index] = refTHW(grid.temperature[index], grid.humidity[index], grid.windSpeed[index]);
+  };
+  compare("THW", out, reference);
+
+  meteorology::THSW(grid.temperature.data(), grid.humidity.data(), grid.windSpeed.data(), grid.solarRadiation.data(), out.data(),
+                    count);
+  for (std::size_t index = 0; index < count; index++)
+  {
+    reference[index] = refTHSW(grid.temperature[index], grid.humidity[index], grid.windSpeed[index],
+                               grid.solarRadiation[index]);
+  };
+  compare("THSW", out, reference);
+
+  meteorology::wetBulb(grid.temperature.data(), grid.humidity.data(), out.data(), count);
+  for (std::size_t index = 0; index < count; index++)
+  {
+    reference[index] = refWetBulb(grid.temperature[index], grid.humidity[index]);
+  };
+  compare("wetBulb", out, reference);
+
+    // Missing values.
+
+  {
+    SWeatherDataRecord wlk[2];
+    SArchiveRecord archive[2];
+    STimeSeriesRecord tsr[2];
+    meteorology::SColumns columns;
+    meteorology::SSummary summary;
+    float dew[2];
+    float chill[2];
+
+    std::memset(wlk, 0, sizeof(wlk));
+    std::memset(archive, 0, sizeof(archive));
+    std::memset(tsr, 0, sizeof(tsr));
+
+    wlk[0].outsideTemp = 700;
+    wlk[0].outsideHum = 500;
+    wlk[0].windSpeed = 10;
+    wlk[1].outsideTemp = 32767;
+    wlk[1].outsideHum = -32768;
+    wlk[1].windSpeed = 255;
+    wlk[1].solarRad = 32767;
+    meteorology::columns(wlk, 2, columns);
+    check("wlk: valid values kept", std::fabs(columns.temperature[0] - 21.111f) < 0.001f && columns.humidity[0] == 50.0f);
+    check("wlk: sentinels are NaN", std::isnan(columns.temperature[1]) && std::isnan(columns.humidity[1]) &&
+                                   std::isnan(columns.windSpeed[1]) && std::isnan(columns.solarRadiation[1]));
+
+    meteorology::dewPoint(columns.temperature.data(), columns.humidity.data(), dew, 2);
+    meteorology::windChill(columns.temperature.data(), columns.windSpeed.data(), chill, 2);
+    check("kernels return NaN for NaN input", !std::isnan(dew[0]) && std::isnan(dew[1]) && std::isnan(chill[1]));
+
+    summary = meteorology::summarise(columns.temperature.data(), 2);
+    check("summarise ignores NaN", summary.high == columns.temperature[0] && summary.low == columns.temperature[0]);
+
+    archive[0].temperatureOutside = 700;
+    archive[0].humidityOutside = 50;
+    archive[1].temperatureOutside = 32767;
+    archive[1].humidityOutside = 255;
+    archive[1].windSpeedAverage = 255;
+    archive[1].solarRadiation = 32767;
+    meteorology::columns(archive, 2, columns);
+    check("archive: valid values kept", std::fabs(columns.temperature[0] - 21.111f) < 0.001f && columns.humidity[0] == 50.0f);
+    check("archive: sentinels are NaN", std::isnan(columns.temperature[1]) && std::isnan(columns.humidity[1]) &&
+                                       std::isnan(columns.windSpeed[1]) && std::isnan(columns.solarRadiation[1]));
+
+    tsr[0].outsideTemp = 294.15;
+    tsr[0].outsideHumidity = 50;
+    tsr[1].outsideTemp = std::nan("");
+    tsr[1].outsideHumidity = 3276.7;
+    tsr[1].solarRad = CRecordValidator::MISSING_SOLAR;
+    meteorology::columns(tsr, 2, columns);
+    check("time series: valid values kept", std::fabs(columns.temperature[0] - 21.0f) < 0.001f && columns.humidity[0] == 50.0f);
+    check("time series: missing values are NaN", std::isnan(columns.temperature[1]) && std::isnan(columns.humidity[1]) &&
+                                                std::isnan(columns.solarRadiation[1]));
+  };
+
+    // Time for a month of 5 minute records.
+
+  {
+    std::size_t const monthRecords = 31 * 288;
+    auto start = std::chrono::steady_clock::now();
+
+    for (int repeat = 0; repeat < 100; repeat++)
+    {
+      meteorology::dewPoint(grid.temperature.data(), grid.humidity.data(), out.data(), monthRecords);
+      meteorology::wetBulb(grid.temperature.data(), grid.humidity.data(), out.data(), monthRecords);
+    };
+    std::printf("dewPoint + wetBulb for a month of records: %.1fus\n",
+                std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / 100);
+  };
+
+  std::printf("%d failure(s)\n", failures);
+
+  return (failures == 0) ? 0 : 1;
+}